@@ -19,6 +19,22 @@
 
 /*****************************************************************************/
 
+/* Operators whose lifting is specialized on base types passed by value */
+
+typedef enum
+{
+	LIFT_EQ,
+	LIFT_NE,
+	LIFT_LT,
+	LIFT_LE,
+	LIFT_GT,
+	LIFT_GE,
+	LIFT_AND,
+	LIFT_OR
+} LiftOper;
+
+/*****************************************************************************/
+
 TemporalInst *tfunc1_temporalinst(TemporalInst *inst, Datum (*func)(Datum), 
 	Oid valuetypid);
 TemporalSeq *tfunc1_temporalseq(TemporalSeq *seq, Datum (*func)(Datum), 
@@ -211,6 +227,13 @@ TemporalS *sync_tfunc4_temporals_temporals_cross(TemporalS *ts1, TemporalS *ts2,
 Temporal *sync_tfunc4_temporal_temporal_cross(Temporal *temp1, Temporal *temp2,
 	Datum (*func)(Datum, Datum, Oid, Oid), Oid valuetypid);
 
+bool lift_byval_type(Oid valuetypid);
+bool sync_tfunc_byval_supported(Temporal *temp1, Temporal *temp2);
+Temporal *tfunc_byval_temporal_base(Temporal *temp, Datum value, 
+	Oid datumtypid, LiftOper oper, bool invert);
+Temporal *sync_tfunc_byval_temporal_temporal(Temporal *temp1, 
+	Temporal *temp2, LiftOper oper);
+
 /*****************************************************************************/
 
 #endif
@@ -3,9 +3,9 @@
  * oidcache.h
  *	  Functions for building a cache of Oids.
  *
- * The temporal extension builds a cache of OIDs in global arrays in order to 
- * avoid (slow) lookups. The global arrays are initialized at the loading 
- * of the extension.
+ * The temporal extension builds a cache of OIDs in order to avoid (slow) 
+ * lookups. The Oids of the types are cached on the first call in a backend
+ * and the Oids of the operators are cached on demand.
  *
  * Portions Copyright (c) 2020, Esteban Zimanyi, Arthur Lesuisse,
  *		Universite Libre de Bruxelles
@@ -67,10 +67,11 @@ typedef enum
  * type (such as period, tint, ...), currently 33. 
  *
  * There are currently 3,392 operators, each of which is identified by an Oid. 
- * To avoid enumerating all of these operators in the Oid cache, we use a 
- * two-dimensional array containing all possible combinations of 
- * operator/left argument/right argument (currently 23 * 40 * 40 = 36,800 cells). 
- * The invalid combinations will be initialized to 0.
+ * To avoid enumerating all of these operators in the Oid cache, they are
+ * identified by the combination operator/left argument/right argument and 
+ * looked up in the catalog the first time a combination is requested. 
+ * The result, including InvalidOid for the invalid combinations, is kept
+ * in a sparse hash table for the lifetime of the backend.
  */
 
 /* Currently 30 operators */
@@ -113,8 +114,6 @@ extern Oid type_oid(CachedType t);
 extern Oid oper_oid(CachedOp op, CachedType lt, CachedType rt);
 extern void populate_oidcache();
 
-extern Datum fill_opcache(PG_FUNCTION_ARGS);
-
 #endif /* TEMPORAL_OIDCACHE_H */
 
 /*****************************************************************************/
@@ -21,10 +21,15 @@
 
 /* Assorted support functions */
 
+extern Period *periodset_per_array(PeriodSet *ps);
 extern Period *periodset_per_n(PeriodSet *ps, int index);
 extern Period *periodset_bbox(PeriodSet *ps);
 extern PeriodSet *periodset_from_periodarr_internal(Period **periods, 
 	int count, bool normalize);
+extern PeriodSet *periodset_alloc(int maxcount);
+extern void periodset_append(PeriodSet *ps, TimestampTz lower, 
+	TimestampTz upper, bool lower_inc, bool upper_inc);
+extern PeriodSet *periodset_finish(PeriodSet *ps);
 extern PeriodSet *periodset_copy(PeriodSet *ps);
 extern bool periodset_find_timestamp(PeriodSet *ps, TimestampTz t, int *pos);
 
@@ -15,6 +15,7 @@
 
 #include <postgres.h>
 #include <catalog/pg_type.h>
+#include <lib/stringinfo.h>
 #include <utils/rangetypes.h>
 
 #include "timetypes.h"
@@ -58,6 +59,27 @@ struct temporal_duration_struct
 #define DURATION_STRUCT_ARRAY_LEN \
 	(sizeof temporal_duration_struct_array/sizeof(struct temporal_duration_struct))
 
+/*****************************************************************************
+ * Base types of the temporal types
+ *****************************************************************************/
+
+/* Compact tag of a base type, used to index the table of type properties */
+
+typedef enum
+{
+	BASE_BOOL,
+	BASE_INT4,
+	BASE_FLOAT8,
+	BASE_TEXT,
+	BASE_TIMESTAMPTZ,
+	BASE_DOUBLE2,
+	BASE_DOUBLE3,
+	BASE_DOUBLE4,
+	BASE_GEOMETRY,
+	BASE_GEOGRAPHY,
+	BASE_NUM_TYPES
+} BaseType;
+
 /*****************************************************************************
  * Additional operator strategy numbers used in the GiST and SP-GiST temporal
  * opclasses with respect to those defined in the file stratnum.h
@@ -83,6 +105,8 @@ struct temporal_duration_struct
 #define MOBDB_FLAGS_GET_Z(flags) 			((bool) (((flags) & 0x08)>>3))
 #define MOBDB_FLAGS_GET_T(flags) 			((bool) (((flags) & 0x10)>>4))
 #define MOBDB_FLAGS_GET_GEODETIC(flags) 	((bool) (((flags) & 0x20)>>5))
+/* The following flag is only used for TemporalSeq of temporal points */
+#define MOBDB_FLAGS_GET_NOTRAJ(flags) 		((bool) (((flags) & 0x40)>>6))
 
 #define MOBDB_FLAGS_SET_LINEAR(flags, value) \
 	((flags) = (value) ? ((flags) | 0x01) : ((flags) & 0xFE))
@@ -97,6 +121,9 @@ struct temporal_duration_struct
 	((flags) = (value) ? ((flags) | 0x10) : ((flags) & 0xEF))
 #define MOBDB_FLAGS_SET_GEODETIC(flags, value) \
 	((flags) = (value) ? ((flags) | 0x20) : ((flags) & 0xDF))
+/* The following flag is only used for TemporalSeq of temporal points */
+#define MOBDB_FLAGS_SET_NOTRAJ(flags, value) \
+	((flags) = (value) ? ((flags) | 0x40) : ((flags) & 0xBF))
 
 /*****************************************************************************
  * Struct definitions
@@ -227,6 +254,11 @@ typedef struct double4
 
 typedef int (*qsort_comparator) (const void *a, const void *b);
 
+/* Function appending a value of a base type to a buffer, the last argument 
+ * is the maximum number of decimal digits of floating point values or -1 for
+ * the default output of the type */
+typedef void (*value_out_func) (StringInfo buf, Oid type, Datum value, int maxdd);
+
 /*****************************************************************************
  * fmgr macros temporal types
  *****************************************************************************/
@@ -255,7 +287,7 @@ typedef int (*qsort_comparator) (const void *a, const void *b);
 #define DatumGetTemporalSeq(X)		((TemporalSeq *) PG_DETOAST_DATUM(X))
 #define DatumGetTemporalS(X)		((TemporalS *) PG_DETOAST_DATUM(X))
 
-#define PG_GETARG_TEMPORAL(i)		((Temporal *) PG_GETARG_VARLENA_P(i))
+#define PG_GETARG_TEMPORAL(i)		temporal_detoast(PG_GETARG_DATUM(i))
 
 #define PG_GETARG_ANYDATUM(i) (get_typlen(get_fn_expr_argtype(fcinfo->flinfo, i)) == -1 ? \
 	PointerGetDatum(PG_GETARG_VARLENA_P(i)) : PG_GETARG_DATUM(i))
@@ -285,6 +317,7 @@ typedef int (*qsort_comparator) (const void *a, const void *b);
 /* Internal functions */
 
 extern Temporal *temporal_copy(Temporal *temp);
+extern Temporal *temporal_detoast(Datum value);
 extern Temporal *pg_getarg_temporal(Temporal *temp);
 extern bool intersection_temporal_temporal(Temporal *temp1, Temporal *temp2, 
 	Temporal **inter1, Temporal **inter2);
@@ -308,6 +341,8 @@ extern bool temporal_type_oid(Oid temptypid);
 
 /* Trajectory functions */
 
+extern bool precompute_trajectory;
+
 extern bool type_has_precomputed_trajectory(Oid valuetypid);
 
 /* Parameter tests */
@@ -326,6 +361,7 @@ extern void ensure_point_base_type(Oid type);
 
 extern Datum temporal_in(PG_FUNCTION_ARGS); 
 extern Datum temporal_out(PG_FUNCTION_ARGS); 
+extern Datum temporal_as_text(PG_FUNCTION_ARGS);
 extern Datum temporal_send(PG_FUNCTION_ARGS); 
 extern Datum temporal_recv(PG_FUNCTION_ARGS);
 extern Temporal* temporal_read(StringInfo buf, Oid valuetypid);
@@ -420,11 +456,14 @@ extern Datum temporal_intersects_timestampset(PG_FUNCTION_ARGS);
 extern Datum temporal_intersects_period(PG_FUNCTION_ARGS);
 extern Datum temporal_intersects_periodset(PG_FUNCTION_ARGS);
  
+extern Temporal *temporal_at_value_internal(Temporal *temp, Datum value);
 extern Temporal *temporal_at_min_internal(Temporal *temp);
 extern TemporalInst *temporal_at_timestamp_internal(Temporal *temp, TimestampTz t);
 extern Temporal *temporal_at_periodset_internal(Temporal *temp, PeriodSet *ps);
 extern void temporal_period(Period *p, Temporal *temp);
-extern char *temporal_to_string(Temporal *temp, char *(*value_out)(Oid, Datum));
+extern void temporal_to_stringbuf(StringInfo buf, Temporal *temp, int maxdd, 
+	value_out_func value_out);
+extern char *temporal_to_string(Temporal *temp, int maxdd, value_out_func value_out);
 extern void temporal_bbox(void *box, const Temporal *temp);
 
 /* Comparison functions */
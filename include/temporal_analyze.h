@@ -81,6 +81,27 @@ typedef struct
 	int	   *tupnoLink;
 } CompareScalarsContext;
 
+/*
+ * The value and the time dimensions of temporal numbers are usually
+ * correlated and thus a joint histogram of both dimensions is collected
+ */
+#define STATISTIC_KIND_VALUE_TIME_HISTOGRAM  11
+
+/*
+ * Equi-width histogram of the value and time dimensions of temporal numbers.
+ * The time dimension is expressed in seconds since 2000-01-01. The cells are 
+ * stored with the value dimension varying fastest, each one containing the 
+ * proportion of the bounding boxes of the features that overlaps it.
+ */
+typedef struct
+{
+	float4 size[2];			/* Number of cells in each dimension */
+	float4 min[2];			/* Lower bounds of the histogram */
+	float4 max[2];			/* Upper bounds of the histogram */
+	float4 features;		/* Number of features in the histogram */
+	float4 value[1];		/* Variable length array of cells */
+} TboxHistogram;
+
 /*****************************************************************************
  * Statistics information for temporal types
  *****************************************************************************/
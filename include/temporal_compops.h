@@ -17,6 +17,7 @@
 #include <catalog/pg_type.h>
 
 #include "temporal.h"
+#include "lifting.h"
 
 /*****************************************************************************/
 
@@ -45,7 +46,7 @@ extern Datum tge_temporal_base(PG_FUNCTION_ARGS);
 extern Datum tge_temporal_temporal(PG_FUNCTION_ARGS);
 
 extern Temporal * tcomp_temporal_base(Temporal *temp, Datum value, Oid datumtypid,
-	Datum (*func)(Datum, Datum, Oid, Oid), bool invert);
+	Datum (*func)(Datum, Datum, Oid, Oid), LiftOper oper, bool invert);
 
 /*****************************************************************************/
 
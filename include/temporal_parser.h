@@ -28,6 +28,7 @@ extern bool p_cbracket(char **str);
 extern bool p_oparen(char **str);
 extern bool p_cparen(char **str);
 extern bool p_comma(char **str);
+extern bool p_double(char **str, double *result);
 
 extern TBOX *tbox_parse(char **str);
 extern Datum basetype_parse(char **str, Oid basetype);
@@ -47,6 +47,7 @@ extern Selectivity temporals_sel(PlannerInfo *root, VariableStatData *vardata,
 
 extern double var_eq_const(VariableStatData *vardata, Oid operator,
 	Datum constval, bool constisnull, bool varonleft, bool negate);
+extern double temporal_notnullfrac(VariableStatData *vardata);
 
 /*****************************************************************************/
 
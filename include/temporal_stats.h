@@ -0,0 +1,82 @@
+/*****************************************************************************
+ *
+ * temporal_stats.h
+ *	  Per-backend counters of the hot paths of the extension
+ *
+ * The counters are only maintained when the mobilitydb.stats parameter is
+ * on, otherwise the cost of each instrumentation point is a single test.
+ *
+ * Portions Copyright (c) 2020, Esteban Zimanyi, Arthur Lesuisse,
+ *		Universite Libre de Bruxelles
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ *****************************************************************************/
+
+#ifndef __TEMPORAL_STATS_H__
+#define __TEMPORAL_STATS_H__
+
+#include <postgres.h>
+#include <fmgr.h>
+#include <portability/instr_time.h>
+
+/*****************************************************************************/
+
+/* Instrumented hot paths */
+
+typedef enum
+{
+	STAT_INSTANTS,			/* instants materialized */
+	STAT_SEQUENCES,			/* sequences built from instants */
+	STAT_TRAJECTORIES,		/* trajectories of sequence points computed */
+	STAT_POSTGIS_CALLS,		/* functions called through call_function* */
+	STAT_SKIPLIST_SPLICES,	/* splices in the skiplist of aggregates */
+	STAT_DETOASTS,			/* temporal arguments detoasted */
+	STAT_DETOAST_BYTES,		/* size of the detoasted temporal arguments */
+	STAT_BBOX_SHORTCUTS,	/* results given by the bounding box alone */
+	STAT_NUM
+} MobdbStat;
+
+typedef struct
+{
+	uint64 count;
+	instr_time time;
+} MobdbStatCounter;
+
+extern bool mobdb_stats;
+extern MobdbStatCounter _mobdb_stats[STAT_NUM];
+
+#define MOBDB_STATS_ADD(stat, n) \
+	do { \
+		if (mobdb_stats) \
+			_mobdb_stats[stat].count += (n); \
+	} while (0)
+
+#define MOBDB_STATS_INC(stat) MOBDB_STATS_ADD(stat, 1)
+
+/*
+ * Timing of a hot path. The start time is zero when the counters are off,
+ * so that switching the parameter in between does not account garbage.
+ */
+#define MOBDB_STATS_START(start) \
+	do { \
+		if (mobdb_stats) \
+			INSTR_TIME_SET_CURRENT(start); \
+		else \
+			INSTR_TIME_SET_ZERO(start); \
+	} while (0)
+
+#define MOBDB_STATS_STOP(stat, start) \
+	do { \
+		if (!INSTR_TIME_IS_ZERO(start)) \
+			mobdb_stats_stop(stat, &(start)); \
+	} while (0)
+
+extern void mobdb_stats_stop(MobdbStat stat, instr_time *start);
+
+extern Datum mobdb_stats_get(PG_FUNCTION_ARGS);
+extern Datum mobdb_stats_reset(PG_FUNCTION_ARGS);
+
+/*****************************************************************************/
+
+#endif
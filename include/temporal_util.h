@@ -27,6 +27,12 @@
 extern void _PG_init(void);
 extern void debugstr(char *msg);
 extern size_t double_pad(size_t size);
+extern MemoryContext temporal_arena_create(void);
+extern int base_type_find(Oid type);
+extern BaseType base_type(Oid type);
+extern bool base_type_byval(BaseType basetype);
+extern int base_type_typlen(BaseType basetype);
+extern bool base_type_linear(BaseType basetype);
 extern bool get_typbyval_fast(Oid type);
 extern int get_typlen_fast(Oid type);
 extern Datum datum_copy(Datum value, Oid type);
@@ -43,6 +49,12 @@ extern Datum call_function2(PGFunction func, Datum arg1, Datum arg2);
 extern Datum call_function3(PGFunction func, Datum arg1, Datum arg2, Datum arg3);
 extern Datum call_function4(PGFunction func, Datum arg1, Datum arg2, Datum arg3, Datum arg4);
 
+/* Output into a buffer */
+
+extern void stringinfo_append_double(StringInfo buf, double d, int maxdd);
+extern void stringinfo_append_timestamp(StringInfo buf, TimestampTz t);
+extern void stringinfo_append_value(StringInfo buf, Oid type, Datum value, int maxdd);
+
 /* Array functions */
 
 extern Datum *datumarr_extract(ArrayType *array, int *count);
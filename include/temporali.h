@@ -37,7 +37,8 @@ extern bool intersection_temporali_temporali(TemporalI *ti1, TemporalI *ti2,
 
 /* Input/output functions */
 
-extern char *temporali_to_string(TemporalI *ti, char *(*value_out)(Oid, Datum));
+extern void temporali_to_stringbuf(StringInfo buf, TemporalI *ti, int maxdd, 
+	value_out_func value_out);
 extern void temporali_write(TemporalI *ti, StringInfo buf);
 extern TemporalI *temporali_read(StringInfo buf, Oid valuetypid);
 
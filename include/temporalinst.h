@@ -19,9 +19,39 @@
 #include "temporal.h"
 #include "postgis.h"
 
+/*****************************************************************************/
+
+/*
+ * Builder of an array of instants. The array mixes references to existing
+ * instants and new instants, which are written in place into chunks owned 
+ * by the builder instead of being allocated one by one. The chunks are 
+ * never moved, so the pointers in the array remain valid until the builder
+ * is reset or freed.
+ */
+typedef struct
+{
+	TemporalInst **instants;	/* instants added so far */
+	int count;					/* number of instants added so far */
+	int maxcount;				/* size of the instants array */
+	char *chunk;				/* current chunk, linked to the previous ones */
+	size_t chunkpos;			/* first free byte in the current chunk */
+	size_t chunksize;			/* size of the current chunk */
+} TemporalInstBuilder;
+
 /*****************************************************************************/
  
 extern TemporalInst *temporalinst_make(Datum value, TimestampTz t, Oid valuetypid);
+extern TemporalInst *temporalinst_make_reuse(TemporalInst *buf, size_t *bufsize,
+	Datum value, TimestampTz t, Oid valuetypid);
+extern TemporalInst **temporalinstarr_make_byval(Datum *values, 
+	TimestampTz *times, int count, Oid valuetypid);
+extern void temporalinstbuilder_init(TemporalInstBuilder *builder, int maxcount);
+extern void temporalinstbuilder_add_inst(TemporalInstBuilder *builder, 
+	TemporalInst *inst);
+extern TemporalInst *temporalinstbuilder_add_value(TemporalInstBuilder *builder,
+	Datum value, TimestampTz t, Oid valuetypid);
+extern void temporalinstbuilder_reset(TemporalInstBuilder *builder);
+extern void temporalinstbuilder_free(TemporalInstBuilder *builder);
 extern TemporalInst *temporalinst_copy(TemporalInst *inst);
 extern Datum* temporalinst_value_ptr(TemporalInst *inst);
 extern Datum temporalinst_value(TemporalInst *inst);
@@ -29,7 +59,8 @@ extern Datum temporalinst_value_copy(TemporalInst *inst);
 
 /* Input/output functions */
 
-char *temporalinst_to_string(TemporalInst *inst, char *(*value_out)(Oid, Datum));
+extern void temporalinst_to_stringbuf(StringInfo buf, TemporalInst *inst, 
+	int maxdd, value_out_func value_out);
 extern void temporalinst_write(TemporalInst *inst, StringInfo buf);
 extern TemporalInst *temporalinst_read(StringInfo buf, Oid valuetypid);
 
@@ -57,7 +57,8 @@ extern bool synchronize_temporals_temporals(TemporalS *ts1, TemporalS *ts2,
 
 /* Input/output functions */
 
-extern char *temporals_to_string(TemporalS *ts, char *(*value_out)(Oid, Datum));
+extern void temporals_to_stringbuf(StringInfo buf, TemporalS *ts, int maxdd, 
+	value_out_func value_out);
 extern void temporals_write(TemporalS *ts, StringInfo buf);
 extern TemporalS *temporals_read(StringInfo buf, Oid valuetypid);
 
@@ -20,6 +20,36 @@
 
 /*****************************************************************************/
 
+/* 
+ * Cursor that walks two temporal sequences over the intersection of their 
+ * periods. Each step yields the instants of both sequences at the next 
+ * timestamp of either of them, the missing one being interpolated from the
+ * current segment into a scratch buffer that is reused across steps.
+ */
+
+typedef struct 
+{
+	TemporalSeq *seq1;			/* first sequence */
+	TemporalSeq *seq2;			/* second sequence */
+	Period		inter;			/* intersection of the periods */
+	int			i;				/* index of the next instant of seq1 */
+	int			j;				/* index of the next instant of seq2 */
+	TemporalInst *inst1;		/* instant of seq1 at the current step */
+	TemporalInst *inst2;		/* instant of seq2 at the current step */
+	TemporalInst *prev1;		/* instant of seq1 at the previous step */
+	TemporalInst *prev2;		/* instant of seq2 at the previous step */
+	bool		interp1;		/* inst1 is interpolated */
+	bool		interp2;		/* inst2 is interpolated */
+	TemporalInst *buf1[2];		/* scratch instants for seq1 */
+	TemporalInst *buf2[2];		/* scratch instants for seq2 */
+	size_t		bufsize1[2];	/* allocated sizes of buf1 */
+	size_t		bufsize2[2];	/* allocated sizes of buf2 */
+	int			last1;			/* last written buffer of buf1 */
+	int			last2;			/* last written buffer of buf2 */
+} TemporalSeqSync;
+
+/*****************************************************************************/
+
 extern TemporalInst *temporalseq_inst_n(TemporalSeq *seq, int index);
 extern TemporalSeq *temporalseq_from_temporalinstarr(TemporalInst **instants, 
 	int count, bool lower_inc, bool upper_inc, bool linear, bool normalize);
@@ -45,6 +75,10 @@ extern bool intersection_temporalseq_temporalseq(TemporalSeq *seq1, TemporalSeq
 
 /* Synchronize functions */
 
+extern bool temporalseq_sync_init(TemporalSeqSync *sync, TemporalSeq *seq1, 
+	TemporalSeq *seq2);
+extern bool temporalseq_sync_next(TemporalSeqSync *sync);
+extern void temporalseq_sync_free(TemporalSeqSync *sync);
 extern bool synchronize_temporalseq_temporalseq(TemporalSeq *seq1, TemporalSeq *seq2, 
 	TemporalSeq **sync1, TemporalSeq **sync2, bool interpoint);
 
@@ -55,7 +89,8 @@ extern bool temporalseq_intersect_at_timestamp(TemporalInst *start1, TemporalIns
 
 /* Input/output functions */
 
-extern char *temporalseq_to_string(TemporalSeq *seq, bool component, char *(*value_out)(Oid, Datum));
+extern void temporalseq_to_stringbuf(StringInfo buf, TemporalSeq *seq, 
+	bool component, int maxdd, value_out_func value_out);
 extern void temporalseq_write(TemporalSeq *seq, StringInfo buf);
 extern TemporalSeq *temporalseq_read(StringInfo buf, Oid valuetypid);
 
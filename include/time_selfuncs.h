@@ -23,6 +23,8 @@
 
 extern double calc_period_hist_selectivity(VariableStatData *vardata,
 	Period *constval, CachedOp cachedOp);
+extern double calc_period_hist_joinselectivity(VariableStatData *vardata1,
+	VariableStatData *vardata2, CachedOp cachedOp);
 extern double calc_period_hist_selectivity_scalar(PeriodBound *constbound,
 	PeriodBound *hist, int hist_nvalues, bool equal);
 extern double calc_period_hist_selectivity_contained(PeriodBound *lower,
@@ -21,9 +21,13 @@
 
 /* assorted support functions */
 
+extern TimestampTz *timestampset_time_array(TimestampSet *ts);
 extern TimestampTz timestampset_time_n(TimestampSet *ts, int index);
 extern Period *timestampset_bbox(TimestampSet *ts);
 extern TimestampSet *timestampset_from_timestamparr_internal(TimestampTz *times, int count);
+extern TimestampSet *timestampset_alloc(int maxcount);
+extern void timestampset_append(TimestampSet *ts, TimestampTz t);
+extern TimestampSet *timestampset_finish(TimestampSet *ts);
 extern TimestampSet *timestampset_copy(TimestampSet *ts);
 extern bool timestampset_find_timestamp(TimestampSet *ts, TimestampTz t, int *pos);
 
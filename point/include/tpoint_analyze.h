@@ -27,6 +27,11 @@
 */
 #define ND_DIMS 4
 
+/**
+* Statistics kind of the joint histogram of the spatial and time dimensions
+*/
+#define STATISTIC_KIND_XYT_HISTOGRAM  10
+
 /**
 * N-dimensional box type for calculations, to avoid doing
 * explicit axis conversions from GBOX in all calculations
@@ -15,6 +15,7 @@
 
 #include <postgres.h>
 #include <catalog/pg_type.h>
+#include <liblwgeom.h>
 #include "temporal.h"
 
 /*****************************************************************************/
@@ -27,6 +28,9 @@ extern Datum distance_geo_tpoint(PG_FUNCTION_ARGS);
 extern Datum distance_tpoint_geo(PG_FUNCTION_ARGS);
 extern Datum distance_tpoint_tpoint(PG_FUNCTION_ARGS);
 
+extern bool tgeompoint_min_dist_fraction(const POINT3DZ *p1, 
+	const POINT3DZ *p2, const POINT3DZ *p3, const POINT3DZ *p4, bool hasz,
+	double *fraction);
 extern bool tpointseq_min_dist_at_timestamp(TemporalInst *start1, TemporalInst *end1, 
 	TemporalInst *start2, TemporalInst *end2, TimestampTz *t);
 
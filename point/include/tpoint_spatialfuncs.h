@@ -35,6 +35,7 @@ extern void ensure_has_not_M(GSERIALIZED *gs);
 
 /* Utility functions */
 
+extern uint8_t *gs_point_ptr(GSERIALIZED *gs);
 extern POINT2D gs_get_point2d(GSERIALIZED *gs);
 extern POINT3DZ gs_get_point3dz(GSERIALIZED *gs);
 extern POINT2D datum_get_point2d(Datum value);
@@ -42,6 +43,33 @@ extern POINT3DZ datum_get_point3dz(Datum value);
 extern bool datum_point_eq(Datum geopoint1, Datum geopoint2);
 extern GSERIALIZED* geometry_serialize(LWGEOM* geom);
 
+/* Streaming synchronization of two temporal geometry point sequences */
+
+typedef struct
+{
+	TemporalSeq	   *seq1;		/* first sequence */
+	TemporalSeq	   *seq2;		/* second sequence */
+	bool		linear1;		/* interpolation of the first sequence */
+	bool		linear2;		/* interpolation of the second sequence */
+	bool		hasz;			/* the points have Z dimension */
+	Period		inter;			/* intersection of the periods */
+	int			i;				/* first instant of seq1 at or after t */
+	int			j;				/* first instant of seq2 at or after t */
+	TimestampTz	t;				/* current synchronization timestamp */
+	POINT3DZ	p1;				/* value of seq1 at t */
+	POINT3DZ	p2;				/* value of seq2 at t */
+	bool		last;			/* t is the upper bound of the intersection */
+} TPointSeqSync;
+
+extern bool tpointseq_sync_init(TPointSeqSync *sync, TemporalSeq *seq1, 
+	TemporalSeq *seq2);
+extern bool tpointseq_sync_next(TPointSeqSync *sync);
+extern double point3dz_distance(const POINT3DZ *p1, const POINT3DZ *p2,
+	bool hasz);
+extern void point3dz_interpolate(const POINT3DZ *start, const POINT3DZ *end,
+	double ratio, POINT3DZ *result);
+extern TemporalSeq **tpoint_sequences(Temporal *temp, int *count);
+
 /* Functions for spatial reference systems */
 
 extern Datum tpoint_srid(PG_FUNCTION_ARGS);
@@ -71,6 +99,7 @@ extern Datum tpointseq_trajectory_append(TemporalSeq *seq, TemporalInst *inst, b
 extern Datum geompoint_trajectory(Datum value1, Datum value2);
 extern Datum geogpoint_trajectory(Datum value1, Datum value2);
 
+extern bool tpointseq_has_trajectory(TemporalSeq *seq);
 extern Datum tpointseq_trajectory(TemporalSeq *seq);
 extern Datum tpointseq_trajectory_copy(TemporalSeq *seq);
 extern Datum tpoints_trajectory(TemporalS *ts);
@@ -15,6 +15,7 @@
 
 #include <postgres.h>
 #include <catalog/pg_type.h>
+#include "temporal.h"
 
 /*****************************************************************************/
 
@@ -53,6 +54,7 @@ extern Datum twithin_tpoint_tpoint(PG_FUNCTION_ARGS);
 extern Datum tdwithin_geo_tpoint(PG_FUNCTION_ARGS);
 extern Datum tdwithin_tpoint_geo(PG_FUNCTION_ARGS);
 extern Datum tdwithin_tpoint_tpoint(PG_FUNCTION_ARGS);
+extern Datum tdwithin_tpointarr_tpointarr_pairs(PG_FUNCTION_ARGS);
 
 extern Datum trelate_geo_tpoint(PG_FUNCTION_ARGS);
 extern Datum trelate_tpoint_geo(PG_FUNCTION_ARGS);
@@ -62,6 +64,9 @@ extern Datum trelate_pattern_geo_tpoint(PG_FUNCTION_ARGS);
 extern Datum trelate_pattern_tpoint_geo(PG_FUNCTION_ARGS);
 extern Datum trelate_pattern_tpoint_tpoint(PG_FUNCTION_ARGS);
 
+extern Temporal *tdwithin_tpoint_tpoint_internal(Temporal *temp1, 
+	Temporal *temp2, Datum dist);
+
 /*****************************************************************************/
 
 #endif
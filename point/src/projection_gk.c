@@ -18,6 +18,7 @@
 #include <liblwgeom.h>
 #include "temporaltypes.h"
 #include "oidcache.h"
+#include "temporal_util.h"
 #include "postgis.h"
 #include "tpoint.h"
 #include "tpoint_spatialfuncs.h"
@@ -40,33 +41,57 @@ double eqwgs = 0;
 double eqbes = 0;
 double MDC = 2.0;		/* standard in Hagen, zone=2 */
 
+/*
+ * Constants derived from the ellipsoid parameters above. They do not depend
+ * on the point being projected and are thus computed once per backend in
+ * gk_init instead of once per coordinate.
+ */
+
+static bool gk_ready = false;
+static double gk_l0;		/* central meridian of the zone in radians */
+static double gk_nk;		/* third flattening of the Bessel ellipsoid */
+static double gk_c2;		/* coefficients of the meridian arc series */
+static double gk_c4;
+static double gk_c6;
+static double gk_ng;		/* abes^2 / bbes */
+static double gk_false_easting;
+
+static void
+gk_init(void)
+{
+	if (gk_ready)
+		return;
+	eqwgs = (awgs * awgs - bwgs * bwgs) / (awgs * awgs);
+	eqbes = (abes * abes - bbes * bbes) / (abes * abes);
+	gk_l0 = Pi * (3.0 * MDC) / 180.0;
+	gk_nk = (abes - bbes) / (abes + bbes);
+	gk_c2 = (-3.0 * gk_nk / 2.0) + (9.0 * gk_nk * gk_nk * gk_nk / 16.0);
+	gk_c4 = 15.0 * gk_nk * gk_nk / 16.0;
+	gk_c6 = -35.0 * gk_nk * gk_nk * gk_nk / 48.0;
+	gk_ng = abes * abes / bbes;
+	gk_false_easting = MDC * 1000000.0 + 500000.0;
+	gk_ready = true;
+}
+
 static POINT2D
 BesselBLToGaussKrueger(double b, double ll)
 {
 	POINT2D result;
-	double l0 = 3.0 * MDC;
-	l0 = Pi * l0 / 180.0;
-	double l = ll - l0;
+	double l = ll - gk_l0;
 	double k = cos(b);
 	double t = sin(b) / k;
-	double eq = eqbes;
-	double Vq = 1.0 + eq * k * k;
-	double v = sqrt(Vq);
-	double Ng = abes * abes / (bbes * v);
-	double nk =(abes - bbes) / (abes + bbes);
-	double X = ((Ng * t * k * k * l * l) / 2) + 
-		((Ng * t * (9 * Vq - t * t - 4) * k * k * k * k * l * l * l * l) / 24);
-	double gg = b + (((-3.0 * nk / 2.0) + (9.0 * nk * nk * nk / 16.0)) *
-		sin(2 * b) + 15 * nk * nk * sin(4 * b) / 16 - 35 * nk * nk * nk * sin(6 * b) / 48);
+	double Vq = 1.0 + eqbes * k * k;
+	double Ng = gk_ng / sqrt(Vq);
+	double k2 = k * k, l2 = l * l, t2 = t * t;
+	double X = ((Ng * t * k2 * l2) / 2) + 
+		((Ng * t * (9 * Vq - t2 - 4) * k2 * k2 * l2 * l2) / 24);
+	double gg = b + gk_c2 * sin(2 * b) + gk_c4 * sin(4 * b) + 
+		gk_c6 * sin(6 * b);
 	double SS = gg * 180.0 * cbes / Pi;
-	double Ho = (SS + X);
-	double Y = Ng * k * l + Ng * (Vq - t * t) * k * k * k * l * l * l / 6 + Ng *
-		(5 - 18 * t * t + t * t * t * t) * k * k * k * k * k * l * l * l * l * l / 120;
-	double kk = 500000;
-	double RVV = MDC;
-	double Re = RVV * 1000000.0 + kk + Y;
-	result.x = Re;
-	result.y = Ho;
+	double Y = Ng * k * l + Ng * (Vq - t2) * k2 * k * l2 * l / 6 + Ng *
+		(5 - 18 * t2 + t2 * t2) * k2 * k2 * k * l2 * l2 * l / 120;
+	result.x = gk_false_easting + Y;
+	result.y = SS + X;
 	return result;
 }
 
@@ -111,49 +136,33 @@ BLRauenberg (double x, double y, double z)
 	return result;
 }
 
-/* Get Datum from 2D point */
-
-static Datum
-point2d_get_datum(POINT2D point2D)
-{
-	LWPOINT *p = lwpoint_make2d(4326, point2D.x, point2D.y);
-	GSERIALIZED *result = geometry_serialize((LWGEOM *)p);
-
-	return PointerGetDatum(result);
-}
-
-static Datum
-gk(Datum inst)
+/*
+ * Project in place an array of 2D points given in WGS84 longitude/latitude
+ * into Gauss Krueger coordinates.
+ * This is the kernel used by all the functions below. It works on raw 
+ * coordinates so that the callers do not need to create a serialized 
+ * geometry per point. The points are projected independently of each other,
+ * but the latitude of the Rauenberg method is computed by an iteration whose
+ * number of steps depends on the point, so the loop is not vectorized.
+ */
+static void
+gk_point2d_array(POINT2D *points, int count)
 {
-	eqwgs = (awgs * awgs - bwgs * bwgs) / (awgs * awgs);
-	eqbes = (abes * abes - bbes * bbes) / (abes * abes);
-	POINT2D point2D = datum_get_point2d(inst);
-	POINT2D result;
-	double x = point2D.x;
-	double y = point2D.y;
-	double a = (x / 180) * Pi;
-	double b = (y / 180) * Pi;
-	double l1 = a;
-	double b1 = b;
-
-	a = awgs;
-
-	double eq = eqwgs;
-	double N = a / sqrt(1 - eq * sin(b1) * sin(b1));
-	double Xq = (N + h1) * cos(b1) * cos(l1);
-	double Yq = (N + h1) * cos(b1) * sin(l1);
-	double Zq = ((1 - eq) * N + h1) * sin(b1);
-
-	POINT3D p = HelmertTransformation(Xq, Yq, Zq);
-	double X = p.x;
-	double Y = p.y;
-	double Z = p.z;
-
-	p = BLRauenberg(X, Y, Z);
-	double b2 = p.x;
-	double l2 = p.y;
-	result = BesselBLToGaussKrueger(b2, l2);
-	return point2d_get_datum(result);
+	gk_init();
+	for (int i = 0; i < count; i++)
+	{
+		double l1 = (points[i].x / 180) * Pi;
+		double b1 = (points[i].y / 180) * Pi;
+		double sinb1 = sin(b1), cosb1 = cos(b1);
+		double N = awgs / sqrt(1 - eqwgs * sinb1 * sinb1);
+		double Xq = (N + h1) * cosb1 * cos(l1);
+		double Yq = (N + h1) * cosb1 * sin(l1);
+		double Zq = ((1 - eqwgs) * N + h1) * sinb1;
+		POINT3D p = HelmertTransformation(Xq, Yq, Zq);
+		p = BLRauenberg(p.x, p.y, p.z);
+		points[i] = BesselBLToGaussKrueger(p.x, p.y);
+	}
+	return;
 }
 
 /* Transform geometry to Gauss Kruger Projection */
@@ -171,8 +180,7 @@ geometry_transform_gk_internal(GSERIALIZED *gs)
 		else
 		{
 			POINT2D point2D	= gs_get_point2d(gs);
-			Datum geom = gk(point2d_get_datum(point2D));
-			point2D	= datum_get_point2d(geom);
+			gk_point2d_array(&point2D, 1);
 			lwpoint = lwpoint_make2d(4326, point2D.x, point2D.y);
 		}
 		result = geometry_serialize((LWGEOM *)lwpoint);
@@ -185,28 +193,27 @@ geometry_transform_gk_internal(GSERIALIZED *gs)
 		{
 			line = lwline_construct_empty(0, false, false);
 			result = geometry_serialize(lwline_as_lwgeom(line));
+			lwline_free(line);
 		}
 		else
 		{
-			LWPOINT *lwpoint = NULL;
+			/* Project the whole point array of the line in a single call */
 			LWGEOM *lwgeom = lwgeom_from_gserialized(gs);
-			line = lwgeom_as_lwline(lwgeom);
-			uint32_t numPoints = line->points->npoints;
-			LWPOINT **points = palloc(sizeof(LWPOINT *) * numPoints);
+			POINTARRAY *pa = lwgeom_as_lwline(lwgeom)->points;
+			uint32_t numPoints = pa->npoints;
+			POINT2D *points = palloc(sizeof(POINT2D) * numPoints);
+			for (uint32_t i = 0; i < numPoints; i++)
+				getPoint2d_p(pa, i, &points[i]);
+			gk_point2d_array(points, (int) numPoints);
+			POINTARRAY *newpa = ptarray_construct(false, false, numPoints);
 			for (uint32_t i = 0; i < numPoints; i++)
 			{
-				lwpoint = lwline_get_lwpoint((LWLINE*)lwgeom, i);
-				Datum point2d_datum = PointerGetDatum(gserialized_from_lwgeom(lwpoint_as_lwgeom(lwpoint), 0));
-				Datum geom = gk(point2d_datum);
-				POINT2D point2D	= datum_get_point2d(geom);
-				points[i] = lwpoint_make2d(4326, point2D.x, point2D.y);
+				POINT4D pt = { points[i].x, points[i].y, 0.0, 0.0 };
+				ptarray_set_point4d(newpa, i, &pt);
 			}
-
-			line = lwline_from_ptarray(4326, numPoints, points);
+			line = lwline_construct(4326, NULL, newpa);
 			result = geometry_serialize(lwline_as_lwgeom(line));
-			lwline_free(line);lwpoint_free(lwpoint);lwgeom_free(lwgeom);
-			for( uint32_t i = 0; i < numPoints; i++)
-				lwpoint_free(points[i]);
+			lwline_free(line); lwgeom_free(lwgeom);
 			pfree(points);
 		}
 	}
@@ -217,13 +224,56 @@ geometry_transform_gk_internal(GSERIALIZED *gs)
 	return result;
 }
 
+/*
+ * Project an array of temporal instants.
+ * The coordinates of all instants are projected in a single call to the 
+ * kernel. Since all resulting points are 2D with the same SRID, all 
+ * resulting instants have the same size, and they are written in a single
+ * buffer by patching the timestamp and the coordinates of a template
+ * instant. The pointers in the returned array point into this buffer, 
+ * which is pointed to by the first element, and thus the caller frees the
+ * result with pfree(result[0]) followed by pfree(result).
+ */
+static TemporalInst **
+tgeompointinstarr_transform_gk(TemporalInst **instants, int count)
+{
+	POINT2D *points = palloc(sizeof(POINT2D) * count);
+	for (int i = 0; i < count; i++)
+		points[i] = datum_get_point2d(temporalinst_value(instants[i]));
+	gk_point2d_array(points, count);
+
+	/* Build the template instant from the first projected point */
+	LWPOINT *lwpoint = lwpoint_make2d(4326, points[0].x, points[0].y);
+	GSERIALIZED *gs = geometry_serialize((LWGEOM *) lwpoint);
+	TemporalInst *inst = temporalinst_make(PointerGetDatum(gs), 
+		instants[0]->t, type_oid(T_GEOMETRY));
+	lwpoint_free(lwpoint); pfree(gs);
+
+	size_t instsize = double_pad(VARSIZE(inst));
+	char *buffer = palloc(instsize * count);
+	TemporalInst **result = palloc(sizeof(TemporalInst *) * count);
+	for (int i = 0; i < count; i++)
+	{
+		result[i] = (TemporalInst *) (buffer + instsize * i);
+		memcpy(result[i], inst, VARSIZE(inst));
+		result[i]->t = instants[i]->t;
+		gs = (GSERIALIZED *) DatumGetPointer(temporalinst_value(result[i]));
+		*((POINT2D *) gs_point_ptr(gs)) = points[i];
+	}
+	pfree(inst); pfree(points);
+	return result;
+}
+
 static TemporalInst *
 tgeompointinst_transform_gk(TemporalInst *inst)
 {
-	Datum geom = gk(temporalinst_value(inst));
-	TemporalInst *result = temporalinst_make(geom, inst->t,
+	POINT2D point = datum_get_point2d(temporalinst_value(inst));
+	gk_point2d_array(&point, 1);
+	LWPOINT *lwpoint = lwpoint_make2d(4326, point.x, point.y);
+	GSERIALIZED *gs = geometry_serialize((LWGEOM *) lwpoint);
+	TemporalInst *result = temporalinst_make(PointerGetDatum(gs), inst->t,
 		type_oid(T_GEOMETRY));
-	pfree(DatumGetPointer(geom));
+	lwpoint_free(lwpoint); pfree(gs);
 	return result;
 }
 
@@ -232,16 +282,13 @@ tgeompointi_transform_gk_internal(TemporalI *ti)
 {
 	TemporalInst **instants = palloc(sizeof(TemporalInst *) * ti->count);
 	for (int i = 0; i < ti->count; i++)
-	{
-		TemporalInst *inst = temporali_inst_n(ti, i);
-		instants[i] = tgeompointinst_transform_gk(inst);
-	}
-	TemporalI *result = temporali_from_temporalinstarr(instants, ti->count);
+		instants[i] = temporali_inst_n(ti, i);
+	TemporalInst **newinstants = tgeompointinstarr_transform_gk(instants, 
+		ti->count);
+	TemporalI *result = temporali_from_temporalinstarr(newinstants, ti->count);
 
-	for (int i = 0; i < ti->count; i++)
-		pfree(instants[i]);
+	pfree(newinstants[0]); pfree(newinstants);
 	pfree(instants);
-
 	return result;
 }
 
@@ -250,18 +297,15 @@ tgeompointseq_transform_gk_internal(TemporalSeq *seq)
 {
 	TemporalInst **instants = palloc(sizeof(TemporalInst *) * seq->count);
 	for (int i = 0; i < seq->count; i++)
-	{
-		TemporalInst *inst = temporalseq_inst_n(seq, i);
-		instants[i] = tgeompointinst_transform_gk(inst);
-	}
-	TemporalSeq *result = temporalseq_from_temporalinstarr(instants,
+		instants[i] = temporalseq_inst_n(seq, i);
+	TemporalInst **newinstants = tgeompointinstarr_transform_gk(instants, 
+		seq->count);
+	TemporalSeq *result = temporalseq_from_temporalinstarr(newinstants,
 		seq->count, seq->period.lower_inc, seq->period.upper_inc, 
 		MOBDB_FLAGS_GET_LINEAR(seq->flags), true);
 
-	for (int i = 0; i < seq->count; i++)
-		pfree(instants[i]);
+	pfree(newinstants[0]); pfree(newinstants);
 	pfree(instants);
-
 	return result;
 }
 
@@ -270,21 +314,7 @@ tgeompoints_transform_gk_internal(TemporalS *ts)
 {
 	TemporalSeq **sequences = palloc(sizeof(TemporalSeq *) * ts->count);
 	for (int i = 0; i < ts->count; i++)
-	{
-		TemporalSeq *seq = temporals_seq_n(ts, i);
-		TemporalInst **instants = palloc(sizeof(TemporalInst *) * seq->count);
-		for (int j = 0; j < seq->count; j++)
-		{
-			TemporalInst *inst = temporalseq_inst_n(seq, j);
-			instants[j] = tgeompointinst_transform_gk(inst);
-		}
-		sequences[i] = temporalseq_from_temporalinstarr(instants,
-			seq->count, seq->period.lower_inc, seq->period.upper_inc, 
-			MOBDB_FLAGS_GET_LINEAR(seq->flags), true);
-		for (int j = 0; j < seq->count; j++)
-			pfree(instants[j]);
-		pfree(instants);
-	}
+		sequences[i] = tgeompointseq_transform_gk_internal(temporals_seq_n(ts, i));
 	TemporalS *result = temporals_from_temporalseqarr(sequences,
 		ts->count, MOBDB_FLAGS_GET_LINEAR(ts->flags), false);
 
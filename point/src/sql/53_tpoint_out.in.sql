@@ -10,7 +10,7 @@
  *
  *****************************************************************************/
 
-CREATE FUNCTION asText(tgeompoint)
+CREATE FUNCTION asText(tgeompoint, maxdecimaldigits int4 DEFAULT 15)
 	RETURNS text
 	AS 'MODULE_PATHNAME', 'tpoint_as_text'
 	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
@@ -19,7 +19,7 @@ CREATE FUNCTION asText(tgeompoint[])
 	AS 'MODULE_PATHNAME', 'tpointarr_as_text'
 	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
-CREATE FUNCTION asText(tgeogpoint)
+CREATE FUNCTION asText(tgeogpoint, maxdecimaldigits int4 DEFAULT 15)
 	RETURNS text
 	AS 'MODULE_PATHNAME', 'tpoint_as_text'
 	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
@@ -37,7 +37,7 @@ CREATE FUNCTION asText(geography[])
 	AS 'MODULE_PATHNAME', 'geoarr_as_text'
 	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;	
 
-CREATE FUNCTION asEWKT(tgeompoint)
+CREATE FUNCTION asEWKT(tgeompoint, maxdecimaldigits int4 DEFAULT 15)
 	RETURNS text
 	AS 'MODULE_PATHNAME', 'tpoint_as_ewkt'
 	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
@@ -46,7 +46,7 @@ CREATE FUNCTION asEWKT(tgeompoint[])
 	AS 'MODULE_PATHNAME', 'tpointarr_as_ewkt'
 	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
-CREATE FUNCTION asEWKT(tgeogpoint)
+CREATE FUNCTION asEWKT(tgeogpoint, maxdecimaldigits int4 DEFAULT 15)
 	RETURNS text
 	AS 'MODULE_PATHNAME', 'tpoint_as_ewkt'
 	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
@@ -73,6 +73,16 @@ CREATE FUNCTION asMFJSON(point tgeogpoint, maxdecimaldigits int4 DEFAULT 15, opt
 	AS 'MODULE_PATHNAME', 'tpoint_as_mfjson'
 	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
+-- The rows returned concatenated in order form the FeatureCollection
+CREATE FUNCTION asMFJSONFeatureCollection(points tgeompoint[], maxdecimaldigits int4 DEFAULT 15, options int4 DEFAULT 0)
+	RETURNS SETOF text
+	AS 'MODULE_PATHNAME', 'tpointarr_as_mfjson_collection'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION asMFJSONFeatureCollection(points tgeogpoint[], maxdecimaldigits int4 DEFAULT 15, options int4 DEFAULT 0)
+	RETURNS SETOF text
+	AS 'MODULE_PATHNAME', 'tpointarr_as_mfjson_collection'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
 CREATE FUNCTION asBinary(tgeompoint, endianenconding text DEFAULT 'NDR')
 	RETURNS bytea
 	AS 'MODULE_PATHNAME', 'tpoint_as_binary'
@@ -231,6 +231,21 @@ CREATE FUNCTION tdwithin(tgeogpoint, tgeogpoint, dist float8)
 	AS 'MODULE_PATHNAME', 'tdwithin_tpoint_tpoint'
 	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
+/*****************************************************************************
+ * tdwithinPairs: proximity join between two arrays of temporal points
+ *****************************************************************************/
+
+CREATE FUNCTION tdwithinPairs(tgeompoint[], tgeompoint[], dist float8,
+	OUT idx1 integer, OUT idx2 integer, OUT times periodset)
+	RETURNS SETOF record
+	AS 'MODULE_PATHNAME', 'tdwithin_tpointarr_tpointarr_pairs'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tdwithinPairs(tgeogpoint[], tgeogpoint[], dist float8,
+	OUT idx1 integer, OUT idx2 integer, OUT times periodset)
+	RETURNS SETOF record
+	AS 'MODULE_PATHNAME', 'tdwithin_tpointarr_tpointarr_pairs'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
 /*****************************************************************************
  * trelate (2 arguments)
  *****************************************************************************/
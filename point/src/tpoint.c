@@ -566,7 +566,7 @@ teq_geo_tpoint(PG_FUNCTION_ARGS)
 	ensure_same_dimensionality_tpoint_gs(temp, gs);
 	Oid datumtypid = get_fn_expr_argtype(fcinfo->flinfo, 0);
 	Temporal *result = tcomp_temporal_base(temp, PointerGetDatum(gs), datumtypid,
-		&datum2_eq2, true);
+		&datum2_eq2, LIFT_EQ, true);
 	PG_FREE_IF_COPY(gs, 0);
 	PG_FREE_IF_COPY(temp, 1);
 	PG_RETURN_POINTER(result);
@@ -584,7 +584,7 @@ teq_tpoint_geo(PG_FUNCTION_ARGS)
 	ensure_same_dimensionality_tpoint_gs(temp, gs);
 	Oid datumtypid = get_fn_expr_argtype(fcinfo->flinfo, 1);
 	Temporal *result = tcomp_temporal_base(temp, PointerGetDatum(gs), datumtypid,
-		&datum2_eq2, false);
+		&datum2_eq2, LIFT_EQ, false);
 	PG_FREE_IF_COPY(temp, 0);
 	PG_FREE_IF_COPY(gs, 1);
 	PG_RETURN_POINTER(result);
@@ -627,7 +627,7 @@ tne_geo_tpoint(PG_FUNCTION_ARGS)
 	ensure_same_dimensionality_tpoint_gs(temp, gs);
 	Oid datumtypid = get_fn_expr_argtype(fcinfo->flinfo, 0);
 	Temporal *result = tcomp_temporal_base(temp, PointerGetDatum(gs), datumtypid,
-		&datum2_ne2, true);
+		&datum2_ne2, LIFT_NE, true);
 	PG_FREE_IF_COPY(gs, 0);
 	PG_FREE_IF_COPY(temp, 1);
 	PG_RETURN_POINTER(result);
@@ -645,7 +645,7 @@ tne_tpoint_geo(PG_FUNCTION_ARGS)
 	ensure_same_dimensionality_tpoint_gs(temp, gs);
 	Oid datumtypid = get_fn_expr_argtype(fcinfo->flinfo, 1);
 	Temporal *result = tcomp_temporal_base(temp, PointerGetDatum(gs), datumtypid,
-		&datum2_ne2, false);
+		&datum2_ne2, LIFT_NE, false);
 	PG_FREE_IF_COPY(temp, 0);
 	PG_FREE_IF_COPY(gs, 1);
 	PG_RETURN_POINTER(result);
@@ -21,6 +21,16 @@
  * 		- stanumbers stores the ND histrogram of occurrence of features.
  * For the time dimension, the statistics collected in Slots 3 and 4 depend on 
  * the duration. Please refer to file temporal_analyze.c for more information.
+ * Since the spatial and the time dimensions are usually correlated, a joint
+ * histogram of both dimensions is also collected.
+ * - Slot 5
+ * 		- stakind contains the type of statistics which is 
+ * 		  STATISTIC_KIND_XYT_HISTOGRAM.
+ * 		- stanumbers stores the (X, Y, T) or (X, Y, Z, T) histogram of 
+ * 		  occurrence of features, where the time dimension is expressed in
+ * 		  seconds since the minimum timestamp of the sample. Seconds since
+ * 		  2000-01-01 would lose minutes in the float4 of the histogram.
+ * 		- stavalues stores this minimum timestamp.
  * 
  * Portions Copyright (c) 2020, Esteban Zimanyi, Mahmoud Sakr, Mohamed Bakli,
  *		Universite Libre de Bruxelles
@@ -518,10 +528,10 @@ nd_box_array_distribution(const ND_BOX **nd_boxes, int num_boxes, const ND_BOX *
  * can then use the histogram
  */
 
-void
-gserialized_compute_stats(VacAttrStats *stats, int sample_rows, int total_rows,
+static ND_STATS *
+nd_stats_compute(VacAttrStats *stats, int sample_rows, int total_rows,
 	double notnull_cnt, const ND_BOX **sample_boxes, ND_BOX *sum, 
-	ND_BOX *sample_extent, int *slot_idx, int ndims)
+	ND_BOX *sample_extent, int ndims, size_t *size)
 {
 	MemoryContext old_context;
 	int d, i;						/* Counters */
@@ -547,9 +557,6 @@ gserialized_compute_stats(VacAttrStats *stats, int sample_rows, int total_rows,
 	double sample_distribution[ND_DIMS]; /* How homogeneous is distribution of sample in each axis? */
 	double total_distribution;		/* Total of sample_distribution */
 
-	int stats_slot;					/* What slot is this data going into? (2D vs ND) */
-	int stats_kind;					/* And this is what? (2D vs ND) */
-
 	/* Initialize boxes */
 	nd_box_init(&avg);
 	nd_box_init(&stddev);
@@ -572,8 +579,7 @@ gserialized_compute_stats(VacAttrStats *stats, int sample_rows, int total_rows,
 	if (! notnull_cnt)
 	{
 		elog(NOTICE, "no non-null/empty features, unable to compute statistics");
-		stats->stats_valid = false;
-		return;
+		return NULL;
 	}
 
 	/*
@@ -590,6 +596,8 @@ gserialized_compute_stats(VacAttrStats *stats, int sample_rows, int total_rows,
 		for (i = 0; i < notnull_cnt; i++)
 		{
 			const ND_BOX *ndb = sample_boxes[i];
+			/* Skip the hard deviants of a previous histogram */
+			if (! ndb) continue;
 			stddev.min[d] += (ndb->min[d] - avg.min[d]) * (ndb->min[d] - avg.min[d]);
 			stddev.max[d] += (ndb->max[d] - avg.max[d]) * (ndb->max[d] - avg.max[d]);
 		}
@@ -610,6 +618,7 @@ gserialized_compute_stats(VacAttrStats *stats, int sample_rows, int total_rows,
 	for (i = 0; i < notnull_cnt; i++)
 	{
 		const ND_BOX *ndb = sample_boxes[i];
+		if (! ndb) continue;
 		/* Skip any hard deviants (boxes entirely outside our histo_extent */
 		if (! nd_box_intersects(&histo_extent, ndb, ndims))
 		{
@@ -812,14 +821,39 @@ gserialized_compute_stats(VacAttrStats *stats, int sample_rows, int total_rows,
 	if (! histogram_features)
 	{
 		elog(NOTICE, " no features lie in the stats histogram, invalid stats");
-		stats->stats_valid = false;
-		return;
+		return NULL;
 	}
 
 	nd_stats->histogram_features = histogram_features;
 	nd_stats->histogram_cells = histo_cells;
 	nd_stats->cells_covered = (float4) total_cell_count;
 
+	*size = nd_stats_size;
+	return nd_stats;
+}
+
+/**
+ * Compute the 2D or the ND histogram of the sample and put it into the 
+ * corresponding slot.
+ */
+void
+gserialized_compute_stats(VacAttrStats *stats, int sample_rows, int total_rows,
+	double notnull_cnt, const ND_BOX **sample_boxes, ND_BOX *sum, 
+	ND_BOX *sample_extent, int *slot_idx, int ndims)
+{
+	ND_STATS *nd_stats;				/* Our histogram */
+	size_t	nd_stats_size;		   /* Size to allocate */
+	int stats_slot;					/* What slot is this data going into? (2D vs ND) */
+	int stats_kind;					/* And this is what? (2D vs ND) */
+
+	nd_stats = nd_stats_compute(stats, sample_rows, total_rows, notnull_cnt,
+		sample_boxes, sum, sample_extent, ndims, &nd_stats_size);
+	if (! nd_stats)
+	{
+		stats->stats_valid = false;
+		return;
+	}
+
 	/* Put this histogram data into the right slot/kind */
 	if (ndims == 2)
 	{
@@ -841,6 +875,47 @@ gserialized_compute_stats(VacAttrStats *stats, int sample_rows, int total_rows,
 	(*slot_idx)++;
 }
 
+/**
+ * Compute the joint histogram of the spatial and time dimensions of the 
+ * sample and put it into the next free slot. The time dimension of the 
+ * boxes is expressed in seconds since the minimum timestamp of the sample,
+ * which is stored as the only value of the slot. Contrary to the spatial 
+ * histograms, failing to compute it does not invalidate the other statistics.
+ */
+static void
+tpoint_compute_xyt_stats(VacAttrStats *stats, int sample_rows, int total_rows,
+	double notnull_cnt, const ND_BOX **sample_boxes, ND_BOX *sum, 
+	ND_BOX *sample_extent, TimestampTz tmin, int *slot_idx, int ndims)
+{
+	MemoryContext old_context;
+	ND_STATS *nd_stats;
+	size_t	nd_stats_size;
+
+	if (*slot_idx >= STATISTIC_NUM_SLOTS)
+		return;
+
+	nd_stats = nd_stats_compute(stats, sample_rows, total_rows, notnull_cnt,
+		sample_boxes, sum, sample_extent, ndims, &nd_stats_size);
+	if (! nd_stats)
+		return;
+
+	stats->stakind[*slot_idx] = STATISTIC_KIND_XYT_HISTOGRAM;
+	stats->staop[*slot_idx] = InvalidOid;
+	stats->stanumbers[*slot_idx] = (float4*) nd_stats;
+	stats->numnumbers[*slot_idx] = (int) (nd_stats_size/sizeof(float4));
+	/* Must copy the target values into anl_context */
+	old_context = MemoryContextSwitchTo(stats->anl_context);
+	stats->stavalues[*slot_idx] = palloc(sizeof(Datum));
+	MemoryContextSwitchTo(old_context);
+	stats->stavalues[*slot_idx][0] = TimestampTzGetDatum(tmin);
+	stats->numvalues[*slot_idx] = 1;
+	stats->statypid[*slot_idx] = TIMESTAMPTZOID;
+	stats->statyplen[*slot_idx] = sizeof(TimestampTz);
+	stats->statypbyval[*slot_idx] = FLOAT8PASSBYVAL;
+	stats->statypalign[*slot_idx] = 'd';
+	(*slot_idx)++;
+}
+
 static void
 tpoint_compute_stats(VacAttrStats *stats, AnalyzeAttrFetchFunc fetchfunc,
 	int sample_rows, double total_rows)
@@ -854,12 +929,17 @@ tpoint_compute_stats(VacAttrStats *stats, AnalyzeAttrFetchFunc fetchfunc,
 	const ND_BOX **sample_boxes;	/* ND_BOXes for each of the sample features */
 	ND_BOX sample_extent;			/* Extent of the raw sample */
 	int   ndims = 2;				/* Dimensionality of the sample */
+	ND_BOX sum_xyt;					/* Same as above for the (X, Y, [Z,] T) boxes */
+	ND_BOX **sample_xyt_boxes;
+	ND_BOX sample_xyt_extent;
+	TimestampTz tmin = 0;			/* Origin of the time dimension of these boxes */
 	float8 *time_lengths;
 	PeriodBound *time_lowers,
 		   *time_uppers;
 
 	/* Initialize sum */
 	nd_box_init(&sum);
+	nd_box_init(&sum_xyt);
 
 	/*
 	 * This is where gserialized_analyze_nd
@@ -872,6 +952,7 @@ tpoint_compute_stats(VacAttrStats *stats, AnalyzeAttrFetchFunc fetchfunc,
 	 * its worth saving...
 	 */
 	sample_boxes = palloc(sizeof(ND_BOX *) * sample_rows);
+	sample_xyt_boxes = palloc(sizeof(ND_BOX *) * sample_rows);
 
 	time_lowers = (PeriodBound *) palloc(sizeof(PeriodBound) * sample_rows);
 	time_uppers = (PeriodBound *) palloc(sizeof(PeriodBound) * sample_rows);
@@ -959,6 +1040,13 @@ tpoint_compute_stats(VacAttrStats *stats, AnalyzeAttrFetchFunc fetchfunc,
 		/* Cache n-d bounding box */
 		sample_boxes[notnull_cnt] = nd_box;
 
+		/* The time dimension of the joint box is set once the minimum 
+		 * timestamp of the sample is known */
+		sample_xyt_boxes[notnull_cnt] = palloc(sizeof(ND_BOX));
+		memcpy(sample_xyt_boxes[notnull_cnt], nd_box, sizeof(ND_BOX));
+		if (! notnull_cnt || timestamp_cmp_internal(period_lower.val, tmin) < 0)
+			tmin = period_lower.val;
+
 		/* Initialize sample extent before merging first entry */
 		if (! notnull_cnt)
 			nd_box_init_bounds(&sample_extent, ndims);
@@ -996,6 +1084,22 @@ tpoint_compute_stats(VacAttrStats *stats, AnalyzeAttrFetchFunc fetchfunc,
 		/* Estimate that non-null values are unique */
 		stats->stadistinct = (float4) (-1.0 * (1.0 - stats->stanullfrac));
 
+		/* Set the time dimension of the joint boxes as seconds since tmin 
+		 * before the time bounds are sorted for the period histograms */
+		nd_box_init_bounds(&sample_xyt_extent, ndims + 1);
+		for (i = 0; i < notnull_cnt; i++)
+		{
+			ND_BOX *nd_xyt_box = sample_xyt_boxes[i];
+			nd_xyt_box->min[ndims] = (float4) period_to_secs(time_lowers[i].val, tmin);
+			nd_xyt_box->max[ndims] = (float4) period_to_secs(time_uppers[i].val, tmin);
+			nd_box_merge(nd_xyt_box, &sample_xyt_extent, ndims + 1);
+			for (d = 0; d <= ndims; d++)
+			{
+				sum_xyt.min[d] += nd_xyt_box->min[d];
+				sum_xyt.max[d] += nd_xyt_box->max[d];
+			}
+		}
+
 		/* Compute statistics for spatial dimension */
 		/* 2D Mode */
 		gserialized_compute_stats(stats, sample_rows, (int) total_rows, notnull_cnt,
@@ -1007,6 +1111,12 @@ tpoint_compute_stats(VacAttrStats *stats, AnalyzeAttrFetchFunc fetchfunc,
 		/* Compute statistics for time dimension */
 		period_compute_stats1(stats, notnull_cnt, &slot_idx,
 			time_lowers, time_uppers, time_lengths);
+
+		/* Compute statistics for the spatial and time dimensions */
+		if (stats->stats_valid)
+			tpoint_compute_xyt_stats(stats, sample_rows, (int) total_rows,
+				notnull_cnt, (const ND_BOX **) sample_xyt_boxes, &sum_xyt, 
+				&sample_xyt_extent, tmin, &slot_idx, ndims + 1);
 	}
 	else if (null_cnt > 0)
 	{
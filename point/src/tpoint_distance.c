@@ -12,6 +12,8 @@
 
 #include "tpoint_distance.h"
 
+#include <utils/timestamp.h>
+
 #include "temporaltypes.h"
 #include "oidcache.h"
 #include "temporal_util.h"
@@ -164,72 +166,99 @@ distance_tpoints_geo(TemporalS *ts, Datum point,
 }
 
 /* 
- * Find the single timestamptz at which two temporal point segments are at the
- * minimum distance. This function is used for computing temporal distance.
- * The function assumes that the two segments are not both constants.
+ * Find the fraction of the segments at which two temporal point segments,
+ * given by the coordinates of their start and end points, are at the minimum
+ * distance. Returns false if the segments are parallel or if the minimum is
+ * reached at a bound.
  */
 bool
-tpointseq_min_dist_at_timestamp(TemporalInst *start1, TemporalInst *end1, 
-	TemporalInst *start2, TemporalInst *end2, TimestampTz *t)
+tgeompoint_min_dist_fraction(const POINT3DZ *p1, const POINT3DZ *p2,
+	const POINT3DZ *p3, const POINT3DZ *p4, bool hasz, double *fraction)
 {
-	double denum, fraction;
-	if (MOBDB_FLAGS_GET_Z(start1->flags)) /* 3D */
+	double denum;
+	if (hasz) /* 3D */
 	{
-		POINT3DZ p1 = datum_get_point3dz(temporalinst_value(start1));
-		POINT3DZ p2 = datum_get_point3dz(temporalinst_value(end1));
-		POINT3DZ p3 = datum_get_point3dz(temporalinst_value(start2));
-		POINT3DZ p4 = datum_get_point3dz(temporalinst_value(end2));
 		/* The following basically computes d/dx (Euclidean distance) = 0.
 		   To reduce problems related to floating point arithmetic, t1 and t2
 		   are shifted, respectively, to 0 and 1 before computing d/dx */
-		double dx1 = p2.x - p1.x;
-		double dy1 = p2.y - p1.y;
-		double dz1 = p2.z - p1.z;
-		double dx2 = p4.x - p3.x;
-		double dy2 = p4.y - p3.y;
-		double dz2 = p4.z - p3.z;
+		double dx1 = p2->x - p1->x;
+		double dy1 = p2->y - p1->y;
+		double dz1 = p2->z - p1->z;
+		double dx2 = p4->x - p3->x;
+		double dy2 = p4->y - p3->y;
+		double dz2 = p4->z - p3->z;
 		
-		double f1 = p3.x * (dx1 - dx2);
-		double f2 = p1.x * (dx2 - dx1);
-		double f3 = p3.y * (dy1 - dy2);
-		double f4 = p1.y * (dy2 - dy1);
-		double f5 = p3.z * (dz1 - dz2);
-		double f6 = p1.z * (dz2 - dz1);
+		double f1 = p3->x * (dx1 - dx2);
+		double f2 = p1->x * (dx2 - dx1);
+		double f3 = p3->y * (dy1 - dy2);
+		double f4 = p1->y * (dy2 - dy1);
+		double f5 = p3->z * (dz1 - dz2);
+		double f6 = p1->z * (dz2 - dz1);
 
 		denum = dx1*(dx1-2*dx2) + dy1*(dy1-2*dy2) + dz1*(dz1-2*dz2) + 
 			dx2*dx2 + dy2*dy2 + dz2*dz2;
 		if (denum == 0)
 			return false;
 
-		fraction = (f1 + f2 + f3 + f4 + f5 + f6) / denum;
+		*fraction = (f1 + f2 + f3 + f4 + f5 + f6) / denum;
 	}
 	else /* 2D */
 	{
-		POINT2D p1 = datum_get_point2d(temporalinst_value(start1));
-		POINT2D p2 = datum_get_point2d(temporalinst_value(end1));
-		POINT2D p3 = datum_get_point2d(temporalinst_value(start2));
-		POINT2D p4 = datum_get_point2d(temporalinst_value(end2));
 		/* The following basically computes d/dx (Euclidean distance) = 0.
 		   To reduce problems related to floating point arithmetic, t1 and t2
 		   are shifted, respectively, to 0 and 1 before computing d/dx */
-		double dx1 = p2.x - p1.x;
-		double dy1 = p2.y - p1.y;
-		double dx2 = p4.x - p3.x;
-		double dy2 = p4.y - p3.y;
+		double dx1 = p2->x - p1->x;
+		double dy1 = p2->y - p1->y;
+		double dx2 = p4->x - p3->x;
+		double dy2 = p4->y - p3->y;
 		
-		double f1 = p3.x * (dx1 - dx2);
-		double f2 = p1.x * (dx2 - dx1);
-		double f3 = p3.y * (dy1 - dy2);
-		double f4 = p1.y * (dy2 - dy1);
+		double f1 = p3->x * (dx1 - dx2);
+		double f2 = p1->x * (dx2 - dx1);
+		double f3 = p3->y * (dy1 - dy2);
+		double f4 = p1->y * (dy2 - dy1);
 
 		denum = dx1*(dx1-2*dx2) + dy1*(dy1-2*dy2) + dy2*dy2 + dx2*dx2;
 		/* If the segments are parallel */
 		if (denum == 0)
 			return false;
 
-		fraction = (f1 + f2 + f3 + f4) / denum;
+		*fraction = (f1 + f2 + f3 + f4) / denum;
+	}
+	if (*fraction <= EPSILON || *fraction >= (1.0 - EPSILON))
+		return false;
+	return true;
+}
+
+/* 
+ * Find the single timestamptz at which two temporal point segments are at the
+ * minimum distance. This function is used for computing temporal distance.
+ * The function assumes that the two segments are not both constants.
+ */
+bool
+tpointseq_min_dist_at_timestamp(TemporalInst *start1, TemporalInst *end1, 
+	TemporalInst *start2, TemporalInst *end2, TimestampTz *t)
+{
+	POINT3DZ p1, p2, p3, p4;
+	bool hasz = MOBDB_FLAGS_GET_Z(start1->flags);
+	if (hasz)
+	{
+		p1 = datum_get_point3dz(temporalinst_value(start1));
+		p2 = datum_get_point3dz(temporalinst_value(end1));
+		p3 = datum_get_point3dz(temporalinst_value(start2));
+		p4 = datum_get_point3dz(temporalinst_value(end2));
+	}
+	else
+	{
+		POINT2D q1 = datum_get_point2d(temporalinst_value(start1));
+		POINT2D q2 = datum_get_point2d(temporalinst_value(end1));
+		POINT2D q3 = datum_get_point2d(temporalinst_value(start2));
+		POINT2D q4 = datum_get_point2d(temporalinst_value(end2));
+		p1.x = q1.x; p1.y = q1.y; p2.x = q2.x; p2.y = q2.y;
+		p3.x = q3.x; p3.y = q3.y; p4.x = q4.x; p4.y = q4.y;
+		p1.z = p2.z = p3.z = p4.z = 0.0;
 	}
-	if (fraction <= EPSILON || fraction >= (1.0 - EPSILON))
+	double fraction;
+	if (! tgeompoint_min_dist_fraction(&p1, &p2, &p3, &p4, hasz, &fraction))
 		return false;
 	*t = start1->t + (long) ((double)(end1->t - start1->t) * fraction);
 	return true;
@@ -340,9 +369,131 @@ distance_tpoint_geo(PG_FUNCTION_ARGS)
 
 /*****************************************************************************/
 
+/*
+ * Temporal distance between two temporal geometry point sequences. The
+ * sequences are walked in lockstep with the TPointSeqSync cursor, which
+ * gives the same result as sync_tfunc2_temporalseq_temporalseq with the
+ * function tpointseq_min_dist_at_timestamp for the turning points without
+ * synchronizing the sequences and without constructing a GSERIALIZED for
+ * each synchronization point.
+ */
+static TemporalSeq *
+distance_tgeompointseq_tgeompointseq(TemporalSeq *seq1, TemporalSeq *seq2,
+	bool linear)
+{
+	TPointSeqSync sync;
+	if (! tpointseq_sync_init(&sync, seq1, seq2))
+		return NULL;
+
+	/* Each synchronization point may be preceded by a turning point */
+	int maxcount = (seq1->count + seq2->count) * 2;
+	Datum *values = palloc(sizeof(Datum) * maxcount);
+	TimestampTz *times = palloc(sizeof(TimestampTz) * maxcount);
+	int k = 0;
+	values[k] = Float8GetDatum(point3dz_distance(&sync.p1, &sync.p2, 
+		sync.hasz));
+	times[k++] = sync.t;
+	POINT3DZ prev1 = sync.p1, prev2 = sync.p2;
+	TimestampTz lower = sync.t;
+	while (tpointseq_sync_next(&sync))
+	{
+		double fraction;
+		if (linear && tgeompoint_min_dist_fraction(&prev1, &sync.p1, &prev2,
+			&sync.p2, sync.hasz, &fraction))
+		{
+			TimestampTz t = lower + (long) ((double)(sync.t - lower) * fraction);
+			double ratio = (double) (t - lower) / (double) (sync.t - lower);
+			POINT3DZ inter1 = prev1, inter2 = prev2;
+			if (sync.linear1)
+				point3dz_interpolate(&prev1, &sync.p1, ratio, &inter1);
+			if (sync.linear2)
+				point3dz_interpolate(&prev2, &sync.p2, ratio, &inter2);
+			values[k] = Float8GetDatum(point3dz_distance(&inter1, &inter2,
+				sync.hasz));
+			times[k++] = t;
+		}
+		values[k] = Float8GetDatum(point3dz_distance(&sync.p1, &sync.p2,
+			sync.hasz));
+		times[k++] = sync.t;
+		prev1 = sync.p1;
+		prev2 = sync.p2;
+		lower = sync.t;
+	}
+	/* The cursor ensures that the last two values of sequences with stepwise
+	   interpolation and exclusive upper bound are equal */
+	TemporalInst **instants = temporalinstarr_make_byval(values, times, k,
+		FLOAT8OID);
+	TemporalSeq *result = temporalseq_from_temporalinstarr(instants, k,
+		sync.inter.lower_inc, sync.inter.upper_inc, linear, true);
+	pfree(instants[0]); pfree(instants);
+	pfree(values); pfree(times);
+	return result;
+}
+
+/*
+ * Temporal distance between two temporal geometry points of sequence or
+ * sequence set duration. Returns NULL if they do not intersect in time.
+ */
+static Temporal *
+distance_tgeompoint_tgeompoint_stream(Temporal *temp1, Temporal *temp2,
+	bool linear)
+{
+	if (temp1->duration == TEMPORALSEQ && temp2->duration == TEMPORALSEQ)
+		return (Temporal *)distance_tgeompointseq_tgeompointseq(
+			(TemporalSeq *)temp1, (TemporalSeq *)temp2, linear);
+
+	int count1, count2;
+	TemporalSeq **sequences1 = tpoint_sequences(temp1, &count1);
+	TemporalSeq **sequences2 = tpoint_sequences(temp2, &count2);
+	TemporalSeq **sequences = palloc(sizeof(TemporalSeq *) * 
+		(count1 + count2));
+	int i = 0, j = 0, k = 0;
+	while (i < count1 && j < count2)
+	{
+		TemporalSeq *seq1 = sequences1[i];
+		TemporalSeq *seq2 = sequences2[j];
+		TemporalSeq *seq = distance_tgeompointseq_tgeompointseq(seq1, seq2, 
+			linear);
+		if (seq != NULL)
+			sequences[k++] = seq;
+		int cmp = timestamp_cmp_internal(seq1->period.upper, seq2->period.upper);
+		if (cmp == 0)
+		{
+			if (! seq1->period.upper_inc && seq2->period.upper_inc)
+				cmp = -1;
+			else if (seq1->period.upper_inc && ! seq2->period.upper_inc)
+				cmp = 1;
+		}
+		if (cmp == 0)
+		{
+			i++; j++;
+		}
+		else if (cmp < 0)
+			i++;
+		else
+			j++;
+	}
+	TemporalS *result = NULL;
+	if (k > 0)
+		result = temporals_from_temporalseqarr(sequences, k, linear, false);
+	for (i = 0; i < k; i++)
+		pfree(sequences[i]);
+	pfree(sequences); pfree(sequences1); pfree(sequences2);
+	return (Temporal *)result;
+}
+
 Temporal *
 distance_tpoint_tpoint_internal(Temporal *temp1, Temporal *temp2)
 {
+	bool linear = MOBDB_FLAGS_GET_LINEAR(temp1->flags) || 
+		MOBDB_FLAGS_GET_LINEAR(temp2->flags);
+	/* Temporal geometry points of sequence (set) duration are processed
+	   without synchronizing them first */
+	if (temp1->valuetypid == type_oid(T_GEOMETRY) &&
+		(temp1->duration == TEMPORALSEQ || temp1->duration == TEMPORALS) &&
+		(temp2->duration == TEMPORALSEQ || temp2->duration == TEMPORALS))
+		return distance_tgeompoint_tgeompoint_stream(temp1, temp2, linear);
+
 	Datum (*func)(Datum, Datum);
 	if (temp1->valuetypid == type_oid(T_GEOMETRY))
 	{
@@ -353,8 +504,6 @@ distance_tpoint_tpoint_internal(Temporal *temp1, Temporal *temp2)
 	}
 	else
 		func = &geog_distance;
-	bool linear = MOBDB_FLAGS_GET_LINEAR(temp1->flags) || 
-		MOBDB_FLAGS_GET_LINEAR(temp2->flags);
 	Temporal *result = linear ?
 		sync_tfunc2_temporal_temporal(temp1, temp2, func, 
 			FLOAT8OID, linear, &tpointseq_min_dist_at_timestamp) :
@@ -13,362 +13,577 @@
 #include "tpoint_in.h"
 
 #include <float.h>
-#include <json-c/json.h>
+#include <utils/builtins.h>
 
 #include "temporaltypes.h"
 #include "oidcache.h"
 #include "temporal_util.h"
+#include "temporal_parser.h"
 #include "postgis.h"
 #include "tpoint.h"
 #include "tpoint_spatialfuncs.h"
 
 /*****************************************************************************
- * Input in MFJSON format 
+ * Construction of temporal point instants in a single allocation
  *****************************************************************************/
 
 /* 
- * We don't include <utils/builtins.h> to avoid collisions with json-c/json.h 
- *
- * This function is taken from PostGIS file lwgeom_in_geojson.c
+ * Allocate an array of count temporal geometric point instants in a single
+ * block of memory. Since all points have the same dimensions, all instants
+ * have the same size, which is the one of the instant constructed for the 
+ * origin point that is copied in every slot. The readers below fill the
+ * coordinates and the timestamp of every instant in place, which avoids 
+ * constructing a GSERIALIZED and a TemporalInst for every point. The block
+ * is freed with pfree(instants[0]) before freeing the array.
  */
-static char*
-text2cstring(const text *textptr)
+static TemporalInst **
+tpointinstarr_alloc(int count, bool hasz, int srid)
 {
-	size_t size = VARSIZE_ANY_EXHDR(textptr);
-	char *str = palloc(size + 1);
-	memcpy(str, VARDATA(textptr), size);
-	str[size]='\0';
-	return str;
+	LWPOINT *lwpoint = hasz ? lwpoint_make3dz(srid, 0, 0, 0) :
+		lwpoint_make2d(srid, 0, 0);
+	GSERIALIZED *gs = geometry_serialize((LWGEOM *) lwpoint);
+	TemporalInst *inst = temporalinst_make(PointerGetDatum(gs), 0, 
+		type_oid(T_GEOMETRY));
+	size_t size = VARSIZE(inst);
+	char *block = palloc(size * count);
+	TemporalInst **result = palloc(sizeof(TemporalInst *) * count);
+	for (int i = 0; i < count; i++)
+	{
+		memcpy(block + size * i, inst, size);
+		result[i] = (TemporalInst *) (block + size * i);
+	}
+	pfree(inst);
+	pfree(gs);
+	lwpoint_free(lwpoint);
+	return result;
 }
 
-/* Function taken from PostGIS file lwin_geojson.c */
+/* Pointer to the coordinates of the point of a temporal point instant */
+static inline double *
+tpointinst_coords_ptr(TemporalInst *inst)
+{
+	GSERIALIZED *gs = (GSERIALIZED *) DatumGetPointer(temporalinst_value(inst));
+	return (double *) gs_point_ptr(gs);
+}
 
-static json_object *
-findMemberByName(json_object *poObj, const char *pszName )
+static void
+tpointinstarr_free(TemporalInst **instants)
 {
-	json_object *poTmp = poObj;
-	json_object_iter it;
+	pfree(instants[0]);
+	pfree(instants);
+}
 
-	if (pszName == NULL || poObj == NULL)
-		return NULL;
+/*****************************************************************************
+ * Input in MFJSON format 
+ *****************************************************************************/
+
+/*
+ * The MF-JSON document is read by a tokenizer in a single pass, without 
+ * building a tree of JSON objects. The coordinates and the timestamps of all
+ * points are collected in two buffers of the parse state, which are enlarged
+ * with repalloc when needed, and each component of the temporal point keeps 
+ * the range of its values in these buffers. Since the members of a JSON 
+ * object may come in any order, the temporal point is constructed once the
+ * whole document has been read, when its SRID is known. Members that are not
+ * needed, e.g., "stBoundedBy", are skipped.
+ */
 
-	it.key = NULL;
-	it.val = NULL;
-	it.entry = NULL;
+/**
+* Used for passing the parse state between the parsing functions.
+*/
+typedef struct
+{
+	char *pos;				/* Current parse position */
+	double *coords;			/* Coordinates of the points, three per point */
+	TimestampTz *times;		/* Timestamps of the points */
+	int npoints;			/* Number of points read */
+	int ntimes;				/* Number of timestamps read */
+	int maxpoints;			/* Size of the coordinate buffer in points */
+	int maxtimes;			/* Size of the timestamp buffer */
+	int ndims;				/* Dimensions of the points, 0 until known */
+} mfjson_parse_state;
 
-	if (json_object_get_object(poTmp) != NULL)
+/**
+* Members of a moving point or of one of its sequences.
+*/
+typedef struct
+{
+	int firstpoint;			/* Position of the first point in the buffer */
+	int npoints;			/* Number of points, -1 if no 'coordinates' */
+	int firsttime;			/* Position of the first timestamp in the buffer */
+	int ntimes;				/* Number of timestamps, -1 if no 'datetimes' */
+	bool points_array;		/* Are the coordinates an array of points? */
+	bool times_array;		/* Are the datetimes an array? */
+	int8 lower_inc;			/* Lower bound, -1 if no 'lower_inc' */
+	int8 upper_inc;			/* Upper bound, -1 if no 'upper_inc' */
+} mfjson_component;
+
+static void
+mfjson_component_init(mfjson_component *comp)
+{
+	comp->firstpoint = comp->firsttime = 0;
+	comp->npoints = comp->ntimes = -1;
+	comp->points_array = comp->times_array = false;
+	comp->lower_inc = comp->upper_inc = -1;
+}
+
+static void
+mfjson_error(void)
+{
+	ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
+		errmsg("Invalid MFJSON string")));
+}
+
+/* Read a string and return a pointer to its content in the document, which
+ * is not null-terminated. Escaped characters are kept as they are */
+static char *
+mfjson_string(mfjson_parse_state *s, int *len)
+{
+	p_whitespace(&s->pos);
+	if (*s->pos != '"')
+		mfjson_error();
+	char *result = ++s->pos;
+	while (*s->pos != '"')
 	{
-		if (json_object_get_object(poTmp)->head == NULL)
+		if (*s->pos == '\0')
+			mfjson_error();
+		if (*s->pos == '\\' && s->pos[1] != '\0')
+			s->pos++;
+		s->pos++;
+	}
+	*len = s->pos - result;
+	s->pos++;
+	return result;
+}
+
+/* Read the key of a member up to and including the colon that follows it */
+static char *
+mfjson_key(mfjson_parse_state *s, int *len)
+{
+	char *result = mfjson_string(s, len);
+	p_whitespace(&s->pos);
+	if (*s->pos != ':')
+		mfjson_error();
+	s->pos++;
+	return result;
+}
+
+/* Keys are compared ignoring case as done by PostGIS */
+static inline bool
+mfjson_key_is(const char *key, int len, const char *name)
+{
+	return (size_t) len == strlen(name) && strncasecmp(key, name, len) == 0;
+}
+
+/* Skip a value of any type */
+static void
+mfjson_skip_value(mfjson_parse_state *s)
+{
+	int depth = 0, len;
+	do
+	{
+		p_whitespace(&s->pos);
+		char c = *s->pos;
+		if (c == '"')
+			mfjson_string(s, &len);
+		else if (c == '{' || c == '[')
 		{
-			ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
-				errmsg("Invalid MFJSON string")));
-			return NULL;
+			depth++;
+			s->pos++;
 		}
-		for (it.entry = json_object_get_object(poTmp)->head;
-				( it.entry ?
-				  ( it.key = (char*)it.entry->k,
-					it.val = (json_object*)it.entry->v, it.entry) : 0);
-				it.entry = it.entry->next)
+		else if (depth > 0 && (c == '}' || c == ']'))
 		{
-			if (strcasecmp(it.key, pszName) == 0)
-				return it.val;
+			depth--;
+			s->pos++;
 		}
+		else if (depth > 0 && (c == ',' || c == ':'))
+			s->pos++;
+		else if (c != '\0' && c != ',' && c != ':' && c != '}' && c != ']')
+		{
+			/* Number, true, false, or null */
+			while (*s->pos != '\0' && *s->pos != ',' && *s->pos != '}' && 
+				*s->pos != ']' && *s->pos != ' ' && *s->pos != '\t' &&
+				*s->pos != '\n' && *s->pos != '\r')
+				s->pos++;
+		}
+		else
+			mfjson_error();
+	} while (depth > 0);
+}
+
+static bool
+mfjson_bool(mfjson_parse_state *s)
+{
+	p_whitespace(&s->pos);
+	if (strncmp(s->pos, "true", 4) == 0)
+	{
+		s->pos += 4;
+		return true;
+	}
+	if (strncmp(s->pos, "false", 5) == 0)
+	{
+		s->pos += 5;
+		return false;
 	}
-	return NULL;
+	mfjson_error();
+	return false; /* make compiler quiet */
 }
 
-static Datum
-parse_mfjson_coord(json_object *poObj)
+/* Read a point given as an array of two or three numbers into the 
+ * coordinate buffer */
+static void
+mfjson_point(mfjson_parse_state *s)
 {
-	if (json_type_array != json_object_get_type(poObj))
+	if (! p_obracket(&s->pos))
 		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
 			errmsg("Invalid coordinate array in MFJSON string")));
-
-	const int numcoord = json_object_array_length(poObj);
-	if (numcoord < 2)
+	if (s->npoints == s->maxpoints)
+	{
+		s->maxpoints *= 2;
+		s->coords = repalloc(s->coords, sizeof(double) * 3 * s->maxpoints);
+	}
+	double *coords = s->coords + 3 * s->npoints;
+	int ncoords = 0;
+	do
+	{
+		if (ncoords == 3)
+			ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
+				errmsg("Too many coordinates in MFJSON string")));
+		if (! p_double(&s->pos, &coords[ncoords]))
+			ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
+				errmsg("Invalid coordinate array in MFJSON string")));
+		ncoords++;
+	} while (p_comma(&s->pos));
+	if (! p_cbracket(&s->pos))
+		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
+			errmsg("Invalid coordinate array in MFJSON string")));
+	if (ncoords < 2)
 		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
 			errmsg("Too few coordinates in MFJSON string")));
-	else if (numcoord > 3)
+	if (s->ndims == 0)
+		s->ndims = ncoords;
+	else if (s->ndims != ncoords)
 		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
-			errmsg("Too many coordinates in MFJSON string")));
-
-	double x, y, z;
-	Datum result;
-	json_object *poObjCoord = NULL;
-
-	/* Read X coordinate */
-	poObjCoord = json_object_array_get_idx(poObj, 0);
-	x = json_object_get_double(poObjCoord);
-
-	/* Read Y coordinate */
-	poObjCoord = json_object_array_get_idx(poObj, 1);
-	y = json_object_get_double(poObjCoord);
-
-	if (numcoord == 3)
-	{
-		/* Read Z coordinate */
-		poObjCoord = json_object_array_get_idx(poObj, 2);
-		z = json_object_get_double(poObjCoord);
-		result = call_function3(LWGEOM_makepoint, Float8GetDatum(x),
-			Float8GetDatum(y), Float8GetDatum(z));
-	}
-	else 
-		result = call_function2(LWGEOM_makepoint, Float8GetDatum(x),
-			Float8GetDatum(y));
-	return result;
+			errmsg("Mixed 2D and 3D coordinates in MFJSON string")));
+	s->npoints++;
 }
 
-/* TODO MAKE POSSIBLE TO CALL THIS FUNCTION */
-static Datum *
-parse_mfjson_points(json_object *mfjson, int *count)
+/* Read the value of 'coordinates', which is either a single point or an 
+ * array of points */
+static void
+mfjson_coordinates(mfjson_parse_state *s, mfjson_component *comp)
 {
-	json_object *mfjsonTmp = mfjson;
-	json_object *coordinates = NULL;
-	coordinates = findMemberByName(mfjsonTmp, "coordinates");
-	if (coordinates == NULL)
-		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
-			errmsg("Unable to find 'coordinates' in MFJSON string")));
-	if (json_object_get_type(coordinates) != json_type_array)
+	p_whitespace(&s->pos);
+	char *start = s->pos;
+	if (! p_obracket(&s->pos))
 		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
 			errmsg("Invalid 'coordinates' array in MFJSON string")));
-
-	int numpoints = json_object_array_length(coordinates);
-	if (numpoints < 1)
+	comp->firstpoint = s->npoints;
+	p_whitespace(&s->pos);
+	if (*s->pos == ']')
 		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
 			errmsg("Invalid value of 'coordinates' array in MFJSON string")));
-	
-	Datum *values = palloc(sizeof(Datum) * numpoints);
-	for (int i = 0; i < numpoints; ++i)
+	if (*s->pos != '[')
 	{
-		json_object *coords = NULL;
-		coords = json_object_array_get_idx(coordinates, i);
-		values[i] = parse_mfjson_coord(coords);
+		/* A single point */
+		s->pos = start;
+		mfjson_point(s);
+		comp->points_array = false;
 	}
-	*count = numpoints;
-	return values;
+	else
+	{
+		do
+			mfjson_point(s);
+		while (p_comma(&s->pos));
+		if (! p_cbracket(&s->pos))
+			ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
+				errmsg("Invalid 'coordinates' array in MFJSON string")));
+		comp->points_array = true;
+	}
+	comp->npoints = s->npoints - comp->firstpoint;
 }
-/* */
 
-static TimestampTz *
-parse_mfjson_datetimes(json_object *mfjson, int *count)
+/* Read a timestamp in ISO 8601 format into the timestamp buffer. The string 
+ * is parsed in place in the document */
+static void
+mfjson_datetime(mfjson_parse_state *s)
 {
-	json_object *datetimes = NULL;
-	datetimes = findMemberByName(mfjson, "datetimes");
-	if (datetimes == NULL)
-			ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
-				errmsg("Unable to find 'datetimes' in MFJSON string")));
-	if (json_object_get_type(datetimes) != json_type_array)
+	int len;
+	char *str = mfjson_string(s, &len);
+	char bak = str[len];
+	str[len] = '\0';
+	char *pos = str;
+	TimestampTz t = timestamp_parse(&pos);
+	p_whitespace(&pos);
+	bool end = (*pos == '\0');
+	str[len] = bak;
+	if (! end)
 		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
-			errmsg("Invalid 'datetimes' array in MFJSON string")));
+			errmsg("Invalid 'datetimes' value in MFJSON string")));
+	if (s->ntimes == s->maxtimes)
+	{
+		s->maxtimes *= 2;
+		s->times = repalloc(s->times, sizeof(TimestampTz) * s->maxtimes);
+	}
+	s->times[s->ntimes++] = t;
+}
 
-	int numdates = json_object_array_length(datetimes);
-	if (numdates < 1)
-		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
-			errmsg("Invalid value of 'datetimes' array in MFJSON string")));
-	
-	TimestampTz *times = palloc(sizeof(TimestampTz) * numdates);
-	for (int i = 0; i < numdates; i++)
+/* Read the value of 'datetimes', which is either a single timestamp or an 
+ * array of timestamps */
+static void
+mfjson_datetimes(mfjson_parse_state *s, mfjson_component *comp)
+{
+	comp->firsttime = s->ntimes;
+	p_whitespace(&s->pos);
+	if (*s->pos == '"')
 	{
-		char datetime[33];
-		json_object* datevalue = NULL;
-		datevalue = json_object_array_get_idx(datetimes, i);
-		const char *strdatevalue = json_object_get_string(datevalue);
-		if (strdatevalue)
-		{
-			strcpy(datetime, strdatevalue);
-			/* Replace 'T' by ' ' before converting to timestamptz */
-			datetime[10] = ' ';
-			times[i] = call_input(TIMESTAMPTZOID, datetime);
-		}
+		mfjson_datetime(s);
+		comp->times_array = false;
 	}
-	*count = numdates;
-	return times;
+	else if (p_obracket(&s->pos))
+	{
+		p_whitespace(&s->pos);
+		if (*s->pos == ']')
+			ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
+				errmsg("Invalid value of 'datetimes' array in MFJSON string")));
+		do
+			mfjson_datetime(s);
+		while (p_comma(&s->pos));
+		if (! p_cbracket(&s->pos))
+			ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
+				errmsg("Invalid 'datetimes' array in MFJSON string")));
+		comp->times_array = true;
+	}
+	else
+		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
+			errmsg("Invalid 'datetimes' value in MFJSON string")));
+	comp->ntimes = s->ntimes - comp->firsttime;
 }
 
-/*****************************************************************************/
+/* Read the value of a member of a moving point or of a sequence if the key 
+ * is one of those of a component. Returns false otherwise */
+static bool
+mfjson_component_member(mfjson_parse_state *s, mfjson_component *comp,
+	const char *key, int len)
+{
+	if (mfjson_key_is(key, len, "coordinates"))
+		mfjson_coordinates(s, comp);
+	else if (mfjson_key_is(key, len, "datetimes"))
+		mfjson_datetimes(s, comp);
+	else if (mfjson_key_is(key, len, "lower_inc"))
+		comp->lower_inc = mfjson_bool(s);
+	else if (mfjson_key_is(key, len, "upper_inc"))
+		comp->upper_inc = mfjson_bool(s);
+	else
+		return false;
+	return true;
+}
 
-static TemporalInst *
-tpointinst_from_mfjson(json_object *mfjson)
+static void
+mfjson_sequence(mfjson_parse_state *s, mfjson_component *comp)
 {
-	/* Get coordinates */
-	json_object *coordinates = findMemberByName(mfjson, "coordinates");
-	if (coordinates == NULL)
+	mfjson_component_init(comp);
+	if (! p_obrace(&s->pos))
+		mfjson_error();
+	if (p_cbrace(&s->pos))
+		return;
+	do
+	{
+		int len;
+		char *key = mfjson_key(s, &len);
+		if (! mfjson_component_member(s, comp, key, len))
+			mfjson_skip_value(s);
+	} while (p_comma(&s->pos));
+	if (! p_cbrace(&s->pos))
+		mfjson_error();
+}
+
+static mfjson_component *
+mfjson_sequences(mfjson_parse_state *s, int *count)
+{
+	if (! p_obracket(&s->pos))
 		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
-			errmsg("Unable to find 'coordinates' in MFJSON string")));
-	Datum value = parse_mfjson_coord(coordinates);
-
-	/* Get datetimes 
-	 * The maximum length of a datetime is 32 characters, e.g.,
-	 *  "2019-08-06T18:35:48.021455+02:30" 
-	 */
-	char str[33];
-	json_object *datetimes = findMemberByName(mfjson, "datetimes");
-	if (datetimes == NULL)
+			errmsg("Invalid 'sequences' array in MFJSON string")));
+	if (p_cbracket(&s->pos))
 		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
-			errmsg("Unable to find 'datetimes' in MFJSON string")));
-	const char *strdatetimes = json_object_get_string(datetimes);
-	if (!strdatetimes)
+			errmsg("Invalid value of 'sequences' array in MFJSON string")));
+	int n = 0, maxcount = 16;
+	mfjson_component *result = palloc(sizeof(mfjson_component) * maxcount);
+	do
+	{
+		if (n == maxcount)
+		{
+			maxcount *= 2;
+			result = repalloc(result, sizeof(mfjson_component) * maxcount);
+		}
+		mfjson_sequence(s, &result[n++]);
+	} while (p_comma(&s->pos));
+	if (! p_cbracket(&s->pos))
 		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
-			errmsg("Invalid 'datetimes' value in MFJSON string")));
-	strcpy(str, strdatetimes);
-	/* Replace 'T' by ' ' before converting to timestamptz */
-	str[10] = ' ';
-	TimestampTz t = call_input(TIMESTAMPTZOID, str);
-	TemporalInst *result = temporalinst_make(value, t, type_oid(T_GEOMETRY));
-	pfree(DatumGetPointer(value));
+			errmsg("Invalid 'sequences' array in MFJSON string")));
+	*count = n;
 	return result;
 }
 
-static TemporalI *
-tpointi_from_mfjson(json_object *mfjson)
+/* Read the value of 'crs' and return the value of its member 'name' in 
+ * 'properties', or NULL if there is none */
+static char *
+mfjson_crs(mfjson_parse_state *s)
 {
-	Datum *values;
+	char *result = NULL;
+	int len;
+	if (! p_obrace(&s->pos))
+		mfjson_error();
+	if (p_cbrace(&s->pos))
+		return NULL;
+	do
+	{
+		char *key = mfjson_key(s, &len);
+		if (! mfjson_key_is(key, len, "properties"))
+		{
+			mfjson_skip_value(s);
+			continue;
+		}
+		if (! p_obrace(&s->pos))
+			mfjson_error();
+		if (p_cbrace(&s->pos))
+			continue;
+		do
+		{
+			key = mfjson_key(s, &len);
+			p_whitespace(&s->pos);
+			if (mfjson_key_is(key, len, "name") && *s->pos == '"')
+			{
+				char *name = mfjson_string(s, &len);
+				result = pnstrdup(name, len);
+			}
+			else
+				mfjson_skip_value(s);
+		} while (p_comma(&s->pos));
+		if (! p_cbrace(&s->pos))
+			mfjson_error();
+	} while (p_comma(&s->pos));
+	if (! p_cbrace(&s->pos))
+		mfjson_error();
+	return result;
+}
 
-	/* Get coordinates */
-	int numpoints;
-	values = parse_mfjson_points(mfjson, &numpoints);
+/* Read the value of 'interpolations', which must be an array with a single 
+ * string, and return whether the interpolation is discrete and linear */
+static void
+mfjson_interpolations(mfjson_parse_state *s, bool *discrete, bool *linear)
+{
+	int len;
+	if (! p_obracket(&s->pos))
+		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
+			errmsg("Invalid 'interpolations' value in MFJSON string")));
+	p_whitespace(&s->pos);
+	if (*s->pos != '"')
+		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
+			errmsg("Invalid 'interpolations' value in MFJSON string")));
+	char *interp = mfjson_string(s, &len);
+	if (! p_cbracket(&s->pos))
+		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
+			errmsg("Invalid 'interpolations' value in MFJSON string")));
+	*discrete = *linear = false;
+	if (len == 8 && strncmp(interp, "Discrete", 8) == 0)
+		*discrete = true;
+	else if (len == 6 && strncmp(interp, "Linear", 6) == 0)
+		*linear = true;
+	else if (len != 8 || strncmp(interp, "Stepwise", 8) != 0)
+		mfjson_error();
+}
 
-	/* Get datetimes */
-	int numdates;
-	TimestampTz *times = parse_mfjson_datetimes(mfjson, &numdates);
+/*****************************************************************************/
 
-	if (numpoints != numdates)
+/* Construct the instants of a component from the buffers of the parse state */
+static TemporalInst **
+tpointinstarr_from_mfjson(mfjson_parse_state *s, mfjson_component *comp,
+	int srid)
+{
+	if (comp->npoints < 0)
+		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
+			errmsg("Unable to find 'coordinates' in MFJSON string")));
+	if (comp->ntimes < 0)
+		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
+			errmsg("Unable to find 'datetimes' in MFJSON string")));
+	if (comp->npoints != comp->ntimes)
 		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
 			errmsg("Distinct number of elements in 'coordinates' and 'datetimes' arrays")));
 
-	/* Construct the temporal point */
-	TemporalInst **instants = palloc(sizeof(TemporalInst *) * numpoints);
-	for (int i = 0; i < numpoints; i++)
-		instants[i] = temporalinst_make(values[i], times[i], type_oid(T_GEOMETRY));
-	TemporalI *result = temporali_from_temporalinstarr(instants, numpoints);
-
-	for (int i = 0; i < numpoints; i++)
+	TemporalInst **result = tpointinstarr_alloc(comp->npoints, s->ndims == 3,
+		srid);
+	const double *coords = s->coords + 3 * comp->firstpoint;
+	const TimestampTz *times = s->times + comp->firsttime;
+	for (int i = 0; i < comp->npoints; i++)
 	{
-		pfree(instants[i]);
-		pfree(DatumGetPointer(values[i]));
+		memcpy(tpointinst_coords_ptr(result[i]), &coords[3 * i], 
+			sizeof(double) * s->ndims);
+		result[i]->t = times[i];
 	}
-	pfree(instants);
 	return result;
 }
 
-static TemporalSeq *
-tpointseq_from_mfjson(json_object *mfjson, bool linear)
+static TemporalInst *
+tpointinst_from_mfjson(mfjson_parse_state *s, mfjson_component *comp,
+	int srid)
 {
-	Datum *values;
-
-	/* Get coordinates */
-	int numpoints;
-	values = parse_mfjson_points(mfjson, &numpoints);
-
-	/* Get datetimes */
-	int numdates;
-	TimestampTz *times = parse_mfjson_datetimes(mfjson, &numdates);
+	if (comp->points_array)
+		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
+			errmsg("Invalid coordinate array in MFJSON string")));
+	/* The block of a single instant is the instant itself */
+	TemporalInst **instants = tpointinstarr_from_mfjson(s, comp, srid);
+	TemporalInst *result = instants[0];
+	pfree(instants);
+	return result;
+}
 
-	if (numpoints != numdates)
+static TemporalI *
+tpointi_from_mfjson(mfjson_parse_state *s, mfjson_component *comp, int srid)
+{
+	if (comp->npoints >= 0 && ! comp->points_array)
 		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
-			errmsg("Distinct number of elements in 'coordinates' and 'datetimes' arrays")));
+			errmsg("Invalid 'coordinates' array in MFJSON string")));
+	TemporalInst **instants = tpointinstarr_from_mfjson(s, comp, srid);
+	TemporalI *result = temporali_from_temporalinstarr(instants, 
+		comp->npoints);
+	tpointinstarr_free(instants);
+	return result;
+}
 
-	json_object *lowerinc = NULL;
-	lowerinc = findMemberByName(mfjson, "lower_inc");
-	if (lowerinc == NULL)
+static TemporalSeq *
+tpointseq_from_mfjson(mfjson_parse_state *s, mfjson_component *comp, 
+	bool linear, int srid)
+{
+	if (comp->npoints >= 0 && ! comp->points_array)
+		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
+			errmsg("Invalid 'coordinates' array in MFJSON string")));
+	if (comp->ntimes >= 0 && ! comp->times_array)
+		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
+			errmsg("Invalid 'datetimes' array in MFJSON string")));
+	TemporalInst **instants = tpointinstarr_from_mfjson(s, comp, srid);
+	if (comp->lower_inc < 0)
 		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
 			errmsg("Unable to find 'lower_inc' in MFJSON string")));
-	bool lower_inc = (bool) json_object_get_boolean(lowerinc);
-
-	json_object *upperinc = NULL;
-	upperinc = findMemberByName(mfjson, "upper_inc");
-	if (upperinc == NULL)
+	if (comp->upper_inc < 0)
 		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
 			errmsg("Unable to find 'upper_inc' in MFJSON string")));
-	bool upper_inc = (bool) json_object_get_boolean(upperinc);
-
-	/* Construct the temporal point */
-	TemporalInst **instants = palloc(sizeof(TemporalInst *) * numpoints);
-	for (int i = 0; i < numpoints; i++)
-		instants[i] = temporalinst_make(values[i], times[i], type_oid(T_GEOMETRY));
-	TemporalSeq *result = temporalseq_from_temporalinstarr(instants, numpoints, 
-		lower_inc, upper_inc, linear, true);
-
-	for (int i = 0; i < numpoints; i++)
-	{
-		pfree(instants[i]);
-		pfree(DatumGetPointer(values[i]));
-	}
-	pfree(instants);
-	pfree(values);
-	pfree(times);
+	TemporalSeq *result = temporalseq_from_temporalinstarr(instants, 
+		comp->npoints, comp->lower_inc, comp->upper_inc, linear, true);
+	tpointinstarr_free(instants);
 	return result;
 }
 
 static TemporalS *
-tpoints_from_mfjson(json_object *mfjson, bool linear)
+tpoints_from_mfjson(mfjson_parse_state *s, mfjson_component *comps, 
+	int count, bool linear, int srid)
 {
-	json_object *seqs = NULL;
-	seqs = findMemberByName(mfjson, "sequences");
-	if (seqs == NULL)
-		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
-			errmsg("Unable to find 'sequences' in MFJSON string")));
-	if (json_object_get_type(seqs) != json_type_array)
-		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
-			errmsg("Invalid 'sequences' array in MFJSON string")));
-	int numseqs = json_object_array_length(seqs);
-	if (numseqs < 1)
-		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
-			errmsg("Invalid value of 'sequences' array in MFJSON string")));
-
-	TemporalSeq **sequences = palloc(sizeof(TemporalSeq *) * numseqs);
-	for (int i = 0; i < numseqs; i++)
-	{
-		Datum *values;
-		TimestampTz *times;
-
-		json_object* seqvalue = NULL;
-		seqvalue = json_object_array_get_idx(seqs, i);
-
-		/* Get coordinates */
-		int numpoints;
-		values = parse_mfjson_points(seqvalue, &numpoints);
-		
-		/* Get datetimes */
-		int numdates;
-		times = parse_mfjson_datetimes(seqvalue, &numdates);
-
-		if (numpoints != numdates)
-			ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
-				errmsg("Distinct number of elements in 'coordinates' and 'datetimes'")));
-
-		json_object *lowerinc = NULL;
-		lowerinc = findMemberByName(seqvalue, "lower_inc");
-		if (lowerinc == NULL)
-			ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
-				errmsg("Unable to find 'lower_inc' in MFJSON string")));
-		bool lower_inc = (bool) json_object_get_boolean(lowerinc);
-
-		json_object *upperinc = NULL;
-		upperinc = findMemberByName(seqvalue, "upper_inc");
-		if (upperinc == NULL)
-			ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
-				errmsg("Unable to find 'upper_inc' in MFJSON string")));
-		bool upper_inc = (bool) json_object_get_boolean(upperinc);
-
-		/* Construct the temporal point */
-		TemporalInst **instants = palloc(sizeof(TemporalInst *) * numpoints);
-		for (int j = 0; j < numpoints; j++)
-			instants[j] = temporalinst_make(values[j], times[j], type_oid(T_GEOMETRY));
-		sequences[i] = temporalseq_from_temporalinstarr(instants, numpoints, 
-			lower_inc, upper_inc, linear, true);
-		for (int j = 0; j < numpoints; j++)
-		{
-			pfree(instants[j]);
-			pfree(DatumGetPointer(values[j]));
-		}
-		pfree(instants);
-		pfree(values);
-		pfree(times);
-	}
-	TemporalS *result = temporals_from_temporalseqarr(sequences, numseqs, 
+	TemporalSeq **sequences = palloc(sizeof(TemporalSeq *) * count);
+	for (int i = 0; i < count; i++)
+		sequences[i] = tpointseq_from_mfjson(s, &comps[i], linear, srid);
+	TemporalS *result = temporals_from_temporalseqarr(sequences, count, 
 		linear, true);
-	for (int i = 0; i < numseqs; i++)
+	for (int i = 0; i < count; i++)
 		pfree(sequences[i]);
 	pfree(sequences);
 	return result;
@@ -379,138 +594,99 @@ PG_FUNCTION_INFO_V1(tpoint_from_mfjson);
 PGDLLEXPORT Datum
 tpoint_from_mfjson(PG_FUNCTION_ARGS)
 {
-	Temporal *temp;
-	text *mfjson_input;
-	char *mfjson;
+	text *mfjson_input = PG_GETARG_TEXT_P(0);
+	char *mfjson = text_to_cstring(mfjson_input);
+
+	/* Initialize the state appropriately */
+	mfjson_parse_state s;
+	s.pos = mfjson;
+	s.npoints = s.ntimes = 0;
+	s.maxpoints = s.maxtimes = 64;
+	s.coords = palloc(sizeof(double) * 3 * s.maxpoints);
+	s.times = palloc(sizeof(TimestampTz) * s.maxtimes);
+	s.ndims = 0;
+
+	mfjson_component comp, *seqs = NULL;
+	mfjson_component_init(&comp);
+	int nseqs = 0;
+	bool hastype = false, hasinterp = false, discrete = false, linear = false;
 	char *srs = NULL;
 
-	/* Get the mfjson stream */
-	mfjson_input = PG_GETARG_TEXT_P(0);
-	mfjson = text2cstring(mfjson_input);
-
-	json_tokener *jstok = NULL;
-	json_object *poObj = NULL;
-	json_object *poObjType = NULL;
-	json_object *poObjInterp = NULL;
-	json_object *poObjInterp1 = NULL;
-	json_object *poObjDates = NULL;
-	json_object *poObjSrs = NULL;
-
-	/* Begin to parse json */
-	jstok = json_tokener_new();
-	poObj = json_tokener_parse_ex(jstok, mfjson, -1);
-	if (jstok->err != json_tokener_success)
+	/* Read the members of the moving point in a single pass */
+	if (! p_obrace(&s.pos))
+		mfjson_error();
+	if (! p_cbrace(&s.pos))
 	{
-		char err[256];
-		snprintf(err, 256, "%s (at offset %d)", json_tokener_error_desc(jstok->err), jstok->char_offset);
-		json_tokener_free(jstok);
-		json_object_put(poObj);
-		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
-			errmsg("Error while processing MFJSON string")));
+		do
+		{
+			int len;
+			char *key = mfjson_key(&s, &len);
+			if (mfjson_component_member(&s, &comp, key, len))
+				continue;
+			if (mfjson_key_is(key, len, "type"))
+			{
+				char *type = mfjson_string(&s, &len);
+				if (len != 11 || strncmp(type, "MovingPoint", 11) != 0)
+					ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
+						errmsg("Invalid 'type' value in MFJSON string")));
+				hastype = true;
+			}
+			else if (mfjson_key_is(key, len, "interpolations"))
+			{
+				mfjson_interpolations(&s, &discrete, &linear);
+				hasinterp = true;
+			}
+			else if (mfjson_key_is(key, len, "sequences"))
+				seqs = mfjson_sequences(&s, &nseqs);
+			else if (mfjson_key_is(key, len, "crs"))
+				srs = mfjson_crs(&s);
+			else
+				mfjson_skip_value(&s);
+		} while (p_comma(&s.pos));
+		if (! p_cbrace(&s.pos))
+			mfjson_error();
 	}
-	json_tokener_free(jstok);
-	
-	/*
-	 * Ensure that it is a moving point
-	 */
-	poObjType = findMemberByName(poObj, "type");
-	if (poObjType == NULL)
-		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
-			errmsg("Unable to find 'type' in MFJSON string")));
+	/* Ensure there is no more input */
+	p_whitespace(&s.pos);
+	if (*s.pos != '\0')
+		mfjson_error();
 
-	const char *pszType = json_object_get_string(poObjType);
-	if (strcmp(pszType, "MovingPoint") != 0)
+	if (! hastype)
 		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
-			errmsg("Invalid 'type' value in MFJSON string")));
-
-	/*
-	 * Determine duration of temporal point and dispatch to the 
-	 *  corresponding parse function 
-	 */
-	poObjInterp = findMemberByName(poObj, "interpolations");
-	if (poObjInterp == NULL)
+			errmsg("Unable to find 'type' in MFJSON string")));
+	if (! hasinterp)
 		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
 			errmsg("Unable to find 'interpolations' in MFJSON string")));
 
-	if (json_object_get_type(poObjInterp) != json_type_array)
-		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
-			errmsg("Invalid 'interpolations' value in MFJSON string")));
-
-	const int nSize = json_object_array_length(poObjInterp);
-	if (nSize != 1)
-		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
-			errmsg("Invalid 'interpolations' value in MFJSON string")));
-
-	/* Read interpolation value */
-	poObjInterp1 = json_object_array_get_idx(poObjInterp, 0);
-	const char *pszInterp = json_object_get_string(poObjInterp1);
-	if (pszInterp)
+	/* The SRID is known before constructing the temporal point */
+	int srid = SRID_UNKNOWN;
+	if (srs)
 	{
-		if (strcmp(pszInterp, "Discrete") == 0)
-		{
-			poObjDates = findMemberByName(poObj, "datetimes");
-			if (poObjDates != NULL &&
-				json_object_get_type(poObjDates) == json_type_array)
-				temp = (Temporal *)tpointi_from_mfjson(poObj);
-			else
-				temp = (Temporal *)tpointinst_from_mfjson(poObj);
-		}
-		else if (strcmp(pszInterp, "Stepwise") == 0)
-		{
-			json_object *poObjSeqs = findMemberByName(poObj, "sequences");
-			if (poObjSeqs != NULL)
-				temp = (Temporal *)tpoints_from_mfjson(poObj, false);
-			else
-				temp = (Temporal *)tpointseq_from_mfjson(poObj, false);
-		}
-		else if (strcmp(pszInterp, "Linear") == 0)
-		{
-			json_object *poObjSeqs = findMemberByName(poObj, "sequences");
-			if (poObjSeqs != NULL)
-				temp = (Temporal *)tpoints_from_mfjson(poObj, true);
-			else
-				temp = (Temporal *)tpointseq_from_mfjson(poObj, true);
-		}
-		else
-			ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
-				errmsg("Invalid MFJSON string")));
+		srid = getSRIDbySRS(srs);
+		pfree(srs);
 	}
 
-	/* Parse crs and set SRID of temporal point */
-	poObjSrs = findMemberByName(poObj, "crs");
-	if (poObjSrs != NULL)
-	{
-		json_object *poObjSrsType = findMemberByName(poObjSrs, "type");
-		if (poObjSrsType != NULL)
-		{
-			json_object *poObjSrsProps = findMemberByName(poObjSrs, "properties");
-			if (poObjSrsProps)
-			{
-				json_object *poNameURL = findMemberByName(poObjSrsProps, "name");
-				if (poNameURL)
-				{
-					const char *pszName = json_object_get_string(poNameURL);
-					if (pszName)
-					{
-						srs = palloc(strlen(pszName) + 1);
-						strcpy(srs, pszName);
-					}
-				}
-			}
-		}
-	}
+	/* Dispatch to the construction function depending on the duration */
 	Temporal *result;
-	if (srs)
+	if (discrete)
 	{
-		result = tpoint_set_srid_internal(temp, getSRIDbySRS(srs));
-		pfree(srs);
-		pfree(temp);
+		if (comp.times_array)
+			result = (Temporal *) tpointi_from_mfjson(&s, &comp, srid);
+		else
+			result = (Temporal *) tpointinst_from_mfjson(&s, &comp, srid);
 	}
+	else if (seqs != NULL)
+		result = (Temporal *) tpoints_from_mfjson(&s, seqs, nseqs, linear, 
+			srid);
 	else
-		result = temp;
-
-	if (result == NULL)
-		PG_RETURN_NULL();
+		result = (Temporal *) tpointseq_from_mfjson(&s, &comp, linear, srid);
+
+	pfree(s.coords);
+	pfree(s.times);
+	if (seqs != NULL)
+		pfree(seqs);
+	pfree(mfjson);
+	PG_FREE_IF_COPY(mfjson_input, 0);
 	PG_RETURN_POINTER(result);
 }
 
@@ -547,6 +723,20 @@ wkb_parse_state_check(wkb_parse_state *s, size_t next)
 		elog(ERROR, "WKB structure does not match expected size!");
 }
 
+/**
+* Reverse the order of the bytes of a value in place.
+*/
+static inline void
+wkb_swap_bytes(uint8_t *value, int size)
+{
+	for (int i = 0; i < size/2; i++)
+	{
+		uint8_t tmp = value[i];
+		value[i] = value[size - i - 1];
+		value[size - i - 1] = tmp;
+	}
+}
+
 /**
 * Byte
 * Read a byte and advance the parse state forward.
@@ -573,44 +763,11 @@ integer_from_wkb_state(wkb_parse_state *s)
 	memcpy(&i, s->pos, WKB_INT_SIZE);
 	/* Swap? Copy into a stack-allocated integer. */
 	if (s->swap_bytes)
-	{
-		uint8_t tmp;
-		for (int j = 0; j < WKB_INT_SIZE/2; j++)
-		{
-			tmp = ((uint8_t*)(&i))[j];
-			((uint8_t*)(&i))[j] = ((uint8_t*)(&i))[WKB_INT_SIZE - j - 1];
-			((uint8_t*)(&i))[WKB_INT_SIZE - j - 1] = tmp;
-		}
-	}
+		wkb_swap_bytes((uint8_t *) &i, WKB_INT_SIZE);
 	s->pos += WKB_INT_SIZE;
 	return i;
 }
 
-/**
-* Double
-* Read an 8-byte double and advance the parse state forward.
-*/
-static double
-double_from_wkb_state(wkb_parse_state *s)
-{
-	double d = 0;
-	wkb_parse_state_check(s, WKB_DOUBLE_SIZE);
-	memcpy(&d, s->pos, WKB_DOUBLE_SIZE);
-	/* Swap? Copy into a stack-allocated integer. */
-	if (s->swap_bytes)
-	{
-		uint8_t tmp;
-		for (int i = 0; i < WKB_DOUBLE_SIZE/2; i++)
-		{
-			tmp = ((uint8_t*)(&d))[i];
-			((uint8_t*)(&d))[i] = ((uint8_t*)(&d))[WKB_DOUBLE_SIZE - i - 1];
-			((uint8_t*)(&d))[WKB_DOUBLE_SIZE - i - 1] = tmp;
-		}
-	}
-	s->pos += WKB_DOUBLE_SIZE;
-	return d;
-}
-
 /**
 * Double
 * Read an 8-byte timestamp and advance the parse state forward.
@@ -623,15 +780,7 @@ timestamp_from_wkb_state(wkb_parse_state *s)
 	memcpy(&t, s->pos, WKB_TIMESTAMP_SIZE);
 	/* Swap? Copy into a stack-allocated integer. */
 	if (s->swap_bytes)
-	{
-		uint8_t tmp;
-		for (int i = 0; i < WKB_TIMESTAMP_SIZE/2; i++)
-		{
-			tmp = ((uint8_t*)(&t))[i];
-			((uint8_t*)(&t))[i] = ((uint8_t*)(&t))[WKB_TIMESTAMP_SIZE - i - 1];
-			((uint8_t*)(&t))[WKB_TIMESTAMP_SIZE - i - 1] = tmp;
-		}
-	}
+		wkb_swap_bytes((uint8_t *) &t, WKB_TIMESTAMP_SIZE);
 	s->pos += WKB_TIMESTAMP_SIZE;
 	return (TimestampTz) t;
 }
@@ -676,6 +825,55 @@ tpoint_type_from_wkb_state(wkb_parse_state *s, uint8_t wkb_type)
 	}
 }
 
+/**
+* Read the count instants that follow in the WKB, each one made of the
+* coordinates of a point and a timestamp, into instants allocated in a single
+* block. The coordinates are copied from the WKB directly into the points of
+* the instants. The caller ensures that the data exists.
+*/
+static TemporalInst **
+tpointinstarr_from_wkb_state(wkb_parse_state *s, int count)
+{
+	size_t coords_size = (s->has_z ? 3 : 2) * WKB_DOUBLE_SIZE;
+	TemporalInst **result = tpointinstarr_alloc(count, s->has_z, s->srid);
+	for (int i = 0; i < count; i++)
+	{
+		uint8_t *coords = (uint8_t *) tpointinst_coords_ptr(result[i]);
+		memcpy(coords, s->pos, coords_size);
+		s->pos += coords_size;
+		if (s->swap_bytes)
+		{
+			for (size_t j = 0; j < coords_size; j += WKB_DOUBLE_SIZE)
+				wkb_swap_bytes(coords + j, WKB_DOUBLE_SIZE);
+		}
+		result[i]->t = timestamp_from_wkb_state(s);
+	}
+	return result;
+}
+
+/**
+* Read the number of instants, which must be positive.
+*/
+static int
+tpoint_count_from_wkb_state(wkb_parse_state *s)
+{
+	int count = (int) integer_from_wkb_state(s);
+	if (count < 1)
+		elog(ERROR, "Invalid number of instants in WKB (%d)!", count);
+	return count;
+}
+
+/**
+* Check that the data of count instants exist.
+*/
+static void
+tpoint_check_instants_wkb_state(wkb_parse_state *s, int count)
+{
+	size_t size = (size_t) count * (((s->has_z ? 3 : 2) * WKB_DOUBLE_SIZE) + 
+		WKB_TIMESTAMP_SIZE);
+	wkb_parse_state_check(s, size);
+}
+
 /**
 * TemporalInst
 * Read a WKB Temporal, starting just after the endian byte,
@@ -687,87 +885,26 @@ tpoint_type_from_wkb_state(wkb_parse_state *s, uint8_t wkb_type)
 static TemporalInst * 
 tpointinst_from_wkb_state(wkb_parse_state *s)
 {
-	double x, y, z;
-	/* Count the dimensions. */
-	uint32_t ndims = (s->has_z) ? 3 : 2;
 	/* Does the data we want to read exist? */
-	size_t size = (ndims * WKB_DOUBLE_SIZE) + WKB_TIMESTAMP_SIZE;
-	wkb_parse_state_check(s, size);
-	/* Parse the coordinates and create the point */
-	Datum value = 0;
-	if (s->has_z)
-	{
-		x = double_from_wkb_state(s);
-		y = double_from_wkb_state(s);
-		z = double_from_wkb_state(s);
-		value = call_function3(LWGEOM_makepoint, Float8GetDatum(x),
-			Float8GetDatum(y), Float8GetDatum(z));
-
-	}
-	else 
-	{
-		x = double_from_wkb_state(s);
-		y = double_from_wkb_state(s);
-		value = call_function2(LWGEOM_makepoint, Float8GetDatum(x),
-			Float8GetDatum(y));
-	}
-	TimestampTz t = timestamp_from_wkb_state(s);
-	if (s->has_srid)
-	{
-		GSERIALIZED *gs = (GSERIALIZED *)DatumGetPointer(value);
-		gserialized_set_srid(gs, s->srid);
-	}
-	TemporalInst *result = temporalinst_make(value, t, type_oid(T_GEOMETRY));
-	pfree(DatumGetPointer(value));
+	tpoint_check_instants_wkb_state(s, 1);
+	/* The block of a single instant is the instant itself */
+	TemporalInst **instants = tpointinstarr_from_wkb_state(s, 1);
+	TemporalInst *result = instants[0];
+	pfree(instants);
 	return result;
 }
 
 static TemporalI * 
 tpointi_from_wkb_state(wkb_parse_state *s)
 {
-	/* Count the dimensions. */
-	uint32_t ndims = (s->has_z) ? 3 : 2;
 	/* Get the number of instants. */
-	int count = integer_from_wkb_state(s);
+	int count = tpoint_count_from_wkb_state(s);
 	/* Does the data we want to read exist? */
-	size_t size = count * ((ndims * WKB_DOUBLE_SIZE) + WKB_TIMESTAMP_SIZE);
-	wkb_parse_state_check(s, size);
+	tpoint_check_instants_wkb_state(s, count);
 	/* Parse the instants */
-	TemporalInst **instants = palloc(sizeof(TemporalInst *) * count);
-	for (int i = 0; i < count; i++)
-	{
-		double x, y, z;
-		/* Parse the coordinates and create the point */
-		Datum value = 0;
-		if (s->has_z)
-		{
-			x = double_from_wkb_state(s);
-			y = double_from_wkb_state(s);
-			z = double_from_wkb_state(s);
-			value = call_function3(LWGEOM_makepoint, Float8GetDatum(x),
-				Float8GetDatum(y), Float8GetDatum(z));
-
-		}
-		else 
-		{
-			x = double_from_wkb_state(s);
-			y = double_from_wkb_state(s);
-			value = call_function2(LWGEOM_makepoint, Float8GetDatum(x),
-				Float8GetDatum(y));
-		}
-		TimestampTz t = timestamp_from_wkb_state(s);
-		if (s->has_srid)
-		{
-			GSERIALIZED *gs = (GSERIALIZED *)DatumGetPointer(value);
-			gserialized_set_srid(gs, s->srid);
-		}
-		instants[i] = temporalinst_make(value, t, type_oid(T_GEOMETRY));
-		pfree(DatumGetPointer(value));
-	}
+	TemporalInst **instants = tpointinstarr_from_wkb_state(s, count);
 	TemporalI *result = temporali_from_temporalinstarr(instants, count); 
-	for (int i = 0; i < count; i++)
-		pfree(instants[i]);
-	pfree(instants);
+	tpointinstarr_free(instants);
 	return result;
 }
 
@@ -787,115 +924,33 @@ tpoint_bounds_from_wkb_state(uint8_t wkb_bounds, bool *lower_inc, bool *upper_in
 static TemporalSeq * 
 tpointseq_from_wkb_state(wkb_parse_state *s)
 {
-	/* Count the dimensions. */
-	uint32_t ndims = (s->has_z) ? 3 : 2;
 	/* Get the number of instants. */
-	int count = integer_from_wkb_state(s);
+	int count = tpoint_count_from_wkb_state(s);
 	/* Get the period bounds */
 	uint8_t wkb_bounds = (uint8_t) byte_from_wkb_state(s);
 	bool lower_inc, upper_inc;
 	tpoint_bounds_from_wkb_state(wkb_bounds, &lower_inc, &upper_inc);
 	/* Does the data we want to read exist? */
-	size_t size = count * ((ndims * WKB_DOUBLE_SIZE) + WKB_TIMESTAMP_SIZE);
-	wkb_parse_state_check(s, size);
+	tpoint_check_instants_wkb_state(s, count);
 	/* Parse the instants */
-	TemporalInst **instants = palloc(sizeof(TemporalInst *) * count);
-	for (int i = 0; i < count; i++)
-	{
-		double x, y, z;
-		/* Parse the coordinates and create the point */
-		Datum value = 0;
-		if (s->has_z)
-		{
-			x = double_from_wkb_state(s);
-			y = double_from_wkb_state(s);
-			z = double_from_wkb_state(s);
-			value = call_function3(LWGEOM_makepoint, Float8GetDatum(x),
-				Float8GetDatum(y), Float8GetDatum(z));
-
-		}
-		else 
-		{
-			x = double_from_wkb_state(s);
-			y = double_from_wkb_state(s);
-			value = call_function2(LWGEOM_makepoint, Float8GetDatum(x),
-				Float8GetDatum(y));
-		}
-		TimestampTz t = timestamp_from_wkb_state(s);
-		if (s->has_srid)
-		{
-			GSERIALIZED *gs = (GSERIALIZED *)DatumGetPointer(value);
-			gserialized_set_srid(gs, s->srid);
-		}
-		instants[i] = temporalinst_make(value, t, type_oid(T_GEOMETRY));
-		pfree(DatumGetPointer(value));
-	}
+	TemporalInst **instants = tpointinstarr_from_wkb_state(s, count);
 	TemporalSeq *result = temporalseq_from_temporalinstarr(instants, count, 
 		lower_inc, upper_inc, s->linear, true); 
-	for (int i = 0; i < count; i++)
-		pfree(instants[i]);
-	pfree(instants);
+	tpointinstarr_free(instants);
 	return result;
 }
 
 static TemporalS * 
 tpoints_from_wkb_state(wkb_parse_state *s)
 {
-	/* Count the dimensions. */
-	uint32_t ndims = (s->has_z) ? 3 : 2;
 	/* Get the number of sequences. */
-	int count = integer_from_wkb_state(s);
+	int count = (int) integer_from_wkb_state(s);
+	if (count < 1)
+		elog(ERROR, "Invalid number of sequences in WKB (%d)!", count);
 	/* Parse the sequences */
 	TemporalSeq **sequences = palloc(sizeof(TemporalSeq *) * count);
 	for (int i = 0; i < count; i++)
-	{
-		/* Get the number of instants */
-		int countinst = integer_from_wkb_state(s);
-		/* Get the period bounds */
-		uint8_t wkb_bounds = (uint8_t) byte_from_wkb_state(s);
-		bool lower_inc, upper_inc;
-		tpoint_bounds_from_wkb_state(wkb_bounds, &lower_inc, &upper_inc);
-		/* Does the data we want to read exist? */
-		size_t size = countinst * ((ndims * WKB_DOUBLE_SIZE) + WKB_TIMESTAMP_SIZE);
-		wkb_parse_state_check(s, size);
-		/* Parse the instants */
-		TemporalInst **instants = palloc(sizeof(TemporalInst *) * countinst);
-		for (int j = 0; j < countinst; j++)
-		{
-			double x, y, z;
-			/* Parse the coordinates and create the point */
-			Datum value = 0;
-			if (s->has_z)
-			{
-				x = double_from_wkb_state(s);
-				y = double_from_wkb_state(s);
-				z = double_from_wkb_state(s);
-				value = call_function3(LWGEOM_makepoint, Float8GetDatum(x),
-					Float8GetDatum(y), Float8GetDatum(z));
-
-			}
-			else 
-			{
-				x = double_from_wkb_state(s);
-				y = double_from_wkb_state(s);
-				value = call_function2(LWGEOM_makepoint, Float8GetDatum(x),
-					Float8GetDatum(y));
-			}
-			TimestampTz t = timestamp_from_wkb_state(s);
-			if (s->has_srid)
-			{
-				GSERIALIZED *gs = (GSERIALIZED *)DatumGetPointer(value);
-				gserialized_set_srid(gs, s->srid);
-			}
-			instants[j] = temporalinst_make(value, t, type_oid(T_GEOMETRY));
-			pfree(DatumGetPointer(value));
-		}
-		sequences[i] = temporalseq_from_temporalinstarr(instants, countinst,
-			lower_inc, upper_inc, s->linear, true); 
-		for (int j = 0; j < countinst; j++)
-			pfree(instants[j]);
-		pfree(instants);
-	}
+		sequences[i] = tpointseq_from_wkb_state(s);
 	TemporalS *result = temporals_from_temporalseqarr(sequences, count, 
 		s->linear, true); 
 	for (int i = 0; i < count; i++)
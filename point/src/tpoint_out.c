@@ -14,7 +14,9 @@
 
 #include <assert.h>
 #include <float.h>
+#include <funcapi.h>
 #include <utils/builtins.h>
+#include <utils/timestamp.h>
 
 #include "temporaltypes.h"
 #include "oidcache.h"
@@ -36,12 +38,12 @@
 
 /* 
  * Output a geometry in Well-Known Text (WKT) and Extended Well-Known Text 
- * (EWKT) format.
- * The Oid argument is not used but is needed since the second argument of 
- * the functions temporal*_to_string is of type char *(*value_out)(Oid, Datum) 
+ * (EWKT) format. These functions are used for the elements of geometry 
+ * arrays, the points of temporal points are appended to a buffer by 
+ * point_wkt_out, which is passed to temporal_to_stringbuf as value_out_func
  */
 static char *
-wkt_out(Oid type, Datum value)
+wkt_out(Datum value)
 {
 	GSERIALIZED *gs = (GSERIALIZED *)DatumGetPointer(value);
 	LWGEOM *geom = lwgeom_from_gserialized(gs);
@@ -55,7 +57,7 @@ wkt_out(Oid type, Datum value)
 }
 
 static char *
-ewkt_out(Oid type, Datum value)
+ewkt_out(Datum value)
 {
 	GSERIALIZED *gs = (GSERIALIZED *)DatumGetPointer(value);
 	LWGEOM *geom = lwgeom_from_gserialized(gs);
@@ -68,23 +70,66 @@ ewkt_out(Oid type, Datum value)
 	return result;
 }
 
+/* 
+ * Append a point in Well-Known Text (WKT) format to the buffer. The output 
+ * is the one of lwgeom_to_wkt but the coordinates are written directly 
+ * without converting the point into an LWGEOM.
+ * The Oid argument is not used but is needed since the function is of type
+ * value_out_func 
+ */
+static void
+point_wkt_out(StringInfo buf, Oid type, Datum value, int maxdd)
+{
+	GSERIALIZED *gs = (GSERIALIZED *)DatumGetPointer(value);
+	char x[OUT_DOUBLE_BUFFER_SIZE];
+	char y[OUT_DOUBLE_BUFFER_SIZE];
+	char z[OUT_DOUBLE_BUFFER_SIZE];
+	if (FLAGS_GET_Z(gs->flags))
+	{
+		POINT3DZ pt = datum_get_point3dz(value);
+		lwprint_double(pt.x, maxdd, x, OUT_DOUBLE_BUFFER_SIZE);
+		lwprint_double(pt.y, maxdd, y, OUT_DOUBLE_BUFFER_SIZE);
+		lwprint_double(pt.z, maxdd, z, OUT_DOUBLE_BUFFER_SIZE);
+		appendStringInfo(buf, "POINT Z (%s %s %s)", x, y, z);
+	}
+	else
+	{
+		POINT2D pt = datum_get_point2d(value);
+		lwprint_double(pt.x, maxdd, x, OUT_DOUBLE_BUFFER_SIZE);
+		lwprint_double(pt.y, maxdd, y, OUT_DOUBLE_BUFFER_SIZE);
+		appendStringInfo(buf, "POINT(%s %s)", x, y);
+	}
+}
+
+/* Get the maximum number of decimal digits, if any (default is max) */
+
+static int
+tpoint_maxdd(FunctionCallInfo fcinfo)
+{
+	int maxdd = DBL_DIG;
+	if (PG_NARGS() > 1 && !PG_ARGISNULL(1))
+	{
+		maxdd = PG_GETARG_INT32(1);
+		if (maxdd > DBL_DIG)
+			maxdd = DBL_DIG;
+		else if (maxdd < 0)
+			maxdd = 0;
+	}
+	return maxdd;
+}
+
 /* Output a temporal point in WKT format */
 
 static text *
-tpoint_as_text_internal(Temporal *temp)
+tpoint_as_text_internal(Temporal *temp, int maxdd)
 {
-	char *str = NULL;
-	ensure_valid_duration(temp->duration);
-	if (temp->duration == TEMPORALINST)
-		str = temporalinst_to_string((TemporalInst *)temp, &wkt_out);
-	else if (temp->duration == TEMPORALI)
-		str = temporali_to_string((TemporalI *)temp, &wkt_out);
-	else if (temp->duration == TEMPORALSEQ)
-		str = temporalseq_to_string((TemporalSeq *)temp, false, &wkt_out);
-	else if (temp->duration == TEMPORALS)
-		str = temporals_to_string((TemporalS *)temp, &wkt_out);
-	text *result = cstring_to_text(str);
-	pfree(str);
+	/* The text is written in place after the varlena header */
+	StringInfoData buf;
+	initStringInfo(&buf);
+	appendStringInfoSpaces(&buf, VARHDRSZ);
+	temporal_to_stringbuf(&buf, temp, maxdd, &point_wkt_out);
+	text *result = (text *) buf.data;
+	SET_VARSIZE(result, buf.len);
 	return result;
 }
 
@@ -94,38 +139,26 @@ PGDLLEXPORT Datum
 tpoint_as_text(PG_FUNCTION_ARGS)
 {
 	Temporal *temp = PG_GETARG_TEMPORAL(0);
-	text *result = tpoint_as_text_internal(temp);
+	text *result = tpoint_as_text_internal(temp, tpoint_maxdd(fcinfo));
 	PG_FREE_IF_COPY(temp, 0);
 	PG_RETURN_TEXT_P(result);
 }
 
-/* Output a temporal point in WKT format */
+/* Output a temporal point in WKT format prefixed with the SRID */
 
 static text *
-tpoint_as_ewkt_internal(Temporal *temp)
+tpoint_as_ewkt_internal(Temporal *temp, int maxdd)
 {
 	int srid = tpoint_srid_internal(temp);
-	char str1[20];
+	StringInfoData buf;
+	initStringInfo(&buf);
+	appendStringInfoSpaces(&buf, VARHDRSZ);
 	if (srid > 0)
-		sprintf(str1, "SRID=%d%c", srid,
+		appendStringInfo(&buf, "SRID=%d%c", srid,
 			MOBDB_FLAGS_GET_LINEAR(temp->flags) ? ';' : ',');
-	else
-		str1[0] = '\0';
-	char *str2 = NULL;
-	ensure_valid_duration(temp->duration);
-	if (temp->duration == TEMPORALINST)
-		str2 = temporalinst_to_string((TemporalInst *)temp, &wkt_out);
-	else if (temp->duration == TEMPORALI)
-		str2 = temporali_to_string((TemporalI *)temp, &wkt_out);
-	else if (temp->duration == TEMPORALSEQ)
-		str2 = temporalseq_to_string((TemporalSeq *)temp, false, &wkt_out);
-	else if (temp->duration == TEMPORALS)
-		str2 = temporals_to_string((TemporalS *)temp, &wkt_out);
-	char *str = (char *) palloc(strlen(str1) + strlen(str2) + 1);
-	strcpy(str, str1);
-	strcat(str, str2);
-	text *result = cstring_to_text(str);
-	pfree(str2); pfree(str);
+	temporal_to_stringbuf(&buf, temp, maxdd, &point_wkt_out);
+	text *result = (text *) buf.data;
+	SET_VARSIZE(result, buf.len);
 	return result;
 }
 
@@ -135,7 +168,7 @@ PGDLLEXPORT Datum
 tpoint_as_ewkt(PG_FUNCTION_ARGS)
 {
 	Temporal *temp = PG_GETARG_TEMPORAL(0);
-	text *result = tpoint_as_ewkt_internal(temp);
+	text *result = tpoint_as_ewkt_internal(temp, tpoint_maxdd(fcinfo));
 	PG_FREE_IF_COPY(temp, 0);
 	PG_RETURN_TEXT_P(result);
 }
@@ -155,8 +188,7 @@ geoarr_as_text(PG_FUNCTION_ARGS)
 	text **textarr = palloc(sizeof(text *) * count);
 	for (int i = 0; i < count; i++)
 	{
-		/* The wkt_out function does not use the first argument */
-		char *str = wkt_out(ANYOID, geoarr[i]);
+		char *str = wkt_out(geoarr[i]);
 		textarr[i] = cstring_to_text(str);
 		pfree(str);
 	}
@@ -184,8 +216,7 @@ geoarr_as_ewkt(PG_FUNCTION_ARGS)
 	text **textarr = palloc(sizeof(text *) * count);
 	for (int i = 0; i < count; i++)
 	{
-		/* The wkt_out function does not use the first argument */
-		char *str = ewkt_out(ANYOID, geoarr[i]);
+		char *str = ewkt_out(geoarr[i]);
 		textarr[i] = cstring_to_text(str);
 		pfree(str);
 	}
@@ -217,7 +248,7 @@ tpointarr_as_text(PG_FUNCTION_ARGS)
 	}
 	text **textarr = palloc(sizeof(text *) * count);
 	for (int i = 0; i < count; i++)
-		textarr[i] = tpoint_as_text_internal(temparr[i]);
+		textarr[i] = tpoint_as_text_internal(temparr[i], DBL_DIG);
 	ArrayType *result = textarr_to_array(textarr, count);
 
 	pfree(temparr);
@@ -246,7 +277,7 @@ tpointarr_as_ewkt(PG_FUNCTION_ARGS)
 	}
 	text **textarr = palloc(sizeof(text *) * count);
 	for (int i = 0; i < count; i++)
-		textarr[i] = tpoint_as_ewkt_internal(temparr[i]);
+		textarr[i] = tpoint_as_ewkt_internal(temparr[i], DBL_DIG);
 	ArrayType *result = textarr_to_array(textarr, count);
 
 	pfree(temparr);
@@ -262,343 +293,287 @@ tpointarr_as_ewkt(PG_FUNCTION_ARGS)
  * Output in MFJSON format 
  *****************************************************************************/
 
+/*
+ * The MF-JSON representation is written in a single pass into a buffer that
+ * is enlarged when needed, instead of computing beforehand the maximum size 
+ * of every component.
+ */
+
 /*
  * Handle coordinate array
- * Returns maximum size of rendered coordinate array in bytes.
+ * The coordinates are printed by lwprint_double directly into the buffer.
  */
-static size_t
-coordinates_mfjson_size(int npoints, bool hasz, int precision)
+static void
+double_mfjson_buf(StringInfo buf, double d, int precision)
 {
-	assert(precision <= OUT_MAX_DOUBLE_PRECISION);
-	if (hasz)
-		return (OUT_MAX_DIGS_DOUBLE + precision + sizeof(","))
-			* 3 * npoints + sizeof(",[]");
-	else
-		return (OUT_MAX_DIGS_DOUBLE + precision + sizeof(","))
-			* 2 * npoints + sizeof(",[]");
+	enlargeStringInfo(buf, OUT_DOUBLE_BUFFER_SIZE);
+	lwprint_double(d, precision, buf->data + buf->len, OUT_DOUBLE_BUFFER_SIZE);
+	buf->len += strlen(buf->data + buf->len);
 }
 
-static size_t
-coordinates_mfjson_buf(char *output, TemporalInst *inst, int precision)
+static void
+coordinates_mfjson_buf(StringInfo buf, TemporalInst *inst, int precision)
 {
-	char *ptr;
-	char x[OUT_DOUBLE_BUFFER_SIZE];
-	char y[OUT_DOUBLE_BUFFER_SIZE];
-	char z[OUT_DOUBLE_BUFFER_SIZE];
-
 	assert (precision <= OUT_MAX_DOUBLE_PRECISION);
-	ptr = output;
-
+	appendStringInfoChar(buf, '[');
 	if (!MOBDB_FLAGS_GET_Z(inst->flags))
 	{
 		POINT2D pt = datum_get_point2d(temporalinst_value(inst));
-		lwprint_double(pt.x, precision, x, OUT_DOUBLE_BUFFER_SIZE);
-		lwprint_double(pt.y, precision, y, OUT_DOUBLE_BUFFER_SIZE);
-		ptr += sprintf(ptr, "[%s,%s]", x, y);
+		double_mfjson_buf(buf, pt.x, precision);
+		appendStringInfoChar(buf, ',');
+		double_mfjson_buf(buf, pt.y, precision);
 	}
 	else
 	{
 		POINT3DZ pt = datum_get_point3dz(temporalinst_value(inst));
-		lwprint_double(pt.x, precision, x, OUT_DOUBLE_BUFFER_SIZE);
-		lwprint_double(pt.y, precision, y, OUT_DOUBLE_BUFFER_SIZE);
-		lwprint_double(pt.z, precision, z, OUT_DOUBLE_BUFFER_SIZE);
-		ptr += sprintf(ptr, "[%s,%s,%s]", x, y, z);
+		double_mfjson_buf(buf, pt.x, precision);
+		appendStringInfoChar(buf, ',');
+		double_mfjson_buf(buf, pt.y, precision);
+		appendStringInfoChar(buf, ',');
+		double_mfjson_buf(buf, pt.z, precision);
 	}
-	return (ptr - output);
+	appendStringInfoChar(buf, ']');
 }
 
 /*
  * Handle datetimes array
- * Returns maximum size of datetimes array in bytes.
- * Example: "datetimes":["2019-08-06T18:35:48.021455+02:30","2019-08-06T18:45:18.476983+02:30"],
- * 32 characters for the timestamptz + 2 double quotes + 1 comma
+ * Example: "datetimes":["2019-08-06T18:35:48.021455+02:30","2019-08-06T18:45:18.476983+02:30"]
+ * The fields are written directly instead of going through the output 
+ * function of PostgreSQL, which also makes the output independent of the 
+ * DateStyle setting.
  */
-static size_t
-datetimes_mfjson_size(int npoints)
+static char *
+digits_mfjson_buf(char *ptr, int value, int ndigits)
 {
-	return sizeof("\"2019-08-06T18:35:48.021455+02:30\",") * npoints + sizeof("[],");
+	for (int i = ndigits - 1; i >= 0; i--)
+	{
+		ptr[i] = (char) ('0' + value % 10);
+		value /= 10;
+	}
+	return ptr + ndigits;
 }
 
-static size_t
-datetimes_mfjson_buf(char *output, TemporalInst *inst)
+static void
+datetimes_mfjson_buf(StringInfo buf, TimestampTz t)
 {
-	char *ptr = output;
-	char *t = call_output(TIMESTAMPTZOID, TimestampTzGetDatum(inst->t));
-	/* Replace ' ' by 'T' as separator between date and time parts */
-	t[10] = 'T';
-	ptr += sprintf(ptr, "\"%s\"", t);
-	pfree(t);
-	return (ptr - output);
+	struct pg_tm tt, *tm = &tt;
+	fsec_t fsec;
+	int tz;
+	const char *tzn;
+
+	if (TIMESTAMP_NOT_FINITE(t) || 
+		timestamp2tm(t, &tz, tm, &fsec, &tzn, NULL) != 0 || 
+		tm->tm_year < 1 || tm->tm_year > 9999)
+	{
+		/* Infinite timestamps and years that do not have four digits are 
+		 * written by the output function */
+		appendStringInfoChar(buf, '"');
+		int start = buf->len;
+		stringinfo_append_timestamp(buf, t);
+		/* Replace ' ' by 'T' as separator between date and time parts */
+		if (buf->len > start + 10 && buf->data[start + 10] == ' ')
+			buf->data[start + 10] = 'T';
+		appendStringInfoChar(buf, '"');
+		return;
+	}
+
+	/* "YYYY-MM-DDTHH:MI:SS.ffffff+HH:MI:SS" */
+	char str[40], *ptr = str;
+	*ptr++ = '"';
+	ptr = digits_mfjson_buf(ptr, tm->tm_year, 4);
+	*ptr++ = '-';
+	ptr = digits_mfjson_buf(ptr, tm->tm_mon, 2);
+	*ptr++ = '-';
+	ptr = digits_mfjson_buf(ptr, tm->tm_mday, 2);
+	*ptr++ = 'T';
+	ptr = digits_mfjson_buf(ptr, tm->tm_hour, 2);
+	*ptr++ = ':';
+	ptr = digits_mfjson_buf(ptr, tm->tm_min, 2);
+	*ptr++ = ':';
+	ptr = digits_mfjson_buf(ptr, tm->tm_sec, 2);
+	if (fsec != 0)
+	{
+		/* Fractional seconds without trailing zeros */
+		int value = (int) fsec, ndigits = 6;
+		while (value % 10 == 0)
+		{
+			value /= 10;
+			ndigits--;
+		}
+		*ptr++ = '.';
+		ptr = digits_mfjson_buf(ptr, value, ndigits);
+	}
+	/* The time zone displacement is kept in seconds west of UTC */
+	int disp = abs(tz);
+	*ptr++ = (tz <= 0) ? '+' : '-';
+	ptr = digits_mfjson_buf(ptr, disp / SECS_PER_HOUR, 2);
+	if (disp % SECS_PER_HOUR != 0)
+	{
+		*ptr++ = ':';
+		ptr = digits_mfjson_buf(ptr, (disp / SECS_PER_MINUTE) % MINS_PER_HOUR, 2);
+		if (disp % SECS_PER_MINUTE != 0)
+		{
+			*ptr++ = ':';
+			ptr = digits_mfjson_buf(ptr, disp % SECS_PER_MINUTE, 2);
+		}
+	}
+	*ptr++ = '"';
+	appendBinaryStringInfo(buf, str, (int) (ptr - str));
 }
 
 /*
  * Handle SRS
  */
-static size_t
-srs_mfjson_size(char *srs)
+static void
+srs_mfjson_buf(StringInfo buf, char *srs)
 {
-	size_t size = sizeof("'crs':{'type':'name',");
-	size += sizeof("'properties':{'name':''}},");
-	size += strlen(srs) * sizeof(char);
-	return size;
-}
-
-static size_t
-srs_mfjson_buf(char *output, char *srs)
-{
-	char *ptr = output;
-	ptr += sprintf(ptr, "\"crs\":{\"type\":\"name\",");
-	ptr += sprintf(ptr, "\"properties\":{\"name\":\"%s\"}},", srs);
-	return (ptr - output);
+	appendStringInfoString(buf, "\"crs\":{\"type\":\"name\",");
+	appendStringInfo(buf, "\"properties\":{\"name\":\"%s\"}},", srs);
 }
 
 /*
  * Handle Bbox
  */
-static size_t
-bbox_mfjson_size(int hasz, int precision)
+static void
+bbox_mfjson_buf(StringInfo buf, STBOX *bbox, int hasz, int precision)
 {
-	/* The maximum size of a timestamptz is 35 characters, e.g., "2019-08-06 23:18:16.195062-09:30" */
-	size_t size = sizeof("'stBoundedBy':{'period':{'begin':,'end':}},") +
-		sizeof("\"2019-08-06T18:35:48.021455+02:30\",") * 2;
+	appendStringInfoString(buf, "\"stBoundedBy\":{");
 	if (!hasz)
-	{
-		size += sizeof("'bbox':[,,,],");
-		size +=	2 * 2 * (OUT_MAX_DIGS_DOUBLE + precision);
-	}
-	else
-	{
-		size += sizeof("\"bbox\":[,,,,,],");
-		size +=	2 * 3 * (OUT_MAX_DIGS_DOUBLE + precision);
-	}
-	return size;
-}
-
-static size_t
-bbox_mfjson_buf(char *output, STBOX *bbox, int hasz, int precision)
-{
-	char *ptr = output;
-	ptr += sprintf(ptr, "\"stBoundedBy\":{");
-	if (!hasz)
-		ptr += sprintf(ptr, "\"bbox\":[%.*f,%.*f,%.*f,%.*f],",
+		appendStringInfo(buf, "\"bbox\":[%.*f,%.*f,%.*f,%.*f],",
 			precision, bbox->xmin, precision, bbox->ymin,
 			precision, bbox->xmax, precision, bbox->ymax);
 	else
-		ptr += sprintf(ptr, "\"bbox\":[%.*f,%.*f,%.*f,%.*f,%.*f,%.*f],",
+		appendStringInfo(buf, "\"bbox\":[%.*f,%.*f,%.*f,%.*f,%.*f,%.*f],",
 			precision, bbox->xmin, precision, bbox->ymin, precision, bbox->zmin,
 			precision, bbox->xmax, precision, bbox->ymax, precision, bbox->zmax);
-	char *begin = call_output(TIMESTAMPTZOID, TimestampTzGetDatum(bbox->tmin));
-	char *end = call_output(TIMESTAMPTZOID, TimestampTzGetDatum(bbox->tmax));
-	ptr += sprintf(ptr, "\"period\":{\"begin\":\"%s\",\"end\":\"%s\"}},", begin, end);
-	pfree(begin); pfree(end);
-	return (ptr - output);
-}
-
-/*****************************************************************************/
-
-static size_t
-tpointinst_as_mfjson_size(const TemporalInst *inst, int precision, STBOX *bbox, char *srs)
-{
-	size_t size = coordinates_mfjson_size(1, MOBDB_FLAGS_GET_Z(inst->flags), precision);
-	size += datetimes_mfjson_size(1);
-	size += sizeof("{'type':'MovingPoint',");
-	size += sizeof("'coordinates':,'datetimes':,'interpolations':['Discrete']}");
-	if (srs) size += srs_mfjson_size(srs);
-	if (bbox) size += bbox_mfjson_size(MOBDB_FLAGS_GET_Z(inst->flags), precision);
-	return size;
-}
-
-static size_t
-tpointinst_as_mfjson_buf(TemporalInst *inst, int precision, STBOX *bbox, char *srs, char *output)
-{
-	char *ptr = output;
-	ptr += sprintf(ptr, "{\"type\":\"MovingPoint\",");
-	if (srs) ptr += srs_mfjson_buf(ptr, srs);
-	if (bbox) ptr += bbox_mfjson_buf(ptr, bbox, MOBDB_FLAGS_GET_Z(inst->flags), precision);
-	ptr += sprintf(ptr, "\"coordinates\":");
-	ptr += coordinates_mfjson_buf(ptr, inst, precision);
-	ptr += sprintf(ptr, ",\"datetimes\":");
-	ptr += datetimes_mfjson_buf(ptr, inst);
-	ptr += sprintf(ptr, ",\"interpolations\":[\"Discrete\"]}");
-	return (ptr - output);
-}
-
-static char *
-tpointinst_as_mfjson(TemporalInst *inst, int precision, STBOX *bbox, char *srs)
-{
-	size_t size = tpointinst_as_mfjson_size(inst, precision, bbox, srs);
-	char *output = palloc(size);
-	tpointinst_as_mfjson_buf(inst, precision, bbox, srs, output);
-	return output;
+	appendStringInfoString(buf, "\"period\":{\"begin\":");
+	datetimes_mfjson_buf(buf, bbox->tmin);
+	appendStringInfoString(buf, ",\"end\":");
+	datetimes_mfjson_buf(buf, bbox->tmax);
+	appendStringInfoString(buf, "}},");
 }
 
 /*****************************************************************************/
 
-static size_t
-tpointi_as_mfjson_size(const TemporalI *ti, int precision, STBOX *bbox, char *srs)
+static void
+tpointinst_as_mfjson_buf(StringInfo buf, TemporalInst *inst, int precision, 
+	STBOX *bbox, char *srs)
 {
-	size_t size = coordinates_mfjson_size(ti->count, MOBDB_FLAGS_GET_Z(ti->flags), precision);
-	size += datetimes_mfjson_size(ti->count);
-	size += sizeof("{'type':'MovingPoint',");
-	size += sizeof("'coordinates':[],'datetimes':[],'interpolations':['Discrete']}");
-	if (srs) size += srs_mfjson_size(srs);
-	if (bbox) size += bbox_mfjson_size(MOBDB_FLAGS_GET_Z(ti->flags), precision);
-	return size;
+	appendStringInfoString(buf, "{\"type\":\"MovingPoint\",");
+	if (srs) srs_mfjson_buf(buf, srs);
+	if (bbox) bbox_mfjson_buf(buf, bbox, MOBDB_FLAGS_GET_Z(inst->flags), precision);
+	appendStringInfoString(buf, "\"coordinates\":");
+	coordinates_mfjson_buf(buf, inst, precision);
+	appendStringInfoString(buf, ",\"datetimes\":");
+	datetimes_mfjson_buf(buf, inst->t);
+	appendStringInfoString(buf, ",\"interpolations\":[\"Discrete\"]}");
 }
 
-static size_t
-tpointi_as_mfjson_buf(TemporalI *ti, int precision, STBOX *bbox, char *srs, char *output)
+static void
+tpointi_as_mfjson_buf(StringInfo buf, TemporalI *ti, int precision, 
+	STBOX *bbox, char *srs)
 {
-	char *ptr = output;
-	ptr += sprintf(ptr, "{\"type\":\"MovingPoint\",");
-	if (srs) ptr += srs_mfjson_buf(ptr, srs);
-	if (bbox) ptr += bbox_mfjson_buf(ptr, bbox, MOBDB_FLAGS_GET_Z(ti->flags), precision);
-	ptr += sprintf(ptr, "\"coordinates\":[");
+	appendStringInfoString(buf, "{\"type\":\"MovingPoint\",");
+	if (srs) srs_mfjson_buf(buf, srs);
+	if (bbox) bbox_mfjson_buf(buf, bbox, MOBDB_FLAGS_GET_Z(ti->flags), precision);
+	appendStringInfoString(buf, "\"coordinates\":[");
 	for (int i = 0; i < ti->count; i++)
 	{
-		if (i) ptr += sprintf(ptr, ",");
-		ptr += coordinates_mfjson_buf(ptr, temporali_inst_n(ti, i), precision);
+		if (i) appendStringInfoChar(buf, ',');
+		coordinates_mfjson_buf(buf, temporali_inst_n(ti, i), precision);
 	}
-	ptr += sprintf(ptr, "],\"datetimes\":[");
+	appendStringInfoString(buf, "],\"datetimes\":[");
 	for (int i = 0; i < ti->count; i++)
 	{
-		if (i) ptr += sprintf(ptr, ",");
-		ptr += datetimes_mfjson_buf(ptr, temporali_inst_n(ti, i));
+		if (i) appendStringInfoChar(buf, ',');
+		datetimes_mfjson_buf(buf, temporali_inst_n(ti, i)->t);
 	}
-	ptr += sprintf(ptr, "],\"interpolations\":[\"Discrete\"]}");
-	return (ptr - output);
+	appendStringInfoString(buf, "],\"interpolations\":[\"Discrete\"]}");
 }
 
-static char *
-tpointi_as_mfjson(TemporalI *ti, int precision, STBOX *bbox, char *srs)
+/* Coordinates, datetimes and bounds of a sequence */
+static void
+tpointseq_mfjson_members_buf(StringInfo buf, TemporalSeq *seq, int precision)
 {
-	size_t size = tpointi_as_mfjson_size(ti, precision, bbox, srs);
-	char *output = palloc(size);
-	tpointi_as_mfjson_buf(ti, precision, bbox, srs, output);
-	return output;
-}
-
-/*****************************************************************************/
-
-static size_t
-tpointseq_as_mfjson_size(const TemporalSeq *seq, int precision, STBOX *bbox, char *srs)
-{
-	size_t size = coordinates_mfjson_size(seq->count, MOBDB_FLAGS_GET_Z(seq->flags), precision);
-	size += datetimes_mfjson_size(seq->count);
-	size += sizeof("{'type':'MovingPoint',");
-	/* We reserve space for the largest strings, i.e., 'false' and "Stepwise" */
-	size += sizeof("'coordinates':[],'datetimes':[],'lower_inc':false,'upper_inc':false,interpolations':['Stepwise']}");
-	if (srs) size += srs_mfjson_size(srs);
-	if (bbox) size += bbox_mfjson_size(MOBDB_FLAGS_GET_Z(seq->flags), precision);
-	return size;
-}
-
-static size_t
-tpointseq_as_mfjson_buf(TemporalSeq *seq, int precision, STBOX *bbox, char *srs, char *output)
-{
-	char *ptr = output;
-	ptr += sprintf(ptr, "{\"type\":\"MovingPoint\",");
-	if (srs) ptr += srs_mfjson_buf(ptr, srs);
-	if (bbox) ptr += bbox_mfjson_buf(ptr, bbox, MOBDB_FLAGS_GET_Z(seq->flags), precision);
-	ptr += sprintf(ptr, "\"coordinates\":[");
+	appendStringInfoString(buf, "\"coordinates\":[");
 	for (int i = 0; i < seq->count; i++)
 	{
-		if (i) ptr += sprintf(ptr, ",");
-		ptr += coordinates_mfjson_buf(ptr, temporalseq_inst_n(seq, i), precision);
+		if (i) appendStringInfoChar(buf, ',');
+		coordinates_mfjson_buf(buf, temporalseq_inst_n(seq, i), precision);
 	}
-	ptr += sprintf(ptr, "],\"datetimes\":[");
+	appendStringInfoString(buf, "],\"datetimes\":[");
 	for (int i = 0; i < seq->count; i++)
 	{
-		if (i) ptr += sprintf(ptr, ",");
-		ptr += datetimes_mfjson_buf(ptr, temporalseq_inst_n(seq, i));
+		if (i) appendStringInfoChar(buf, ',');
+		datetimes_mfjson_buf(buf, temporalseq_inst_n(seq, i)->t);
 	}
-	ptr += sprintf(ptr, "],\"lower_inc\":%s,\"upper_inc\":%s,\"interpolations\":[\"%s\"]}",
-		seq->period.lower_inc ? "true" : "false", seq->period.upper_inc ? "true" : "false",
-		MOBDB_FLAGS_GET_LINEAR(seq->flags) ? "Linear" : "Stepwise");
-	return (ptr - output);
+	appendStringInfo(buf, "],\"lower_inc\":%s,\"upper_inc\":%s",
+		seq->period.lower_inc ? "true" : "false", 
+		seq->period.upper_inc ? "true" : "false");
 }
 
-static char *
-tpointseq_as_mfjson(TemporalSeq *seq, int precision, STBOX *bbox, char *srs)
+static void
+tpointseq_as_mfjson_buf(StringInfo buf, TemporalSeq *seq, int precision, 
+	STBOX *bbox, char *srs)
 {
-	size_t size = tpointseq_as_mfjson_size(seq, precision, bbox, srs);
-	char *output = palloc(size);
-	tpointseq_as_mfjson_buf(seq, precision, bbox, srs, output);
-	return output;
-}
-
-/*****************************************************************************/
-
-static size_t
-tpoints_as_mfjson_size(TemporalS *ts, int precision, STBOX *bbox, char *srs)
-{
-	size_t size = sizeof("{'type':'MovingPoint','sequences':[],");
-	size += sizeof("{'coordinates':[],'datetimes':[],'lower_inc':false,'upper_inc':false},") * ts->count;
-	size += coordinates_mfjson_size(ts->totalcount, MOBDB_FLAGS_GET_Z(ts->flags), precision);
-	size += datetimes_mfjson_size(ts->totalcount);
-	/* We reserve space for the largest interpolation string, i.e., "Stepwise" */
-	size += sizeof(",interpolations':['Stepwise']}");
-	if (srs) size += srs_mfjson_size(srs);
-	if (bbox) size += bbox_mfjson_size(MOBDB_FLAGS_GET_Z(ts->flags), precision);
-	return size;
+	appendStringInfoString(buf, "{\"type\":\"MovingPoint\",");
+	if (srs) srs_mfjson_buf(buf, srs);
+	if (bbox) bbox_mfjson_buf(buf, bbox, MOBDB_FLAGS_GET_Z(seq->flags), precision);
+	tpointseq_mfjson_members_buf(buf, seq, precision);
+	appendStringInfo(buf, ",\"interpolations\":[\"%s\"]}",
+		MOBDB_FLAGS_GET_LINEAR(seq->flags) ? "Linear" : "Stepwise");
 }
 
-static size_t
-tpoints_as_mfjson_buf(TemporalS *ts, int precision, STBOX *bbox, char *srs, char *output)
+static void
+tpoints_as_mfjson_buf(StringInfo buf, TemporalS *ts, int precision, 
+	STBOX *bbox, char *srs)
 {
-	char *ptr = output;
-	ptr += sprintf(ptr, "{\"type\":\"MovingPoint\",");
-	if (srs) ptr += srs_mfjson_buf(ptr, srs);
-	if (bbox) ptr += bbox_mfjson_buf(ptr, bbox, MOBDB_FLAGS_GET_Z(ts->flags), precision);
-	ptr += sprintf(ptr, "\"sequences\":[");
+	appendStringInfoString(buf, "{\"type\":\"MovingPoint\",");
+	if (srs) srs_mfjson_buf(buf, srs);
+	if (bbox) bbox_mfjson_buf(buf, bbox, MOBDB_FLAGS_GET_Z(ts->flags), precision);
+	appendStringInfoString(buf, "\"sequences\":[");
 	for (int i = 0; i < ts->count; i++)
 	{
-		TemporalSeq *seq = temporals_seq_n(ts, i);
-		if (i) ptr += sprintf(ptr, ",");
-		ptr += sprintf(ptr, "{\"coordinates\":[");
-		for (int j = 0; j < seq->count; j++)
-		{
-			if (j) ptr += sprintf(ptr, ",");
-			ptr += coordinates_mfjson_buf(ptr, temporalseq_inst_n(seq, j), precision);
-		}
-		ptr += sprintf(ptr, "],\"datetimes\":[");
-		for (int j = 0; j < seq->count; j++)
-		{
-			if (j) ptr += sprintf(ptr, ",");
-			ptr += datetimes_mfjson_buf(ptr, temporalseq_inst_n(seq, j));
-		}
-		ptr += sprintf(ptr, "],\"lower_inc\":%s,\"upper_inc\":%s}",
-			seq->period.lower_inc ? "true" : "false", seq->period.upper_inc ? "true" : "false");
+		if (i) appendStringInfoChar(buf, ',');
+		appendStringInfoChar(buf, '{');
+		tpointseq_mfjson_members_buf(buf, temporals_seq_n(ts, i), precision);
+		appendStringInfoChar(buf, '}');
 	}
-	ptr += sprintf(ptr, "],\"interpolations\":[\"%s\"]}",
+	appendStringInfo(buf, "],\"interpolations\":[\"%s\"]}",
 		MOBDB_FLAGS_GET_LINEAR(ts->flags) ? "Linear" : "Stepwise");
-	return (ptr - output);
 }
 
-static char *
-tpoints_as_mfjson(TemporalS *ts, int precision, STBOX *bbox, char *srs)
+/* Append the MF-JSON representation of a temporal point (dispatch function) */
+static void
+tpoint_as_mfjson_buf(StringInfo buf, Temporal *temp, int precision, 
+	bool has_bbox, char *srs)
 {
-	size_t size = tpoints_as_mfjson_size(ts, precision, bbox, srs);
-	char *output = palloc(size);
-	tpoints_as_mfjson_buf(ts, precision, bbox, srs, output);
-	return output;
+	/* Get bounding box if needed */
+	STBOX *bbox = NULL, tmp;
+	memset(&tmp, 0, sizeof(STBOX));
+	if (has_bbox)
+	{
+		temporal_bbox(&tmp, temp);
+		bbox = &tmp;
+	}
+	ensure_valid_duration(temp->duration);
+	if (temp->duration == TEMPORALINST)
+		tpointinst_as_mfjson_buf(buf, (TemporalInst *)temp, precision, bbox, srs);
+	else if (temp->duration == TEMPORALI)
+		tpointi_as_mfjson_buf(buf, (TemporalI *)temp, precision, bbox, srs);
+	else if (temp->duration == TEMPORALSEQ)
+		tpointseq_as_mfjson_buf(buf, (TemporalSeq *)temp, precision, bbox, srs);
+	else if (temp->duration == TEMPORALS)
+		tpoints_as_mfjson_buf(buf, (TemporalS *)temp, precision, bbox, srs);
 }
 
 /*****************************************************************************/
 
-PG_FUNCTION_INFO_V1(tpoint_as_mfjson);
-
-PGDLLEXPORT Datum
-tpoint_as_mfjson(PG_FUNCTION_ARGS)
+/* Retrieve precision if any (default is max) */
+static int
+mfjson_precision(FunctionCallInfo fcinfo)
 {
-	int has_bbox = 0;
 	int precision = DBL_DIG;
-	char *srs = NULL;
-
-	/* Get the temporal point */
-	Temporal *temp = PG_GETARG_TEMPORAL(0);
-
-	/* Retrieve precision if any (default is max) */
 	if (PG_NARGS() > 1 && !PG_ARGISNULL(1))
 	{
 		precision = PG_GETARG_INT32(1);
@@ -607,64 +582,138 @@ tpoint_as_mfjson(PG_FUNCTION_ARGS)
 		else if (precision < 0)
 			precision = 0;
 	}
+	return precision;
+}
 
-	/* Retrieve output option
-	 * 0 = without option (default)
-	 * 1 = bbox
-	 * 2 = short crs
-	 * 4 = long crs
-	 */
+/* Retrieve output option
+ * 0 = without option (default)
+ * 1 = bbox
+ * 2 = short crs
+ * 4 = long crs
+ */
+static int
+mfjson_option(FunctionCallInfo fcinfo)
+{
 	if (PG_NARGS() > 2 && !PG_ARGISNULL(2))
-	{
-		int option = PG_GETARG_INT32(2);
-
-		if (option & 2 || option & 4)
-		{
-			int32_t srid = tpoint_srid_internal(temp);
-			if (srid != SRID_UNKNOWN)
-			{
-				if (option & 2)
-					srs = getSRSbySRID(srid, true);
-
-				if (option & 4)
-					srs = getSRSbySRID(srid, false);
-
-				if (!srs)
-				{
-					elog(ERROR, "SRID %i unknown in spatial_ref_sys table",
-						  srid);
-					PG_RETURN_NULL();
-				}
-			}
-		}
-		if (option & 1)
-			has_bbox = 1;
-	}
+		return PG_GETARG_INT32(2);
+	return 0;
+}
 
-	/* Get bounding box if needed */
-	STBOX *bbox = NULL, tmp;
-	memset(&tmp, 0, sizeof(STBOX));
-	if (has_bbox)
+/* Get the name of the spatial reference system if required by the option */
+static char *
+mfjson_srs(int32_t srid, int option)
+{
+	char *srs = NULL;
+	if ((option & 2 || option & 4) && srid != SRID_UNKNOWN)
 	{
-		temporal_bbox(&tmp, temp);
-		bbox = &tmp;
+		if (option & 2)
+			srs = getSRSbySRID(srid, true);
+		if (option & 4)
+			srs = getSRSbySRID(srid, false);
+		if (!srs)
+			elog(ERROR, "SRID %i unknown in spatial_ref_sys table", srid);
 	}
+	return srs;
+}
 
-	char *mfjson = NULL;
-	ensure_valid_duration(temp->duration);
-	if (temp->duration == TEMPORALINST)
-		mfjson = tpointinst_as_mfjson((TemporalInst *)temp, precision, bbox, srs);
-	else if (temp->duration == TEMPORALI)
-		mfjson = tpointi_as_mfjson((TemporalI *)temp, precision, bbox, srs);
-	else if (temp->duration == TEMPORALSEQ)
-		mfjson = tpointseq_as_mfjson((TemporalSeq *)temp, precision, bbox, srs);
-	else if (temp->duration == TEMPORALS)
-		mfjson = tpoints_as_mfjson((TemporalS *)temp, precision, bbox, srs);
-	text *result = cstring_to_text(mfjson);
+PG_FUNCTION_INFO_V1(tpoint_as_mfjson);
+
+PGDLLEXPORT Datum
+tpoint_as_mfjson(PG_FUNCTION_ARGS)
+{
+	Temporal *temp = PG_GETARG_TEMPORAL(0);
+	int precision = mfjson_precision(fcinfo);
+	int option = mfjson_option(fcinfo);
+	char *srs = mfjson_srs(tpoint_srid_internal(temp), option);
+
+	/* The text is written in place after the varlena header */
+	StringInfoData buf;
+	initStringInfo(&buf);
+	appendStringInfoSpaces(&buf, VARHDRSZ);
+	tpoint_as_mfjson_buf(&buf, temp, precision, option & 1, srs);
+	text *result = (text *) buf.data;
+	SET_VARSIZE(result, buf.len);
 	PG_FREE_IF_COPY(temp, 0);
 	PG_RETURN_TEXT_P(result);
 }
 
+/*
+ * Output an array of temporal points as an MF-JSON FeatureCollection. The 
+ * collection is returned in consecutive pieces, the opening of the 
+ * collection, one feature per temporal point, and the closing of the 
+ * collection, so that concatenating the rows gives the complete document 
+ * while only one feature is held in memory at a time.
+ */
+
+typedef struct
+{
+	Temporal **temparr;
+	int count;
+	int precision;
+	int option;
+	int32_t srid;   /* SRID of the cached SRS name */
+	char *srs;
+} MFJSONCollectionState;
+
+PG_FUNCTION_INFO_V1(tpointarr_as_mfjson_collection);
+
+PGDLLEXPORT Datum
+tpointarr_as_mfjson_collection(PG_FUNCTION_ARGS)
+{
+	FuncCallContext *funcctx;
+	MFJSONCollectionState *state;
+	if (SRF_IS_FIRSTCALL())
+	{
+		funcctx = SRF_FIRSTCALL_INIT();
+		MemoryContext oldcontext = 
+			MemoryContextSwitchTo(funcctx->multi_call_memory_ctx);
+		ArrayType *array = PG_GETARG_ARRAYTYPE_P(0);
+		state = palloc0(sizeof(MFJSONCollectionState));
+		state->temparr = temporalarr_extract(array, &state->count);
+		state->precision = mfjson_precision(fcinfo);
+		state->option = mfjson_option(fcinfo);
+		state->srid = SRID_UNKNOWN;
+		funcctx->user_fctx = state;
+		MemoryContextSwitchTo(oldcontext);
+	}
+	funcctx = SRF_PERCALL_SETUP();
+	state = funcctx->user_fctx;
+	int i = (int) funcctx->call_cntr;
+	if (i > state->count + 1)
+		SRF_RETURN_DONE(funcctx);
+
+	StringInfoData buf;
+	initStringInfo(&buf);
+	appendStringInfoSpaces(&buf, VARHDRSZ);
+	if (i == 0)
+		appendStringInfoString(&buf, "{\"type\":\"FeatureCollection\",\"features\":[");
+	else if (i == state->count + 1)
+		appendStringInfoString(&buf, "]}");
+	else
+	{
+		Temporal *temp = state->temparr[i - 1];
+		int32_t srid = tpoint_srid_internal(temp);
+		if (srid != state->srid)
+		{
+			MemoryContext oldcontext = 
+				MemoryContextSwitchTo(funcctx->multi_call_memory_ctx);
+			state->srs = mfjson_srs(srid, state->option);
+			state->srid = srid;
+			MemoryContextSwitchTo(oldcontext);
+		}
+		if (i > 1)
+			appendStringInfoChar(&buf, ',');
+		appendStringInfoString(&buf, 
+			"{\"type\":\"Feature\",\"geometry\":null,\"properties\":null,\"temporalGeometry\":");
+		tpoint_as_mfjson_buf(&buf, temp, state->precision, state->option & 1, 
+			state->srs);
+		appendStringInfoChar(&buf, '}');
+	}
+	text *result = (text *) buf.data;
+	SET_VARSIZE(result, buf.len);
+	SRF_RETURN_NEXT(funcctx, PointerGetDatum(result));
+}
+
 /*****************************************************************************
  * Output in WKB format 
  *****************************************************************************/
@@ -677,28 +726,54 @@ tpoint_as_mfjson(PG_FUNCTION_ARGS)
 // #define WKT_SFSQL 0x02
 #define WKT_EXTENDED 0x04
 
+/*
+ * The WKB is always written in binary form. Since every byte of the binary
+ * form, including those of the flags, corresponds to two characters of the
+ * hexadecimal form, the latter is obtained by encoding the binary form in a
+ * single pass with hex_to_buf.
+ */
+
 /*
 * Look-up table for hex writer
 */
 static char *hexchr = "0123456789ABCDEF";
 
+/*
+* Look-up table giving the two hexadecimal characters of every byte value,
+* filled on first use
+*/
+static char hexpairs[512];
+static bool hexpairs_filled = false;
+
+/*
+* Encode size bytes in hexadecimal. The encoding can be made in place when
+* the bytes are located at buf + size, since the two characters of a byte
+* are written at or before the position of the byte
+*/
+static void
+hex_to_buf(const uint8_t *wkb, size_t size, uint8_t *buf)
+{
+	if (! hexpairs_filled)
+	{
+		for (int i = 0; i < 256; i++)
+		{
+			hexpairs[2 * i] = hexchr[i >> 4];
+			hexpairs[2 * i + 1] = hexchr[i & 0x0F];
+		}
+		hexpairs_filled = true;
+	}
+	for (size_t i = 0; i < size; i++)
+		memcpy(buf + 2 * i, &hexpairs[2 * wkb[i]], 2);
+}
+
 /*
 * Endian
 */
 static uint8_t *
 endian_to_wkb_buf(uint8_t *buf, uint8_t variant)
 {
-	if (variant & WKB_HEX)
-	{
-		buf[0] = '0';
-		buf[1] = ((variant & WKB_NDR) ? (uint8_t) '1' : (uint8_t) '0');
-		return buf + 2;
-	}
-	else
-	{
-		buf[0] = ((variant & WKB_NDR) ? (uint8_t) 1 : (uint8_t) 0);
-		return buf + 1;
-	}
+	buf[0] = ((variant & WKB_NDR) ? (uint8_t) 1 : (uint8_t) 0);
+	return buf + 1;
 }
 
 /*
@@ -717,145 +792,66 @@ wkb_swap_bytes(uint8_t variant)
 }
 
 /*
-* Integer32
+* Flip the byte order of count values of size bytes written in the buffer
 */
-static uint8_t*
-integer_to_wkb_buf(const int ival, uint8_t *buf, uint8_t variant)
+static inline void
+wkb_buf_swap(uint8_t *buf, int count, int size)
 {
-	char *iptr = (char*)(&ival);
-	int i = 0;
-
-	if (sizeof(int) != WKB_INT_SIZE)
-		elog(ERROR, "Machine int size is not %d bytes!", WKB_INT_SIZE);
-
-	if (variant & WKB_HEX)
-	{
-		int swap = wkb_swap_bytes(variant);
-		/* Machine/request arch mismatch, so flip byte order */
-		for (i = 0; i < WKB_INT_SIZE; i++)
-		{
-			int j = (swap ? WKB_INT_SIZE - 1 - i : i);
-			uint8_t b = (uint8_t) iptr[j];
-			/* Top four bits to 0-F */
-			buf[2*i] = (uint8_t) hexchr[b >> 4];
-			/* Bottom four bits to 0-F */
-			buf[2*i + 1] = (uint8_t) hexchr[b & 0x0F];
-		}
-		return buf + (2 * WKB_INT_SIZE);
-	}
-	else
+	for (int i = 0; i < count; i++, buf += size)
 	{
-		/* Machine/request arch mismatch, so flip byte order */
-		if (wkb_swap_bytes(variant))
+		for (int j = 0; j < size / 2; j++)
 		{
-			for (i = 0; i < WKB_INT_SIZE; i++)
-			{
-				buf[i] = (uint8_t) iptr[WKB_INT_SIZE - 1 - i];
-			}
+			uint8_t tmp = buf[j];
+			buf[j] = buf[size - 1 - j];
+			buf[size - 1 - j] = tmp;
 		}
-		/* If machine arch and requested arch match, don't flip byte order */
-		else
-		{
-			memcpy(buf, iptr, WKB_INT_SIZE);
-		}
-		return buf + WKB_INT_SIZE;
 	}
 }
 
 /*
-* Float64
+* Integer32
 */
 static uint8_t*
-double_to_wkb_buf(const double d, uint8_t *buf, uint8_t variant)
+integer_to_wkb_buf(const int ival, uint8_t *buf, uint8_t variant)
 {
-	char *dptr = (char*)(&d);
-	int i = 0;
-
-	if (sizeof(double) != WKB_DOUBLE_SIZE)
-	{
-		elog(ERROR, "Machine double size is not %d bytes!", WKB_DOUBLE_SIZE);
-	}
+	if (sizeof(int) != WKB_INT_SIZE)
+		elog(ERROR, "Machine int size is not %d bytes!", WKB_INT_SIZE);
 
-	if (variant & WKB_HEX)
-	{
-		int swap =  wkb_swap_bytes(variant);
-		/* Machine/request arch mismatch, so flip byte order */
-		for (i = 0; i < WKB_DOUBLE_SIZE; i++)
-		{
-			int j = (swap ? WKB_DOUBLE_SIZE - 1 - i : i);
-			uint8_t b = (uint8_t) dptr[j];
-			/* Top four bits to 0-F */
-			buf[2*i] = (uint8_t) hexchr[b >> 4];
-			/* Bottom four bits to 0-F */
-			buf[2*i + 1] = (uint8_t) hexchr[b & 0x0F];
-		}
-		return buf + (2 * WKB_DOUBLE_SIZE);
-	}
-	else
-	{
-		/* Machine/request arch mismatch, so flip byte order */
-		if (wkb_swap_bytes(variant))
-		{
-			for (i = 0; i < WKB_DOUBLE_SIZE; i++)
-			{
-				buf[i] = (uint8_t) dptr[WKB_DOUBLE_SIZE - 1 - i];
-			}
-		}
-		/* If machine arch and requested arch match, don't flip byte order */
-		else
-		{
-			memcpy(buf, dptr, WKB_DOUBLE_SIZE);
-		}
-		return buf + WKB_DOUBLE_SIZE;
-	}
+	memcpy(buf, &ival, WKB_INT_SIZE);
+	/* Machine/request arch mismatch, so flip byte order */
+	if (wkb_swap_bytes(variant))
+		wkb_buf_swap(buf, 1, WKB_INT_SIZE);
+	return buf + WKB_INT_SIZE;
 }
 
 /*
- * TimestampTz aka int64
- */
-static uint8_t*
-timestamp_to_wkb_buf(const TimestampTz t, uint8_t *buf, uint8_t variant)
+* Coordinates and timestamp of an instant. The point stores its coordinates
+* contiguously, so they are copied in a single block followed by the 
+* timestamp. The byte order of the block is flipped afterwards only when the
+* requested one is not the one of the machine.
+*/
+static inline uint8_t *
+tpointinst_coords_to_wkb_buf(TemporalInst *inst, uint8_t *buf, 
+	size_t coords_size, bool swap)
 {
-	char *tptr = (char*)(&t);
-	int i = 0;
-
-	if (sizeof(double) != WKB_DOUBLE_SIZE)
-	{
-		elog(ERROR, "Machine timestamp size is not %d bytes!", WKB_DOUBLE_SIZE);
-	}
+	GSERIALIZED *gs = (GSERIALIZED *) DatumGetPointer(temporalinst_value(inst));
+	memcpy(buf, gs_point_ptr(gs), coords_size);
+	memcpy(buf + coords_size, &inst->t, WKB_TIMESTAMP_SIZE);
+	if (swap)
+		wkb_buf_swap(buf, (int) (coords_size / WKB_DOUBLE_SIZE) + 1, 
+			WKB_DOUBLE_SIZE);
+	return buf + coords_size + WKB_TIMESTAMP_SIZE;
+}
 
-	if (variant & WKB_HEX)
-	{
-		int swap =  wkb_swap_bytes(variant);
-		/* Machine/request arch mismatch, so flip byte order */
-		for (i = 0; i < WKB_DOUBLE_SIZE; i++)
-		{
-			int j = (swap ? WKB_DOUBLE_SIZE - 1 - i : i);
-			uint8_t b = (uint8_t) tptr[j];
-			/* Top four bits to 0-F */
-			buf[2*i] = (uint8_t)hexchr[b >> 4];
-			/* Bottom four bits to 0-F */
-			buf[2*i + 1] = (uint8_t) hexchr[b & 0x0F];
-		}
-		return buf + (2 * WKB_DOUBLE_SIZE);
-	}
-	else
-	{
-		/* Machine/request arch mismatch, so flip byte order */
-		if (wkb_swap_bytes(variant))
-		{
-			for (i = 0; i < WKB_DOUBLE_SIZE; i++)
-			{
-				buf[i] = (uint8_t) tptr[WKB_DOUBLE_SIZE - 1 - i];
-			}
-		}
-		/* If machine arch and requested arch match, don't flip byte order */
-		else
-		{
-			memcpy(buf, tptr, WKB_DOUBLE_SIZE);
-		}
-		return buf + WKB_DOUBLE_SIZE;
-	}
+/* Size of the coordinates of the points of a temporal point */
+static inline size_t
+tpoint_coords_wkb_size(const Temporal *temp)
+{
+	if (sizeof(double) != WKB_DOUBLE_SIZE || 
+		sizeof(TimestampTz) != WKB_TIMESTAMP_SIZE)
+		elog(ERROR, "Machine double or timestamp size is not %d bytes!", 
+			WKB_DOUBLE_SIZE);
+	return (MOBDB_FLAGS_GET_Z(temp->flags) ? 3 : 2) * WKB_DOUBLE_SIZE;
 }
 
 static bool
@@ -976,17 +972,8 @@ tpoint_wkb_type(Temporal *temp, uint8_t *buf, uint8_t variant)
 		if (MOBDB_FLAGS_GET_LINEAR(temp->flags))
 			wkb_flags |= WKB_LINEAR_INTERP;
 	}
-	if (variant & WKB_HEX)
-	{
-		buf[0] = (uint8_t) hexchr[wkb_flags >> 4];
-		buf[1] = (uint8_t) hexchr[temp->duration];
-		return buf + 2;
-	}
-	else
-	{
-		buf[0] = (uint8_t) temp->duration + wkb_flags;
-		return buf + 1;
-	}
+	buf[0] = (uint8_t) temp->duration + wkb_flags;
+	return buf + 1;
 }
 
 static uint8_t *
@@ -999,21 +986,9 @@ tpointinst_to_wkb_buf(TemporalInst *inst, uint8_t *buf, uint8_t variant)
 	/* Set the optional SRID for extended variant */
 	if (tpoint_wkb_needs_srid((Temporal *)inst, variant))
 		buf = integer_to_wkb_buf(tpoint_srid_internal((Temporal *)inst), buf, variant);
-	/* Set the coordinates */
-	if (MOBDB_FLAGS_GET_Z(inst->flags))
-	{
-		POINT3DZ point = datum_get_point3dz(temporalinst_value(inst));
-		buf = double_to_wkb_buf(point.x, buf, variant);
-		buf = double_to_wkb_buf(point.y, buf, variant);
-		buf = double_to_wkb_buf(point.z, buf, variant);
-	}
-	else
-	{
-		POINT2D point = datum_get_point2d(temporalinst_value(inst));
-		buf = double_to_wkb_buf(point.x, buf, variant);
-		buf = double_to_wkb_buf(point.y, buf, variant);
-	}
-	buf = timestamp_to_wkb_buf(inst->t, buf, variant);
+	/* Set the coordinates and the timestamp */
+	buf = tpointinst_coords_to_wkb_buf(inst, buf, 
+		tpoint_coords_wkb_size((Temporal *)inst), wkb_swap_bytes(variant));
 	return buf;
 }
 
@@ -1030,47 +1005,40 @@ tpointi_to_wkb_buf(TemporalI *ti, uint8_t *buf, uint8_t variant)
 	/* Set the count */
 	buf = integer_to_wkb_buf(ti->count, buf, variant);
 	/* Set the TemporalInst array */
+	size_t coords_size = tpoint_coords_wkb_size((Temporal *)ti);
+	bool swap = wkb_swap_bytes(variant);
 	for (int i = 0; i < ti->count; i++)
-	{
-		TemporalInst *inst = temporali_inst_n(ti, i);
-		/* Set the coordinates */
-		if (MOBDB_FLAGS_GET_Z(inst->flags))
-		{
-			POINT3DZ point = datum_get_point3dz(temporalinst_value(inst));
-			buf = double_to_wkb_buf(point.x, buf, variant);
-			buf = double_to_wkb_buf(point.y, buf, variant);
-			buf = double_to_wkb_buf(point.z, buf, variant);
-		}
-		else
-		{
-			POINT2D point = datum_get_point2d(temporalinst_value(inst));
-			buf = double_to_wkb_buf(point.x, buf, variant);
-			buf = double_to_wkb_buf(point.y, buf, variant);
-		}
-		buf = timestamp_to_wkb_buf(inst->t, buf, variant);
-	}
+		buf = tpointinst_coords_to_wkb_buf(temporali_inst_n(ti, i), buf, 
+			coords_size, swap);
 	return buf;
 }
 
 static uint8_t *
-tpointseq_wkb_bounds(TemporalSeq *seq, uint8_t *buf, uint8_t variant)
+tpointseq_wkb_bounds(TemporalSeq *seq, uint8_t *buf)
 {
 	uint8_t wkb_flags = 0;
 	if (seq->period.lower_inc)
 		wkb_flags |= WKB_LOWER_INC;
 	if (seq->period.upper_inc)
 		wkb_flags |= WKB_UPPER_INC;
-	if (variant & WKB_HEX)
-	{
-		buf[0] = '0';
-		buf[1] = (uint8_t) hexchr[wkb_flags];
-		return buf + 2;
-	}
-	else
-	{
-		buf[0] = wkb_flags;
-		return buf + 1;
-	}
+	buf[0] = wkb_flags;
+	return buf + 1;
+}
+
+/* Number of instants, period bounds, and TemporalInst array of a sequence */
+static uint8_t *
+tpointseq_instants_to_wkb_buf(TemporalSeq *seq, uint8_t *buf, uint8_t variant,
+	size_t coords_size, bool swap)
+{
+	/* Set the count */
+	buf = integer_to_wkb_buf(seq->count, buf, variant);
+	/* Set the period bounds */
+	buf = tpointseq_wkb_bounds(seq, buf);
+	/* Set the TemporalInst array */
+	for (int i = 0; i < seq->count; i++)
+		buf = tpointinst_coords_to_wkb_buf(temporalseq_inst_n(seq, i), buf, 
+			coords_size, swap);
+	return buf;
 }
 
 static uint8_t *
@@ -1083,31 +1051,9 @@ tpointseq_to_wkb_buf(TemporalSeq *seq, uint8_t *buf, uint8_t variant)
 	/* Set the optional SRID for extended variant */
 	if (tpoint_wkb_needs_srid((Temporal *)seq, variant))
 		buf = integer_to_wkb_buf(tpoint_srid_internal((Temporal *)seq), buf, variant);
-	/* Set the count */
-	buf = integer_to_wkb_buf(seq->count, buf, variant);
-	/* Set the period bounds */
-	buf = tpointseq_wkb_bounds(seq, buf, variant);
-	/* Set the TemporalInst array */
-	for (int i = 0; i < seq->count; i++)
-	{
-		TemporalInst *inst = temporalseq_inst_n(seq, i);
-		/* Set the coordinates */
-		if (MOBDB_FLAGS_GET_Z(inst->flags))
-		{
-			POINT3DZ point = datum_get_point3dz(temporalinst_value(inst));
-			buf = double_to_wkb_buf(point.x, buf, variant);
-			buf = double_to_wkb_buf(point.y, buf, variant);
-			buf = double_to_wkb_buf(point.z, buf, variant);
-		}
-		else
-		{
-			POINT2D point = datum_get_point2d(temporalinst_value(inst));
-			buf = double_to_wkb_buf(point.x, buf, variant);
-			buf = double_to_wkb_buf(point.y, buf, variant);
-		}
-		buf = timestamp_to_wkb_buf(inst->t, buf, variant);
-	}
-	return buf;
+	/* Set the count, the period bounds, and the TemporalInst array */
+	return tpointseq_instants_to_wkb_buf(seq, buf, variant, 
+		tpoint_coords_wkb_size((Temporal *)seq), wkb_swap_bytes(variant));
 }
 
 static uint8_t *
@@ -1123,33 +1069,11 @@ tpoints_to_wkb_buf(TemporalS *ts, uint8_t *buf, uint8_t variant)
 	/* Set the count */
 	buf = integer_to_wkb_buf(ts->count, buf, variant);
 	/* Set the sequences */
+	size_t coords_size = tpoint_coords_wkb_size((Temporal *)ts);
+	bool swap = wkb_swap_bytes(variant);
 	for (int i = 0; i < ts->count; i++)
-	{
-		TemporalSeq *seq = temporals_seq_n(ts, i);
-		/* Set the number of instants */
-		buf = integer_to_wkb_buf(seq->count, buf, variant);
-		/* Set the period bounds */
-		buf = tpointseq_wkb_bounds(seq, buf, variant);
-		for (int j = 0; j < seq->count; j++)
-		{
-			TemporalInst *inst = temporalseq_inst_n(seq, j);
-			/* Set the coordinates */
-			if (MOBDB_FLAGS_GET_Z(inst->flags))
-			{
-				POINT3DZ point = datum_get_point3dz(temporalinst_value(inst));
-				buf = double_to_wkb_buf(point.x, buf, variant);
-				buf = double_to_wkb_buf(point.y, buf, variant);
-				buf = double_to_wkb_buf(point.z, buf, variant);
-			}
-			else
-			{
-				POINT2D point = datum_get_point2d(temporalinst_value(inst));
-				buf = double_to_wkb_buf(point.x, buf, variant);
-				buf = double_to_wkb_buf(point.y, buf, variant);
-			}
-			buf = timestamp_to_wkb_buf(inst->t, buf, variant);
-		}
-	}
+		buf = tpointseq_instants_to_wkb_buf(temporals_seq_n(ts, i), buf, 
+			variant, coords_size, swap);
 	return buf;
 }
 
@@ -1169,47 +1093,23 @@ tpoint_to_wkb_buf(const Temporal *temp, uint8_t *buf, uint8_t variant)
 }
 
 /**
-* Convert Temporal to a char* in WKB format. Caller is responsible for freeing
-* the returned array.
+* Convert Temporal to a bytea in WKB format. The WKB is written directly
+* after the varlena header of the result.
 *
 * @param variant. Unsigned bitmask value. Accepts one of: WKB_ISO, WKB_EXTENDED, WKB_SFSQL.
 * Accepts any of: WKB_NDR, WKB_HEX. For example: Variant = (WKB_ISO | WKB_NDR) would
 * return the little-endian ISO form of WKB. For Example: Variant = (WKB_EXTENDED | WKB_HEX)
-* would return the big-endian extended form of WKB, as hex-encoded ASCII (the "canonical form").
-* @param size_out If supplied, will return the size of the returned memory segment,
-* including the null terminator in the case of ASCII.
+* would return the big-endian extended form of WKB, as hex-encoded ASCII (the "canonical form"),
+* in which case the result is a text without null terminator.
 */
 
-static uint8_t *
-tpoint_to_wkb(const Temporal *temp, uint8_t variant, size_t *size_out)
+static struct varlena *
+tpoint_to_wkb(const Temporal *temp, uint8_t variant)
 {
-	size_t buf_size;
-	uint8_t *buf = NULL;
-	uint8_t *wkb_out = NULL;
-
-	/* Initialize output size */
-	if (size_out) *size_out = 0;
-
-	if (temp == NULL)
-	{
-		elog(ERROR, "Cannot convert NULL into WKB.");
-		return NULL;
-	}
-
 	/* Calculate the required size of the output buffer */
-	buf_size = tpoint_to_wkb_size(temp, variant);
-
-	if (buf_size == 0)
-	{
+	size_t size = tpoint_to_wkb_size(temp, variant);
+	if (size == 0)
 		elog(ERROR, "Error calculating output WKB buffer size.");
-		return NULL;
-	}
-
-	/* Hex string takes twice as much space as binary + a null character */
-	if (variant & WKB_HEX)
-	{
-		buf_size = 2 * buf_size + 1;
-	}
 
 	/* If neither or both variants are specified, choose the native order */
 	if (! (variant & WKB_NDR || variant & WKB_XDR) ||
@@ -1221,78 +1121,54 @@ tpoint_to_wkb(const Temporal *temp, uint8_t variant, size_t *size_out)
 			variant = variant | (uint8_t) WKB_XDR;
 	}
 
-	/* Allocate the buffer */
-	buf = palloc(buf_size);
-
-	if (buf == NULL)
-	{
-		elog(ERROR, "Unable to allocate %lu bytes for WKB output buffer.", buf_size);
-		return NULL;
-	}
-
-	/* Retain a pointer to the front of the buffer for later */
-	wkb_out = buf;
+	/* Hex string takes twice as much space as binary. In that case the 
+	 * binary form is written in the second half of the buffer and encoded 
+	 * in place */
+	size_t result_size = (variant & WKB_HEX) ? 2 * size : size;
+	struct varlena *result = palloc(result_size + VARHDRSZ);
+	uint8_t *wkb = (uint8_t *) VARDATA(result) + (result_size - size);
 
 	/* Write the WKB into the output buffer */
-	buf = tpoint_to_wkb_buf(temp, buf, variant);
-
-	/* Null the last byte if this is a hex output */
-	if (variant & WKB_HEX)
-	{
-		*buf = '\0';
-		buf++;
-	}
+	uint8_t *end = tpoint_to_wkb_buf(temp, wkb, variant);
 
 	/* The buffer pointer should now land at the end of the allocated buffer space. Let's check. */
-	if (buf_size != (size_t) (buf - wkb_out))
-	{
+	if (size != (size_t) (end - wkb))
 		elog(ERROR, "Output WKB is not the same size as the allocated buffer.");
-		pfree(wkb_out);
-		return NULL;
-	}
 
-	/* Report output size */
-	if (size_out) *size_out = buf_size;
-
-	return wkb_out;
+	if (variant & WKB_HEX)
+		hex_to_buf(wkb, size, (uint8_t *) VARDATA(result));
+	SET_VARSIZE(result, result_size + VARHDRSZ);
+	return result;
 }
 
-/*
- * This will have no 'SRID=#;'
- */
-PG_FUNCTION_INFO_V1(tpoint_as_binary);
-
-PGDLLEXPORT Datum
-tpoint_as_binary(PG_FUNCTION_ARGS)
+/* Get the endianness requested by the user, if any */
+static uint8_t
+wkb_endian_variant(FunctionCallInfo fcinfo)
 {
-	Temporal *temp = PG_GETARG_TEMPORAL(0);
-	uint8_t *wkb;
-	size_t wkb_size;
 	uint8_t variant = 0;
- 	bytea *result;
-	text *type;
 	/* If user specified endianness, respect it */
 	if ((PG_NARGS() > 1) && (!PG_ARGISNULL(1)))
 	{
-		type = PG_GETARG_TEXT_P(1);
-
+		text *type = PG_GETARG_TEXT_P(1);
 		if (! strncmp(VARDATA(type), "xdr", 3) ||
 			! strncmp(VARDATA(type), "XDR", 3))
 			variant = variant | (uint8_t) WKB_XDR;
 		else
 			variant = variant | (uint8_t) WKB_NDR;
 	}
-	wkb_size = VARSIZE_ANY_EXHDR(temp);
-	/* Create WKB hex string */
-	wkb = tpoint_to_wkb(temp, variant, &wkb_size);
+	return variant;
+}
 
-	/* Prepare the PgSQL text return type */
-	result = palloc(wkb_size + VARHDRSZ);
-	memcpy(VARDATA(result), wkb, wkb_size);
-	SET_VARSIZE(result, wkb_size + VARHDRSZ);
+/*
+ * This will have no 'SRID=#;'
+ */
+PG_FUNCTION_INFO_V1(tpoint_as_binary);
 
-	/* Clean up and return */
-	pfree(wkb);
+PGDLLEXPORT Datum
+tpoint_as_binary(PG_FUNCTION_ARGS)
+{
+	Temporal *temp = PG_GETARG_TEMPORAL(0);
+	bytea *result = tpoint_to_wkb(temp, wkb_endian_variant(fcinfo));
 	PG_FREE_IF_COPY(temp, 0);
 	PG_RETURN_BYTEA_P(result);
 }
@@ -1306,33 +1182,8 @@ PGDLLEXPORT Datum
 tpoint_as_ewkb(PG_FUNCTION_ARGS)
 {
 	Temporal *temp = PG_GETARG_TEMPORAL(0);
-	uint8_t *wkb;
-	size_t wkb_size;
-	uint8_t variant = 0;
- 	bytea *result;
-	text *type;
-	/* If user specified endianness, respect it */
-	if ((PG_NARGS() > 1) && (!PG_ARGISNULL(1)))
-	{
-		type = PG_GETARG_TEXT_P(1);
-
-		if (! strncmp(VARDATA(type), "xdr", 3) ||
-			! strncmp(VARDATA(type), "XDR", 3))
-			variant = variant | (uint8_t) WKB_XDR;
-		else
-			variant = variant | (uint8_t) WKB_NDR;
-	}
-	wkb_size = VARSIZE_ANY_EXHDR(temp);
-	/* Create WKB hex string */
-	wkb = tpoint_to_wkb(temp, variant | (uint8_t) WKB_EXTENDED, &wkb_size);
-
-	/* Prepare the PgSQL text return type */
-	result = palloc(wkb_size + VARHDRSZ);
-	memcpy(VARDATA(result), wkb, wkb_size);
-	SET_VARSIZE(result, wkb_size + VARHDRSZ);
-
-	/* Clean up and return */
-	pfree(wkb);
+	bytea *result = tpoint_to_wkb(temp, 
+		wkb_endian_variant(fcinfo) | (uint8_t) WKB_EXTENDED);
 	PG_FREE_IF_COPY(temp, 0);
 	PG_RETURN_BYTEA_P(result);
 }
@@ -1346,34 +1197,8 @@ PGDLLEXPORT Datum
 tpoint_as_hexewkb(PG_FUNCTION_ARGS)
 {
 	Temporal *temp = PG_GETARG_TEMPORAL(0);
-	char *hexwkb;
-	size_t hexwkb_size;
-	uint8_t variant = 0;
-	text *result;
-	text *type;
-	size_t text_size;
-	/* If user specified endianness, respect it */
-	if ((PG_NARGS() > 1) && (!PG_ARGISNULL(1)))
-	{
-		type = PG_GETARG_TEXT_P(1);
-		if (! strncmp(VARDATA(type), "xdr", 3) ||
-			! strncmp(VARDATA(type), "XDR", 3))
-			variant = variant | (uint8_t) WKB_XDR;
-		else
-			variant = variant | (uint8_t) WKB_NDR;
-	}
-
-	/* Create WKB hex string */
-	hexwkb = (char *)tpoint_to_wkb(temp, variant | (uint8_t) WKB_EXTENDED | (uint8_t) WKB_HEX, &hexwkb_size);
-
-	/* Prepare the PgSQL text return type */
-	text_size = hexwkb_size - 1 + VARHDRSZ;
-	result = palloc(text_size);
-	memcpy(VARDATA(result), hexwkb, hexwkb_size - 1);
-	SET_VARSIZE(result, text_size);
-
-	/* Clean up and return */
-	pfree(hexwkb);
+	text *result = tpoint_to_wkb(temp, wkb_endian_variant(fcinfo) | 
+		(uint8_t) WKB_EXTENDED | (uint8_t) WKB_HEX);
 	PG_FREE_IF_COPY(temp, 0);
 	PG_RETURN_TEXT_P(result);
 }
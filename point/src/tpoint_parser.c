@@ -242,17 +242,88 @@ stbox_parse(char **str)
 
 /*****************************************************************************/
 
+/* Parse a point in the format [SRID=n;]POINT[ Z](x y[ z]), which is the one
+ * of the output function, up to and including the '@' that follows it. This
+ * avoids copying the value and calling the WKT parser of PostGIS for every
+ * instant. Returns NULL without consuming input for any other format, e.g.,
+ * hexadecimal (E)WKB, or for geographies requiring the checks made by the
+ * input function of PostGIS, in which case that function is called */
+static GSERIALIZED *
+point_parse_fast(char **str, Oid basetype)
+{
+	bool geodetic = (basetype == type_oid(T_GEOGRAPHY));
+	int srid = SRID_UNKNOWN, ncoords = 0;
+	bool hasz = false;
+	double coords[3];
+	char *s = *str;
+
+	if (strncasecmp(s, "SRID=", 5) == 0)
+	{
+		char *end;
+		s += 5;
+		long l = strtol(s, &end, 10);
+		if (end == s || *end != ';' || l <= 0 || l > SRID_USER_MAXIMUM)
+			return NULL;
+		srid = (int) l;
+		s = end + 1;
+	}
+	if (strncasecmp(s, "POINT", 5) != 0)
+		return NULL;
+	s += 5;
+	p_whitespace(&s);
+	if (*s == 'Z' || *s == 'z')
+	{
+		hasz = true;
+		s++;
+	}
+	if (! p_oparen(&s))
+		return NULL;
+	while (ncoords < 3 && p_double(&s, &coords[ncoords]))
+	{
+		ncoords++;
+		/* Coordinates must be separated by whitespace */
+		if (*s != ' ' && *s != '\t' && *s != '\n' && *s != '\r' && *s != ')')
+			return NULL;
+	}
+	if (! p_cparen(&s) || ncoords < 2 || (hasz && ncoords < 3))
+		return NULL;
+	p_whitespace(&s);
+	if (*s != '@')
+		return NULL;
+	if (geodetic)
+	{
+		if (srid == SRID_UNKNOWN)
+			srid = SRID_DEFAULT;
+		if (srid != SRID_DEFAULT || coords[0] < -180.0 || coords[0] > 180.0 ||
+			coords[1] < -90.0 || coords[1] > 90.0)
+			return NULL;
+	}
+
+	LWPOINT *lwpoint = (ncoords == 3) ?
+		lwpoint_make3dz(srid, coords[0], coords[1], coords[2]) :
+		lwpoint_make2d(srid, coords[0], coords[1]);
+	FLAGS_SET_GEODETIC(lwpoint->flags, geodetic);
+	GSERIALIZED *result = geometry_serialize((LWGEOM *) lwpoint);
+	pfree(lwpoint);
+	*str = s + 1;
+	return result;
+}
+
 static TemporalInst *
 tpointinst_parse(char **str, Oid basetype, bool end, int *tpoint_srid) 
 {
 	p_whitespace(str);
-	/* The next instruction will throw an exception if it fails */
-	Datum geo = basetype_parse(str, basetype); 
-	GSERIALIZED *gs = (GSERIALIZED *)PG_DETOAST_DATUM(geo);
+	GSERIALIZED *gs = point_parse_fast(str, basetype);
+	if (gs == NULL)
+	{
+		/* The next instruction will throw an exception if it fails */
+		Datum geo = basetype_parse(str, basetype); 
+		gs = (GSERIALIZED *)PG_DETOAST_DATUM(geo);
+		ensure_point_type(gs);
+		ensure_non_empty(gs);
+		ensure_has_not_M(gs);
+	}
 	int geo_srid = gserialized_get_srid(gs);
-	ensure_point_type(gs);
-	ensure_non_empty(gs);
-	ensure_has_not_M(gs);
 	if (*tpoint_srid != SRID_UNKNOWN && geo_srid != SRID_UNKNOWN && *tpoint_srid != geo_srid)
 		ereport(ERROR, (errcode(ERRCODE_INVALID_TEXT_REPRESENTATION), 
 			errmsg("Geometry SRID (%d) does not match temporal type SRID (%d)", 
@@ -286,6 +357,45 @@ tpointinst_parse(char **str, Oid basetype, bool end, int *tpoint_srid)
 	return result;
 }
 
+/* Parse a list of instants separated by commas in a single pass. The array
+ * is enlarged with repalloc when needed */
+static TemporalInst **
+tpointinstarr_parse(char **str, Oid basetype, int *tpoint_srid, int *count) 
+{
+	int n = 0, maxcount = 16;
+	TemporalInst **instants = palloc(sizeof(TemporalInst *) * maxcount);
+	do
+	{
+		if (n == maxcount)
+		{
+			maxcount *= 2;
+			instants = repalloc(instants, sizeof(TemporalInst *) * maxcount);
+		}
+		instants[n++] = tpointinst_parse(str, basetype, false, tpoint_srid);
+	} while (p_comma(str));
+	*count = n;
+	return instants;
+}
+
+/* Set the SRID of the temporal point to the instants that were parsed before
+ * an instant stating the SRID was found */
+static void
+tpointinstarr_set_srid(TemporalInst **instants, int count, Oid basetype,
+	int tpoint_srid) 
+{
+	if (tpoint_srid == SRID_UNKNOWN)
+		return;
+	int srid_unknown = (basetype == type_oid(T_GEOMETRY)) ? 
+		SRID_UNKNOWN : SRID_DEFAULT;
+	for (int i = 0; i < count; i++)
+	{
+		GSERIALIZED *gs = (GSERIALIZED *)DatumGetPointer(
+			temporalinst_value(instants[i]));
+		if (gserialized_get_srid(gs) == srid_unknown)
+			gserialized_set_srid(gs, tpoint_srid);
+	}
+}
+
 static TemporalI *
 tpointi_parse(char **str, Oid basetype, int *tpoint_srid) 
 {
@@ -294,17 +404,9 @@ tpointi_parse(char **str, Oid basetype, int *tpoint_srid)
 	 * to call this function in the dispatch function tpoint_parse */
 	p_obrace(str);
 
-	/* First parsing */
-	char *bak = *str;
-	TemporalInst *inst = tpointinst_parse(str, basetype, false, tpoint_srid);
-	int count = 1;
-	while (p_comma(str)) 
-	{
-		count++;
-		pfree(inst);
-		inst = tpointinst_parse(str, basetype, false, tpoint_srid);
-	}
-	pfree(inst);
+	int count;
+	TemporalInst **insts = tpointinstarr_parse(str, basetype, tpoint_srid, 
+		&count);
 	if (!p_cbrace(str))
 		ereport(ERROR, (errcode(ERRCODE_INVALID_TEXT_REPRESENTATION), 
 			errmsg("Could not parse temporal value")));
@@ -313,15 +415,8 @@ tpointi_parse(char **str, Oid basetype, int *tpoint_srid)
 	if (**str != 0)
 		ereport(ERROR, (errcode(ERRCODE_INVALID_TEXT_REPRESENTATION), 
 			errmsg("Could not parse temporal value")));
-	/* Second parsing */
-	*str = bak;
-	TemporalInst **insts = palloc(sizeof(TemporalInst *) * count);
-	for (int i = 0; i < count; i++) 
-	{
-		p_comma(str);
-		insts[i] = tpointinst_parse(str, basetype, false, tpoint_srid);
-	}
-	p_cbrace(str);
+
+	tpointinstarr_set_srid(insts, count, basetype, *tpoint_srid);
 	TemporalI *result = temporali_from_temporalinstarr(insts, count);
 
 	for (int i = 0; i < count; i++)
@@ -331,56 +426,46 @@ tpointi_parse(char **str, Oid basetype, int *tpoint_srid)
 	return result;
 }
 
-static TemporalSeq *
-tpointseq_parse(char **str, Oid basetype, bool linear, bool end, int *tpoint_srid) 
+/* Parse the bounds and the instants of a sequence. The sequence itself is
+ * constructed by the caller once the SRID of the temporal point is known */
+static TemporalInst **
+tpointseq_parse_instants(char **str, Oid basetype, int *tpoint_srid, 
+	int *count, bool *lower_inc, bool *upper_inc) 
 {
 	p_whitespace(str);
-	bool lower_inc = false, upper_inc = false;
 	/* We are sure to find an opening bracket or parenthesis because that was 
 	 * the condition to call this function in the dispatch function tpoint_parse */
 	if (p_obracket(str))
-		lower_inc = true;
+		*lower_inc = true;
 	else if (p_oparen(str))
-		lower_inc = false;
+		*lower_inc = false;
 
-	/* First parsing */
-	char *bak = *str;
-	TemporalInst *inst = tpointinst_parse(str, basetype, false, tpoint_srid);
-	int count = 1;
-	while (p_comma(str)) 
-	{
-		count++;
-		pfree(inst);
-		inst = tpointinst_parse(str, basetype, false, tpoint_srid);
-	}
-	pfree(inst);
+	TemporalInst **insts = tpointinstarr_parse(str, basetype, tpoint_srid, 
+		count);
 	if (p_cbracket(str))
-		upper_inc = true;
+		*upper_inc = true;
 	else if (p_cparen(str))
-		upper_inc = false;
+		*upper_inc = false;
 	else
 		ereport(ERROR, (errcode(ERRCODE_INVALID_TEXT_REPRESENTATION), 
 			errmsg("Could not parse temporal value")));
-	if (end)
-	{
-		/* Ensure there is no more input */
-		p_whitespace(str);
-		if (**str != 0)
-			ereport(ERROR, (errcode(ERRCODE_INVALID_TEXT_REPRESENTATION), 
-				errmsg("Could not parse temporal value")));
-	}
-	/* Second parsing */
-	*str = bak; 
-	TemporalInst **insts = palloc(sizeof(TemporalInst *) * count);
-	for (int i = 0; i < count; i++) 
-	{
-		p_comma(str);
-		insts[i] = tpointinst_parse(str, basetype, false, tpoint_srid);
-	}
+	return insts;
+}
 
-	p_cbracket(str);
-	p_cparen(str);
+static TemporalSeq *
+tpointseq_parse(char **str, Oid basetype, bool linear, int *tpoint_srid) 
+{
+	int count;
+	bool lower_inc = false, upper_inc = false;
+	TemporalInst **insts = tpointseq_parse_instants(str, basetype, tpoint_srid,
+		&count, &lower_inc, &upper_inc);
+	/* Ensure there is no more input */
+	p_whitespace(str);
+	if (**str != 0)
+		ereport(ERROR, (errcode(ERRCODE_INVALID_TEXT_REPRESENTATION), 
+			errmsg("Could not parse temporal value")));
 
+	tpointinstarr_set_srid(insts, count, basetype, *tpoint_srid);
 	TemporalSeq *result = temporalseq_from_temporalinstarr(insts, 
 		count, lower_inc, upper_inc, linear, true);
 
@@ -399,17 +484,27 @@ tpoints_parse(char **str, Oid basetype, bool linear, int *tpoint_srid)
 	 * to call this function in the dispatch function tpoint_parse */
 	p_obrace(str);
 
-	/* First parsing */
-	char *bak = *str;
-	TemporalSeq *seq = tpointseq_parse(str, basetype, linear, false, tpoint_srid);
-	int count = 1;
-	while (p_comma(str)) 
+	/* The instants of all sequences are collected before constructing the 
+	 * sequences since an instant stating the SRID may come in any of them */
+	int count = 0, maxcount = 16;
+	TemporalInst ***insts = palloc(sizeof(TemporalInst **) * maxcount);
+	int *counts = palloc(sizeof(int) * maxcount);
+	bool *lower_inc = palloc(sizeof(bool) * maxcount);
+	bool *upper_inc = palloc(sizeof(bool) * maxcount);
+	do
 	{
+		if (count == maxcount)
+		{
+			maxcount *= 2;
+			insts = repalloc(insts, sizeof(TemporalInst **) * maxcount);
+			counts = repalloc(counts, sizeof(int) * maxcount);
+			lower_inc = repalloc(lower_inc, sizeof(bool) * maxcount);
+			upper_inc = repalloc(upper_inc, sizeof(bool) * maxcount);
+		}
+		insts[count] = tpointseq_parse_instants(str, basetype, tpoint_srid,
+			&counts[count], &lower_inc[count], &upper_inc[count]);
 		count++;
-		pfree(seq);
-		seq = tpointseq_parse(str, basetype, linear, false, tpoint_srid);
-	}
-	pfree(seq);
+	} while (p_comma(str));
 	if (!p_cbrace(str))
 		ereport(ERROR, (errcode(ERRCODE_INVALID_TEXT_REPRESENTATION), 
 			errmsg("Could not parse temporal value")));
@@ -418,21 +513,27 @@ tpoints_parse(char **str, Oid basetype, bool linear, int *tpoint_srid)
 	if (**str != 0)
 		ereport(ERROR, (errcode(ERRCODE_INVALID_TEXT_REPRESENTATION), 
 			errmsg("Could not parse temporal value")));
-	/* Second parsing */
-	*str = bak;
+
 	TemporalSeq **seqs = palloc(sizeof(TemporalSeq *) * count);
-	for (int i = 0; i < count; i++) 
+	for (int i = 0; i < count; i++)
 	{
-		p_comma(str);
-		seqs[i] = tpointseq_parse(str, basetype, linear, false, tpoint_srid);
+		tpointinstarr_set_srid(insts[i], counts[i], basetype, *tpoint_srid);
+		seqs[i] = temporalseq_from_temporalinstarr(insts[i], counts[i], 
+			lower_inc[i], upper_inc[i], linear, true);
+		for (int j = 0; j < counts[i]; j++)
+			pfree(insts[i][j]);
+		pfree(insts[i]);
 	}
-	p_cbrace(str);
 	TemporalS *result = temporals_from_temporalseqarr(seqs, count, 
 		linear, true);
 
 	for (int i = 0; i < count; i++)
 		pfree(seqs[i]);
 	pfree(seqs);
+	pfree(insts);
+	pfree(counts);
+	pfree(lower_inc);
+	pfree(upper_inc);
 
 	return result;
 }
@@ -488,7 +589,7 @@ tpoint_parse(char **str, Oid basetype)
 		result = (Temporal *)tpointinst_parse(str, basetype, true, &tpoint_srid);
 	}
 	else if (**str == '[' || **str == '(')
-		result = (Temporal *)tpointseq_parse(str, basetype, linear, true, &tpoint_srid);		
+		result = (Temporal *)tpointseq_parse(str, basetype, linear, &tpoint_srid);		
 	else if (**str == '{')
 	{
 		bak = *str;
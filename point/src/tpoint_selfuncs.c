@@ -14,9 +14,11 @@
 
 #include <assert.h>
 #include <float.h>
+#include <math.h>
 
 #include "period.h"
 #include "temporal_selfuncs.h"
+#include "time_selfuncs.h"
 #include "stbox.h"
 #include "tpoint.h"
 #include "tpoint_boxops.h"
@@ -637,6 +639,44 @@ default_tpoint_selectivity(CachedOp operator)
 	}
 }
 
+/*
+ * Returns a copy of the histogram of the given kind of a temporal point 
+ * column, or NULL if there are no statistics for it.
+ */
+static ND_STATS *
+tpoint_nd_stats(VariableStatData *vardata, int kind)
+{
+	AttStatsSlot sslot;
+	ND_STATS *nd_stats;
+
+	/* Currently PostGIS does not set the associated staopN so we
+	 * can pass InvalidOid */
+	if (!(HeapTupleIsValid(vardata->statsTuple) &&
+		  get_attstatsslot(&sslot, vardata->statsTuple, kind,
+			InvalidOid, ATTSTATSSLOT_NUMBERS)))
+		return NULL;
+
+	/* Clone the stats here so we can release the attstatsslot immediately */
+	nd_stats = palloc(sizeof(float4) * sslot.nnumbers);
+	memcpy(nd_stats, sslot.numbers, sizeof(float4) * sslot.nnumbers);
+	free_attstatsslot(&sslot);
+	return nd_stats;
+}
+
+/*
+ * Returns a copy of the spatial histogram of a temporal point column. The
+ * ND histogram is only collected for columns with Z dimension, otherwise
+ * the 2D histogram is used.
+ */
+static ND_STATS *
+tpoint_spatial_stats(VariableStatData *vardata)
+{
+	ND_STATS *nd_stats = tpoint_nd_stats(vardata, STATISTIC_KIND_ND);
+	if (nd_stats == NULL)
+		nd_stats = tpoint_nd_stats(vardata, STATISTIC_KIND_2D);
+	return nd_stats;
+}
+
 /*
  * This function returns an estimate of the selectivity of a search STBOX by
  * looking at data in the ND_STATS structure. The selectivity is a float from 
@@ -654,7 +694,6 @@ static float8
 calc_geo_selectivity(VariableStatData *vardata, const STBOX *box, CachedOp op)
 {
 	ND_STATS *nd_stats;
-	AttStatsSlot sslot;	
 	int d; /* counter */
 	float8 selectivity;
 	ND_BOX nd_box;
@@ -673,19 +712,11 @@ calc_geo_selectivity(VariableStatData *vardata, const STBOX *box, CachedOp op)
 	bool bboxop = (op == OVERLAPS_OP || op == CONTAINS_OP ||
 		op == CONTAINED_OP || op == SAME_OP);
 
-	/* Get statistics 
-	 * Currently PostGIS does not set the associated staopN so we
-	 * can pass InvalidOid */
-	if (!(HeapTupleIsValid(vardata->statsTuple) &&
-		  get_attstatsslot(&sslot, vardata->statsTuple, STATISTIC_KIND_ND, 
-			InvalidOid, ATTSTATSSLOT_NUMBERS)))
+	/* Get statistics */
+	nd_stats = tpoint_spatial_stats(vardata);
+	if (nd_stats == NULL)
 		return -1;
 
-	/* Clone the stats here so we can release the attstatsslot immediately */
-	nd_stats = palloc(sizeof(float4) * sslot.nnumbers);
-	memcpy(nd_stats, sslot.numbers, sizeof(float4) * sslot.nnumbers);
-
-	free_attstatsslot(&sslot);		
 	/* Calculate the number of common coordinate dimensions  on the histogram */
 	ndims_max = (int) Max(nd_stats->ndims, MOBDB_FLAGS_GET_Z(box->flags) ? 3 : 2);
 
@@ -843,6 +874,230 @@ calc_geo_selectivity(VariableStatData *vardata, const STBOX *box, CachedOp op)
 	return selectivity;
 }
 
+/*
+ * This function returns an estimate of the join selectivity of the bounding
+ * box operators between two temporal point columns by looking at the data in
+ * their ND_STATS structures.
+ *
+ * To get our estimate, we traverse the cells of the histogram with the
+ * fewest cells and, for each of them, sum up the values of the cells of the
+ * other histogram that overlap it pro-rated by the overlap, and then divide
+ * by the number of pairs of not null features.
+ *
+ * This function is a port of PostGIS function estimate_join_selectivity in
+ * file gserialized_estimate.c
+ */
+static float8
+calc_geo_joinselectivity(const ND_STATS *s1, const ND_STATS *s2)
+{
+	const ND_STATS *stats_tmp;
+	ND_IBOX ibox1, ibox2;
+	int at1[ND_DIMS], at2[ND_DIMS];
+	double min1[ND_DIMS], cellsize1[ND_DIMS];
+	double min2[ND_DIMS], cellsize2[ND_DIMS];
+	double ntuples_not_null1, ntuples_not_null2;
+	double val = 0.0;
+	float8 selectivity;
+	int ndims, d;
+
+	ndims = (int) Max(s1->ndims, s2->ndims);
+
+	/* If the extents of the two histograms do not intersect there is no join */
+	if (! nd_box_intersects(&(s1->extent), &(s2->extent), ndims))
+		return 0.0;
+
+	/* We want to iterate through the histogram with the fewest cells */
+	if (s1->histogram_cells > s2->histogram_cells)
+	{
+		stats_tmp = s1;
+		s1 = s2;
+		s2 = stats_tmp;
+	}
+
+	/* Work out some measurements of the histograms */
+	for (d = 0; d < ndims; d++)
+	{
+		min1[d] = s1->extent.min[d];
+		min2[d] = s2->extent.min[d];
+		cellsize1[d] = (s1->extent.max[d] - s1->extent.min[d]) / s1->size[d];
+		cellsize2[d] = (s2->extent.max[d] - s2->extent.min[d]) / s2->size[d];
+	}
+
+	/* Find the cells of s1 that overlap the extent of s2 */
+	if (! nd_box_overlap(s1, &(s2->extent), &ibox1))
+		return FALLBACK_ND_JOINSEL;
+
+	/* Initialize the counter */
+	memset(at1, 0, sizeof(int) * ND_DIMS);
+	for (d = 0; d < ndims; d++)
+		at1[d] = ibox1.min[d];
+
+	/* Move through all the overlapping cells of s1 */
+	do
+	{
+		double val1;
+		ND_BOX nd_cell1;
+		memset(&nd_cell1, 0, sizeof(ND_BOX));
+
+		for (d = 0; d < ndims; d++)
+		{
+			nd_cell1.min[d] = (float4) (min1[d] + (at1[d]+0) * cellsize1[d]);
+			nd_cell1.max[d] = (float4) (min1[d] + (at1[d]+1) * cellsize1[d]);
+		}
+
+		/* Find the cells of s2 that overlap the cell of s1 */
+		if (! nd_box_overlap(s2, &nd_cell1, &ibox2))
+			return FALLBACK_ND_JOINSEL;
+
+		memset(at2, 0, sizeof(int) * ND_DIMS);
+		for (d = 0; d < ndims; d++)
+			at2[d] = ibox2.min[d];
+
+		val1 = s1->value[nd_stats_value_index(s1, at1)];
+
+		/* Add the pro-rated counts of the cells of s2 */
+		do
+		{
+			double ratio2, val2;
+			ND_BOX nd_cell2;
+			memset(&nd_cell2, 0, sizeof(ND_BOX));
+
+			for (d = 0; d < ndims; d++)
+			{
+				nd_cell2.min[d] = (float4) (min2[d] + (at2[d]+0) * cellsize2[d]);
+				nd_cell2.max[d] = (float4) (min2[d] + (at2[d]+1) * cellsize2[d]);
+			}
+			ratio2 = nd_box_ratio_overlaps(&nd_cell1, &nd_cell2, ndims);
+			val2 = s2->value[nd_stats_value_index(s2, at2)];
+			val += val1 * (val2 * ratio2);
+		}
+		while (nd_increment(&ibox2, ndims, at2));
+	}
+	while (nd_increment(&ibox1, ndims, at1));
+
+	/* Scale by the ratio of sample to table features */
+	val *= (s1->table_features / s1->sample_features);
+	val *= (s2->table_features / s2->sample_features);
+
+	/* Divide by the number of pairs of not null features */
+	ntuples_not_null1 = s1->table_features *
+		(s1->not_null_features / s1->sample_features);
+	ntuples_not_null2 = s2->table_features *
+		(s2->not_null_features / s2->sample_features);
+	selectivity = val / (ntuples_not_null1 * ntuples_not_null2);
+
+	/* Guard against NaN and infinite values */
+	if (isnan(selectivity) || ! isfinite(selectivity) || selectivity < 0.0)
+		selectivity = FALLBACK_ND_JOINSEL;
+	else if (selectivity > 1.0)
+		selectivity = 1.0;
+
+	return selectivity;
+}
+
+/*
+ * This function returns an estimate of the selectivity of the bounding box
+ * operators for a search STBOX with both spatial and time dimensions by 
+ * looking at the joint histogram of the spatial and time dimensions. 
+ * Contrary to multiplying the spatial and the time selectivities, this
+ * takes into account the correlation between both dimensions. Returns -1
+ * if the joint histogram is not available.
+ */
+static float8
+calc_xyt_selectivity(VariableStatData *vardata, const STBOX *box)
+{
+	AttStatsSlot sslot;
+	TimestampTz tmin;
+	ND_STATS *nd_stats;
+	ND_BOX nd_box;
+	ND_IBOX nd_ibox;
+	int at[ND_DIMS];
+	double cell_size[ND_DIMS];
+	double min[ND_DIMS];
+	double total_count = 0.0;
+	float8 selectivity;
+	int ndims, d;
+
+	/* The only value of the slot is the origin of the time dimension */
+	if (!(HeapTupleIsValid(vardata->statsTuple) &&
+		  get_attstatsslot(&sslot, vardata->statsTuple, 
+			STATISTIC_KIND_XYT_HISTOGRAM, InvalidOid, 
+			ATTSTATSSLOT_NUMBERS | ATTSTATSSLOT_VALUES)))
+		return -1;
+	if (sslot.nvalues != 1)
+	{
+		free_attstatsslot(&sslot);
+		return -1;
+	}
+	tmin = DatumGetTimestampTz(sslot.values[0]);
+	nd_stats = palloc(sizeof(float4) * sslot.nnumbers);
+	memcpy(nd_stats, sslot.numbers, sizeof(float4) * sslot.nnumbers);
+	free_attstatsslot(&sslot);
+	ndims = (int) nd_stats->ndims;
+
+	/* The time dimension comes after the spatial ones */
+	nd_box_from_stbox(box, &nd_box);
+	if (ndims == 4 && ! MOBDB_FLAGS_GET_Z(box->flags))
+	{
+		/* A box without Z dimension does not restrict it */
+		nd_box.min[Z_DIM] = nd_stats->extent.min[Z_DIM];
+		nd_box.max[Z_DIM] = nd_stats->extent.max[Z_DIM];
+	}
+	nd_box.min[ndims - 1] = (float4) period_to_secs(box->tmin, tmin);
+	nd_box.max[ndims - 1] = (float4) period_to_secs(box->tmax, tmin);
+
+	/* Full histogram extent op box is false or true? */
+	if (! nd_box_intersects(&(nd_stats->extent), &nd_box, ndims))
+	{
+		pfree(nd_stats);
+		return 0.0;
+	}
+	if (nd_box_contains(&nd_box, &(nd_stats->extent), ndims))
+	{
+		pfree(nd_stats);
+		return 1.0;
+	}
+
+	/* Calculate the overlap of the box on the histogram */
+	nd_box_overlap(nd_stats, &nd_box, &nd_ibox);
+
+	/* Work out some measurements of the histogram */
+	memset(at, 0, sizeof(int) * ND_DIMS);
+	for (d = 0; d < ndims; d++)
+	{
+		min[d] = nd_stats->extent.min[d];
+		cell_size[d] = (nd_stats->extent.max[d] - min[d]) / nd_stats->size[d];
+		at[d] = nd_ibox.min[d];
+	}
+
+	/* Move through all the overlap values and sum them */
+	do
+	{
+		ND_BOX nd_cell;
+		memset(&nd_cell, 0, sizeof(ND_BOX));
+
+		/* We have to pro-rate partially overlapped cells. */
+		for (d = 0; d < ndims; d++)
+		{
+			nd_cell.min[d] = (float4) (min[d] + (at[d]+0) * cell_size[d]);
+			nd_cell.max[d] = (float4) (min[d] + (at[d]+1) * cell_size[d]);
+		}
+		total_count += nd_stats->value[nd_stats_value_index(nd_stats, at)] *
+			nd_box_ratio_overlaps(&nd_box, &nd_cell, ndims);
+	}
+	while (nd_increment(&nd_ibox, ndims, at));
+
+	/* Scale by the number of features in our histogram to get the proportion */
+	selectivity = total_count / nd_stats->histogram_features;
+	pfree(nd_stats);
+
+	/* Prevent rounding overflows */
+	if (selectivity > 1.0) selectivity = 1.0;
+	else if (selectivity < 0.0) selectivity = 0.0;
+
+	return selectivity;
+}
+
 /*****************************************************************************/
 
 PG_FUNCTION_INFO_V1(tpoint_sel);
@@ -924,6 +1179,22 @@ tpoint_sel(PG_FUNCTION_ARGS)
 
 	assert(MOBDB_FLAGS_GET_X(constBox.flags) || MOBDB_FLAGS_GET_T(constBox.flags));
 	
+	/*
+	 * Estimate the selectivity of the bounding box operators for both 
+	 * dimensions with the joint histogram when it is available
+	 */
+	if (MOBDB_FLAGS_GET_X(constBox.flags) && MOBDB_FLAGS_GET_T(constBox.flags) &&
+		(cachedOp == OVERLAPS_OP || cachedOp == CONTAINS_OP ||
+		 cachedOp == CONTAINED_OP || cachedOp == SAME_OP))
+	{
+		selec = calc_xyt_selectivity(&vardata, &constBox);
+		if (selec >= 0.0)
+		{
+			ReleaseVariableStats(vardata);
+			PG_RETURN_FLOAT8(selec);
+		}
+	}
+
 	/* Enable the multiplication of the selectivity of the spatial and time 
 	 * dimensions since either may be missing */
 	selec = 1.0; 
@@ -964,7 +1235,70 @@ PG_FUNCTION_INFO_V1(tpoint_joinsel);
 PGDLLEXPORT Datum
 tpoint_joinsel(PG_FUNCTION_ARGS)
 {
-	PG_RETURN_FLOAT8(DEFAULT_TEMP_SELECTIVITY);
+	PlannerInfo *root = (PlannerInfo *) PG_GETARG_POINTER(0);
+	Oid operator = PG_GETARG_OID(1);
+	List *args = (List *) PG_GETARG_POINTER(2);
+	JoinType jointype = (JoinType) PG_GETARG_INT16(3);
+	SpecialJoinInfo *sjinfo = (SpecialJoinInfo *) PG_GETARG_POINTER(4);
+	VariableStatData vardata1, vardata2;
+	ND_STATS *nd_stats1, *nd_stats2;
+	bool join_is_reversed, found = false;
+	CachedOp cachedOp;
+	double selec = 1.0, timesel;
+
+	/* In the case of unknown operator */
+	if (!tpoint_cachedop(operator, &cachedOp))
+		PG_RETURN_FLOAT8(DEFAULT_TEMP_SELECTIVITY);
+
+	/* Only inner joins between two arguments are estimated */
+	if (jointype != JOIN_INNER || list_length(args) != 2)
+		PG_RETURN_FLOAT8(default_tpoint_selectivity(cachedOp));
+
+	get_join_variables(root, args, sjinfo, &vardata1, &vardata2,
+		&join_is_reversed);
+
+	/*
+	 * Estimate selectivity for the spatial dimension. As for the restriction
+	 * selectivity, the histograms do not allow us to differentiate between
+	 * the bounding box operators.
+	 */
+	if (cachedOp == OVERLAPS_OP || cachedOp == CONTAINS_OP ||
+		cachedOp == CONTAINED_OP || cachedOp == SAME_OP)
+	{
+		nd_stats1 = tpoint_spatial_stats(&vardata1);
+		nd_stats2 = tpoint_spatial_stats(&vardata2);
+		if (nd_stats1 != NULL && nd_stats2 != NULL)
+		{
+			selec *= calc_geo_joinselectivity(nd_stats1, nd_stats2);
+			found = true;
+		}
+		if (nd_stats1 != NULL)
+			pfree(nd_stats1);
+		if (nd_stats2 != NULL)
+			pfree(nd_stats2);
+	}
+
+	/*
+	 * Estimate selectivity for the time dimension
+	 */
+	timesel = calc_period_hist_joinselectivity(&vardata1, &vardata2, cachedOp);
+	if (timesel >= 0.0)
+	{
+		/* The spatial estimate already excludes the NULL values */
+		if (! found)
+			timesel *= temporal_notnullfrac(&vardata1) *
+				temporal_notnullfrac(&vardata2);
+		selec *= timesel;
+		found = true;
+	}
+
+	ReleaseVariableStats(vardata1);
+	ReleaseVariableStats(vardata2);
+
+	if (! found)
+		selec = default_tpoint_selectivity(cachedOp);
+	CLAMP_PROBABILITY(selec);
+	PG_RETURN_FLOAT8(selec);
 }
 
 /*****************************************************************************/
@@ -14,6 +14,7 @@
 
 #include <assert.h>
 #include <float.h>
+#include <math.h>
 #include <utils/builtins.h>
 #include <utils/timestamp.h>
 
@@ -22,6 +23,7 @@
 #include "temporaltypes.h"
 #include "oidcache.h"
 #include "temporal_util.h"
+#include "temporal_stats.h"
 #include "lifting.h"
 #include "tnumber_mathfuncs.h"
 #include "tpoint.h"
@@ -126,13 +128,25 @@ ensure_has_not_M(GSERIALIZED *gs)
  * that has been already detoasted with PG_GETARG_TEMPORAL* 
  */
 
+/*
+ * Pointer to the coordinates of a serialized point. The coordinates follow
+ * the type and the number of points, which requires the serialized geometry 
+ * to be a point without a bounding box, as are the values of temporal points.
+ */
+
+uint8_t *
+gs_point_ptr(GSERIALIZED *gs)
+{
+	assert(! FLAGS_GET_BBOX(gs->flags) && gserialized_get_type(gs) == POINTTYPE);
+	return (uint8_t *) gs->data + 8;
+}
+
 /* Get 2D point from a serialized geometry */
 
 POINT2D
 gs_get_point2d(GSERIALIZED *gs)
 {
-	POINT2D *point = (POINT2D *)((uint8_t*)gs->data + 8);
-	return *point;
+	return *((POINT2D *) gs_point_ptr(gs));
 }
 
 /* Get 2D point from a datum */
@@ -140,8 +154,7 @@ POINT2D
 datum_get_point2d(Datum geom)
 {
 	GSERIALIZED *gs = (GSERIALIZED *)DatumGetPointer(geom);
-	POINT2D *point = (POINT2D *)((uint8_t*)gs->data + 8);
-	return *point;
+	return *((POINT2D *) gs_point_ptr(gs));
 }
 
 /* Get 3DZ point from a serialized geometry */
@@ -149,8 +162,7 @@ datum_get_point2d(Datum geom)
 POINT3DZ
 gs_get_point3dz(GSERIALIZED *gs)
 {
-	POINT3DZ *point = (POINT3DZ *)((uint8_t*)gs->data + 8);
-	return *point;
+	return *((POINT3DZ *) gs_point_ptr(gs));
 }
 
 /* Get 3DZ point from a datum */
@@ -252,6 +264,204 @@ geom_to_geog(Datum value)
 	return call_function1(geography_from_geometry, value);
 }
 
+/*****************************************************************************
+ * Streaming synchronization of two temporal geometry point sequences.
+ * The cursor walks the instants of both sequences in lockstep over the
+ * intersection of their periods and exposes at each synchronization
+ * timestamp the raw coordinates of both values. Contrary to the function
+ * synchronize_temporalseq_temporalseq, no synchronized copy of the sequences
+ * is materialized and no intermediate GSERIALIZED is constructed.
+ *****************************************************************************/
+
+/* Get the coordinates of a temporal geometry point instant */
+
+static void
+tgeompointinst_point3dz(TemporalInst *inst, bool hasz, POINT3DZ *p)
+{
+	GSERIALIZED *gs = (GSERIALIZED *)DatumGetPointer(temporalinst_value(inst));
+	if (hasz)
+		*p = gs_get_point3dz(gs);
+	else
+	{
+		POINT2D p2d = gs_get_point2d(gs);
+		p->x = p2d.x;
+		p->y = p2d.y;
+		p->z = 0.0;
+	}
+}
+
+/* Distance between two points given by their coordinates */
+
+double
+point3dz_distance(const POINT3DZ *p1, const POINT3DZ *p2, bool hasz)
+{
+	double dx = p2->x - p1->x;
+	double dy = p2->y - p1->y;
+	if (hasz)
+	{
+		double dz = p2->z - p1->z;
+		return sqrt(dx * dx + dy * dy + dz * dz);
+	}
+	return sqrt(dx * dx + dy * dy);
+}
+
+/* Point located at a fraction of the segment between two points */
+
+void
+point3dz_interpolate(const POINT3DZ *start, const POINT3DZ *end, double ratio,
+	POINT3DZ *result)
+{
+	result->x = start->x + (end->x - start->x) * ratio;
+	result->y = start->y + (end->y - start->y) * ratio;
+	result->z = start->z + (end->z - start->z) * ratio;
+}
+
+/* Returns the position of the first instant of the sequence at or after t */
+
+static int
+tpointseq_sync_find(TemporalSeq *seq, TimestampTz t)
+{
+	int first = 0, last = seq->count - 1;
+	while (first < last)
+	{
+		int middle = (first + last) / 2;
+		TemporalInst *inst = temporalseq_inst_n(seq, middle);
+		if (timestamp_cmp_internal(inst->t, t) < 0)
+			first = middle + 1;
+		else
+			last = middle;
+	}
+	return first;
+}
+
+/*
+ * Compute the value of the sequence at timestamp t, where *n is the position
+ * of an instant at or before the first instant at or after t. The position
+ * is advanced accordingly. The interpolation is the same as the one of
+ * temporalseq_value_at_timestamp1 for geometries.
+ */
+static void
+tpointseq_sync_value(TemporalSeq *seq, bool linear, bool hasz, TimestampTz t,
+	int *n, POINT3DZ *p)
+{
+	while (*n < seq->count - 1 &&
+		timestamp_cmp_internal(temporalseq_inst_n(seq, *n)->t, t) < 0)
+		(*n)++;
+	TemporalInst *inst2 = temporalseq_inst_n(seq, *n);
+	if (*n == 0 || timestamp_cmp_internal(inst2->t, t) == 0)
+	{
+		tgeompointinst_point3dz(inst2, hasz, p);
+		return;
+	}
+	TemporalInst *inst1 = temporalseq_inst_n(seq, *n - 1);
+	tgeompointinst_point3dz(inst1, hasz, p);
+	if (! linear)
+		return;
+	POINT3DZ p1 = *p, p2;
+	tgeompointinst_point3dz(inst2, hasz, &p2);
+	double ratio = (double) (t - inst1->t) / (double) (inst2->t - inst1->t);
+	point3dz_interpolate(&p1, &p2, ratio, p);
+}
+
+/*
+ * Position the cursor at the first synchronization timestamp. Returns false
+ * if the two sequences do not intersect in time.
+ */
+bool
+tpointseq_sync_init(TPointSeqSync *sync, TemporalSeq *seq1, TemporalSeq *seq2)
+{
+	Period *inter = intersection_period_period_internal(&seq1->period,
+		&seq2->period);
+	if (inter == NULL)
+		return false;
+
+	sync->seq1 = seq1;
+	sync->seq2 = seq2;
+	sync->linear1 = MOBDB_FLAGS_GET_LINEAR(seq1->flags);
+	sync->linear2 = MOBDB_FLAGS_GET_LINEAR(seq2->flags);
+	sync->hasz = MOBDB_FLAGS_GET_Z(seq1->flags);
+	sync->inter = *inter;
+	sync->t = inter->lower;
+	sync->last = timestamp_cmp_internal(inter->lower, inter->upper) == 0;
+	sync->i = tpointseq_sync_find(seq1, sync->t);
+	sync->j = tpointseq_sync_find(seq2, sync->t);
+	tpointseq_sync_value(seq1, sync->linear1, sync->hasz, sync->t, &sync->i,
+		&sync->p1);
+	tpointseq_sync_value(seq2, sync->linear2, sync->hasz, sync->t, &sync->j,
+		&sync->p2);
+	pfree(inter);
+	return true;
+}
+
+/*
+ * Advance the cursor to the next synchronization timestamp, that is, the
+ * next instant of any of the two sequences. Returns false when the upper
+ * bound of the intersection has been already reached.
+ */
+bool
+tpointseq_sync_next(TPointSeqSync *sync)
+{
+	if (sync->last)
+		return false;
+
+	TimestampTz next = sync->inter.upper;
+	TemporalInst *inst1 = temporalseq_inst_n(sync->seq1, sync->i);
+	if (timestamp_cmp_internal(inst1->t, sync->t) == 0 &&
+		sync->i < sync->seq1->count - 1)
+		inst1 = temporalseq_inst_n(sync->seq1, sync->i + 1);
+	if (timestamp_cmp_internal(inst1->t, sync->t) > 0 &&
+		timestamp_cmp_internal(inst1->t, next) < 0)
+		next = inst1->t;
+	TemporalInst *inst2 = temporalseq_inst_n(sync->seq2, sync->j);
+	if (timestamp_cmp_internal(inst2->t, sync->t) == 0 &&
+		sync->j < sync->seq2->count - 1)
+		inst2 = temporalseq_inst_n(sync->seq2, sync->j + 1);
+	if (timestamp_cmp_internal(inst2->t, sync->t) > 0 &&
+		timestamp_cmp_internal(inst2->t, next) < 0)
+		next = inst2->t;
+
+	POINT3DZ prev1 = sync->p1, prev2 = sync->p2;
+	sync->t = next;
+	sync->last = timestamp_cmp_internal(next, sync->inter.upper) == 0;
+	tpointseq_sync_value(sync->seq1, sync->linear1, sync->hasz, next,
+		&sync->i, &sync->p1);
+	tpointseq_sync_value(sync->seq2, sync->linear2, sync->hasz, next,
+		&sync->j, &sync->p2);
+	/* The last two values of sequences with stepwise interpolation and
+	   exclusive upper bound must be equal */
+	if (sync->last && ! sync->inter.upper_inc)
+	{
+		if (! sync->linear1)
+			sync->p1 = prev1;
+		if (! sync->linear2)
+			sync->p2 = prev2;
+	}
+	return true;
+}
+
+/*
+ * Returns the sequences composing a temporal point of sequence or sequence
+ * set duration. The array must be freed by the calling function.
+ */
+TemporalSeq **
+tpoint_sequences(Temporal *temp, int *count)
+{
+	TemporalSeq **result;
+	if (temp->duration == TEMPORALSEQ)
+	{
+		result = palloc(sizeof(TemporalSeq *));
+		result[0] = (TemporalSeq *)temp;
+		*count = 1;
+		return result;
+	}
+	TemporalS *ts = (TemporalS *)temp;
+	result = palloc(sizeof(TemporalSeq *) * ts->count);
+	for (int i = 0; i < ts->count; i++)
+		result[i] = temporals_seq_n(ts, i);
+	*count = ts->count;
+	return result;
+}
+
 /*****************************************************************************
  * Functions for spatial reference systems
  *****************************************************************************/
@@ -561,84 +771,117 @@ pointarr_make_trajectory(Datum *points, int count, bool linear)
 	return result;
 }
 
-/* Compute the trajectory of an array of instants.
- * This function is called by the constructor of a temporal sequence and
- * returns a single Datum which is a geometry */
-Datum
-tpointseq_make_trajectory(TemporalInst **instants, int count, bool linear)
+/* Compute the trajectory of an array of instants from the coordinates of
+ * their points. No intermediate geometry is deserialized and the points are
+ * copied once into the point array of the result. The coordinates of 
+ * geography points are read as those of geometry points */
+static Datum
+tgeompointinstarr_make_trajectory(TemporalInst **instants, int count,
+	bool linear)
 {
-	Oid valuetypid = instants[0]->valuetypid;
-	ensure_point_base_type(valuetypid);
-	bool geometry = (valuetypid == type_oid(T_GEOMETRY));
-	Datum *points = palloc(sizeof(Datum) * count);
-	int k;
-	if (linear)
-	{
-		/* Remove two consecutive points if they are equal */
-		Datum value1 = geometry ? temporalinst_value(instants[0]) :
-			call_function1(geometry_from_geography, temporalinst_value(instants[0]));
-		points[0] = value1;
-		k = 1;
-		for (int i = 1; i < count; i++)
-		{
-			Datum value2 = geometry ? temporalinst_value(instants[i]) :
-				call_function1(geometry_from_geography, temporalinst_value(instants[i]));
-			if (!datum_point_eq(value1, value2))
-				points[k++] = value2;
-			value1 = value2;
-		}
-	}
-	else
+	bool hasz = MOBDB_FLAGS_GET_Z(instants[0]->flags);
+	int srid = tpoint_srid_internal((Temporal *) instants[0]);
+	POINTARRAY *pa = ptarray_construct_empty(hasz, false, (uint32_t) count);
+	POINT3DZ *points = linear ? NULL : palloc(sizeof(POINT3DZ) * count);
+	int k = 0;
+	POINT3DZ p;
+	POINT4D p4d;
+	p4d.m = 0.0;
+	for (int i = 0; i < count; i++)
 	{
-		 /* Remove all duplicate points */
-		k = 0;
-		for (int i = 0; i < count; i++)
+		tgeompointinst_point3dz(instants[i], hasz, &p);
+		p4d.x = p.x; p4d.y = p.y; p4d.z = p.z;
+		if (linear)
+			/* Remove two consecutive points if they are equal */
+			ptarray_append_point(pa, &p4d, LW_FALSE);
+		else
 		{
-			Datum value = geometry ? temporalinst_value(instants[i]) :
-				call_function1(geometry_from_geography, temporalinst_value(instants[i]));
+			/* Remove all duplicate points */
 			bool found = false;
 			for (int j = 0; j < k; j++)
 			{
-				if (datum_point_eq(value, points[j]))
+				if (p.x == points[j].x && p.y == points[j].y && 
+					p.z == points[j].z)
 				{
 					found = true;
 					break;
 				}
 			}
 			if (!found)
-				points[k++] = value;
+			{
+				points[k++] = p;
+				ptarray_append_point(pa, &p4d, LW_TRUE);
+			}
 		}
 	}
-	Datum result;
-	if (geometry)
+	if (! linear)
+		pfree(points);
+	LWGEOM *traj;
+	if (pa->npoints == 1)
+		traj = (LWGEOM *) lwpoint_construct(srid, NULL, pa);
+	else if (linear)
+		traj = (LWGEOM *) lwline_construct(srid, NULL, pa);
+	else
 	{
-		if (k == 1)
-			result = PointerGetDatum(gserialized_copy(
-				(GSERIALIZED *) DatumGetPointer(points[0])));
-		else
-			result = pointarr_make_trajectory(points, k, linear);
+		traj = (LWGEOM *) lwmpoint_construct(srid, pa);
+		ptarray_free(pa);
 	}
-	else
+	Datum result = PointerGetDatum(geometry_serialize(traj));
+	lwgeom_free(traj);
+	return result;
+}
+
+/* Compute the trajectory of an array of instants.
+ * This function is called by the constructor of a temporal sequence and
+ * returns a single Datum which is a geometry */
+Datum
+tpointseq_make_trajectory(TemporalInst **instants, int count, bool linear)
+{
+	instr_time start;
+	MOBDB_STATS_START(start);
+	Oid valuetypid = instants[0]->valuetypid;
+	ensure_point_base_type(valuetypid);
+	Datum result = tgeompointinstarr_make_trajectory(instants, count, linear);
+	if (valuetypid == type_oid(T_GEOGRAPHY))
 	{
-		Datum geomresult;
-		if (k == 1)
-			geomresult = points[0];
-		else
-			geomresult = pointarr_make_trajectory(points, k, linear);
+		Datum geomresult = result;
 		result = call_function1(geography_from_geometry, geomresult);
+		pfree(DatumGetPointer(geomresult));
 	}
-	if (! geometry)
-		for (int i = 0; i < k; i++)
-			pfree(DatumGetPointer(points[i]));
-	pfree(points);
+	MOBDB_STATS_STOP(STAT_TRAJECTORIES, start);
 	return result;	
 }
 
-/* Get the precomputed trajectory of a tpointseq */
+/* Returns true if the trajectory of a tpointseq is precomputed */
+
+bool
+tpointseq_has_trajectory(TemporalSeq *seq)
+{
+	return ! MOBDB_FLAGS_GET_NOTRAJ(seq->flags);
+}
+
+/* Compute the trajectory of a tpointseq constructed without it */
+
+static Datum
+tpointseq_build_trajectory(TemporalSeq *seq)
+{
+	TemporalInst **instants = temporalseq_instants(seq);
+	Datum result = tpointseq_make_trajectory(instants, seq->count,
+		MOBDB_FLAGS_GET_LINEAR(seq->flags));
+	pfree(instants);
+	return result;
+}
+
+/* Get the precomputed trajectory of a tpointseq. If the sequence has been
+ * constructed without it, the trajectory is computed and must be freed by
+ * the calling function, which can be determined with the function
+ * tpointseq_has_trajectory */
 
 Datum
 tpointseq_trajectory(TemporalSeq *seq)
 {
+	if (! tpointseq_has_trajectory(seq))
+		return tpointseq_build_trajectory(seq);
 	void *traj = (char *)(&seq->offsets[seq->count + 2]) + 	/* start of data */
 			seq->offsets[seq->count + 1];					/* offset */
 	return PointerGetDatum(traj);
@@ -723,6 +966,8 @@ tpointseq_trajectory_append(TemporalSeq *seq, TemporalInst *inst, bool replace)
 Datum
 tpointseq_trajectory_copy(TemporalSeq *seq)
 {
+	if (! tpointseq_has_trajectory(seq))
+		return tpointseq_build_trajectory(seq);
 	void *traj = (char *)(&seq->offsets[seq->count + 2]) + 	/* start of data */
 			seq->offsets[seq->count + 1];					/* offset */
 	return PointerGetDatum(gserialized_copy(traj));
@@ -743,10 +988,15 @@ tgeompoints_trajectory(TemporalS *ts)
 	
 	Datum *points = palloc(sizeof(Datum) * ts->totalcount);
 	Datum *trajectories = palloc(sizeof(Datum) * ts->count);
-	int k = 0, l = 0;
+	/* Trajectories computed on demand, which are freed at the end */
+	Datum *built = palloc(sizeof(Datum) * ts->count);
+	int k = 0, l = 0, nbuilt = 0;
 	for (int i = 0; i < ts->count; i++)
 	{
-		Datum traj = tpointseq_trajectory(temporals_seq_n(ts, i));
+		TemporalSeq *seq = temporals_seq_n(ts, i);
+		Datum traj = tpointseq_trajectory(seq);
+		if (! tpointseq_has_trajectory(seq))
+			built[nbuilt++] = traj;
 		GSERIALIZED *gstraj = (GSERIALIZED *)DatumGetPointer(traj);
 		if (gserialized_get_type(gstraj) == POINTTYPE)
 		{
@@ -821,7 +1071,9 @@ tgeompoints_trajectory(TemporalS *ts)
 		result = call_function1(LWGEOM_collect_garray, PointerGetDatum(array));
 		pfree(array);
 	}
-	pfree(points); pfree(trajectories);
+	for (int i = 0; i < nbuilt; i++)
+		pfree(DatumGetPointer(built[i]));
+	pfree(points); pfree(trajectories); pfree(built);
 	return result;
 }
 
@@ -887,21 +1139,33 @@ static double
 tpointseq_length(TemporalSeq *seq)
 {
 	assert(MOBDB_FLAGS_GET_LINEAR(seq->flags));
+	ensure_point_base_type(seq->valuetypid);
+	if (seq->valuetypid == type_oid(T_GEOMETRY))
+	{
+		/* Sum the length of the segments as ST_Length does for the
+		 * trajectory, which works for 2D and 3D */
+		bool hasz = MOBDB_FLAGS_GET_Z(seq->flags);
+		double result = 0.0;
+		POINT3DZ p1, p2;
+		tgeompointinst_point3dz(temporalseq_inst_n(seq, 0), hasz, &p1);
+		for (int i = 1; i < seq->count; i++)
+		{
+			tgeompointinst_point3dz(temporalseq_inst_n(seq, i), hasz, &p2);
+			result += point3dz_distance(&p1, &p2, hasz);
+			p1 = p2;
+		}
+		return result;
+	}
+
+	/* The trajectory of temporal geography points is always precomputed */
 	Datum traj = tpointseq_trajectory(seq);
 	GSERIALIZED *gstraj = (GSERIALIZED *)DatumGetPointer(traj);
 	if (gserialized_get_type(gstraj) == POINTTYPE)
 		return 0;
 	
 	/* We are sure that the trajectory is a line */
-	double result = 0.0;
-	ensure_point_base_type(seq->valuetypid);
-	if (seq->valuetypid == type_oid(T_GEOMETRY))
-		/* The next function call works for 2D and 3D */
-		result = DatumGetFloat8(call_function1(LWGEOM_length_linestring, traj));
-	else if (seq->valuetypid == type_oid(T_GEOGRAPHY))
-		result = DatumGetFloat8(call_function2(geography_length, traj,
-			BoolGetDatum(true)));
-	return result;
+	return DatumGetFloat8(call_function2(geography_length, traj,
+		BoolGetDatum(true)));
 }
 
 static double
@@ -2703,6 +2967,121 @@ shortestline_tpoints_tpoints(TemporalS *ts1, TemporalS *ts2,
 
 /*****************************************************************************/
 
+/*
+ * Keep the values of the two sequences at the current position of the cursor
+ * if they are closer than the current minimum distance
+ */
+static void
+shortestline_sync_update(const POINT3DZ *p1, const POINT3DZ *p2, bool hasz,
+	bool *found, double *mindist, POINT3DZ *min1, POINT3DZ *min2)
+{
+	double dist = point3dz_distance(p1, p2, hasz);
+	if (! *found || dist < *mindist)
+	{
+		*found = true;
+		*mindist = dist;
+		*min1 = *p1;
+		*min2 = *p2;
+	}
+}
+
+/*
+ * Shortest line between two temporal geometry points of sequence or 
+ * sequence set duration. The sequences are walked in lockstep with the
+ * TPointSeqSync cursor and the minimum distance is computed at the
+ * synchronization points and at the turning points of each segment, 
+ * without synchronizing the values and computing their temporal distance
+ * first. Returns false if the temporal points do not intersect in time.
+ */
+static bool
+shortestline_tgeompoint_tgeompoint(Temporal *temp1, Temporal *temp2,
+	Datum *result)
+{
+	int count1, count2;
+	TemporalSeq **sequences1 = tpoint_sequences(temp1, &count1);
+	TemporalSeq **sequences2 = tpoint_sequences(temp2, &count2);
+	bool hasz = MOBDB_FLAGS_GET_Z(temp1->flags);
+	bool found = false;
+	double mindist = 0;
+	POINT3DZ min1, min2;
+	int i = 0, j = 0;
+	while (i < count1 && j < count2)
+	{
+		TemporalSeq *seq1 = sequences1[i];
+		TemporalSeq *seq2 = sequences2[j];
+		TPointSeqSync sync;
+		if (tpointseq_sync_init(&sync, seq1, seq2))
+		{
+			bool linear = sync.linear1 || sync.linear2;
+			shortestline_sync_update(&sync.p1, &sync.p2, hasz, &found,
+				&mindist, &min1, &min2);
+			POINT3DZ prev1 = sync.p1, prev2 = sync.p2;
+			TimestampTz lower = sync.t;
+			while (tpointseq_sync_next(&sync))
+			{
+				double fraction;
+				if (linear && tgeompoint_min_dist_fraction(&prev1, &sync.p1,
+					&prev2, &sync.p2, hasz, &fraction))
+				{
+					TimestampTz t = lower + 
+						(long) ((double)(sync.t - lower) * fraction);
+					double ratio = (double) (t - lower) / 
+						(double) (sync.t - lower);
+					POINT3DZ inter1 = prev1, inter2 = prev2;
+					if (sync.linear1)
+						point3dz_interpolate(&prev1, &sync.p1, ratio, &inter1);
+					if (sync.linear2)
+						point3dz_interpolate(&prev2, &sync.p2, ratio, &inter2);
+					shortestline_sync_update(&inter1, &inter2, hasz, &found,
+						&mindist, &min1, &min2);
+				}
+				shortestline_sync_update(&sync.p1, &sync.p2, hasz, &found,
+					&mindist, &min1, &min2);
+				prev1 = sync.p1;
+				prev2 = sync.p2;
+				lower = sync.t;
+			}
+		}
+		int cmp = timestamp_cmp_internal(seq1->period.upper, seq2->period.upper);
+		if (cmp == 0)
+		{
+			if (! seq1->period.upper_inc && seq2->period.upper_inc)
+				cmp = -1;
+			else if (seq1->period.upper_inc && ! seq2->period.upper_inc)
+				cmp = 1;
+		}
+		if (cmp == 0)
+		{
+			i++; j++;
+		}
+		else if (cmp < 0)
+			i++;
+		else
+			j++;
+	}
+	pfree(sequences1); pfree(sequences2);
+	if (! found)
+		return false;
+
+	int srid = tpoint_srid_internal(temp1);
+	LWGEOM *lwgeoms[2];
+	if (hasz)
+	{
+		lwgeoms[0] = (LWGEOM *) lwpoint_make3dz(srid, min1.x, min1.y, min1.z);
+		lwgeoms[1] = (LWGEOM *) lwpoint_make3dz(srid, min2.x, min2.y, min2.z);
+	}
+	else
+	{
+		lwgeoms[0] = (LWGEOM *) lwpoint_make2d(srid, min1.x, min1.y);
+		lwgeoms[1] = (LWGEOM *) lwpoint_make2d(srid, min2.x, min2.y);
+	}
+	LWLINE *line = lwline_from_lwgeom_array(srid, 2, lwgeoms);
+	*result = PointerGetDatum(geometry_serialize((LWGEOM *)line));
+	lwgeom_free(lwgeoms[0]); lwgeom_free(lwgeoms[1]);
+	lwline_free(line);
+	return true;
+}
+
 PG_FUNCTION_INFO_V1(shortestline_tpoint_tpoint);
 
 PGDLLEXPORT Datum
@@ -2712,6 +3091,21 @@ shortestline_tpoint_tpoint(PG_FUNCTION_ARGS)
 	Temporal *temp2 = PG_GETARG_TEMPORAL(1);
 	ensure_same_srid_tpoint(temp1, temp2);
 	ensure_same_dimensionality_tpoint(temp1, temp2);
+	/* Temporal geometry points of sequence (set) duration are processed
+	   without synchronizing them first */
+	if (temp1->valuetypid == type_oid(T_GEOMETRY) &&
+		(temp1->duration == TEMPORALSEQ || temp1->duration == TEMPORALS) &&
+		(temp2->duration == TEMPORALSEQ || temp2->duration == TEMPORALS))
+	{
+		Datum result;
+		bool found = shortestline_tgeompoint_tgeompoint(temp1, temp2, &result);
+		PG_FREE_IF_COPY(temp1, 0);
+		PG_FREE_IF_COPY(temp2, 1);
+		if (! found)
+			PG_RETURN_NULL();
+		PG_RETURN_DATUM(result);
+	}
+
 	Temporal *sync1, *sync2;
 	/* Return NULL if the temporal points do not intersect in time */
 	if (!synchronize_temporal_temporal(temp1, temp2, &sync1, &sync2, true))
@@ -25,6 +25,9 @@
 
 #include "tpoint_spatialrels.h"
 
+#include <float.h>
+#include <math.h>
+
 #include "temporaltypes.h"
 #include "oidcache.h"
 #include "temporal_util.h"
@@ -241,6 +244,250 @@ dwithin_tpoints_tpoints(TemporalS *ts1, TemporalS *ts2, Datum d,
 	return false;
 }
 
+/*****************************************************************************
+ * Native evaluation of intersects and dwithin between a 2D temporal geometry
+ * point and a point or a linestring. The segments of the temporal point are
+ * scanned with bounding box pruning and the scan stops as soon as one 
+ * segment satisfies the predicate. In this way, neither the trajectory of
+ * the temporal point nor any other GSERIALIZED is constructed. The distance
+ * computations follow those of PostGIS while intersects uses the sign of
+ * the orientation of the points as in GEOS.
+ *****************************************************************************/
+
+typedef struct
+{
+	const POINT2D **points;		/* points of the geometry */
+	int			count;			/* number of points of the geometry */
+	double		xmin;			/* bounding box of the geometry */
+	double		xmax;
+	double		ymin;
+	double		ymax;
+	double		dist;			/* distance for dwithin */
+	bool		dwithin;		/* dwithin or intersects */
+} SegRelGeo;
+
+static double
+segrel_pt_pt_dist(const POINT2D *p, const POINT2D *q)
+{
+	double dx = q->x - p->x;
+	double dy = q->y - p->y;
+	return sqrt(dx * dx + dy * dy);
+}
+
+/* Distance between a point and a segment as in lw_dist2d_pt_seg */
+
+static double
+segrel_pt_seg_dist(const POINT2D *p, const POINT2D *a, const POINT2D *b)
+{
+	if (a->x == b->x && a->y == b->y)
+		return segrel_pt_pt_dist(p, a);
+	double r = ((p->x - a->x) * (b->x - a->x) + (p->y - a->y) * (b->y - a->y)) /
+		((b->x - a->x) * (b->x - a->x) + (b->y - a->y) * (b->y - a->y));
+	if (r < 0)
+		return segrel_pt_pt_dist(p, a);
+	if (r > 1)
+		return segrel_pt_pt_dist(p, b);
+	POINT2D c;
+	c.x = a->x + r * (b->x - a->x);
+	c.y = a->y + r * (b->y - a->y);
+	return segrel_pt_pt_dist(p, &c);
+}
+
+/* Distance between two segments as in lw_dist2d_seg_seg */
+
+static double
+segrel_seg_seg_dist(const POINT2D *a, const POINT2D *b, const POINT2D *c,
+	const POINT2D *d)
+{
+	if (a->x == b->x && a->y == b->y)
+		return segrel_pt_seg_dist(a, c, d);
+	if (c->x == d->x && c->y == d->y)
+		return segrel_pt_seg_dist(c, a, b);
+
+	double r_top = (a->y - c->y) * (d->x - c->x) - (a->x - c->x) * (d->y - c->y);
+	double r_bot = (b->x - a->x) * (d->y - c->y) - (b->y - a->y) * (d->x - c->x);
+	double s_top = (a->y - c->y) * (b->x - a->x) - (a->x - c->x) * (b->y - a->y);
+	if (r_bot != 0)
+	{
+		double r = r_top / r_bot;
+		double s = s_top / r_bot;
+		/* The segments intersect */
+		if (r >= 0 && r <= 1 && s >= 0 && s <= 1)
+			return 0.0;
+	}
+	/* The segments are parallel or do not intersect */
+	return Min(Min(segrel_pt_seg_dist(a, c, d), segrel_pt_seg_dist(b, c, d)),
+		Min(segrel_pt_seg_dist(c, a, b), segrel_pt_seg_dist(d, a, b)));
+}
+
+/* Side of point p with respect to the line defined by a and b */
+
+static int
+segrel_side(const POINT2D *a, const POINT2D *b, const POINT2D *p)
+{
+	double side = (p->x - a->x) * (b->y - a->y) - (b->x - a->x) * (p->y - a->y);
+	return (side < 0) ? -1 : ((side > 0) ? 1 : 0);
+}
+
+static bool
+segrel_pt_on_seg(const POINT2D *p, const POINT2D *a, const POINT2D *b)
+{
+	return segrel_side(a, b, p) == 0 &&
+		p->x >= Min(a->x, b->x) && p->x <= Max(a->x, b->x) &&
+		p->y >= Min(a->y, b->y) && p->y <= Max(a->y, b->y);
+}
+
+static bool
+segrel_seg_seg_intersects(const POINT2D *a, const POINT2D *b,
+	const POINT2D *c, const POINT2D *d)
+{
+	int s1 = segrel_side(a, b, c), s2 = segrel_side(a, b, d);
+	int s3 = segrel_side(c, d, a), s4 = segrel_side(c, d, b);
+	/* Proper intersection */
+	if (s1 * s2 < 0 && s3 * s4 < 0)
+		return true;
+	/* An endpoint of a segment is located on the other segment */
+	return segrel_pt_on_seg(c, a, b) || segrel_pt_on_seg(d, a, b) ||
+		segrel_pt_on_seg(a, c, d) || segrel_pt_on_seg(b, c, d);
+}
+
+/*
+ * Test whether the segment defined by the points a and b satisfies the 
+ * relationship with the geometry. A single point is given by b == a.
+ */
+static bool
+segrel_seg_geo(const POINT2D *a, const POINT2D *b, const SegRelGeo *geo)
+{
+	double d = geo->dwithin ? geo->dist : 0.0;
+	double xmin = Min(a->x, b->x) - d, xmax = Max(a->x, b->x) + d;
+	double ymin = Min(a->y, b->y) - d, ymax = Max(a->y, b->y) + d;
+	/* Bounding box pruning with respect to the whole geometry */
+	if (xmax < geo->xmin || xmin > geo->xmax || 
+		ymax < geo->ymin || ymin > geo->ymax)
+		return false;
+
+	if (geo->count == 1)
+	{
+		const POINT2D *p = geo->points[0];
+		return geo->dwithin ? segrel_pt_seg_dist(p, a, b) <= d :
+			segrel_pt_on_seg(p, a, b);
+	}
+	for (int i = 1; i < geo->count; i++)
+	{
+		const POINT2D *c = geo->points[i - 1];
+		const POINT2D *e = geo->points[i];
+		/* Bounding box pruning with respect to the segment */
+		if (xmax < Min(c->x, e->x) || xmin > Max(c->x, e->x) ||
+			ymax < Min(c->y, e->y) || ymin > Max(c->y, e->y))
+			continue;
+		if (geo->dwithin ? segrel_seg_seg_dist(a, b, c, e) <= d :
+			segrel_seg_seg_intersects(a, b, c, e))
+			return true;
+	}
+	return false;
+}
+
+static bool
+segrel_tpointinst_geo(TemporalInst *inst, const SegRelGeo *geo)
+{
+	POINT2D p = datum_get_point2d(temporalinst_value(inst));
+	return segrel_seg_geo(&p, &p, geo);
+}
+
+static bool
+segrel_tpointseq_geo(TemporalSeq *seq, const SegRelGeo *geo)
+{
+	TemporalInst *inst1 = temporalseq_inst_n(seq, 0);
+	if (seq->count == 1 || ! MOBDB_FLAGS_GET_LINEAR(seq->flags))
+	{
+		for (int i = 0; i < seq->count; i++)
+		{
+			if (segrel_tpointinst_geo(temporalseq_inst_n(seq, i), geo))
+				return true;
+		}
+		return false;
+	}
+	POINT2D p1 = datum_get_point2d(temporalinst_value(inst1));
+	for (int i = 1; i < seq->count; i++)
+	{
+		TemporalInst *inst2 = temporalseq_inst_n(seq, i);
+		POINT2D p2 = datum_get_point2d(temporalinst_value(inst2));
+		if (segrel_seg_geo(&p1, &p2, geo))
+			return true;
+		p1 = p2;
+	}
+	return false;
+}
+
+/*
+ * Evaluate intersects or dwithin between a temporal point and a geometry.
+ * Returns false in *applies if the native evaluation does not apply to the
+ * arguments, that is, if they are not a 2D temporal geometry point and a
+ * point or a linestring. Negative distances are left to PostGIS, which
+ * raises the corresponding error.
+ */
+static bool
+segrel_tpoint_geo(Temporal *temp, GSERIALIZED *gs, double dist, bool dwithin,
+	bool *applies)
+{
+	int geotype = gserialized_get_type(gs);
+	*applies = temp->valuetypid == type_oid(T_GEOMETRY) &&
+		! MOBDB_FLAGS_GET_Z(temp->flags) &&
+		(geotype == POINTTYPE || geotype == LINETYPE) &&
+		(! dwithin || dist >= 0);
+	if (! *applies)
+		return false;
+
+	LWGEOM *lwgeom = lwgeom_from_gserialized(gs);
+	POINTARRAY *pa = (geotype == POINTTYPE) ? 
+		lwgeom_as_lwpoint(lwgeom)->point : lwgeom_as_lwline(lwgeom)->points;
+	SegRelGeo geo;
+	geo.count = pa->npoints;
+	geo.points = palloc(sizeof(POINT2D *) * geo.count);
+	geo.xmin = geo.ymin = DBL_MAX;
+	geo.xmax = geo.ymax = -DBL_MAX;
+	for (int i = 0; i < geo.count; i++)
+	{
+		const POINT2D *p = getPoint2d_cp(pa, i);
+		geo.points[i] = p;
+		geo.xmin = Min(geo.xmin, p->x); geo.xmax = Max(geo.xmax, p->x);
+		geo.ymin = Min(geo.ymin, p->y); geo.ymax = Max(geo.ymax, p->y);
+	}
+	geo.dist = dist;
+	geo.dwithin = dwithin;
+
+	/* Bounding box pruning with respect to the whole temporal point */
+	STBOX box;
+	memset(&box, 0, sizeof(STBOX));
+	temporal_bbox(&box, temp);
+	double d = dwithin ? dist : 0.0;
+	bool result = false;
+	if (box.xmax + d >= geo.xmin && box.xmin - d <= geo.xmax &&
+		box.ymax + d >= geo.ymin && box.ymin - d <= geo.ymax)
+	{
+		ensure_valid_duration(temp->duration);
+		if (temp->duration == TEMPORALINST)
+			result = segrel_tpointinst_geo((TemporalInst *)temp, &geo);
+		else if (temp->duration == TEMPORALI)
+		{
+			TemporalI *ti = (TemporalI *)temp;
+			for (int i = 0; i < ti->count && ! result; i++)
+				result = segrel_tpointinst_geo(temporali_inst_n(ti, i), &geo);
+		}
+		else if (temp->duration == TEMPORALSEQ)
+			result = segrel_tpointseq_geo((TemporalSeq *)temp, &geo);
+		else /* temp->duration == TEMPORALS */
+		{
+			TemporalS *ts = (TemporalS *)temp;
+			for (int i = 0; i < ts->count && ! result; i++)
+				result = segrel_tpointseq_geo(temporals_seq_n(ts, i), &geo);
+		}
+	}
+	pfree(geo.points);
+	lwgeom_free(lwgeom);
+	return result;
+}
+
 /*****************************************************************************
  * Generic functions
  * The functions that have two temporal points as arguments suppose that they
@@ -248,13 +495,33 @@ dwithin_tpoints_tpoints(TemporalS *ts1, TemporalS *ts2, Datum d,
  * this, they have the same timeframe and they are of the same duration.
  *****************************************************************************/
 
+/* 
+ * The precomputed trajectory of a sequence is kept with it and thus it is 
+ * not copied 
+ */
+static Datum
+tpoint_trajectory_ref(Temporal *temp)
+{
+	if (temp->duration == TEMPORALSEQ)
+		return tpointseq_trajectory((TemporalSeq *)temp);
+	return tpoint_trajectory_internal(temp);
+}
+
+static void
+tpoint_trajectory_free(Temporal *temp, Datum traj)
+{
+	if (temp->duration != TEMPORALSEQ || 
+		! tpointseq_has_trajectory((TemporalSeq *)temp))
+		pfree(DatumGetPointer(traj));
+}
+
 static Datum
 spatialrel_tpoint_geo(Temporal *temp, Datum geo,
 	Datum (*func)(Datum, Datum), bool invert)
 {
-	Datum traj = tpoint_trajectory_internal(temp);
+	Datum traj = tpoint_trajectory_ref(temp);
 	Datum result = invert ? func(geo, traj) : func(traj, geo);
-	pfree(DatumGetPointer(traj));
+	tpoint_trajectory_free(temp, traj);
 	return result;
 }
  
@@ -262,9 +529,9 @@ static Datum
 spatialrel3_tpoint_geo(Temporal *temp, Datum geo, Datum param,
 	Datum (*func)(Datum, Datum, Datum), bool invert)
 {
-	Datum traj = tpoint_trajectory_internal(temp);
+	Datum traj = tpoint_trajectory_ref(temp);
 	Datum result = invert ? func(geo, traj, param) : func(traj, geo, param);
-	pfree(DatumGetPointer(traj));
+	tpoint_trajectory_free(temp, traj);
 	return result;
 }
 
@@ -853,6 +1120,14 @@ intersects_geo_tpoint(PG_FUNCTION_ARGS)
 		PG_FREE_IF_COPY(temp, 1);
 		PG_RETURN_NULL();
 	}
+	bool applies;
+	bool found = segrel_tpoint_geo(temp, gs, 0.0, false, &applies);
+	if (applies)
+	{
+		PG_FREE_IF_COPY(gs, 0);
+		PG_FREE_IF_COPY(temp, 1);
+		PG_RETURN_BOOL(found);
+	}
 	Datum (*func)(Datum, Datum) = NULL;
 	ensure_point_base_type(temp->valuetypid);
 	if (temp->valuetypid == type_oid(T_GEOMETRY))
@@ -886,6 +1161,14 @@ intersects_tpoint_geo(PG_FUNCTION_ARGS)
 		PG_FREE_IF_COPY(gs, 1);
 		PG_RETURN_NULL();
 	}
+	bool applies;
+	bool found = segrel_tpoint_geo(temp, gs, 0.0, false, &applies);
+	if (applies)
+	{
+		PG_FREE_IF_COPY(temp, 0);
+		PG_FREE_IF_COPY(gs, 1);
+		PG_RETURN_BOOL(found);
+	}
 	Datum (*func)(Datum, Datum) = NULL;
 	ensure_point_base_type(temp->valuetypid);
 	if (temp->valuetypid == type_oid(T_GEOMETRY))
@@ -1172,6 +1455,15 @@ dwithin_geo_tpoint(PG_FUNCTION_ARGS)
 		PG_FREE_IF_COPY(temp, 1);
 		PG_RETURN_NULL();
 	}
+	bool applies;
+	bool found = segrel_tpoint_geo(temp, gs, DatumGetFloat8(dist), true,
+		&applies);
+	if (applies)
+	{
+		PG_FREE_IF_COPY(gs, 0);
+		PG_FREE_IF_COPY(temp, 1);
+		PG_RETURN_BOOL(found);
+	}
 	Datum (*func)(Datum, Datum, Datum) = NULL;
 	ensure_point_base_type(temp->valuetypid);
 	if (temp->valuetypid == type_oid(T_GEOMETRY))
@@ -1206,6 +1498,15 @@ dwithin_tpoint_geo(PG_FUNCTION_ARGS)
 		PG_FREE_IF_COPY(gs, 1);
 		PG_RETURN_NULL();
 	}
+	bool applies;
+	bool found = segrel_tpoint_geo(temp, gs, DatumGetFloat8(dist), true,
+		&applies);
+	if (applies)
+	{
+		PG_FREE_IF_COPY(temp, 0);
+		PG_FREE_IF_COPY(gs, 1);
+		PG_RETURN_BOOL(found);
+	}
 	Datum (*func)(Datum, Datum, Datum) = NULL;
 	ensure_point_base_type(temp->valuetypid);
 	if (temp->valuetypid == type_oid(T_GEOMETRY))
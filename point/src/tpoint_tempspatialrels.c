@@ -20,6 +20,9 @@
 
 #include "tpoint_tempspatialrels.h"
 
+#include <access/htup_details.h>
+#include <funcapi.h>
+#include <math.h>
 #include <utils/timestamp.h>
 
 #include "period.h"
@@ -948,10 +951,18 @@ tgeompoint '[POINT(4 3)@2000-01-04, POINT(5 3)@2000-01-05]', 1)
  
  *****************************************************************************/
 
+/*
+ * Solve the quadratic equation giving the instants at which the distance
+ * between two linear segments defined over [lower, upper] is equal to d.
+ * The segments are given by the coordinates of their start and end points.
+ * Returns the number of solutions, or -1 when the segments are parallel,
+ * moving in the same direction at the same speed, in which case the distance
+ * is constant and the calling function must compare it with d.
+ */
 static int
-tdwithin_tpointseq_tpointseq1(Datum sv1, Datum ev1, Datum sv2, Datum ev2, 
-	TimestampTz lower, TimestampTz upper, double d, bool hasz,
-	Datum (*func)(Datum, Datum, Datum), TimestampTz *t1, TimestampTz *t2)
+tdwithin_tpointseq_tpointseq1(const POINT3DZ *p1, const POINT3DZ *p2,
+	const POINT3DZ *p3, const POINT3DZ *p4, TimestampTz lower,
+	TimestampTz upper, double d, bool hasz, TimestampTz *t1, TimestampTz *t2)
 {
 	/* To reduce problems related to floating point arithmetic, lower and upper
 	   are shifted, respectively, to 0 and 1 before computing the solutions
@@ -960,32 +971,27 @@ tdwithin_tpointseq_tpointseq1(Datum sv1, Datum ev1, Datum sv2, Datum ev2,
 	long double a, b, c;
 	if (hasz) /* 3D */
 	{
-		POINT3DZ p1 = datum_get_point3dz(sv1);
-		POINT3DZ p2 = datum_get_point3dz(ev1);
-		POINT3DZ p3 = datum_get_point3dz(sv2);
-		POINT3DZ p4 = datum_get_point3dz(ev2);
-
 		/* per1 functions
  		* x(t) = a1 * t + c1
  		* y(t) = a2 * t + c2
 		* z(t) = a3 * t + c3 */
-		double a1 = (p2.x - p1.x);
-		double c1 = p1.x;
-		double a2 = (p2.y - p1.y);
-		double c2 = p1.y;
-		double a3 = (p2.z - p1.z);
-		double c3 = p1.z;
+		double a1 = (p2->x - p1->x);
+		double c1 = p1->x;
+		double a2 = (p2->y - p1->y);
+		double c2 = p1->y;
+		double a3 = (p2->z - p1->z);
+		double c3 = p1->z;
 
 		/* per2 functions
 		 * x(t) = a4 * t + c4
 		 * y(t) = a5 * t + c5
 		 * z(t) = a6 * t + c6 */
-		double a4 = (p4.x - p3.x);
-		double c4 = p3.x;
-		double a5 = (p4.y - p3.y);
-		double c5 = p3.y;
-		double a6 = (p4.z - p3.z);
-		double c6 = p3.z;
+		double a4 = (p4->x - p3->x);
+		double c4 = p3->x;
+		double a5 = (p4->y - p3->y);
+		double c5 = p3->y;
+		double a6 = (p4->z - p3->z);
+		double c6 = p3->z;
 
 		/* compute the distance function */
 		double a_x = (a1 - a4) * (a1 - a4);
@@ -1004,24 +1010,20 @@ tdwithin_tpointseq_tpointseq1(Datum sv1, Datum ev1, Datum sv2, Datum ev2,
 	}
 	else /* 2D */
 	{
-		POINT2D p1 = datum_get_point2d(sv1);
-		POINT2D p2 = datum_get_point2d(ev1);
-		POINT2D p3 = datum_get_point2d(sv2);
-		POINT2D p4 = datum_get_point2d(ev2);
 		/* per1 functions
 		 * x(t) = a1 * t + c1
 		 * y(t) = a2 * t + c2 */
-		double a1 = (p2.x - p1.x);
-		double c1 = p1.x;
-		double a2 = (p2.y - p1.y);
-		double c2 = p1.y;
+		double a1 = (p2->x - p1->x);
+		double c1 = p1->x;
+		double a2 = (p2->y - p1->y);
+		double c2 = p1->y;
 		/* per2 functions
 		 * x(t) = a3 * t + c3
 		 * y(t) = a4 * t + c4 */
-		double a3 = (p4.x - p3.x);
-		double c3 = p3.x;
-		double a4 = (p4.y - p3.y);
-		double c4 = p3.y;
+		double a3 = (p4->x - p3->x);
+		double c3 = p3->x;
+		double a4 = (p4->y - p3->y);
+		double c4 = p3->y;
 		/* compute the distance function */
 		double a_x = (a1 - a3) * (a1 - a3);
 		double a_y = (a2 - a4) * (a2 - a4);
@@ -1036,13 +1038,7 @@ tdwithin_tpointseq_tpointseq1(Datum sv1, Datum ev1, Datum sv2, Datum ev2,
 	}
 	/* They are parallel, moving in the same direction at the same speed */
 	if (a == 0)
-	{
-		if (!func(sv1, sv2, Float8GetDatum(d)))
-			return 0;
-		*t1 = lower;
-		*t2 = upper;
-		return 2;
-	}
+		return -1;
 	/* Solving the quadratic equation for distance = d */
 	long double discriminant = b * b - 4 * a * c;
 
@@ -1151,8 +1147,29 @@ tdwithin_tpointseq_tpointseq2(TemporalSeq **result,
 	TimestampTz t1, t2;
 	Datum sev1 = linear1 ? ev1 : sv1;
 	Datum sev2 = linear2 ? ev2 : sv2;
-	int solutions = tdwithin_tpointseq_tpointseq1(sv1, sev1, sv2, sev2,
-		lower, upper, DatumGetFloat8(d), hasz, func, &t1, &t2);
+	POINT3DZ p1, p2, p3, p4;
+	if (hasz)
+	{
+		p1 = datum_get_point3dz(sv1); p2 = datum_get_point3dz(sev1);
+		p3 = datum_get_point3dz(sv2); p4 = datum_get_point3dz(sev2);
+	}
+	else
+	{
+		POINT2D q1 = datum_get_point2d(sv1), q2 = datum_get_point2d(sev1),
+			q3 = datum_get_point2d(sv2), q4 = datum_get_point2d(sev2);
+		p1.x = q1.x; p1.y = q1.y; p2.x = q2.x; p2.y = q2.y;
+		p3.x = q3.x; p3.y = q3.y; p4.x = q4.x; p4.y = q4.y;
+		p1.z = p2.z = p3.z = p4.z = 0.0;
+	}
+	int solutions = tdwithin_tpointseq_tpointseq1(&p1, &p2, &p3, &p4,
+		lower, upper, DatumGetFloat8(d), hasz, &t1, &t2);
+	/* The segments are parallel and thus the distance is constant */
+	if (solutions == -1)
+	{
+		solutions = DatumGetBool(func(sv1, sv2, d)) ? 2 : 0;
+		t1 = lower;
+		t2 = upper;
+	}
 
 	/* No instant is returned */
 	int k;
@@ -1375,6 +1392,311 @@ tdwithin_tpoints_tpoints(TemporalS *ts1, TemporalS *ts2, Datum d,
 	return result;
 }
 
+/*****************************************************************************
+ * Streaming temporal dwithin for temporal geometry points of sequence or
+ * sequence set duration. The instants of both values are walked in lockstep
+ * with the TPointSeqSync cursor and the solutions of the quadratic equation
+ * are computed from the raw coordinates. The boolean pieces obtained for
+ * each synchronized segment are appended directly to the instants of the
+ * resulting sequences, so that neither synchronized copies of the arguments
+ * nor intermediate sequences for each segment are constructed. The pieces
+ * are the same as those constructed by tdwithin_tpointseq_tpointseq2.
+ *****************************************************************************/
+
+typedef struct
+{
+	Datum	   *values;			/* values of the current sequence */
+	TimestampTz *times;			/* timestamps of the current sequence */
+	int			count;			/* number of instants of the current sequence */
+	int			maxcount;		/* size of the values and times arrays */
+	bool		lower_inc;		/* lower bound of the current sequence */
+	bool		upper_inc;		/* upper bound of the current sequence */
+	TemporalSeq **sequences;	/* sequences already constructed */
+	int			nseqs;			/* number of sequences already constructed */
+	int			maxseqs;		/* size of the sequences array */
+} TDWithinState;
+
+static void
+tdwithin_state_init(TDWithinState *state, int count)
+{
+	state->maxcount = Max(count, 2);
+	state->values = palloc(sizeof(Datum) * state->maxcount);
+	state->times = palloc(sizeof(TimestampTz) * state->maxcount);
+	state->count = 0;
+	state->maxseqs = 8;
+	state->sequences = palloc(sizeof(TemporalSeq *) * state->maxseqs);
+	state->nseqs = 0;
+}
+
+/* Construct a sequence from the current instants of the state */
+
+static void
+tdwithin_state_flush(TDWithinState *state)
+{
+	if (state->count == 0)
+		return;
+	TemporalInst **instants = temporalinstarr_make_byval(state->values,
+		state->times, state->count, BOOLOID);
+	if (state->nseqs == state->maxseqs)
+	{
+		state->maxseqs *= 2;
+		state->sequences = repalloc(state->sequences,
+			sizeof(TemporalSeq *) * state->maxseqs);
+	}
+	state->sequences[state->nseqs++] = temporalseq_from_temporalinstarr(
+		instants, state->count, state->lower_inc, state->upper_inc, false, true);
+	pfree(instants[0]); pfree(instants);
+	state->count = 0;
+}
+
+static void
+tdwithin_state_add_instant(TDWithinState *state, Datum value, TimestampTz t)
+{
+	int n = state->count;
+	/* Instants in the middle of a run of equal values are redundant */
+	if (n > 1 && state->values[n - 1] == value && state->values[n - 2] == value)
+	{
+		state->times[n - 1] = t;
+		return;
+	}
+	if (n == state->maxcount)
+	{
+		state->maxcount *= 2;
+		state->values = repalloc(state->values, sizeof(Datum) * state->maxcount);
+		state->times = repalloc(state->times,
+			sizeof(TimestampTz) * state->maxcount);
+	}
+	state->values[n] = value;
+	state->times[n] = t;
+	state->count++;
+}
+
+/*
+ * Append a piece with constant value defined over the interval given by
+ * lower, upper, lower_inc, and upper_inc to the current sequence. A new
+ * sequence is started when the piece cannot be represented with stepwise
+ * interpolation in the current one.
+ */
+static void
+tdwithin_state_add_piece(TDWithinState *state, bool value, TimestampTz lower,
+	TimestampTz upper, bool lower_inc, bool upper_inc)
+{
+	/* Empty pieces may result from rounding the solutions to microseconds */
+	int cmp = timestamp_cmp_internal(lower, upper);
+	if (cmp > 0 || (cmp == 0 && (! lower_inc || ! upper_inc)))
+		return;
+
+	Datum datum = BoolGetDatum(value);
+	bool start = true;
+	if (state->count > 0)
+	{
+		TimestampTz end = state->times[state->count - 1];
+		Datum last = state->values[state->count - 1];
+		bool adjacent = timestamp_cmp_internal(end, lower) == 0;
+		/* ..., v@t1, v@t2) [w@t2, ... -> ..., v@t1, w@t2, ... */
+		/* ..., v@t1, v@t2] (v@t2, ... -> ..., v@t1, v@t2, ... */
+		if (adjacent && ((! state->upper_inc && lower_inc) ||
+			(state->upper_inc && ! lower_inc && last == datum)))
+		{
+			state->count--;
+			start = false;
+		}
+		else
+			tdwithin_state_flush(state);
+	}
+	if (start)
+		state->lower_inc = lower_inc;
+	tdwithin_state_add_instant(state, datum, lower);
+	if (cmp < 0)
+		tdwithin_state_add_instant(state, datum, upper);
+	state->upper_inc = upper_inc;
+}
+
+static bool
+point3dz_dwithin(const POINT3DZ *p1, const POINT3DZ *p2, double d, bool hasz)
+{
+	return point3dz_distance(p1, p2, hasz) <= d;
+}
+
+static bool
+point3dz_eq(const POINT3DZ *p1, const POINT3DZ *p2, bool hasz)
+{
+	return p1->x == p2->x && p1->y == p2->y && (! hasz || p1->z == p2->z);
+}
+
+/* Raw-coordinate counterpart of tdwithin_tpointseq_tpointseq2 */
+
+static void
+tdwithin_tgeompointseq_segment(TDWithinState *state,
+	const POINT3DZ *sv1, const POINT3DZ *ev1, bool linear1,
+	const POINT3DZ *sv2, const POINT3DZ *ev2, bool linear2,
+	TimestampTz lower, TimestampTz upper, bool lower_inc, bool upper_inc,
+	double d, bool hasz)
+{
+	/* Both segments are constant */
+	if (point3dz_eq(sv1, ev1, hasz) && point3dz_eq(sv2, ev2, hasz))
+	{
+		tdwithin_state_add_piece(state, point3dz_dwithin(sv1, sv2, d, hasz),
+			lower, upper, lower_inc, upper_inc);
+		return;
+	}
+
+	/* Both segments have stepwise interpolation */
+	if (! linear1 && ! linear2)
+	{
+		tdwithin_state_add_piece(state, point3dz_dwithin(sv1, sv2, d, hasz),
+			lower, upper, lower_inc, false);
+		if (upper_inc)
+			tdwithin_state_add_piece(state, point3dz_dwithin(ev1, ev2, d, hasz),
+				upper, upper, true, true);
+		return;
+	}
+
+	/* Find the instants t1 and t2 (if any) during which the dwithin function is true */
+	TimestampTz t1, t2;
+	const POINT3DZ *sev1 = linear1 ? ev1 : sv1;
+	const POINT3DZ *sev2 = linear2 ? ev2 : sv2;
+	int solutions = tdwithin_tpointseq_tpointseq1(sv1, sev1, sv2, sev2,
+		lower, upper, d, hasz, &t1, &t2);
+	/* The segments are parallel and thus the distance is constant */
+	if (solutions == -1)
+	{
+		solutions = point3dz_dwithin(sv1, sv2, d, hasz) ? 2 : 0;
+		t1 = lower;
+		t2 = upper;
+	}
+
+	bool upper_inc1 = linear1 && linear2 && upper_inc;
+	if (solutions == 0 ||
+		(solutions == 1 && ((t1 == lower && ! lower_inc) || 
+			(t1 == upper && ! upper_inc))))
+		tdwithin_state_add_piece(state, false, lower, upper, lower_inc,
+			upper_inc1);
+	else if (solutions == 1 && t1 == lower) /* && lower_inc */
+	{
+		tdwithin_state_add_piece(state, true, lower, lower, true, true);
+		tdwithin_state_add_piece(state, false, lower, upper, false, upper_inc1);
+	}
+	else if (solutions == 1 && t1 == upper) /* && upper_inc */
+	{
+		tdwithin_state_add_piece(state, false, lower, upper, lower_inc, false);
+		if (upper_inc1)
+			tdwithin_state_add_piece(state, true, upper, upper, true, true);
+	}
+	else if (solutions == 1)
+	{
+		tdwithin_state_add_piece(state, false, lower, t1, lower_inc, false);
+		tdwithin_state_add_piece(state, true, t1, t1, true, true);
+		tdwithin_state_add_piece(state, false, t1, upper, false, upper_inc1);
+	}
+	/* solutions == 2 */
+	else if (lower == t1 && upper == t2)
+		tdwithin_state_add_piece(state, true, lower, upper, lower_inc,
+			upper_inc1);
+	else if (upper == t2)
+	{
+		tdwithin_state_add_piece(state, false, lower, t1, lower_inc, false);
+		tdwithin_state_add_piece(state, true, t1, upper, true, upper_inc1);
+	}
+	else if (lower == t1)
+	{
+		tdwithin_state_add_piece(state, true, lower, t2, lower_inc, false);
+		tdwithin_state_add_piece(state, false, t2, upper, true, upper_inc1);
+	}
+	else
+	{
+		tdwithin_state_add_piece(state, false, lower, t1, lower_inc, false);
+		tdwithin_state_add_piece(state, true, t1, t2, true, true);
+		tdwithin_state_add_piece(state, false, t2, upper, false, upper_inc1);
+	}
+	/* Add extra final point if only one segment is linear */
+	if (upper_inc && (! linear1 || ! linear2))
+		tdwithin_state_add_piece(state, point3dz_dwithin(ev1, ev2, d, hasz),
+			upper, upper, true, true);
+}
+
+static void
+tdwithin_tgeompointseq_tgeompointseq(TDWithinState *state, TemporalSeq *seq1,
+	TemporalSeq *seq2, double d)
+{
+	TPointSeqSync sync;
+	if (! tpointseq_sync_init(&sync, seq1, seq2))
+		return;
+
+	/* The two sequences intersect at an instant */
+	if (sync.last)
+	{
+		tdwithin_state_add_piece(state, 
+			point3dz_dwithin(&sync.p1, &sync.p2, d, sync.hasz),
+			sync.t, sync.t, true, true);
+		return;
+	}
+
+	POINT3DZ sv1 = sync.p1, sv2 = sync.p2;
+	TimestampTz lower = sync.t;
+	bool lower_inc = sync.inter.lower_inc;
+	while (tpointseq_sync_next(&sync))
+	{
+		bool upper_inc = sync.last && sync.inter.upper_inc;
+		tdwithin_tgeompointseq_segment(state, &sv1, &sync.p1, sync.linear1,
+			&sv2, &sync.p2, sync.linear2, lower, sync.t, lower_inc, upper_inc,
+			d, sync.hasz);
+		sv1 = sync.p1;
+		sv2 = sync.p2;
+		lower = sync.t;
+		lower_inc = true;
+	}
+}
+
+/*
+ * Temporal dwithin between two temporal geometry points of sequence or 
+ * sequence set duration. Returns NULL if they do not intersect in time.
+ */
+static TemporalS *
+tdwithin_tgeompoint_tgeompoint_stream(Temporal *temp1, Temporal *temp2,
+	double d)
+{
+	int count1, count2;
+	TemporalSeq **sequences1 = tpoint_sequences(temp1, &count1);
+	TemporalSeq **sequences2 = tpoint_sequences(temp2, &count2);
+	TDWithinState state;
+	tdwithin_state_init(&state, 16);
+	int i = 0, j = 0;
+	while (i < count1 && j < count2)
+	{
+		TemporalSeq *seq1 = sequences1[i];
+		TemporalSeq *seq2 = sequences2[j];
+		tdwithin_tgeompointseq_tgeompointseq(&state, seq1, seq2, d);
+		int cmp = timestamp_cmp_internal(seq1->period.upper, seq2->period.upper);
+		if (cmp == 0)
+		{
+			if (! seq1->period.upper_inc && seq2->period.upper_inc)
+				cmp = -1;
+			else if (seq1->period.upper_inc && ! seq2->period.upper_inc)
+				cmp = 1;
+		}
+		if (cmp == 0)
+		{
+			i++; j++;
+		}
+		else if (cmp < 0)
+			i++;
+		else
+			j++;
+	}
+	tdwithin_state_flush(&state);
+
+	TemporalS *result = NULL;
+	if (state.nseqs > 0)
+		result = temporals_from_temporalseqarr(state.sequences, state.nseqs,
+			false, true);
+	for (i = 0; i < state.nseqs; i++)
+		pfree(state.sequences[i]);
+	pfree(state.sequences); pfree(state.values); pfree(state.times);
+	pfree(sequences1); pfree(sequences2);
+	return result;
+}
+
 /*****************************************************************************
  * Generic dispatch functions
  *****************************************************************************/
@@ -2094,25 +2416,26 @@ tdwithin_tpoint_geo(PG_FUNCTION_ARGS)
 	PG_RETURN_POINTER(result);
 }
 
-PG_FUNCTION_INFO_V1(tdwithin_tpoint_tpoint);
-
-PGDLLEXPORT Datum
-tdwithin_tpoint_tpoint(PG_FUNCTION_ARGS)
+/*
+ * Temporal dwithin between two temporal points (internal function).
+ * Returns NULL if the temporal points do not intersect in time.
+ */
+Temporal *
+tdwithin_tpoint_tpoint_internal(Temporal *temp1, Temporal *temp2, Datum dist)
 {
-	Temporal *temp1 = PG_GETARG_TEMPORAL(0);
-	Temporal *temp2 = PG_GETARG_TEMPORAL(1);
-	Datum dist = PG_GETARG_DATUM(2);
-	ensure_same_srid_tpoint(temp1, temp2);
-	ensure_same_dimensionality_tpoint(temp1, temp2);
+	/* Temporal geometry points of sequence (set) duration are processed
+	   without synchronizing them first */
+	if (temp1->valuetypid == type_oid(T_GEOMETRY) &&
+		(temp1->duration == TEMPORALSEQ || temp1->duration == TEMPORALS) &&
+		(temp2->duration == TEMPORALSEQ || temp2->duration == TEMPORALS))
+		return (Temporal *)tdwithin_tgeompoint_tgeompoint_stream(temp1, temp2,
+			DatumGetFloat8(dist));
+
 	Temporal *sync1, *sync2;
-	/* Return false if the temporal points do not intersect in time
+	/* Return NULL if the temporal points do not intersect in time
 	   The last parameter crossing must be set to false  */
 	if (!synchronize_temporal_temporal(temp1, temp2, &sync1, &sync2, false))
-	{
-		PG_FREE_IF_COPY(temp1, 0);
-		PG_FREE_IF_COPY(temp2, 1);
-		PG_RETURN_NULL();
-	}
+		return NULL;
 
 	Datum (*func)(Datum, Datum, Datum) = NULL;
 	ensure_point_base_type(temp1->valuetypid);
@@ -2144,8 +2467,24 @@ tdwithin_tpoint_tpoint(PG_FUNCTION_ARGS)
 			(TemporalS *)sync1, (TemporalS *)sync2, dist, func);
 
 	pfree(sync1); pfree(sync2); 
+	return result;
+}
+
+PG_FUNCTION_INFO_V1(tdwithin_tpoint_tpoint);
+
+PGDLLEXPORT Datum
+tdwithin_tpoint_tpoint(PG_FUNCTION_ARGS)
+{
+	Temporal *temp1 = PG_GETARG_TEMPORAL(0);
+	Temporal *temp2 = PG_GETARG_TEMPORAL(1);
+	Datum dist = PG_GETARG_DATUM(2);
+	ensure_same_srid_tpoint(temp1, temp2);
+	ensure_same_dimensionality_tpoint(temp1, temp2);
+	Temporal *result = tdwithin_tpoint_tpoint_internal(temp1, temp2, dist);
 	PG_FREE_IF_COPY(temp1, 0);
 	PG_FREE_IF_COPY(temp2, 1);
+	if (result == NULL)
+		PG_RETURN_NULL();
 	PG_RETURN_POINTER(result);
 }
 
@@ -2285,3 +2624,376 @@ trelate_pattern_tpoint_tpoint(PG_FUNCTION_ARGS)
 }
 
 /*****************************************************************************/
+
+/*****************************************************************************
+ * Proximity join
+ * Given two arrays of temporal points and a distance, find all the pairs of
+ * temporal points that are within the distance of each other at some instant
+ * together with the time during which this happens. 
+ *
+ * The candidate pairs are found with a uniform grid over the spatial extent
+ * of the bounding boxes of the temporal points, where the boxes of the first
+ * array are expanded by the distance. In each cell, the boxes are scanned in
+ * increasing order of their start timestamp (plane sweep on time) while 
+ * keeping a list of active boxes for each array. A pair found in several 
+ * cells is only reported in the cell containing the lower-left corner of the
+ * intersection of the two boxes. The candidate pairs are then refined with
+ * the temporal dwithin function.
+ *****************************************************************************/
+
+/* Target number of boxes per cell and maximum number of cells per axis */
+#define PROXJOIN_CELL_BOXES		16
+#define PROXJOIN_MAX_CELLS		256
+
+typedef struct
+{
+	STBOX box;			/* bounding box, expanded for the first array */
+	int idx;			/* index of the temporal point in its array */
+	bool first;			/* true if the temporal point is in the first array */
+} ProxJoinBox;
+
+typedef struct
+{
+	double xmin;		/* origin of the grid */
+	double ymin;
+	double xsize;		/* size of a cell */
+	double ysize;
+	int ncells;			/* number of cells per axis */
+} ProxJoinGrid;
+
+/*
+ * State of the proximity join kept across the calls of the set returning
+ * function. The grid is built in the first call, then the cells are swept 
+ * one at a time when the pairs found in the previous cell are exhausted.
+ */
+typedef struct
+{
+	Temporal **temps1;		/* temporal points of the first array */
+	Temporal **temps2;		/* temporal points of the second array */
+	Datum dist;				/* distance */
+	bool hasz;				/* the boxes have Z dimension */
+	ProxJoinGrid grid;		/* grid over the spatial extent of the boxes */
+	ProxJoinBox *boxes;		/* boxes of the temporal points */
+	ProxJoinBox **cellboxes;/* boxes of the cells as consecutive slices */
+	int *cellstart;			/* start of the slice of each cell */
+	int cell;				/* next cell to sweep */
+	int maxcand;			/* size of the arrays below */
+	int *cand1;				/* candidate pairs of the current cell */
+	int *cand2;
+	int count;				/* number of resulting pairs of the current cell */
+	int next;				/* next resulting pair to return */
+	int *idx1;				/* index in the first array */
+	int *idx2;				/* index in the second array */
+	PeriodSet **times;		/* time during which the pair is within distance */
+} ProxJoinState;
+
+static int
+proxjoin_cell(double value, double origin, double size, int ncells)
+{
+	if (size <= 0)
+		return 0;
+	int result = (int) ((value - origin) / size);
+	if (result < 0)
+		return 0;
+	if (result >= ncells)
+		return ncells - 1;
+	return result;
+}
+
+static bool
+proxjoin_overlaps(const STBOX *box1, const STBOX *box2, bool hasz)
+{
+	if (box1->xmax < box2->xmin || box1->xmin > box2->xmax ||
+		box1->ymax < box2->ymin || box1->ymin > box2->ymax)
+		return false;
+	if (hasz && (box1->zmax < box2->zmin || box1->zmin > box2->zmax))
+		return false;
+	return (box1->tmax >= box2->tmin && box1->tmin <= box2->tmax);
+}
+
+static int
+proxjoinbox_cmp(const ProxJoinBox **b1, const ProxJoinBox **b2)
+{
+	return timestamp_cmp_internal((*b1)->box.tmin, (*b2)->box.tmin);
+}
+
+/*
+ * Plane sweep on time of the boxes of a grid cell. The candidate pairs are
+ * appended to the arrays cand1 and cand2 that are enlarged when needed.
+ */
+static void
+proxjoin_sweep_cell(ProxJoinBox **boxes, int count, int cx, int cy,
+	const ProxJoinGrid *grid, bool hasz, int **cand1, int **cand2, 
+	int *ncand, int *maxcand)
+{
+	qsort(boxes, (size_t) count, sizeof(ProxJoinBox *),
+		(qsort_comparator) &proxjoinbox_cmp);
+	ProxJoinBox **active1 = palloc(sizeof(ProxJoinBox *) * count);
+	ProxJoinBox **active2 = palloc(sizeof(ProxJoinBox *) * count);
+	int nactive1 = 0, nactive2 = 0;
+	for (int i = 0; i < count; i++)
+	{
+		ProxJoinBox *b = boxes[i];
+		ProxJoinBox **other = b->first ? active2 : active1;
+		int *nother = b->first ? &nactive2 : &nactive1;
+		int j = 0;
+		while (j < *nother)
+		{
+			ProxJoinBox *o = other[j];
+			/* Remove the boxes that ended before the current one starts */
+			if (o->box.tmax < b->box.tmin)
+			{
+				other[j] = other[--(*nother)];
+				continue;
+			}
+			j++;
+			if (! proxjoin_overlaps(&b->box, &o->box, hasz))
+				continue;
+			/* Report the pair only in the cell of the reference point */
+			double rx = Max(b->box.xmin, o->box.xmin);
+			double ry = Max(b->box.ymin, o->box.ymin);
+			if (proxjoin_cell(rx, grid->xmin, grid->xsize, grid->ncells) != cx ||
+				proxjoin_cell(ry, grid->ymin, grid->ysize, grid->ncells) != cy)
+				continue;
+			if (*ncand == *maxcand)
+			{
+				*maxcand *= 2;
+				*cand1 = repalloc(*cand1, sizeof(int) * (*maxcand));
+				*cand2 = repalloc(*cand2, sizeof(int) * (*maxcand));
+			}
+			(*cand1)[*ncand] = b->first ? b->idx : o->idx;
+			(*cand2)[*ncand] = b->first ? o->idx : b->idx;
+			(*ncand)++;
+		}
+		if (b->first)
+			active1[nactive1++] = b;
+		else
+			active2[nactive2++] = b;
+	}
+	pfree(active1); pfree(active2);
+	return;
+}
+
+/*
+ * Build the grid of the proximity join between the temporal points of the
+ * two arrays. The pairs are computed afterwards cell by cell by 
+ * proxjoin_next_cell.
+ */
+static ProxJoinState *
+proxjoin_init(Temporal **temps1, int count1, Temporal **temps2, int count2,
+	Datum dist)
+{
+	ProxJoinState *result = palloc0(sizeof(ProxJoinState));
+	result->temps1 = temps1;
+	result->temps2 = temps2;
+	result->dist = dist;
+	if (count1 == 0 || count2 == 0)
+		return result;
+	double d = DatumGetFloat8(dist);
+	bool geodetic = MOBDB_FLAGS_GET_GEODETIC(temps1[0]->flags);
+	result->hasz = MOBDB_FLAGS_GET_Z(temps1[0]->flags) || geodetic;
+	if (geodetic)
+	{
+		/* The boxes of geodetic points are in geocentric coordinates on the
+		 * unit sphere while the distance is in meters. The boxes are then
+		 * expanded by the chord of the arc of this length on a sphere of 
+		 * the minor axis of the spheroid, which bounds both the spherical 
+		 * and the spheroidal distances */
+		double angle = d / WGS84_MINOR_AXIS;
+		d = (angle >= M_PI) ? 2.0 : 2.0 * sin(angle / 2.0);
+	}
+
+	/* Collect the bounding boxes and the spatial extent of the grid */
+	int count = count1 + count2;
+	ProxJoinBox *boxes = palloc0(sizeof(ProxJoinBox) * count);
+	for (int i = 0; i < count; i++)
+	{
+		bool first = i < count1;
+		Temporal *temp = first ? temps1[i] : temps2[i - count1];
+		if (i > 0)
+		{
+			ensure_same_srid_tpoint(temps1[0], temp);
+			ensure_same_dimensionality_tpoint(temps1[0], temp);
+		}
+		temporal_bbox(&boxes[i].box, temp);
+		boxes[i].idx = first ? i : i - count1;
+		boxes[i].first = first;
+		if (first)
+		{
+			boxes[i].box.xmin -= d; boxes[i].box.xmax += d;
+			boxes[i].box.ymin -= d; boxes[i].box.ymax += d;
+			boxes[i].box.zmin -= d; boxes[i].box.zmax += d;
+		}
+	}
+	ProxJoinGrid *grid = &result->grid;
+	double xmax = boxes[0].box.xmax, ymax = boxes[0].box.ymax;
+	grid->xmin = boxes[0].box.xmin;
+	grid->ymin = boxes[0].box.ymin;
+	for (int i = 1; i < count; i++)
+	{
+		grid->xmin = Min(grid->xmin, boxes[i].box.xmin);
+		grid->ymin = Min(grid->ymin, boxes[i].box.ymin);
+		xmax = Max(xmax, boxes[i].box.xmax);
+		ymax = Max(ymax, boxes[i].box.ymax);
+	}
+	grid->ncells = (int) ceil(sqrt((double) count / PROXJOIN_CELL_BOXES));
+	grid->ncells = Max(1, Min(grid->ncells, PROXJOIN_MAX_CELLS));
+	grid->xsize = (xmax - grid->xmin) / grid->ncells;
+	grid->ysize = (ymax - grid->ymin) / grid->ncells;
+
+	/* Assign the boxes to the cells they overlap. The cells are stored as 
+	 * consecutive slices of a single array, the first pass computes the
+	 * number of boxes per cell and the second one fills the slices */
+	int ncells = grid->ncells * grid->ncells;
+	int *cellstart = palloc0(sizeof(int) * (ncells + 1));
+	ProxJoinBox **cellboxes = NULL;
+	int *cellpos = NULL;
+	for (int pass = 0; pass < 2; pass++)
+	{
+		if (pass == 1)
+		{
+			for (int c = 0; c < ncells; c++)
+				cellstart[c + 1] += cellstart[c];
+			cellboxes = palloc(sizeof(ProxJoinBox *) * cellstart[ncells]);
+			cellpos = palloc(sizeof(int) * ncells);
+			memcpy(cellpos, cellstart, sizeof(int) * ncells);
+		}
+		for (int i = 0; i < count; i++)
+		{
+			STBOX *box = &boxes[i].box;
+			int cx1 = proxjoin_cell(box->xmin, grid->xmin, grid->xsize, grid->ncells);
+			int cx2 = proxjoin_cell(box->xmax, grid->xmin, grid->xsize, grid->ncells);
+			int cy1 = proxjoin_cell(box->ymin, grid->ymin, grid->ysize, grid->ncells);
+			int cy2 = proxjoin_cell(box->ymax, grid->ymin, grid->ysize, grid->ncells);
+			for (int cx = cx1; cx <= cx2; cx++)
+				for (int cy = cy1; cy <= cy2; cy++)
+				{
+					int c = cy * grid->ncells + cx;
+					if (pass == 0)
+						cellstart[c + 1]++;
+					else
+						cellboxes[cellpos[c]++] = &boxes[i];
+				}
+		}
+	}
+	pfree(cellpos);
+	result->boxes = boxes;
+	result->cellboxes = cellboxes;
+	result->cellstart = cellstart;
+	result->maxcand = Max(count, 64);
+	result->cand1 = palloc(sizeof(int) * result->maxcand);
+	result->cand2 = palloc(sizeof(int) * result->maxcand);
+	return result;
+}
+
+/*
+ * Sweep the next cell of the grid that yields at least one pair of temporal 
+ * points within the distance and refine its candidate pairs. Returns false
+ * when all the cells have been swept.
+ */
+static bool
+proxjoin_next_cell(ProxJoinState *state)
+{
+	int ncells = state->grid.ncells * state->grid.ncells;
+	/* The pairs of the previous cell have been returned */
+	for (int k = 0; k < state->count; k++)
+		pfree(state->times[k]);
+	state->count = state->next = 0;
+	while (state->count == 0 && state->cell < ncells)
+	{
+		int c = state->cell++;
+		int n = state->cellstart[c + 1] - state->cellstart[c];
+		if (n < 2)
+			continue;
+		int ncand = 0;
+		proxjoin_sweep_cell(&state->cellboxes[state->cellstart[c]], n, 
+			c % state->grid.ncells, c / state->grid.ncells, &state->grid, 
+			state->hasz, &state->cand1, &state->cand2, &ncand, &state->maxcand);
+		if (ncand == 0)
+			continue;
+		/* Refine the candidate pairs */
+		state->idx1 = state->idx1 == NULL ? 
+			palloc(sizeof(int) * state->maxcand) :
+			repalloc(state->idx1, sizeof(int) * state->maxcand);
+		state->idx2 = state->idx2 == NULL ? 
+			palloc(sizeof(int) * state->maxcand) :
+			repalloc(state->idx2, sizeof(int) * state->maxcand);
+		state->times = state->times == NULL ? 
+			palloc(sizeof(PeriodSet *) * state->maxcand) :
+			repalloc(state->times, sizeof(PeriodSet *) * state->maxcand);
+		for (int k = 0; k < ncand; k++)
+		{
+			int i = state->cand1[k], j = state->cand2[k];
+			Temporal *tdwithin = tdwithin_tpoint_tpoint_internal(
+				state->temps1[i], state->temps2[j], state->dist);
+			if (tdwithin == NULL)
+				continue;
+			Temporal *attrue = temporal_at_value_internal(tdwithin, 
+				BoolGetDatum(true));
+			pfree(tdwithin);
+			if (attrue == NULL)
+				continue;
+			state->idx1[state->count] = i;
+			state->idx2[state->count] = j;
+			state->times[state->count++] = temporal_get_time_internal(attrue);
+			pfree(attrue);
+		}
+	}
+	return state->count > 0;
+}
+
+PG_FUNCTION_INFO_V1(tdwithin_tpointarr_tpointarr_pairs);
+
+PGDLLEXPORT Datum
+tdwithin_tpointarr_tpointarr_pairs(PG_FUNCTION_ARGS)
+{
+	FuncCallContext *funcctx;
+	ProxJoinState *state;
+	if (SRF_IS_FIRSTCALL())
+	{
+		funcctx = SRF_FIRSTCALL_INIT();
+		MemoryContext oldcontext = 
+			MemoryContextSwitchTo(funcctx->multi_call_memory_ctx);
+		/* The temporal points point into the detoasted arrays, which are
+		 * kept in this context until the last call */
+		ArrayType *array1 = PG_GETARG_ARRAYTYPE_P(0);
+		ArrayType *array2 = PG_GETARG_ARRAYTYPE_P(1);
+		Datum dist = PG_GETARG_DATUM(2);
+		int count1, count2;
+		Temporal **temps1 = temporalarr_extract(array1, &count1);
+		Temporal **temps2 = temporalarr_extract(array2, &count2);
+		if (count1 > 0)
+			ensure_point_base_type(temps1[0]->valuetypid);
+		funcctx->user_fctx = proxjoin_init(temps1, count1, temps2, count2, 
+			dist);
+		TupleDesc tupdesc;
+		if (get_call_result_type(fcinfo, NULL, &tupdesc) != TYPEFUNC_COMPOSITE)
+			ereport(ERROR, (errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+				errmsg("Function returning record called in context that cannot accept type record")));
+		funcctx->tuple_desc = BlessTupleDesc(tupdesc);
+		MemoryContextSwitchTo(oldcontext);
+	}
+	funcctx = SRF_PERCALL_SETUP();
+	state = funcctx->user_fctx;
+	if (state->next == state->count)
+	{
+		/* The state of the join lives as long as the function call */
+		MemoryContext oldcontext = 
+			MemoryContextSwitchTo(funcctx->multi_call_memory_ctx);
+		bool found = proxjoin_next_cell(state);
+		MemoryContextSwitchTo(oldcontext);
+		if (! found)
+			SRF_RETURN_DONE(funcctx);
+	}
+	int i = state->next++;
+	Datum values[3];
+	bool isnull[3] = {false, false, false};
+	/* Indexes are returned 1-based as for SQL arrays */
+	values[0] = Int32GetDatum(state->idx1[i] + 1);
+	values[1] = Int32GetDatum(state->idx2[i] + 1);
+	values[2] = PointerGetDatum(state->times[i]);
+	HeapTuple tuple = heap_form_tuple(funcctx->tuple_desc, values, isnull);
+	SRF_RETURN_NEXT(funcctx, HeapTupleGetDatum(tuple));
+}
+
+/*****************************************************************************/
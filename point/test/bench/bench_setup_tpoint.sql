@@ -0,0 +1,37 @@
+/*****************************************************************************
+ *
+ * bench_setup_tpoint.sql
+ *	  Generation of the datasets of temporal points for the benchmarks.
+ *
+ * The datasets are generated with the functions of random_tpoint.sql from 
+ * a fixed seed. Their size is given by the same psql variables as the 
+ * datasets in test/bench/bench_setup.sql.
+ *
+ * Portions Copyright (c) 2020, Esteban Zimanyi, Arthur Lesuisse, 
+ * 		Universite Libre de Bruxelles
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ *****************************************************************************/
+
+SELECT setseed(0.5);
+
+DROP TABLE IF EXISTS bench_tgeompointseq;
+CREATE TABLE bench_tgeompointseq AS
+SELECT k, random_tgeompointseq(0, 100, 0, 100, '2001-01-01', '2001-12-31', 
+	10, :instants) AS seq
+FROM generate_series(1, :rows) k;
+
+DROP TABLE IF EXISTS bench_tgeompoints;
+CREATE TABLE bench_tgeompoints AS
+SELECT k, random_tgeompoints(0, 100, 0, 100, '2001-01-01', '2001-12-31', 
+	10, :instants, :sequences) AS ts
+FROM generate_series(1, :rows) k;
+
+ANALYZE bench_tgeompointseq;
+ANALYZE bench_tgeompoints;
+
+SELECT bench_size('size_tgeompointseq', 'bench_tgeompointseq');
+SELECT bench_size('size_tgeompoints', 'bench_tgeompoints');
+
+/*****************************************************************************/
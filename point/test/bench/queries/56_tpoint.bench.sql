@@ -0,0 +1,64 @@
+-------------------------------------------------------------------------------
+-- Restriction
+-------------------------------------------------------------------------------
+
+SELECT bench_run('atPeriod_tgeompointseq',
+	'SELECT count(atPeriod(seq, period ''[2001-06-01, 2001-07-01]'')) FROM bench_tgeompointseq');
+SELECT bench_run('atGeometry_tgeompointseq',
+	'SELECT count(atGeometry(seq, geometry ''Polygon((40 40,40 60,60 60,60 40,40 40))'')) FROM bench_tgeompointseq');
+SELECT bench_run('atGeometry_tgeompoints',
+	'SELECT count(atGeometry(ts, geometry ''Polygon((40 40,40 60,60 60,60 40,40 40))'')) FROM bench_tgeompoints');
+
+-------------------------------------------------------------------------------
+-- Distance and temporal spatial relationships
+-------------------------------------------------------------------------------
+
+SELECT bench_run('distance_tgeompointseq_geometry',
+	'SELECT count(seq <-> geometry ''Point(50 50)'') FROM bench_tgeompointseq');
+SELECT bench_run('distance_tgeompointseq_tgeompointseq',
+	'SELECT count(t1.seq <-> t2.seq) FROM bench_tgeompointseq t1, bench_tgeompointseq t2 
+	WHERE t1.k <= 100 AND t2.k <= 100');
+SELECT bench_run('tdwithin_tgeompointseq_geometry',
+	'SELECT count(tdwithin(seq, geometry ''Point(50 50)'', 10.0)) FROM bench_tgeompointseq');
+SELECT bench_run('tdwithin_tgeompointseq_tgeompointseq',
+	'SELECT count(tdwithin(t1.seq, t2.seq, 10.0)) FROM bench_tgeompointseq t1, bench_tgeompointseq t2 
+	WHERE t1.k <= 100 AND t2.k <= 100');
+
+-------------------------------------------------------------------------------
+-- Aggregates
+-------------------------------------------------------------------------------
+
+SELECT bench_run('tcount_tgeompointseq',
+	'SELECT numInstants(tcount(seq)) FROM bench_tgeompointseq');
+
+-------------------------------------------------------------------------------
+-- Indexes
+-------------------------------------------------------------------------------
+
+SELECT bench_run('gist_build_tgeompoints',
+	'CREATE INDEX bench_tgeompoints_gist_idx ON bench_tgeompoints USING gist(ts)',
+	3, 'DROP INDEX bench_tgeompoints_gist_idx');
+SELECT bench_run('spgist_build_tgeompoints',
+	'CREATE INDEX bench_tgeompoints_spgist_idx ON bench_tgeompoints USING spgist(ts)',
+	3, 'DROP INDEX bench_tgeompoints_spgist_idx');
+
+CREATE INDEX bench_tgeompoints_gist_idx ON bench_tgeompoints USING gist(ts);
+SET enable_seqscan = off;
+SELECT bench_run('gist_probe_tgeompoints',
+	'SELECT count(*) FROM bench_tgeompoints WHERE ts && geometry ''Polygon((40 40,40 60,60 60,60 40,40 40))''');
+SET enable_seqscan = on;
+DROP INDEX bench_tgeompoints_gist_idx;
+
+-------------------------------------------------------------------------------
+-- Input/output
+-------------------------------------------------------------------------------
+
+SELECT bench_run('copy_out_tgeompoints',
+	'COPY bench_tgeompoints TO ' || quote_literal(:'copyfile'));
+CREATE TABLE bench_tgeompoints_copy (LIKE bench_tgeompoints);
+SELECT bench_run('copy_in_tgeompoints',
+	'COPY bench_tgeompoints_copy FROM ' || quote_literal(:'copyfile'),
+	3, 'TRUNCATE bench_tgeompoints_copy');
+DROP TABLE bench_tgeompoints_copy;
+
+-------------------------------------------------------------------------------
@@ -17,6 +17,7 @@ SELECT asText(tgeogpoint 'Point(1.5 1.5 1.5)@2000-01-01');
 SELECT asText(tgeogpoint '{Point(1.5 1.5 1.5)@2000-01-01, Point(2.5 2.5 2.5)@2000-01-02, Point(1.5 1.5 1.5)@2000-01-03}');
 SELECT asText(tgeogpoint '[Point(1.5 1.5 1.5)@2000-01-01, Point(2.5 2.5 2.5)@2000-01-02, Point(1.5 1.5 1.5)@2000-01-03]');
 SELECT asText(tgeogpoint '{[Point(1.5 1.5 1.5)@2000-01-01, Point(2.5 2.5 2.5)@2000-01-02, Point(1.5 1.5 1.5)@2000-01-03],[Point(3.5 3.5 3.5)@2000-01-04, Point(3.5 3.5 3.5)@2000-01-05]}');
+SELECT asText(tgeompoint '[Point(1.123456 2.987654)@2000-01-01, Point(3 4)@2000-01-02]', 2);
 
 SELECT asText('{}'::tgeompoint[]);
 SELECT asText(ARRAY[tgeompoint 'Point(1 1)@2000-01-01']);
@@ -65,6 +66,7 @@ SELECT asMFJSON(tgeompoint 'Point(1 1)@2000-01-01',-1);
 SELECT asMFJSON(tgeompoint 'SRID=4326;Point(50.813810 4.384260)@2019-01-01 18:00:00.15+02', 2, 3);
 SELECT asMFJSON(tgeompoint 'SRID=4326;Point(50.813810 4.384260)@2019-01-01 18:00:00.15+02', 2, 4);
 SELECT asMFJSON(tgeompoint '[Point(1 2 3)@2019-01-01, Point(4 5 6)@2019-01-02]', 2, 1);
+SELECT string_agg(f, '') FROM asMFJSONFeatureCollection(ARRAY[tgeompoint 'Point(1 1)@2000-01-01', '[Point(1 2)@2000-01-01, Point(3 4)@2000-01-02]']) f;
 
 /* Errors */
 SELECT asMFJSON(tgeompoint 'SRID=123456;Point(50.813810 4.384260)@2019-01-01 18:00:00.15+02', 2, 4);
@@ -72,6 +74,8 @@ SELECT asMFJSON(tgeompoint 'SRID=123456;Point(50.813810 4.384260)@2019-01-01 18:
 SELECT asBinary(tgeompoint 'Point(1 1)@2000-01-01');
 SELECT asEWKB(tgeompoint 'SRID=4326;Point(1 1)@2000-01-01');
 SELECT asHexEWKB(tgeompoint 'SRID=4326;Point(1 1)@2000-01-01');
+SELECT asHexEWKB(tgeompoint 'SRID=4326;[Point(1 2)@2000-01-01, Point(3 4)@2000-01-02]', 'NDR');
+SELECT asHexEWKB(tgeompoint 'SRID=4326;[Point(1 2)@2000-01-01, Point(3 4)@2000-01-02]', 'XDR');
 
 -------------------------------------------------------------------------------
 
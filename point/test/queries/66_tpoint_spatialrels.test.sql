@@ -791,6 +791,8 @@ SELECT intersects(geometry 'Point(1 1)', tgeompoint 'Point(1 1)@2000-01-01');
 SELECT intersects(geometry 'Point(1 1)', tgeompoint '{Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03}');
 SELECT intersects(geometry 'Point(1 1)', tgeompoint '[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03]');
 SELECT intersects(geometry 'Point(1 1)', tgeompoint '{[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03],[Point(3 3)@2000-01-04, Point(3 3)@2000-01-05]}');
+SELECT intersects(geometry 'Linestring(0 2,2 0)', tgeompoint '[Point(0 0)@2000-01-01, Point(2 2)@2000-01-02]');
+SELECT intersects(geometry 'Linestring(0 3,3 3)', tgeompoint '[Point(0 0)@2000-01-01, Point(2 2)@2000-01-02]');
 
 SELECT intersects(geometry 'Point empty', tgeompoint 'Point(1 1)@2000-01-01');
 SELECT intersects(geometry 'Point empty', tgeompoint '{Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03}');
@@ -1233,6 +1235,8 @@ SELECT dwithin(geometry 'Point(1 1)', tgeompoint 'Point(1 1)@2000-01-01', 2);
 SELECT dwithin(geometry 'Point(1 1)', tgeompoint '{Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03}', 2);
 SELECT dwithin(geometry 'Point(1 1)', tgeompoint '[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03]', 2);
 SELECT dwithin(geometry 'Point(1 1)', tgeompoint '{[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03],[Point(3 3)@2000-01-04, Point(3 3)@2000-01-05]}', 2);
+SELECT dwithin(geometry 'Linestring(0 3,3 3)', tgeompoint '[Point(0 0)@2000-01-01, Point(2 2)@2000-01-02]', 1);
+SELECT dwithin(geometry 'Linestring(0 3,3 3)', tgeompoint '[Point(0 0)@2000-01-01, Point(2 2)@2000-01-02]', 0.5);
 
 SELECT dwithin(geometry 'Point empty', tgeompoint 'Point(1 1)@2000-01-01', 2);
 SELECT dwithin(geometry 'Point empty', tgeompoint '{Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03}', 2);
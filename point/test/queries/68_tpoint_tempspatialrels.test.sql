@@ -1116,6 +1116,15 @@ SELECT tdwithin(geography 'Point(1 1 1)', tgeogpoint 'Point(1 1)@2000-01-01', 2)
 SELECT tdwithin(tgeogpoint 'Point(1 1 1)@2000-01-01', geography 'Point(1 1)', 2);
 SELECT tdwithin(tgeogpoint 'Point(1 1 1)@2000-01-01', tgeogpoint 'Point(1 1)@2000-01-01', 2);
 
+-------------------------------------------------------------------------------
+-- tdwithinPairs
+-------------------------------------------------------------------------------
+
+SELECT * FROM tdwithinPairs(ARRAY[tgeompoint '[Point(0 0)@2000-01-01, Point(2 0)@2000-01-03]', tgeompoint '[Point(10 10)@2000-01-01, Point(10 12)@2000-01-03]'], ARRAY[tgeompoint '[Point(0 1)@2000-01-01, Point(2 1)@2000-01-03]'], 1);
+SELECT * FROM tdwithinPairs(ARRAY[tgeompoint '[Point(0 0)@2000-01-01, Point(2 0)@2000-01-03]'], ARRAY[tgeompoint '[Point(0 5)@2000-01-01, Point(2 5)@2000-01-03]'], 1);
+SELECT * FROM tdwithinPairs(ARRAY[tgeogpoint 'Point(0 0)@2000-01-01', tgeogpoint 'Point(10 10)@2000-01-01'], ARRAY[tgeogpoint 'Point(0 1)@2000-01-01'], 200000);
+SELECT * FROM tdwithinPairs(ARRAY[tgeogpoint 'Point(0 0)@2000-01-01', tgeogpoint 'Point(10 10)@2000-01-01'], ARRAY[tgeogpoint 'Point(0 1)@2000-01-01'], 100000);
+
 -------------------------------------------------------------------------------
 -- trelate (2 arguments returns text)
 -------------------------------------------------------------------------------
@@ -3,6 +3,29 @@
 ANALYZE tbl_tgeompoint3D_big;
 ANALYZE tbl_tgeogpoint3D_big;
 
+-- Joint histogram of the spatial and time dimensions
+SELECT count(*) FROM pg_statistic WHERE starelid = 'tbl_tgeompoint3D_big'::regclass AND 10 IN (stakind1, stakind2, stakind3, stakind4, stakind5);
+
+-- Join selectivity from the 2D statistics of 2D columns and the ND statistics
+-- of 3D columns, which differs from the default selectivity
+ANALYZE tbl_tgeompoint;
+ANALYZE tbl_tgeompoint3D;
+SELECT count(*) FROM pg_statistic WHERE starelid = 'tbl_tgeompoint'::regclass AND 103 IN (stakind1, stakind2, stakind3, stakind4, stakind5);
+SELECT count(*) FROM pg_statistic WHERE starelid = 'tbl_tgeompoint3D'::regclass AND 102 IN (stakind1, stakind2, stakind3, stakind4, stakind5);
+DROP FUNCTION IF EXISTS join_plan_rows;
+CREATE FUNCTION join_plan_rows(query text)
+RETURNS float AS $$
+DECLARE
+	J json;
+BEGIN
+	EXECUTE 'EXPLAIN (FORMAT JSON) ' || query INTO J;
+	RETURN (J->0->'Plan'->>'Plan Rows')::float;
+END;
+$$ LANGUAGE 'plpgsql';
+SELECT join_plan_rows('SELECT * FROM tbl_tgeompoint t1, tbl_tgeompoint t2 WHERE t1.temp && t2.temp') <> round((SELECT count(*) FROM tbl_tgeompoint)^2 * 0.005);
+SELECT join_plan_rows('SELECT * FROM tbl_tgeompoint3D t1, tbl_tgeompoint3D t2 WHERE t1.temp && t2.temp') <> round((SELECT count(*) FROM tbl_tgeompoint3D)^2 * 0.005);
+DROP FUNCTION join_plan_rows;
+
 DROP INDEX IF EXISTS tbl_tgeompoint3D_big_gist_idx;
 DROP INDEX IF EXISTS tbl_tgeogpoint3D_big_gist_idx;
 
@@ -64,6 +64,9 @@
 
 #include "lifting.h"
 
+#include <assert.h>
+#include <math.h>
+#include <utils/memutils.h>
 #include <utils/timestamp.h>
 
 #include "period.h"
@@ -999,123 +1002,57 @@ sync_tfunc2_temporalseq_temporalseq(TemporalSeq *seq1, TemporalSeq *seq2,
 	bool (*interpoint)(TemporalInst *, TemporalInst *, TemporalInst *, TemporalInst *, TimestampTz *))
 {
 	/* Test whether the bounding period of the two temporal values overlap */
-	Period *inter = intersection_period_period_internal(&seq1->period, 
-		&seq2->period);
-	if (inter == NULL)
+	TemporalSeqSync sync;
+	if (! temporalseq_sync_init(&sync, seq1, seq2))
 		return NULL;
 	
-	/* If the two sequences intersect at an instant */
-	if (timestamp_cmp_internal(inter->lower, inter->upper) == 0)
-	{
-		Datum value1, value2;
-		temporalseq_value_at_timestamp(seq1, inter->lower, &value1);
-		temporalseq_value_at_timestamp(seq2, inter->lower, &value2);
-		Datum value = func(value1, value2);
-		TemporalInst *inst = temporalinst_make(value, inter->lower, valuetypid);
-		/* Result has stepwise interpolation */
-		TemporalSeq *result = temporalseq_from_temporalinstarr(&inst, 1, 
-			true, true, linear, false);
-		FREE_DATUM(value1, seq1->valuetypid); FREE_DATUM(value2, seq2->valuetypid);
-		FREE_DATUM(value, valuetypid); pfree(inst); pfree(inter);
-		return result;
-	}
-	
 	/* 
-	 * General case 
 	 * seq1 =  ...    *       *       *>
 	 * seq2 =    <*       *   *   * ...
 	 * result =  <X I X I X I * I X I X>
 	 * where X, I, and * are values computed, respectively at synchronization points, 
 	 * intermediate points, and common points
+	 * The intermediate instants and values are allocated in an arena that
+	 * is deleted once the result is built.
 	 */
-	TemporalInst *inst1 = temporalseq_inst_n(seq1, 0);
-	TemporalInst *inst2 = temporalseq_inst_n(seq2, 0);
-	TemporalInst *tofreeinst = NULL;
-	int i = 0, j = 0, k = 0, l = 0;
-	if (timestamp_cmp_internal(inst1->t, inter->lower) < 0)
-	{
-		inst1 = temporalseq_at_timestamp(seq1, inter->lower);
-		tofreeinst = inst1;
-		i = temporalseq_find_timestamp(seq1, inter->lower);
-	}
-	else if (timestamp_cmp_internal(inst2->t, inter->lower) < 0)
-	{
-		inst2 = temporalseq_at_timestamp(seq2, inter->lower);
-		tofreeinst = inst2;
-		j = temporalseq_find_timestamp(seq2, inter->lower);
-	}
-	int count = (seq1->count - i + seq2->count - j) * 2;
+	MemoryContext arena = temporal_arena_create();
+	MemoryContext oldcontext = MemoryContextSwitchTo(arena);
+	int count = (seq1->count + seq2->count) * 2;
 	TemporalInst **instants = palloc(sizeof(TemporalInst *) * count);
-	TemporalInst **tofree = palloc(sizeof(TemporalInst *) * count);
-	if (tofreeinst != NULL)
-		tofree[l++] = tofreeinst;
-	TemporalInst *prev1, *prev2;
+	int k = 0;
 	Datum inter1, inter2, value;
 	TimestampTz intertime;
-	while (i < seq1->count && j < seq2->count &&
-		(timestamp_cmp_internal(inst1->t, inter->upper) <= 0 ||
-		timestamp_cmp_internal(inst2->t, inter->upper) <= 0))
+	while (temporalseq_sync_next(&sync))
 	{
-		int cmp = timestamp_cmp_internal(inst1->t, inst2->t);
-		if (cmp == 0)
-		{
-			i++; j++;
-		}
-		else if (cmp < 0)
-		{
-			i++;
-			inst2 = temporalseq_at_timestamp(seq2, inst1->t);
-			tofree[l++] = inst2;
-		}
-		else 
-		{
-			j++;
-			inst1 = temporalseq_at_timestamp(seq1, inst2->t);
-			tofree[l++] = inst1;
-		}
 		/* If not the first instant compute the function on the potential
 		   intermediate point before adding the new instants */
 		if (interpoint != NULL && k > 0 && 
-			interpoint(prev1, inst1, prev2, inst2, &intertime))
+			interpoint(sync.prev1, sync.inst1, sync.prev2, sync.inst2, &intertime))
 		{
-			inter1 = temporalseq_value_at_timestamp1(prev1, inst1, 
+			inter1 = temporalseq_value_at_timestamp1(sync.prev1, sync.inst1, 
 				MOBDB_FLAGS_GET_LINEAR(seq1->flags), intertime);
-			inter2 = temporalseq_value_at_timestamp1(prev2, inst2, 
+			inter2 = temporalseq_value_at_timestamp1(sync.prev2, sync.inst2, 
 				MOBDB_FLAGS_GET_LINEAR(seq2->flags), intertime);
 			value = func(inter1, inter2);
 			instants[k++] = temporalinst_make(value, intertime, valuetypid);
-			FREE_DATUM(inter1, seq1->valuetypid); FREE_DATUM(inter2, seq2->valuetypid);
-			FREE_DATUM(value, valuetypid);
 		}
-		value = func(temporalinst_value(inst1), temporalinst_value(inst2));
-		instants[k++] = temporalinst_make(value, inst1->t, valuetypid);
-		FREE_DATUM(value, valuetypid);
-		if (i == seq1->count || j == seq2->count)
-			break;
-		prev1 = inst1; prev2 = inst2;
-		inst1 = temporalseq_inst_n(seq1, i);
-		inst2 = temporalseq_inst_n(seq2, j);
+		value = func(temporalinst_value(sync.inst1), temporalinst_value(sync.inst2));
+		instants[k++] = temporalinst_make(value, sync.inst1->t, valuetypid);
 	}
+	temporalseq_sync_free(&sync);
 	/* We are sure that k != 0 due to the period intersection test above */
 	/* The last two values of sequences with stepwise interpolation and  
 	   exclusive upper bound must be equal */
-	if (!linear && !inter->upper_inc && k > 1)
+	if (!linear && !sync.inter.upper_inc && k > 1)
 	{
-		tofree[l++] = instants[k - 1];
 		value = temporalinst_value(instants[k - 2]);
 		instants[k - 1] = temporalinst_make(value, instants[k - 1]->t, valuetypid); 		
 	}
 
-   TemporalSeq *result = temporalseq_from_temporalinstarr(instants, k, 
-		inter->lower_inc, inter->upper_inc, linear, true);
-	
-	for (i = 0; i < k; i++)
-		pfree(instants[i]); 
-	pfree(instants);
-	for (i = 0; i < l; i++)
-		pfree(tofree[i]);
-	pfree(tofree); pfree(inter);
-
+	MemoryContextSwitchTo(oldcontext);
+	TemporalSeq *result = temporalseq_from_temporalinstarr(instants, k, 
+		sync.inter.lower_inc, sync.inter.upper_inc, linear, true);
+	MemoryContextDelete(arena);
 	return result; 
 }
 
@@ -1135,6 +1072,8 @@ sync_tfunc2_temporals_temporalseq(TemporalS *ts, TemporalSeq *seq,
 	int n;
 	temporals_find_timestamp(ts, seq->period.lower, &n);
 	/* We are sure that n < ts->count due to the bounding period test above */
+	MemoryContext arena = temporal_arena_create();
+	MemoryContext oldcontext = MemoryContextSwitchTo(arena);
 	TemporalSeq **sequences = palloc(sizeof(TemporalSeq *) * (ts->count - n));
 	int k = 0;
 	for (int i = n; i < ts->count; i++)
@@ -1149,17 +1088,16 @@ sync_tfunc2_temporals_temporalseq(TemporalS *ts, TemporalSeq *seq,
 			(!seq->period.upper_inc || seq1->period.upper_inc)))
 			break;
 	}
+	MemoryContextSwitchTo(oldcontext);
 	if (k == 0)
 	{
-		pfree(sequences);
+		MemoryContextDelete(arena);
 		return NULL;
 	}
 	
 	TemporalS *result = temporals_from_temporalseqarr(sequences, k,
 		linear, false);
-	for (int i = 0; i < k; i++) 
-		pfree(sequences[i]);
-	pfree(sequences);
+	MemoryContextDelete(arena);
 	return result;
 }
 
@@ -1184,6 +1122,8 @@ sync_tfunc2_temporals_temporals(TemporalS *ts1, TemporalS *ts2,
 		return NULL;
 	
 	/* Previously it was Max(ts1->count, ts2->count) and was not correct */
+	MemoryContext arena = temporal_arena_create();
+	MemoryContext oldcontext = MemoryContextSwitchTo(arena);
 	TemporalSeq **sequences = palloc(sizeof(TemporalSeq *) * 
 		(ts1->count + ts2->count));
 	int i = 0, j = 0, k = 0;
@@ -1212,17 +1152,16 @@ sync_tfunc2_temporals_temporals(TemporalS *ts1, TemporalS *ts2,
 		else 
 			j++;
 	}
+	MemoryContextSwitchTo(oldcontext);
 	if (k == 0)
 	{
-		pfree(sequences); 
+		MemoryContextDelete(arena);
 		return NULL;
 	}
 	
 	TemporalS *result = temporals_from_temporalseqarr(sequences, k,
 		linear, false);
-	for (i = 0; i < k; i++)
-		pfree(sequences[i]);
-	pfree(sequences); 
+	MemoryContextDelete(arena);
 	return result;
 }
 
@@ -2113,124 +2052,58 @@ sync_tfunc4_temporalseq_temporalseq(TemporalSeq *seq1, TemporalSeq *seq2,
 	bool (*interpoint)(TemporalInst *, TemporalInst *, TemporalInst *, TemporalInst *, TimestampTz *))
 {
 	/* Test whether the bounding period of the two temporal values overlap */
-	Period *inter = intersection_period_period_internal(&seq1->period, 
-		&seq2->period);
-	if (inter == NULL)
+	TemporalSeqSync sync;
+	if (! temporalseq_sync_init(&sync, seq1, seq2))
 		return NULL;
 	
-	/* If the two sequences intersect at an instant */
-	if (timestamp_cmp_internal(inter->lower, inter->upper) == 0)
-	{
-		Datum value1, value2;
-		temporalseq_value_at_timestamp(seq1, inter->lower, &value1);
-		temporalseq_value_at_timestamp(seq2, inter->lower, &value2);
-		Datum value = func(value1, value2, 
-			seq1->valuetypid, seq2->valuetypid);
-		TemporalInst *inst = temporalinst_make(value, inter->lower, valuetypid);
-		TemporalSeq *result = temporalseq_from_temporalinstarr(&inst, 1, 
-			true, true, linear, false);
-		FREE_DATUM(value1, seq1->valuetypid); FREE_DATUM(value2, seq2->valuetypid);
-		FREE_DATUM(value, valuetypid); pfree(inst); pfree(inter);
-		return result;
-	}
-	
 	/* 
-	 * General case 
 	 * seq1 =  ...    *       *       *>
 	 * seq2 =    <*       *   *   * ...
 	 * result =  <X I X I X I * I X I X>
 	 * where X, I, and * are values computed, respectively at synchronization points, 
 	 * intermediate points, and common points
+	 * The intermediate instants and values are allocated in an arena that
+	 * is deleted once the result is built.
 	 */
-	TemporalInst *inst1 = temporalseq_inst_n(seq1, 0);
-	TemporalInst *inst2 = temporalseq_inst_n(seq2, 0);
-	TemporalInst *tofreeinst = NULL;
-	int i = 0, j = 0, k = 0, l = 0;
-	if (timestamp_cmp_internal(inst1->t, inter->lower) < 0)
-	{
-		inst1 = temporalseq_at_timestamp(seq1, inter->lower);
-		tofreeinst = inst1;
-		i = temporalseq_find_timestamp(seq1, inter->lower);
-	}
-	else if (timestamp_cmp_internal(inst2->t, inter->lower) < 0)
-	{
-		inst2 = temporalseq_at_timestamp(seq2, inter->lower);
-		tofreeinst = inst2;
-		j = temporalseq_find_timestamp(seq2, inter->lower);
-	}
-	int count = (seq1->count - i + seq2->count - j) * 2;
+	MemoryContext arena = temporal_arena_create();
+	MemoryContext oldcontext = MemoryContextSwitchTo(arena);
+	int count = (seq1->count + seq2->count) * 2;
 	TemporalInst **instants = palloc(sizeof(TemporalInst *) * count);
-	TemporalInst **tofree = palloc(sizeof(TemporalInst *) * count);
-	if (tofreeinst != NULL)
-		tofree[l++] = tofreeinst;
-	TemporalInst *prev1, *prev2;
+	int k = 0;
 	Datum inter1, inter2, value;
 	TimestampTz intertime;
-	while (i < seq1->count && j < seq2->count &&
-		(timestamp_cmp_internal(inst1->t, inter->upper) <= 0 ||
-		timestamp_cmp_internal(inst2->t, inter->upper) <= 0))
+	while (temporalseq_sync_next(&sync))
 	{
-		int cmp = timestamp_cmp_internal(inst1->t, inst2->t);
-		if (cmp == 0)
-		{
-			i++; j++;
-		}
-		else if (cmp < 0)
-		{
-			i++;
-			inst2 = temporalseq_at_timestamp(seq2, inst1->t);
-			tofree[l++] = inst2;
-		}
-		else 
-		{
-			j++;
-			inst1 = temporalseq_at_timestamp(seq1, inst2->t);
-			tofree[l++] = inst1;
-		}
 		/* If not the first instant compute the function on the potential
 		   intermediate point before adding the new instants */
 		if (interpoint != NULL && k > 0 && 
-			interpoint(prev1, inst1, prev2, inst2, &intertime))
+			interpoint(sync.prev1, sync.inst1, sync.prev2, sync.inst2, &intertime))
 		{
-			inter1 = temporalseq_value_at_timestamp1(prev1, inst1, 
+			inter1 = temporalseq_value_at_timestamp1(sync.prev1, sync.inst1, 
 				MOBDB_FLAGS_GET_LINEAR(seq1->flags), intertime);
-			inter2 = temporalseq_value_at_timestamp1(prev2, inst2, 
+			inter2 = temporalseq_value_at_timestamp1(sync.prev2, sync.inst2, 
 				MOBDB_FLAGS_GET_LINEAR(seq2->flags), intertime);
 			value = func(inter1, inter2, seq1->valuetypid, seq2->valuetypid);
 			instants[k++] = temporalinst_make(value, intertime, valuetypid);
-			FREE_DATUM(inter1, seq1->valuetypid); FREE_DATUM(inter2, seq2->valuetypid);
-			FREE_DATUM(value, valuetypid);
 		}
-		value = func(temporalinst_value(inst1), temporalinst_value(inst2), 
+		value = func(temporalinst_value(sync.inst1), temporalinst_value(sync.inst2), 
 			seq1->valuetypid, seq2->valuetypid);
-		instants[k++] = temporalinst_make(value, inst1->t, valuetypid);
-		FREE_DATUM(value, valuetypid);
-		if (i == seq1->count || j == seq2->count)
-			break;
-		prev1 = inst1; prev2 = inst2;
-		inst1 = temporalseq_inst_n(seq1, i);
-		inst2 = temporalseq_inst_n(seq2, j);
+		instants[k++] = temporalinst_make(value, sync.inst1->t, valuetypid);
 	}
+	temporalseq_sync_free(&sync);
 	/* We are sure that k != 0 due to the period intersection test above */
 	/* The last two values of sequences with stepwise interpolation and  
 	   exclusive upper bound must be equal */
-	if (!linear && !inter->upper_inc && k > 1)
+	if (!linear && !sync.inter.upper_inc && k > 1)
 	{
-		tofree[l++] = instants[k - 1];
 		value = temporalinst_value(instants[k - 2]);
 		instants[k - 1] = temporalinst_make(value, instants[k - 1]->t, valuetypid); 		
 	}
 
-   TemporalSeq *result = temporalseq_from_temporalinstarr(instants, k, 
-		inter->lower_inc, inter->upper_inc, linear, true);
-	
-	for (i = 0; i < k; i++)
-		pfree(instants[i]); 
-	pfree(instants);
-	for (i = 0; i < l; i++)
-		pfree(tofree[i]);
-	pfree(tofree); pfree(inter);
-
+	MemoryContextSwitchTo(oldcontext);
+	TemporalSeq *result = temporalseq_from_temporalinstarr(instants, k, 
+		sync.inter.lower_inc, sync.inter.upper_inc, linear, true);
+	MemoryContextDelete(arena);
 	return result; 
 }
 
@@ -2250,6 +2123,8 @@ sync_tfunc4_temporals_temporalseq(TemporalS *ts, TemporalSeq *seq,
 	int n;
 	temporals_find_timestamp(ts, seq->period.lower, &n);
 	/* We are sure that n < ts->count due to the bounding period test above */
+	MemoryContext arena = temporal_arena_create();
+	MemoryContext oldcontext = MemoryContextSwitchTo(arena);
 	TemporalSeq **sequences = palloc(sizeof(TemporalSeq *) * (ts->count - n));
 	int k = 0;
 	for (int i = n; i < ts->count; i++)
@@ -2264,17 +2139,16 @@ sync_tfunc4_temporals_temporalseq(TemporalS *ts, TemporalSeq *seq,
 			(!seq->period.upper_inc || seq1->period.upper_inc)))
 			break;
 	}
+	MemoryContextSwitchTo(oldcontext);
 	if (k == 0)
 	{
-		pfree(sequences);
+		MemoryContextDelete(arena);
 		return NULL;
 	}
 	
 	TemporalS *result = temporals_from_temporalseqarr(sequences, k,
 		linear, false);
-	for (int i = 0; i < k; i++) 
-		pfree(sequences[i]);
-	pfree(sequences);
+	MemoryContextDelete(arena);
 	return result;
 }
 
@@ -2299,6 +2173,8 @@ sync_tfunc4_temporals_temporals(TemporalS *ts1, TemporalS *ts2,
 		return NULL;
 	
 	/* Previously it was Max(ts1->count, ts2->count) and was not correct */
+	MemoryContext arena = temporal_arena_create();
+	MemoryContext oldcontext = MemoryContextSwitchTo(arena);
 	TemporalSeq **sequences = palloc(sizeof(TemporalSeq *) * 
 		(ts1->count + ts2->count));
 	int i = 0, j = 0, k = 0;
@@ -2327,17 +2203,16 @@ sync_tfunc4_temporals_temporals(TemporalS *ts1, TemporalS *ts2,
 		else 
 			j++;
 	}
+	MemoryContextSwitchTo(oldcontext);
 	if (k == 0)
 	{
-		pfree(sequences); 
+		MemoryContextDelete(arena);
 		return NULL;
 	}
 	
 	TemporalS *result = temporals_from_temporalseqarr(sequences, k,
 		linear, false);
-	for (i = 0; i < k; i++)
-		pfree(sequences[i]);
-	pfree(sequences); 
+	MemoryContextDelete(arena);
 	return result;
 }
 
@@ -2580,82 +2455,39 @@ sync_tfunc2_temporalseq_temporalseq_cross2(TemporalSeq **result, TemporalSeq *se
 	TemporalSeq *seq2, Datum (*func)(Datum, Datum), Oid valuetypid)
 {
 	/* Test whether the bounding period of the two temporal values overlap */
-	Period *inter = intersection_period_period_internal(&seq1->period, 
-		&seq2->period);
-	if (inter == NULL)
+	TemporalSeqSync sync;
+	if (! temporalseq_sync_init(&sync, seq1, seq2))
 		return 0;
+	temporalseq_sync_next(&sync);
 	
 	/* If the two sequences intersect at an instant */
-	if (timestamp_cmp_internal(inter->lower, inter->upper) == 0)
+	if (timestamp_cmp_internal(sync.inter.lower, sync.inter.upper) == 0)
 	{
-		Datum startresult, value2;
-		temporalseq_value_at_timestamp(seq1, inter->lower, &startresult);
-		temporalseq_value_at_timestamp(seq2, inter->lower, &value2);
-		Datum value = func(startresult, value2);
-		TemporalInst *inst = temporalinst_make(value, inter->lower, valuetypid);
+		Datum value = func(temporalinst_value(sync.inst1), temporalinst_value(sync.inst2));
+		TemporalInst *inst = temporalinst_make(value, sync.inter.lower, valuetypid);
 		/* Result has stepwise interpolation */
 		result[0] = temporalseq_from_temporalinstarr(&inst, 1, true, true, 
 			false, false);
-		FREE_DATUM(startresult, seq1->valuetypid);
-		FREE_DATUM(value2, seq2->valuetypid);
-		FREE_DATUM(value, valuetypid); pfree(inst); pfree(inter);
+		FREE_DATUM(value, valuetypid); pfree(inst); 
+		temporalseq_sync_free(&sync);
 		return 1;
 	}
 
 	/* General case */
-	TemporalInst **tofree = palloc(sizeof(TemporalInst *) * 
-		(seq1->count + seq2->count) * 2);
-	TemporalInst *start1 = temporalseq_inst_n(seq1, 0);
-	TemporalInst *start2 = temporalseq_inst_n(seq2, 0);
-	int i = 1, j = 1, k = 0, l = 0;
-	if (timestamp_cmp_internal(start1->t, inter->lower) < 0)
-	{
-		start1 = temporalseq_at_timestamp(seq1, inter->lower);
-		tofree[l++] = start1;
-		i = temporalseq_find_timestamp(seq1, inter->lower) + 1;
-	}
-	else if (timestamp_cmp_internal(start2->t, inter->lower) < 0)
-	{
-		start2 = temporalseq_at_timestamp(seq2, inter->lower);
-		tofree[l++] = start2;
-		j = temporalseq_find_timestamp(seq2, inter->lower) + 1;
-	}
-	bool lower_inc = inter->lower_inc;
-	while (i < seq1->count && j < seq2->count)
+	int k = 0;
+	bool lower_inc = sync.inter.lower_inc;
+	while (temporalseq_sync_next(&sync))
 	{
-		TemporalInst *end1 = temporalseq_inst_n(seq1, i);
-		TemporalInst *end2 = temporalseq_inst_n(seq2, j);
-		int cmp = timestamp_cmp_internal(end1->t, end2->t);
-		if (cmp == 0)
-		{
-			i++; j++;			
-		}
-		else if (cmp < 0)
-		{
-			i++;
-			end2 = temporalseq_at_timestamp1(start2, end2,
-				MOBDB_FLAGS_GET_LINEAR(seq2->flags), end1->t);
-			tofree[l++] = end2;
-		}
-		else
-		{
-			j++;
-			end1 = temporalseq_at_timestamp1(start1, end1,
-				MOBDB_FLAGS_GET_LINEAR(seq1->flags), end2->t);
-			tofree[l++] = end1;
-		}
-		bool upper_inc = (timestamp_cmp_internal(end1->t, inter->upper) == 0) ? 
-			inter->upper_inc : false;
+		bool upper_inc = (timestamp_cmp_internal(sync.inst1->t, 
+			sync.inter.upper) == 0) ? sync.inter.upper_inc : false;
 		/* The next step adds between one and three sequences */
 		k += sync_tfunc2_temporalseq_temporalseq_cross1(&result[k], 
-			start1, end1, MOBDB_FLAGS_GET_LINEAR(seq1->flags), 
-			start2, end2, MOBDB_FLAGS_GET_LINEAR(seq2->flags), 
+			sync.prev1, sync.inst1, MOBDB_FLAGS_GET_LINEAR(seq1->flags), 
+			sync.prev2, sync.inst2, MOBDB_FLAGS_GET_LINEAR(seq2->flags), 
 			lower_inc, upper_inc, func, valuetypid);
-		start1 = end1;
-		start2 = end2;
 		lower_inc = true;
 	}
-	pfree(inter);
+	temporalseq_sync_free(&sync);
 	return k;
 }
 
@@ -2663,18 +2495,22 @@ TemporalS *
 sync_tfunc2_temporalseq_temporalseq_cross(TemporalSeq *seq1, TemporalSeq *seq2, 
 	Datum (*func)(Datum, Datum), Oid valuetypid)
 {
+	MemoryContext arena = temporal_arena_create();
+	MemoryContext oldcontext = MemoryContextSwitchTo(arena);
 	TemporalSeq **sequences = palloc(sizeof(TemporalSeq *) * 
 		(seq1->count + seq2->count) * 3);
 	int count = sync_tfunc2_temporalseq_temporalseq_cross2(sequences,
 		seq1, seq2, func, valuetypid); 
+	MemoryContextSwitchTo(oldcontext);
 	if (count == 0)
+	{
+		MemoryContextDelete(arena);
 		return NULL;
+	}
 	/* Result has stepwise interpolation */
 	TemporalS *result = temporals_from_temporalseqarr(sequences, count,
 		false, true);
-	for (int i = 0; i < count; i++)
-		pfree(sequences[i]);
-	pfree(sequences);
+	MemoryContextDelete(arena);
 	return result;
 }
 
@@ -2686,6 +2522,8 @@ TemporalS *
 sync_tfunc2_temporals_temporalseq_cross(TemporalS *ts, TemporalSeq *seq, 
 	Datum (*func)(Datum, Datum), Oid valuetypid)
 {
+	MemoryContext arena = temporal_arena_create();
+	MemoryContext oldcontext = MemoryContextSwitchTo(arena);
 	TemporalSeq **sequences = palloc(sizeof(TemporalSeq *) * 
 		(ts->totalcount + seq->count) * 3);
 	int k = 0;
@@ -2695,18 +2533,16 @@ sync_tfunc2_temporals_temporalseq_cross(TemporalS *ts, TemporalSeq *seq,
 		k += sync_tfunc2_temporalseq_temporalseq_cross2(&sequences[k], 
 			seq1, seq, func, valuetypid);
 	}
+	MemoryContextSwitchTo(oldcontext);
 	if (k == 0)
 	{
-		pfree(sequences);
+		MemoryContextDelete(arena);
 		return NULL;
 	}
 	/* Result has stepwise interpolation */
 	TemporalS *result = temporals_from_temporalseqarr(sequences, k,
 		false, true);
-
-	for (int i = 0; i < k; i++)
-		pfree(sequences[i]);
-	pfree(sequences); 
+	MemoryContextDelete(arena);
 	
 	return result;
 }
@@ -2722,6 +2558,8 @@ TemporalS *
 sync_tfunc2_temporals_temporals_cross(TemporalS *ts1, TemporalS *ts2, 
 	Datum (*func)(Datum, Datum), Oid valuetypid)
 {
+	MemoryContext arena = temporal_arena_create();
+	MemoryContext oldcontext = MemoryContextSwitchTo(arena);
 	TemporalSeq **sequences = palloc(sizeof(TemporalSeq *) * 
 		(ts1->totalcount + ts2->totalcount) * 3);
 	int i = 0, j = 0, k = 0;
@@ -2731,27 +2569,35 @@ sync_tfunc2_temporals_temporals_cross(TemporalS *ts1, TemporalS *ts2,
 		TemporalSeq *seq2 = temporals_seq_n(ts2, j);
 		k += sync_tfunc2_temporalseq_temporalseq_cross2(&sequences[k], 
 			seq1, seq2, func, valuetypid);
-		if (period_eq_internal(&seq1->period, &seq2->period))
+		/* Advance on the upper bounds so that no overlapping pair of 
+		   sequences is skipped */
+		int cmp = timestamp_cmp_internal(seq1->period.upper, seq2->period.upper);
+		if (cmp == 0)
+		{
+			if (!seq1->period.upper_inc && seq2->period.upper_inc)
+				cmp = -1;
+			else if (seq1->period.upper_inc && !seq2->period.upper_inc)
+				cmp = 1;
+		}
+		if (cmp == 0)
 		{
 			i++; j++;
 		}
-		else if (period_lt_internal(&seq1->period, &seq2->period))
+		else if (cmp < 0)
 			i++; 
 		else 
 			j++;
 	}
+	MemoryContextSwitchTo(oldcontext);
 	if (k == 0)
 	{
-		pfree(sequences);
+		MemoryContextDelete(arena);
 		return NULL;
 	}
 	/* Result has stepwise interpolation */
 	TemporalS *result = temporals_from_temporalseqarr(sequences, k,
 		false, true);
-
-	for (i = 0; i < k; i++)
-		pfree(sequences[i]);
-	pfree(sequences); 
+	MemoryContextDelete(arena);
 	
 	return result;
 }
@@ -2978,81 +2824,40 @@ sync_tfunc3_temporalseq_temporalseq_cross2(TemporalSeq **result,
 	Datum param, Datum (*func)(Datum, Datum, Datum), Oid valuetypid)
 {
 	/* Test whether the bounding period of the two temporal values overlap */
-	Period *inter = intersection_period_period_internal(&seq1->period, 
-		&seq2->period);
-	if (inter == NULL)
+	TemporalSeqSync sync;
+	if (! temporalseq_sync_init(&sync, seq1, seq2))
 		return 0;
+	temporalseq_sync_next(&sync);
 	
 	/* If the two sequences intersect at an instant */
-	if (timestamp_cmp_internal(inter->lower, inter->upper) == 0)
+	if (timestamp_cmp_internal(sync.inter.lower, sync.inter.upper) == 0)
 	{
-		Datum value1, value2;
-		temporalseq_value_at_timestamp(seq1, inter->lower, &value1);
-		temporalseq_value_at_timestamp(seq2, inter->lower, &value2);
-		Datum value = func(value1, value2, param);
-		TemporalInst *inst = temporalinst_make(value, inter->lower, valuetypid);
+		Datum value = func(temporalinst_value(sync.inst1), 
+			temporalinst_value(sync.inst2), param);
+		TemporalInst *inst = temporalinst_make(value, sync.inter.lower, valuetypid);
 		/* Result has stepwise interpolation */
-		result[0] = temporalseq_from_temporalinstarr(&inst, 1, true, true,
+		result[0] = temporalseq_from_temporalinstarr(&inst, 1, true, true, 
 			false, false);
-		FREE_DATUM(value1, seq1->valuetypid); FREE_DATUM(value2, seq2->valuetypid);
-		FREE_DATUM(value, valuetypid); pfree(inst); pfree(inter);
+		FREE_DATUM(value, valuetypid); pfree(inst); 
+		temporalseq_sync_free(&sync);
 		return 1;
 	}
 
 	/* General case */
-	TemporalInst **tofree = palloc(sizeof(TemporalInst *) * 
-		(seq1->count + seq2->count) * 2);
-	TemporalInst *start1 = temporalseq_inst_n(seq1, 0);
-	TemporalInst *start2 = temporalseq_inst_n(seq2, 0);
-	int i = 1, j = 1, k = 0, l = 0;
-	if (timestamp_cmp_internal(start1->t, inter->lower) < 0)
-	{
-		start1 = temporalseq_at_timestamp(seq1, inter->lower);
-		tofree[l++] = start1;
-		i = temporalseq_find_timestamp(seq1, inter->lower) + 1;
-	}
-	else if (timestamp_cmp_internal(start2->t, inter->lower) < 0)
+	int k = 0;
+	bool lower_inc = sync.inter.lower_inc;
+	while (temporalseq_sync_next(&sync))
 	{
-		start2 = temporalseq_at_timestamp(seq2, inter->lower);
-		tofree[l++] = start2;
-		j = temporalseq_find_timestamp(seq2, inter->lower) + 1;
+		bool upper_inc = (timestamp_cmp_internal(sync.inst1->t, 
+			sync.inter.upper) == 0) ? sync.inter.upper_inc : false;
+		/* The next step adds between one and three sequences */
+		k += sync_tfunc3_temporalseq_temporalseq_cross1(&result[k], 
+			sync.prev1, sync.inst1, MOBDB_FLAGS_GET_LINEAR(seq1->flags), 
+			sync.prev2, sync.inst2, MOBDB_FLAGS_GET_LINEAR(seq2->flags), 
+			lower_inc, upper_inc, param, func, valuetypid);
+		lower_inc = true;
 	}
-	bool lower_inc = inter->lower_inc;
-	while (i < seq1->count && j < seq2->count)
-	{
-		TemporalInst *end1 = temporalseq_inst_n(seq1, i);
-		TemporalInst *end2 = temporalseq_inst_n(seq2, j);
-		int cmp = timestamp_cmp_internal(end1->t, end2->t);
-		if (cmp == 0)
-		{
-			i++; j++;			
-		}
-		else if (cmp < 0)
-		{
-			i++;
-			end2 = temporalseq_at_timestamp1(start2, end2,
-				MOBDB_FLAGS_GET_LINEAR(seq2->flags), end1->t);
-			tofree[l++] = end2;
-		}
-		else
-		{
-			j++;
-			end1 = temporalseq_at_timestamp1(start1, end1,
-				MOBDB_FLAGS_GET_LINEAR(seq1->flags), end2->t);
-			tofree[l++] = end1;
-		}
-		bool upper_inc = (timestamp_cmp_internal(end1->t, inter->upper) == 0) ? 
-			inter->upper_inc : false;
-		/* The next step adds between one and three sequences */
-		k += sync_tfunc3_temporalseq_temporalseq_cross1(&result[k],
-			start1, end1, MOBDB_FLAGS_GET_LINEAR(seq1->flags), 
-			start2, end2, MOBDB_FLAGS_GET_LINEAR(seq2->flags),
-			lower_inc, upper_inc, param, func, valuetypid);
-		start1 = end1;
-		start2 = end2;
-		lower_inc = true;
-	}
-	pfree(inter);
+	temporalseq_sync_free(&sync);
 	return k;
 }
 
@@ -3061,19 +2866,22 @@ TemporalS *
 sync_tfunc3_temporalseq_temporalseq_cross(TemporalSeq *seq1, TemporalSeq *seq2, 
 	Datum param, Datum (*func)(Datum, Datum, Datum), Oid valuetypid)
 {
+	MemoryContext arena = temporal_arena_create();
+	MemoryContext oldcontext = MemoryContextSwitchTo(arena);
 	TemporalSeq **sequences = palloc(sizeof(TemporalSeq *) * 
 		(seq1->count + seq2->count) * 3);
 	int count = sync_tfunc3_temporalseq_temporalseq_cross2(sequences,
 		seq1, seq2, param, func, valuetypid); 
+	MemoryContextSwitchTo(oldcontext);
 	if (count == 0)
+	{
+		MemoryContextDelete(arena);
 		return NULL;
+	}
 	/* Result has stepwise interpolation */
 	TemporalS *result = temporals_from_temporalseqarr(sequences, count,
 		false, true);
-		
-	for (int i = 0; i < count; i++)
-		pfree(sequences[i]);
-	pfree(sequences);
+	MemoryContextDelete(arena);
 	return result;
 }
 
@@ -3085,6 +2893,8 @@ TemporalS *
 sync_tfunc3_temporals_temporalseq_cross(TemporalS *ts, TemporalSeq *seq, 
 	Datum param, Datum (*func)(Datum, Datum, Datum), Oid valuetypid)
 {
+	MemoryContext arena = temporal_arena_create();
+	MemoryContext oldcontext = MemoryContextSwitchTo(arena);
 	TemporalSeq **sequences = palloc(sizeof(TemporalSeq *) * 
 		(ts->totalcount + seq->count) * 3);
 	int k = 0;
@@ -3094,18 +2904,16 @@ sync_tfunc3_temporals_temporalseq_cross(TemporalS *ts, TemporalSeq *seq,
 		k += sync_tfunc3_temporalseq_temporalseq_cross2(&sequences[k], 
 			seq1, seq, param, func, valuetypid);
 	}
+	MemoryContextSwitchTo(oldcontext);
 	if (k == 0)
 	{
-		pfree(sequences);
+		MemoryContextDelete(arena);
 		return NULL;
 	}
 	/* Result has stepwise interpolation */
 	TemporalS *result = temporals_from_temporalseqarr(sequences, k,
 		false, true);
-
-	for (int i = 0; i < k; i++)
-		pfree(sequences[i]);
-	pfree(sequences); 
+	MemoryContextDelete(arena);
 	
 	return result;
 }
@@ -3130,6 +2938,8 @@ sync_tfunc3_temporals_temporals_cross(TemporalS *ts1, TemporalS *ts2,
 		return NULL;
 	
 	/* General case */
+	MemoryContext arena = temporal_arena_create();
+	MemoryContext oldcontext = MemoryContextSwitchTo(arena);
 	TemporalSeq **sequences = palloc(sizeof(TemporalSeq *) *
 		(ts1->totalcount + ts2->totalcount) * 3);
 	int i = 0, j = 0, k = 0;
@@ -3139,27 +2949,35 @@ sync_tfunc3_temporals_temporals_cross(TemporalS *ts1, TemporalS *ts2,
 		TemporalSeq *seq2 = temporals_seq_n(ts2, j);
 		k += sync_tfunc3_temporalseq_temporalseq_cross2(&sequences[k],
 			seq1, seq2, param, func, valuetypid);
-		if (period_eq_internal(&seq1->period, &seq2->period))
+		/* Advance on the upper bounds so that no overlapping pair of 
+		   sequences is skipped */
+		int cmp = timestamp_cmp_internal(seq1->period.upper, seq2->period.upper);
+		if (cmp == 0)
+		{
+			if (!seq1->period.upper_inc && seq2->period.upper_inc)
+				cmp = -1;
+			else if (seq1->period.upper_inc && !seq2->period.upper_inc)
+				cmp = 1;
+		}
+		if (cmp == 0)
 		{
 			i++; j++;
 		}
-		else if (period_lt_internal(&seq1->period, &seq2->period))
+		else if (cmp < 0)
 			i++; 
 		else 
 			j++;
 	}
+	MemoryContextSwitchTo(oldcontext);
 	if (k == 0)
 	{
-		pfree(sequences);
+		MemoryContextDelete(arena);
 		return NULL;
 	}
 	/* Result has stepwise interpolation */
 	TemporalS *result = temporals_from_temporalseqarr(sequences, k,
 		false, true);
-
-	for (i = 0; i < k; i++)
-		pfree(sequences[i]);
-	pfree(sequences); 
+	MemoryContextDelete(arena);
 	
 	return result;
 }
@@ -3391,82 +3209,40 @@ sync_tfunc4_temporalseq_temporalseq_cross2(TemporalSeq **result,
 	Datum (*func)(Datum, Datum, Oid, Oid), Oid valuetypid)
 {
 	/* Test whether the bounding period of the two temporal values overlap */
-	Period *inter = intersection_period_period_internal(&seq1->period, 
-		&seq2->period);
-	if (inter == NULL)
+	TemporalSeqSync sync;
+	if (! temporalseq_sync_init(&sync, seq1, seq2))
 		return 0;
+	temporalseq_sync_next(&sync);
 	
 	/* If the two sequences intersect at an instant */
-	if (timestamp_cmp_internal(inter->lower, inter->upper) == 0)
+	if (timestamp_cmp_internal(sync.inter.lower, sync.inter.upper) == 0)
 	{
-		Datum value1, value2;
-		temporalseq_value_at_timestamp(seq1, inter->lower, &value1);
-		temporalseq_value_at_timestamp(seq2, inter->lower, &value2);
-		Datum value = func(value1, value2, seq1->valuetypid, seq2->valuetypid);
-		TemporalInst *inst = temporalinst_make(value, inter->lower, valuetypid);
+		Datum value = func(temporalinst_value(sync.inst1), 
+			temporalinst_value(sync.inst2), seq1->valuetypid, seq2->valuetypid);
+		TemporalInst *inst = temporalinst_make(value, sync.inter.lower, valuetypid);
 		/* Result has stepwise interpolation */
 		result[0] = temporalseq_from_temporalinstarr(&inst, 1, true, true, 
 			false, false);
-		FREE_DATUM(value1, seq1->valuetypid); 
-		FREE_DATUM(value2, seq2->valuetypid);
-		FREE_DATUM(value, valuetypid); pfree(inst); pfree(inter);
+		FREE_DATUM(value, valuetypid); pfree(inst); 
+		temporalseq_sync_free(&sync);
 		return 1;
 	}
 
 	/* General case */
-	TemporalInst **tofree = palloc(sizeof(TemporalInst *) * 
-		(seq1->count + seq2->count) * 2);
-	TemporalInst *start1 = temporalseq_inst_n(seq1, 0);
-	TemporalInst *start2 = temporalseq_inst_n(seq2, 0);
-	int i = 1, j = 1, k = 0, l = 0;
-	if (timestamp_cmp_internal(start1->t, inter->lower) < 0)
-	{
-		start1 = temporalseq_at_timestamp(seq1, inter->lower);
-		tofree[l++] = start1;
-		i = temporalseq_find_timestamp(seq1, inter->lower) + 1;
-	}
-	else if (timestamp_cmp_internal(start2->t, inter->lower) < 0)
-	{
-		start2 = temporalseq_at_timestamp(seq2, inter->lower);
-		tofree[l++] = start2;
-		j = temporalseq_find_timestamp(seq2, inter->lower) + 1;
-	}
-	bool lower_inc = inter->lower_inc;
-	while (i < seq1->count && j < seq2->count)
+	int k = 0;
+	bool lower_inc = sync.inter.lower_inc;
+	while (temporalseq_sync_next(&sync))
 	{
-		TemporalInst *end1 = temporalseq_inst_n(seq1, i);
-		TemporalInst *end2 = temporalseq_inst_n(seq2, j);
-		int cmp = timestamp_cmp_internal(end1->t, end2->t);
-		if (cmp == 0)
-		{
-			i++; j++;			
-		}
-		else if (cmp < 0)
-		{
-			i++;
-			end2 = temporalseq_at_timestamp1(start2, end2, 
-				MOBDB_FLAGS_GET_LINEAR(seq2->flags), end1->t);
-			tofree[l++] = end2;
-		}
-		else
-		{
-			j++;
-			end1 = temporalseq_at_timestamp1(start1, end1,
-				MOBDB_FLAGS_GET_LINEAR(seq1->flags), end2->t);
-			tofree[l++] = end1;
-		}
-		bool upper_inc = (timestamp_cmp_internal(end1->t, inter->upper) == 0) ? 
-			inter->upper_inc : false;
+		bool upper_inc = (timestamp_cmp_internal(sync.inst1->t, 
+			sync.inter.upper) == 0) ? sync.inter.upper_inc : false;
 		/* The next step adds between one and three sequences */
 		k += sync_tfunc4_temporalseq_temporalseq_cross1(&result[k], 
-			start1, end1, MOBDB_FLAGS_GET_LINEAR(seq1->flags),
-			start2, end2, MOBDB_FLAGS_GET_LINEAR(seq2->flags),
+			sync.prev1, sync.inst1, MOBDB_FLAGS_GET_LINEAR(seq1->flags), 
+			sync.prev2, sync.inst2, MOBDB_FLAGS_GET_LINEAR(seq2->flags), 
 			lower_inc, upper_inc, func, valuetypid);
-		start1 = end1;
-		start2 = end2;
 		lower_inc = true;
 	}
-	pfree(inter);
+	temporalseq_sync_free(&sync);
 	return k;
 }
 
@@ -3474,19 +3250,22 @@ TemporalS *
 sync_tfunc4_temporalseq_temporalseq_cross(TemporalSeq *seq1, TemporalSeq *seq2, 
 	Datum (*func)(Datum, Datum, Oid, Oid), Oid valuetypid)
 {
+	MemoryContext arena = temporal_arena_create();
+	MemoryContext oldcontext = MemoryContextSwitchTo(arena);
 	TemporalSeq **sequences = palloc(sizeof(TemporalSeq *) * 
 		(seq1->count + seq2->count) * 3);
 	int count = sync_tfunc4_temporalseq_temporalseq_cross2(sequences,
 		seq1, seq2, func, valuetypid);
+	MemoryContextSwitchTo(oldcontext);
 	if (count == 0)
+	{
+		MemoryContextDelete(arena);
 		return NULL;
+	}
 	/* Result has stepwise interpolation */
 	TemporalS *result = temporals_from_temporalseqarr(sequences, count,
 		false, true);
-		
-	for (int i = 0; i < count; i++)
-		pfree(sequences[i]);
-	pfree(sequences);
+	MemoryContextDelete(arena);
 	return result;
 }
 
@@ -3498,6 +3277,8 @@ TemporalS *
 sync_tfunc4_temporals_temporalseq_cross(TemporalS *ts, TemporalSeq *seq, 
 	Datum (*func)(Datum, Datum, Oid, Oid), Oid valuetypid)
 {
+	MemoryContext arena = temporal_arena_create();
+	MemoryContext oldcontext = MemoryContextSwitchTo(arena);
 	TemporalSeq **sequences = palloc(sizeof(TemporalSeq *) *
 		(ts->totalcount + seq->count) * 3);
 	int k = 0;
@@ -3507,18 +3288,16 @@ sync_tfunc4_temporals_temporalseq_cross(TemporalS *ts, TemporalSeq *seq,
 		k += sync_tfunc4_temporalseq_temporalseq_cross2(&sequences[k],
 			seq1, seq, func, valuetypid);
 	}
+	MemoryContextSwitchTo(oldcontext);
 	if (k == 0)
 	{
-		pfree(sequences);
+		MemoryContextDelete(arena);
 		return NULL;
 	}
 	/* Result has stepwise interpolation */
 	TemporalS *result = temporals_from_temporalseqarr(sequences, k,
 		false, true);
-
-	for (int i = 0; i < k; i++)
-		pfree(sequences[i]);
-	pfree(sequences); 
+	MemoryContextDelete(arena);
 	
 	return result;
 }
@@ -3542,6 +3321,8 @@ sync_tfunc4_temporals_temporals_cross(TemporalS *ts1, TemporalS *ts2,
 		return NULL;
 	
 	/* General case */
+	MemoryContext arena = temporal_arena_create();
+	MemoryContext oldcontext = MemoryContextSwitchTo(arena);
 	TemporalSeq **sequences = palloc(sizeof(TemporalSeq *) *
 		(ts1->totalcount + ts2->totalcount) * 3);
 	int i = 0, j = 0, k = 0;
@@ -3551,27 +3332,35 @@ sync_tfunc4_temporals_temporals_cross(TemporalS *ts1, TemporalS *ts2,
 		TemporalSeq *seq2 = temporals_seq_n(ts2, j);
 		k += sync_tfunc4_temporalseq_temporalseq_cross2(&sequences[k],
 			seq1, seq2, func, valuetypid);
-		if (period_eq_internal(&seq1->period, &seq2->period))
+		/* Advance on the upper bounds so that no overlapping pair of 
+		   sequences is skipped */
+		int cmp = timestamp_cmp_internal(seq1->period.upper, seq2->period.upper);
+		if (cmp == 0)
+		{
+			if (!seq1->period.upper_inc && seq2->period.upper_inc)
+				cmp = -1;
+			else if (seq1->period.upper_inc && !seq2->period.upper_inc)
+				cmp = 1;
+		}
+		if (cmp == 0)
 		{
 			i++; j++;
 		}
-		else if (period_lt_internal(&seq1->period, &seq2->period))
+		else if (cmp < 0)
 			i++; 
 		else 
 			j++;
 	}
+	MemoryContextSwitchTo(oldcontext);
 	if (k == 0)
 	{
-		pfree(sequences);
+		MemoryContextDelete(arena);
 		return NULL;
 	}
 	/* Result has stepwise interpolation */
 	TemporalS *result = temporals_from_temporalseqarr(sequences, k,
 		false, true);
-
-	for (i = 0; i < k; i++)
-		pfree(sequences[i]);
-	pfree(sequences); 
+	MemoryContextDelete(arena);
 	
 	return result;
 }
@@ -3657,3 +3446,650 @@ sync_tfunc4_temporal_temporal_cross(Temporal *temp1, Temporal *temp2,
 
 /*****************************************************************************/
 
+/*****************************************************************************
+ * Lifting specialized on base types passed by value
+ *
+ * The generic functions above box every value into a Datum, call the lifted
+ * function through a pointer, and construct every instant with 
+ * temporalinst_make, which looks up the properties of the base type. The
+ * functions below are specialized for the comparison and Boolean operators 
+ * on temporal integers, floats, and Booleans, whose result is a temporal 
+ * Boolean. They read the values of the instants as doubles, apply the 
+ * operator inline, and construct the instants of the result in a single 
+ * buffer. The workers are always inlined and receive the operator as a 
+ * constant function pointer, so that the compiler generates one loop per
+ * operator from the LIFT_BYVAL_DISPATCH macro.
+ * The functions follow the same steps as their generic counterparts and
+ * therefore produce the same results.
+ *****************************************************************************/
+
+static inline bool lift_eq(double l, double r) { return l == r; }
+static inline bool lift_ne(double l, double r) { return l != r; }
+static inline bool lift_lt(double l, double r) { return l < r; }
+static inline bool lift_le(double l, double r) { return l <= r; }
+static inline bool lift_gt(double l, double r) { return l > r; }
+static inline bool lift_ge(double l, double r) { return l >= r; }
+static inline bool lift_and(double l, double r) { return l != 0 && r != 0; }
+static inline bool lift_or(double l, double r) { return l != 0 || r != 0; }
+
+/* Instantiate the call macro CALL for the kernel of the operator */
+
+#define LIFT_BYVAL_DISPATCH(oper, CALL) \
+	do { \
+		switch (oper) \
+		{ \
+			case LIFT_EQ: CALL(lift_eq); break; \
+			case LIFT_NE: CALL(lift_ne); break; \
+			case LIFT_LT: CALL(lift_lt); break; \
+			case LIFT_LE: CALL(lift_le); break; \
+			case LIFT_GT: CALL(lift_gt); break; \
+			case LIFT_GE: CALL(lift_ge); break; \
+			case LIFT_AND: CALL(lift_and); break; \
+			case LIFT_OR: CALL(lift_or); break; \
+		} \
+	} while (0)
+
+/* Operator obtained by swapping the arguments */
+
+static LiftOper
+lift_oper_commute(LiftOper oper)
+{
+	if (oper == LIFT_LT)
+		return LIFT_GT;
+	if (oper == LIFT_LE)
+		return LIFT_GE;
+	if (oper == LIFT_GT)
+		return LIFT_LT;
+	if (oper == LIFT_GE)
+		return LIFT_LE;
+	return oper;
+}
+
+/* Returns true if the base type has a specialized lifting */
+
+bool
+lift_byval_type(Oid valuetypid)
+{
+	return valuetypid == BOOLOID || valuetypid == INT4OID || 
+		valuetypid == FLOAT8OID;
+}
+
+/* 
+ * Returns true if the lifting of an operator on the two temporal values 
+ * can be specialized. Instants and instant sets are left to the generic 
+ * functions.
+ */
+
+bool
+sync_tfunc_byval_supported(Temporal *temp1, Temporal *temp2)
+{
+	return lift_byval_type(temp1->valuetypid) && 
+		lift_byval_type(temp2->valuetypid) &&
+		(temp1->duration == TEMPORALSEQ || temp1->duration == TEMPORALS) &&
+		(temp2->duration == TEMPORALSEQ || temp2->duration == TEMPORALS);
+}
+
+static double
+lift_byval_datum(Datum value, Oid valuetypid)
+{
+	if (valuetypid == FLOAT8OID)
+		return DatumGetFloat8(value);
+	if (valuetypid == INT4OID)
+		return (double) DatumGetInt32(value);
+	return DatumGetBool(value) ? 1.0 : 0.0;
+}
+
+static inline double
+lift_byval_value(TemporalInst *inst)
+{
+	return lift_byval_datum(temporalinst_value(inst), inst->valuetypid);
+}
+
+/* Value of a segment at a timestamp, as in temporalseq_value_at_timestamp1 */
+
+static double
+lift_byval_segment_value(TemporalInst *inst1, TemporalInst *inst2, 
+	bool linear, TimestampTz t)
+{
+	double value1 = lift_byval_value(inst1);
+	double value2 = lift_byval_value(inst2);
+	if (value1 == value2 || inst1->t == t || (! linear && t < inst2->t))
+		return value1;
+	if (inst2->t == t)
+		return value2;
+	double ratio = (double) (t - inst1->t) / (double) (inst2->t - inst1->t);
+	return value1 + (value2 - value1) * ratio;
+}
+
+/* 
+ * Timestamp at which a linear segment takes a value, as in 
+ * tlinearseq_timestamp_at_value 
+ */
+
+static bool
+lift_byval_segment_cross(double value1, double value2, TimestampTz lower,
+	TimestampTz upper, double value, TimestampTz *t)
+{
+	double min = Min(value1, value2);
+	double max = Max(value1, value2);
+	if (value < min || value > max)
+		return false;
+	double range = max - min;
+	double partial = value - min;
+	double fraction = value1 < value2 ? 
+		partial / range : 1 - partial / range;
+	if (fabs(fraction) < EPSILON || fabs(fraction - 1.0) < EPSILON)
+		return false;
+	*t = lower + (long) ((double) (upper - lower) * fraction);
+	return true;
+}
+
+/* 
+ * Construct a temporal Boolean sequence with stepwise interpolation from 
+ * one or two instants, reusing the two instants given in the first argument
+ */
+
+static TemporalSeq *
+tboolseq_piece(TemporalInst **instants, int count, bool value, 
+	TimestampTz lower, TimestampTz upper, bool lower_inc, bool upper_inc)
+{
+	*temporalinst_value_ptr(instants[0]) = BoolGetDatum(value);
+	instants[0]->t = lower;
+	if (count == 2)
+	{
+		*temporalinst_value_ptr(instants[1]) = BoolGetDatum(value);
+		instants[1]->t = upper;
+	}
+	return temporalseq_from_temporalinstarr(instants, count, lower_inc, 
+		upper_inc, false, false);
+}
+
+/* Allocate the two instants reused by tboolseq_piece */
+
+static TemporalInst **
+tboolseq_piece_instants(void)
+{
+	Datum values[2] = {BoolGetDatum(false), BoolGetDatum(false)};
+	TimestampTz times[2] = {0, 0};
+	return temporalinstarr_make_byval(values, times, 2, BOOLOID);
+}
+
+/*****************************************************************************/
+
+/* Apply the kernel to the values of the instants and a constant */
+
+static pg_attribute_always_inline void
+tfunc_byval_map(const double *values, int count, double value, 
+	Datum *result, bool (*kernel)(double, double))
+{
+	for (int i = 0; i < count; i++)
+		result[i] = BoolGetDatum(kernel(values[i], value));
+}
+
+/* 
+ * Apply the operator to the instants of a temporal instant, instant set, 
+ * or sequence and a constant. The result must be freed with 
+ * pfree(result[0]); pfree(result). 
+ */
+
+static TemporalInst **
+tfunc_byval_instarr(Temporal *temp, int count, double value, LiftOper oper)
+{
+	double *values = palloc(sizeof(double) * count);
+	TimestampTz *times = palloc(sizeof(TimestampTz) * count);
+	Datum *results = palloc(sizeof(Datum) * count);
+	for (int i = 0; i < count; i++)
+	{
+		TemporalInst *inst = (temp->duration == TEMPORALINST) ? 
+			(TemporalInst *) temp : (temp->duration == TEMPORALI) ?
+			temporali_inst_n((TemporalI *) temp, i) :
+			temporalseq_inst_n((TemporalSeq *) temp, i);
+		values[i] = lift_byval_value(inst);
+		times[i] = inst->t;
+	}
+#define CALL(kernel) tfunc_byval_map(values, count, value, results, &kernel)
+	LIFT_BYVAL_DISPATCH(oper, CALL);
+#undef CALL
+	TemporalInst **result = temporalinstarr_make_byval(results, times, count,
+		BOOLOID);
+	pfree(values); pfree(times); pfree(results);
+	return result;
+}
+
+static TemporalSeq *
+tfunc_byval_temporalseq(TemporalSeq *seq, double value, LiftOper oper)
+{
+	TemporalInst **instants = tfunc_byval_instarr((Temporal *) seq, 
+		seq->count, value, oper);
+	TemporalSeq *result = temporalseq_from_temporalinstarr(instants, 
+		seq->count, seq->period.lower_inc, seq->period.upper_inc, false, true);
+	pfree(instants[0]); pfree(instants);
+	return result;
+}
+
+/* 
+ * Apply the kernel to the segments of a sequence with linear interpolation
+ * and a constant adding the crossings, as tfunc4_temporalseq_base_cross2 
+ */
+
+static pg_attribute_always_inline int
+tfunc_byval_temporalseq_cross(TemporalSeq **result, TemporalSeq *seq,
+	double value, TemporalInst **instants, bool (*kernel)(double, double))
+{
+	TemporalInst *inst1 = temporalseq_inst_n(seq, 0);
+	double value1 = lift_byval_value(inst1);
+	/* Instantaneous sequence */
+	if (seq->count == 1)
+	{
+		result[0] = tboolseq_piece(instants, 1, kernel(value1, value),
+			inst1->t, inst1->t, true, true);
+		return 1;
+	}
+
+	int k = 0;
+	bool lower_inc = seq->period.lower_inc;
+	for (int i = 1; i < seq->count; i++)
+	{
+		TemporalInst *inst2 = temporalseq_inst_n(seq, i);
+		double value2 = lift_byval_value(inst2);
+		bool upper_inc = (i == seq->count - 1) ? seq->period.upper_inc : false;
+		TimestampTz lower = inst1->t, upper = inst2->t, inttime, crosstime;
+		bool startresult = kernel(value1, value);
+		if (value1 == value2)
+			/* Constant segment */
+			result[k++] = tboolseq_piece(instants, 2, startresult, 
+				lower, upper, lower_inc, upper_inc);
+		else if (value1 == value || value2 == value)
+		{
+			/* Compute the operator at the start, at the middle, and at
+			 * the end instants */
+			if (lower_inc)
+				result[k++] = tboolseq_piece(instants, 1, startresult, 
+					lower, lower, true, true);
+			inttime = lower + ((upper - lower) / 2);
+			result[k++] = tboolseq_piece(instants, 2, 
+				kernel(lift_byval_segment_value(inst1, inst2, true, inttime), 
+				value), lower, upper, false, false);
+			if (upper_inc)
+				result[k++] = tboolseq_piece(instants, 1, 
+					kernel(value2, value), upper, upper, true, true);
+		}
+		else if (! lift_byval_segment_cross(value1, value2, lower, upper, 
+			value, &crosstime))
+			result[k++] = tboolseq_piece(instants, 2, startresult, 
+				lower, upper, lower_inc, upper_inc);
+		else
+		{
+			/* Compute the operator before, at, and after the crossing */
+			result[k++] = tboolseq_piece(instants, 2, startresult, 
+				lower, crosstime, lower_inc, false);
+			result[k++] = tboolseq_piece(instants, 1, kernel(value, value), 
+				crosstime, crosstime, true, true);
+			inttime = crosstime + ((upper - crosstime) / 2);
+			result[k++] = tboolseq_piece(instants, 2, 
+				kernel(lift_byval_segment_value(inst1, inst2, true, inttime), 
+				value), crosstime, upper, false, upper_inc);
+		}
+		inst1 = inst2;
+		value1 = value2;
+		lower_inc = true;
+	}
+	return k;
+}
+
+static int
+tfunc_byval_temporalseq_cross_oper(TemporalSeq **result, TemporalSeq *seq,
+	double value, TemporalInst **instants, LiftOper oper)
+{
+	int k = 0;
+#define CALL(kernel) \
+	k = tfunc_byval_temporalseq_cross(result, seq, value, instants, &kernel)
+	LIFT_BYVAL_DISPATCH(oper, CALL);
+#undef CALL
+	return k;
+}
+
+/* 
+ * Apply an operator to a temporal integer, float, or Boolean and a 
+ * constant. The last argument states whether we are computing 
+ * base <oper> temporal or temporal <oper> base.
+ */
+
+Temporal *
+tfunc_byval_temporal_base(Temporal *temp, Datum value, Oid datumtypid,
+	LiftOper oper, bool invert)
+{
+	double d = lift_byval_datum(value, datumtypid);
+	if (invert)
+		oper = lift_oper_commute(oper);
+	Temporal *result = NULL;
+	ensure_valid_duration(temp->duration);
+	if (temp->duration == TEMPORALINST)
+	{
+		/* The single instant is the whole buffer of the array */
+		TemporalInst **instants = tfunc_byval_instarr(temp, 1, d, oper);
+		result = (Temporal *) instants[0];
+		pfree(instants);
+	}
+	else if (temp->duration == TEMPORALI)
+	{
+		TemporalI *ti = (TemporalI *) temp;
+		TemporalInst **instants = tfunc_byval_instarr(temp, ti->count, d, 
+			oper);
+		result = (Temporal *) temporali_from_temporalinstarr(instants, 
+			ti->count);
+		pfree(instants[0]); pfree(instants);
+	}
+	else if (temp->duration == TEMPORALSEQ && 
+		! MOBDB_FLAGS_GET_LINEAR(temp->flags))
+		result = (Temporal *) tfunc_byval_temporalseq((TemporalSeq *) temp,
+			d, oper);
+	else if (temp->duration == TEMPORALS && 
+		! MOBDB_FLAGS_GET_LINEAR(temp->flags))
+	{
+		TemporalS *ts = (TemporalS *) temp;
+		TemporalSeq **sequences = palloc(sizeof(TemporalSeq *) * ts->count);
+		for (int i = 0; i < ts->count; i++)
+			sequences[i] = tfunc_byval_temporalseq(temporals_seq_n(ts, i), 
+				d, oper);
+		result = (Temporal *) temporals_from_temporalseqarr(sequences, 
+			ts->count, false, true);
+		for (int i = 0; i < ts->count; i++)
+			pfree(sequences[i]);
+		pfree(sequences);
+	}
+	else
+	{
+		/* Sequence or sequence set with linear interpolation */
+		TemporalInst **instants = tboolseq_piece_instants();
+		int count = (temp->duration == TEMPORALSEQ) ? 
+			((TemporalSeq *) temp)->count : ((TemporalS *) temp)->totalcount;
+		TemporalSeq **sequences = palloc(sizeof(TemporalSeq *) * count * 3);
+		int k = 0;
+		if (temp->duration == TEMPORALSEQ)
+			k = tfunc_byval_temporalseq_cross_oper(sequences, 
+				(TemporalSeq *) temp, d, instants, oper);
+		else
+		{
+			TemporalS *ts = (TemporalS *) temp;
+			for (int i = 0; i < ts->count; i++)
+				k += tfunc_byval_temporalseq_cross_oper(&sequences[k], 
+					temporals_seq_n(ts, i), d, instants, oper);
+		}
+		/* Result has stepwise interpolation */
+		result = (Temporal *) temporals_from_temporalseqarr(sequences, k,
+			false, true);
+		for (int i = 0; i < k; i++)
+			pfree(sequences[i]);
+		pfree(sequences);
+		pfree(instants[0]); pfree(instants);
+	}
+	return result;
+}
+
+/*****************************************************************************/
+
+/* 
+ * Apply the kernel to two synchronized sequences with stepwise 
+ * interpolation, as sync_tfunc4_temporalseq_temporalseq 
+ */
+
+static pg_attribute_always_inline TemporalSeq *
+sync_byval_temporalseq_temporalseq(TemporalSeq *seq1, TemporalSeq *seq2,
+	bool (*kernel)(double, double))
+{
+	TemporalSeqSync sync;
+	if (! temporalseq_sync_init(&sync, seq1, seq2))
+		return NULL;
+
+	int count = seq1->count + seq2->count;
+	Datum *values = palloc(sizeof(Datum) * count);
+	TimestampTz *times = palloc(sizeof(TimestampTz) * count);
+	int k = 0;
+	while (temporalseq_sync_next(&sync))
+	{
+		values[k] = BoolGetDatum(kernel(lift_byval_value(sync.inst1), 
+			lift_byval_value(sync.inst2)));
+		times[k++] = sync.inst1->t;
+	}
+	temporalseq_sync_free(&sync);
+	/* The last two values of sequences with stepwise interpolation and  
+	   exclusive upper bound must be equal */
+	if (! sync.inter.upper_inc && k > 1)
+		values[k - 1] = values[k - 2];
+	TemporalInst **instants = temporalinstarr_make_byval(values, times, k,
+		BOOLOID);
+	TemporalSeq *result = temporalseq_from_temporalinstarr(instants, k, 
+		sync.inter.lower_inc, sync.inter.upper_inc, false, true);
+	pfree(instants[0]); pfree(instants);
+	pfree(values); pfree(times);
+	return result;
+}
+
+static TemporalSeq *
+sync_byval_temporalseq_temporalseq_oper(TemporalSeq *seq1, TemporalSeq *seq2,
+	LiftOper oper)
+{
+	TemporalSeq *result = NULL;
+#define CALL(kernel) \
+	result = sync_byval_temporalseq_temporalseq(seq1, seq2, &kernel)
+	LIFT_BYVAL_DISPATCH(oper, CALL);
+#undef CALL
+	return result;
+}
+
+/* 
+ * Apply the kernel to two synchronized sequences, at least one of them 
+ * with linear interpolation, adding the crossings, as 
+ * sync_tfunc4_temporalseq_temporalseq_cross2
+ */
+
+static pg_attribute_always_inline int
+sync_byval_temporalseq_temporalseq_cross(TemporalSeq **result, 
+	TemporalSeq *seq1, TemporalSeq *seq2, TemporalInst **instants,
+	bool (*kernel)(double, double))
+{
+	TemporalSeqSync sync;
+	if (! temporalseq_sync_init(&sync, seq1, seq2))
+		return 0;
+	temporalseq_sync_next(&sync);
+
+	/* If the two sequences intersect at an instant */
+	if (timestamp_cmp_internal(sync.inter.lower, sync.inter.upper) == 0)
+	{
+		result[0] = tboolseq_piece(instants, 1, 
+			kernel(lift_byval_value(sync.inst1), lift_byval_value(sync.inst2)),
+			sync.inter.lower, sync.inter.lower, true, true);
+		temporalseq_sync_free(&sync);
+		return 1;
+	}
+
+	bool linear1 = MOBDB_FLAGS_GET_LINEAR(seq1->flags);
+	bool linear2 = MOBDB_FLAGS_GET_LINEAR(seq2->flags);
+	int k = 0;
+	bool lower_inc = sync.inter.lower_inc;
+	while (temporalseq_sync_next(&sync))
+	{
+		TemporalInst *start1 = sync.prev1, *end1 = sync.inst1;
+		TemporalInst *start2 = sync.prev2, *end2 = sync.inst2;
+		double startvalue1 = lift_byval_value(start1);
+		double endvalue1 = lift_byval_value(end1);
+		double startvalue2 = lift_byval_value(start2);
+		double endvalue2 = lift_byval_value(end2);
+		TimestampTz lower = start1->t, upper = end1->t, inttime, crosstime;
+		bool upper_inc = (timestamp_cmp_internal(upper, 
+			sync.inter.upper) == 0) ? sync.inter.upper_inc : false;
+		bool startresult = kernel(startvalue1, startvalue2);
+		bool hascross;
+		
+		/* Both segments are constant */
+		if (startvalue1 == endvalue1 && startvalue2 == endvalue2)
+			result[k++] = tboolseq_piece(instants, 2, startresult, 
+				lower, upper, lower_inc, upper_inc);
+		/* The start values are equal or the end values are equal and both
+		 * segments are linear */
+		else if (startvalue1 == startvalue2 || 
+			(linear1 && linear2 && endvalue1 == endvalue2))
+		{
+			if (lower_inc)
+				result[k++] = tboolseq_piece(instants, 1, startresult, 
+					lower, lower, true, true);
+			inttime = lower + ((upper - lower) / 2);
+			result[k++] = tboolseq_piece(instants, 2, kernel(
+				lift_byval_segment_value(start1, end1, linear1, inttime),
+				lift_byval_segment_value(start2, end2, linear2, inttime)),
+				lower, upper, false, false);
+			if (upper_inc)
+				result[k++] = tboolseq_piece(instants, 1, 
+					kernel(endvalue1, endvalue2), upper, upper, true, true);
+		}
+		else
+		{
+			if (! linear1)
+				hascross = lift_byval_segment_cross(startvalue2, endvalue2, 
+					lower, upper, startvalue1, &crosstime);
+			else if (! linear2)
+				hascross = lift_byval_segment_cross(startvalue1, endvalue1, 
+					lower, upper, startvalue2, &crosstime);
+			else 
+				hascross = temporalseq_intersect_at_timestamp(start1, end1, 
+					linear1, start2, end2, linear2, &crosstime);
+			if (! hascross)
+			{
+				result[k++] = tboolseq_piece(instants, 2, startresult, 
+					lower, upper, lower_inc, false);
+				if (upper_inc)
+					result[k++] = tboolseq_piece(instants, 1, 
+						kernel(endvalue1, endvalue2), upper, upper, true, true);
+			}
+			else
+			{
+				result[k++] = tboolseq_piece(instants, 2, startresult, 
+					lower, crosstime, lower_inc, false);
+				result[k++] = tboolseq_piece(instants, 1, kernel(
+					lift_byval_segment_value(start1, end1, linear1, crosstime),
+					lift_byval_segment_value(start2, end2, linear2, crosstime)),
+					crosstime, crosstime, true, true);
+				result[k++] = tboolseq_piece(instants, 2, 
+					kernel(endvalue1, endvalue2), crosstime, upper, 
+					false, upper_inc);
+			}
+		}
+		lower_inc = true;
+	}
+	temporalseq_sync_free(&sync);
+	return k;
+}
+
+static int
+sync_byval_temporalseq_temporalseq_cross_oper(TemporalSeq **result, 
+	TemporalSeq *seq1, TemporalSeq *seq2, TemporalInst **instants, 
+	LiftOper oper)
+{
+	int k = 0;
+#define CALL(kernel) \
+	k = sync_byval_temporalseq_temporalseq_cross(result, seq1, seq2, \
+		instants, &kernel)
+	LIFT_BYVAL_DISPATCH(oper, CALL);
+#undef CALL
+	return k;
+}
+
+/* Composing sequences of a temporal sequence or sequence set */
+
+static inline int
+sync_byval_seqcount(Temporal *temp)
+{
+	return (temp->duration == TEMPORALSEQ) ? 1 : ((TemporalS *) temp)->count;
+}
+
+static inline int
+sync_byval_instcount(Temporal *temp)
+{
+	return (temp->duration == TEMPORALSEQ) ? ((TemporalSeq *) temp)->count :
+		((TemporalS *) temp)->totalcount;
+}
+
+static inline TemporalSeq *
+sync_byval_seq_n(Temporal *temp, int i)
+{
+	return (temp->duration == TEMPORALSEQ) ? (TemporalSeq *) temp :
+		temporals_seq_n((TemporalS *) temp, i);
+}
+
+/* 
+ * Apply an operator to two temporal integers, floats, or Booleans that are 
+ * sequences or sequence sets, as sync_tfunc4_temporal_temporal and
+ * sync_tfunc4_temporal_temporal_cross. The caller must ensure that 
+ * sync_tfunc_byval_supported holds for the arguments.
+ */
+
+Temporal *
+sync_tfunc_byval_temporal_temporal(Temporal *temp1, Temporal *temp2,
+	LiftOper oper)
+{
+	assert(sync_tfunc_byval_supported(temp1, temp2));
+	bool linear = MOBDB_FLAGS_GET_LINEAR(temp1->flags) || 
+		MOBDB_FLAGS_GET_LINEAR(temp2->flags);
+	if (! linear && temp1->duration == TEMPORALSEQ && 
+		temp2->duration == TEMPORALSEQ)
+		return (Temporal *) sync_byval_temporalseq_temporalseq_oper(
+			(TemporalSeq *) temp1, (TemporalSeq *) temp2, oper);
+
+	int count1 = sync_byval_seqcount(temp1);
+	int count2 = sync_byval_seqcount(temp2);
+	int count = linear ? (sync_byval_instcount(temp1) + 
+		sync_byval_instcount(temp2) + count1 + count2) * 3 : count1 + count2;
+	TemporalSeq **sequences = palloc(sizeof(TemporalSeq *) * count);
+	TemporalInst **instants = linear ? tboolseq_piece_instants() : NULL;
+	int i = 0, j = 0, k = 0;
+	while (i < count1 && j < count2)
+	{
+		TemporalSeq *seq1 = sync_byval_seq_n(temp1, i);
+		TemporalSeq *seq2 = sync_byval_seq_n(temp2, j);
+		if (linear)
+			k += sync_byval_temporalseq_temporalseq_cross_oper(&sequences[k],
+				seq1, seq2, instants, oper);
+		else
+		{
+			TemporalSeq *seq = sync_byval_temporalseq_temporalseq_oper(seq1, 
+				seq2, oper);
+			if (seq != NULL)
+				sequences[k++] = seq;
+		}
+		int cmp = timestamp_cmp_internal(seq1->period.upper, seq2->period.upper);
+		if (cmp == 0)
+		{
+			if (!seq1->period.upper_inc && seq2->period.upper_inc)
+				cmp = -1;
+			else if (seq1->period.upper_inc && !seq2->period.upper_inc)
+				cmp = 1;
+		}
+		if (cmp == 0)
+		{
+			i++; j++;
+		}
+		else if (cmp < 0)
+			i++; 
+		else 
+			j++;
+	}
+	if (instants != NULL)
+	{
+		pfree(instants[0]); pfree(instants);
+	}
+	if (k == 0)
+	{
+		pfree(sequences);
+		return NULL;
+	}
+	/* Result has stepwise interpolation */
+	TemporalS *result = temporals_from_temporalseqarr(sequences, k,
+		false, linear);
+	for (i = 0; i < k; i++)
+		pfree(sequences[i]);
+	pfree(sequences);
+	return (Temporal *) result;
+}
+
+/*****************************************************************************/
@@ -12,16 +12,17 @@
 
 #include "oidcache.h"
 
-#include <access/heapam.h>
-#include <access/htup_details.h>
 #include <catalog/namespace.h>
-#include <utils/rel.h>
+#include <nodes/value.h>
+#include <utils/hsearch.h>
+#include <utils/memutils.h>
 
 #include "temporaltypes.h"
 
 /*****************************************************************************
  * Global arrays for caching the OIDs in order to avoid (slow) lookups.
- * These arrays are initialized at the loading of the extension
+ * The Oids of the types are looked up on the first call in the backend, 
+ * those of the operators are looked up one by one when they are requested
  *****************************************************************************/
 
 const char *_type_names[] = 
@@ -99,9 +100,41 @@ const char *_op_names[] =
 
 bool _ready = false;
 Oid _type_oids[sizeof(_type_names) / sizeof(char *)];
-Oid _op_oids[sizeof(_op_names) / sizeof(char *)]
-	[sizeof(_type_names) / sizeof(char *)]
-	[sizeof(_type_names) / sizeof(char *)];
+
+/*
+ * Sparse cache of the operator Oids. Only a small fraction of the
+ * combinations operator/left argument/right argument are valid and only
+ * the ones requested by the backend are looked up and stored.
+ */
+
+typedef struct
+{
+	int32 op;
+	int32 ltype;
+	int32 rtype;
+} OperCacheKey;
+
+typedef struct
+{
+	OperCacheKey key;	/* hash key, must be first */
+	Oid oid;			/* InvalidOid for invalid combinations */
+} OperCacheEntry;
+
+static HTAB *_op_cache = NULL;
+
+/*
+ * The types and operators of the extension are looked up in the public
+ * schema, independently of the search path of the session
+ */
+
+static void
+push_public_search_path(void)
+{
+	Oid namespaceId = LookupNamespaceNoError("public");
+	OverrideSearchPath *overridePath = GetOverrideSearchPath(CurrentMemoryContext);
+	overridePath->schemas = lcons_oid(namespaceId, overridePath->schemas);
+	PushOverrideSearchPath(overridePath);
+}
 
 /* Fetch in the cache the oid of a type */
 
@@ -113,14 +146,64 @@ type_oid(CachedType t)
 	return _type_oids[t];
 }
 
+/* Look up in the catalog the oid of an operator */
+
+static Oid
+lookup_oper_oid(CachedOp op, CachedType lt, CachedType rt)
+{
+	Oid ltypid = type_oid(lt), rtypid = type_oid(rt);
+	List *lst = list_make1(makeString((char *) _op_names[op]));
+	/* Assigned inside PG_TRY and read after it, hence volatile */
+	volatile Oid result = InvalidOid;
+
+	push_public_search_path();
+	PG_TRY();
+	{
+		result = OpernameGetOprid(lst, ltypid, rtypid);
+	}
+	PG_CATCH();
+	{
+		PopOverrideSearchPath();
+		PG_RE_THROW();
+	}
+	PG_END_TRY();
+	PopOverrideSearchPath();
+	list_free_deep(lst);
+	return result;
+}
+
 /* Fetch in the cache the oid of an operator */
 
 Oid 
 oper_oid(CachedOp op, CachedType lt, CachedType rt)
 {
-	if (!_ready)
-		populate_oidcache();
-	return _op_oids[op][lt][rt];
+	if (_op_cache == NULL)
+	{
+		HASHCTL ctl;
+		MemSet(&ctl, 0, sizeof(ctl));
+		ctl.keysize = sizeof(OperCacheKey);
+		ctl.entrysize = sizeof(OperCacheEntry);
+		ctl.hcxt = TopMemoryContext;
+		_op_cache = hash_create("MobilityDB operator Oid cache", 256, &ctl,
+			HASH_ELEM | HASH_BLOBS | HASH_CONTEXT);
+	}
+
+	OperCacheKey key;
+	MemSet(&key, 0, sizeof(key));
+	key.op = (int32) op;
+	key.ltype = (int32) lt;
+	key.rtype = (int32) rt;
+	OperCacheEntry *entry = (OperCacheEntry *) hash_search(_op_cache, &key,
+		HASH_FIND, NULL);
+	if (entry != NULL)
+		return entry->oid;
+
+	/* Look up the operator before entering it so that an error does not 
+	 * leave an uninitialized entry in the cache */
+	Oid result = lookup_oper_oid(op, lt, rt);
+	entry = (OperCacheEntry *) hash_search(_op_cache, &key, HASH_ENTER, NULL);
+	entry->oid = result;
+	return result;
 }
 
 /* Populate the oid cache */
@@ -138,92 +221,26 @@ populate_types()
 	}
 }
 
+/*
+ * Populate the oid cache of the types. This only requires a syscache lookup
+ * per type, the operators are looked up on demand by oper_oid.
+ */
 void 
 populate_oidcache() 
 {
-	Oid namespaceId = LookupNamespaceNoError("public") ;
-	OverrideSearchPath* overridePath = GetOverrideSearchPath(CurrentMemoryContext);
-	overridePath->schemas = lcons_oid(namespaceId, overridePath->schemas);
-	PushOverrideSearchPath(overridePath);
-
+	push_public_search_path();
 	PG_TRY();
 	{
-
 		populate_types();
-		bzero(_op_oids, sizeof(_op_oids));
-
-		/*
-		 * This fetches the pre-computed operator cache from the catalog where
-		 * it is stored in a table. See the fill_opcache function below.
-		 */
-		Oid catalog = RelnameGetRelid("pg_temporal_opcache");
-		Relation rel = heap_open(catalog, AccessShareLock);
-		TupleDesc tupDesc = rel->rd_att;
-		ScanKeyData scandata;
-		HeapScanDesc scan = heap_beginscan_catalog(rel, 0, &scandata);
-		HeapTuple tuple = heap_getnext(scan, ForwardScanDirection);
-		while (HeapTupleIsValid(tuple))
-		{
-			bool isnull = false;
-			int32 i = DatumGetInt32(heap_getattr(tuple, 1, tupDesc, &isnull));
-			int32 j = DatumGetInt32(heap_getattr(tuple, 2, tupDesc, &isnull));
-			int32 k = DatumGetInt32(heap_getattr(tuple, 3, tupDesc, &isnull));
-			_op_oids[i][j][k] = DatumGetObjectId(heap_getattr(tuple, 4, tupDesc, &isnull));
-			tuple = heap_getnext(scan, ForwardScanDirection);
-		}
-		heap_endscan(scan);
-		heap_close(rel, AccessShareLock);
 		_ready = true;
-
-		PopOverrideSearchPath() ;
 	}
 	PG_CATCH();
 	{
-		PopOverrideSearchPath() ;
+		PopOverrideSearchPath();
 		PG_RE_THROW();
 	}
 	PG_END_TRY();
-}
-
-/*
- * This function is run during the CREATE EXTENSION to pre-compute the 
- * opcache and store it as a table in the catalog.
- */
-PG_FUNCTION_INFO_V1(fill_opcache);
-
-PGDLLEXPORT Datum 
-fill_opcache(PG_FUNCTION_ARGS) 
-{
-	Oid catalog = RelnameGetRelid("pg_temporal_opcache");
-	Relation rel = heap_open(catalog, AccessExclusiveLock);
-	TupleDesc tupDesc = rel->rd_att;
-
-	bool isnull[] = {false, false, false, false};
-	Datum data[] = {0, 0, 0, 0};
-
-	populate_types();
-	int32 m = sizeof(_op_names) / sizeof(char *);
-	int32 n = sizeof(_type_names) / sizeof(char *);
-	for (int32 i = 0; i < m; i++)
-	{
-		List* lst = list_make1(makeString((char *) _op_names[i]));
-		for (int32 j = 0; j < n; j++)
-			for (int32 k = 0; k < n; k++) 
-			{
-				data[3] = ObjectIdGetDatum(OpernameGetOprid(lst, _type_oids[j], _type_oids[k]));
-				if (data[3] != InvalidOid) 
-				{
-					data[0] = Int32GetDatum(i);
-					data[1] = Int32GetDatum(j);
-					data[2] = Int32GetDatum(k);
-					HeapTuple t = heap_form_tuple(tupDesc, data, isnull);
-					simple_heap_insert(rel, t);
-				}
-			}
-		pfree(lst);
-	}
-	heap_close(rel, AccessExclusiveLock);
-	PG_RETURN_VOID();
+	PopOverrideSearchPath();
 }
 
 /*****************************************************************************/
@@ -30,24 +30,30 @@
 /* 
  * The memory structure of a PeriodSet with, e.g., 3 periods is as follows
  *
- *  --------------------------------------------------------------------
- *	( PeriodSet | offset_0 | offset_1 | offset_2 | offset_3 | )_X | ...
- *	--------------------------------------------------------------------
- *	--------------------------------------------------------------------
- *	(( Period_0 )_Y | ( Period_1 )_Y | ( Period_2 )_Y | ( bbox )_Y )_X |
- *	--------------------------------------------------------------------
+ *	-----------------------------------------------------------------
+ *	( PeriodSet )_X | ( Period_0 )_X | ( Period_1 )_X | ( Period_2 )_X | 
+ *	-----------------------------------------------------------------
+ *	------------
+ *	( bbox )_X |
+ *	------------
  *
- * where the X are unused bytes added for double padding, the Y are unused bytes 
- * added for int4 padding, offset_0 to offset_2 are offsets for the corresponding 
- * periods, and offset_3 is the offset for the bounding box which is a Period.
+ * where the X are unused bytes added for double padding and the bounding box
+ * is a Period. Since all the elements have the same size, they are accessed
+ * with a fixed stride from the first one.
+ *
+ * Previous versions stored in addition an array of count + 1 offsets of type
+ * size_t between the header and the periods. Such values are recognized by 
+ * their size, which is always greater than the one of the current layout for
+ * the same number of periods, and remain readable.
  */
- 
-/* Pointer to array of offsets of the PeriodSet */
 
-static size_t *
-periodset_offsets_ptr(PeriodSet *ps)
+/* Returns true if the PeriodSet has the array of offsets of previous versions */
+
+static bool
+periodset_has_offsets(PeriodSet *ps)
 {
-	return (size_t *) (((char *)ps) + sizeof(PeriodSet));
+	return VARSIZE(ps) != double_pad(sizeof(PeriodSet)) + 
+		double_pad(sizeof(Period)) * (ps->count + 1);
 }
 
 /* Pointer to the first period */
@@ -55,8 +61,24 @@ periodset_offsets_ptr(PeriodSet *ps)
 static char * 
 periodset_data_ptr(PeriodSet *ps)
 {
-	return (char *)ps + double_pad(sizeof(PeriodSet) + 
-		sizeof(size_t) * (ps->count + 1));
+	if (periodset_has_offsets(ps))
+		return (char *)ps + double_pad(sizeof(PeriodSet) + 
+			sizeof(size_t) * (ps->count + 1));
+	return (char *)ps + double_pad(sizeof(PeriodSet));
+}
+
+/* 
+ * Array of the periods of a PeriodSet followed by its bounding box. Since 
+ * double_pad(sizeof(Period)) == sizeof(Period) the array can be indexed 
+ * directly.
+ */
+
+Period *
+periodset_per_array(PeriodSet *ps)
+{
+	StaticAssertStmt(DOUBLEALIGN(sizeof(Period)) == sizeof(Period),
+		"the size of a Period must be double aligned");
+	return (Period *) periodset_data_ptr(ps);
 }
 
 /* N-th Period of a PeriodSet */
@@ -64,8 +86,7 @@ periodset_data_ptr(PeriodSet *ps)
 Period *
 periodset_per_n(PeriodSet *ps, int index)
 {
-	size_t *offsets = periodset_offsets_ptr(ps);
-	return (Period *) (periodset_data_ptr(ps) + offsets[index]);
+	return periodset_per_array(ps) + index;
 }
 
 /* Bounding box of a PeriodSet */
@@ -73,9 +94,85 @@ periodset_per_n(PeriodSet *ps, int index)
 Period *
 periodset_bbox(PeriodSet *ps) 
 {
-	size_t *offsets = periodset_offsets_ptr(ps);
-	assert(offsets[ps->count] != 0);
-	return (Period *)(periodset_data_ptr(ps) + offsets[ps->count]);
+	return periodset_per_n(ps, ps->count);
+}
+
+/*
+ * Construction of a PeriodSet in a single pass. The result is allocated with
+ * room for at most maxcount periods, the periods are appended in increasing
+ * order with periodset_append, and the value is completed with 
+ * periodset_finish. This avoids the intermediate array of periods used by
+ * periodset_from_periodarr_internal.
+ */
+
+static Period *
+periodset_alloc_data(PeriodSet *ps)
+{
+	/* The size of the value is not yet final, do not test the layout */
+	return (Period *) ((char *)ps + double_pad(sizeof(PeriodSet)));
+}
+
+PeriodSet *
+periodset_alloc(int maxcount)
+{
+	size_t pdata = double_pad(sizeof(PeriodSet));
+	size_t memsize = double_pad(sizeof(Period)) * (maxcount + 1);
+	PeriodSet *result = palloc0(pdata + memsize);
+	SET_VARSIZE(result, pdata + memsize);
+	result->count = 0;
+	return result;
+}
+
+/* 
+ * Append a period to a PeriodSet under construction. The lower bound must 
+ * not be before the one of the last period appended. The period is merged
+ * with the last one when they overlap or are adjacent.
+ */
+
+void
+periodset_append(PeriodSet *ps, TimestampTz lower, TimestampTz upper,
+	bool lower_inc, bool upper_inc)
+{
+	Period *perarr = periodset_alloc_data(ps);
+	if (ps->count > 0)
+	{
+		Period *last = &perarr[ps->count - 1];
+		int cmp = timestamp_cmp_internal(last->upper, lower);
+		if (cmp > 0 || (cmp == 0 && (last->upper_inc || lower_inc)))
+		{
+			if (period_cmp_bounds(upper, last->upper, false, false,
+				upper_inc, last->upper_inc) > 0)
+			{
+				last->upper = upper;
+				last->upper_inc = upper_inc;
+			}
+			return;
+		}
+	}
+	period_set(&perarr[ps->count++], lower, upper, lower_inc, upper_inc);
+}
+
+/* 
+ * Complete a PeriodSet under construction by setting its bounding box and
+ * its final size. Returns NULL and frees the value if it has no period.
+ */
+
+PeriodSet *
+periodset_finish(PeriodSet *ps)
+{
+	if (ps->count == 0)
+	{
+		pfree(ps);
+		return NULL;
+	}
+	Period *perarr = periodset_alloc_data(ps);
+	int count = ps->count;
+	period_set(&perarr[count], perarr[0].lower, perarr[count - 1].upper,
+		perarr[0].lower_inc, perarr[count - 1].upper_inc);
+	/* The memory in excess, if any, is left unused */
+	SET_VARSIZE(ps, double_pad(sizeof(PeriodSet)) + 
+		double_pad(sizeof(Period)) * (count + 1));
+	return ps;
 }
 
 /* Construct a PeriodSet from an array of Period */
@@ -83,7 +180,6 @@ periodset_bbox(PeriodSet *ps)
 PeriodSet *
 periodset_from_periodarr_internal(Period **periods, int count, bool normalize)
 {
-	Period bbox;
 	/* Test the validity of the periods */
 	for (int i = 0; i < count - 1; i++)
 	{
@@ -94,39 +190,17 @@ periodset_from_periodarr_internal(Period **periods, int count, bool normalize)
 				errmsg("Invalid value for period set")));
 	}
 
-	Period **newperiods = periods;
-	int newcount = count;
-	if (normalize && count > 1)
-		newperiods = periodarr_normalize(periods, count, &newcount);
-	size_t memsize = double_pad(sizeof(Period)) * (newcount + 1);
-	/* Array of pointers containing the pointers to the component Period,
-	   and a pointer to the bbox */
-	size_t pdata = double_pad(sizeof(PeriodSet) + (newcount + 1) * sizeof(size_t));
-	PeriodSet *result = palloc0(pdata + memsize);
-	SET_VARSIZE(result, pdata + memsize);
-	result->count = newcount;
-
-	size_t *offsets = periodset_offsets_ptr(result);
-	size_t pos = 0;	
-	for (int i = 0; i < newcount; i++)
-	{
-		memcpy(((char *) result) + pdata + pos, newperiods[i], sizeof(Period));
-		offsets[i] = pos;
-		pos += double_pad(sizeof(Period));
-	}
-	/* Precompute the bounding box */
-	period_set(&bbox, newperiods[0]->lower, newperiods[newcount - 1]->upper,
-		newperiods[0]->lower_inc, newperiods[newcount - 1]->upper_inc);
-	offsets[newcount] = pos;
-	memcpy(((char *) result) + pdata + pos, &bbox, sizeof(Period));
-	/* Normalize */
-	if (normalize && count > 1)
+	PeriodSet *result = periodset_alloc(count);
+	Period *perarr = periodset_alloc_data(result);
+	for (int i = 0; i < count; i++)
 	{
-		for (int i = 0; i < newcount; i++)
-			pfree(newperiods[i]);
-		pfree(newperiods);
+		if (normalize)
+			periodset_append(result, periods[i]->lower, periods[i]->upper,
+				periods[i]->lower_inc, periods[i]->upper_inc);
+		else
+			perarr[result->count++] = *periods[i];
 	}
-	return result;
+	return periodset_finish(result);
 }
 
 PeriodSet *
@@ -154,6 +228,7 @@ periodset_copy(PeriodSet *ps)
 bool 
 periodset_find_timestamp(PeriodSet *ps, TimestampTz t, int *pos) 
 {
+	Period *perarr = periodset_per_array(ps);
 	int first = 0;
 	int last = ps->count - 1;
 	int middle = 0; /* make compiler quiet */
@@ -161,7 +236,7 @@ periodset_find_timestamp(PeriodSet *ps, TimestampTz t, int *pos)
 	while (first <= last) 
 	{
 		middle = (first + last)/2;
-		p = periodset_per_n(ps, middle);
+		p = &perarr[middle];
 		if (contains_period_timestamp_internal(p, t))
 		{
 			*pos = middle;
@@ -32,6 +32,16 @@ CREATE FUNCTION mobdb_full_version() RETURNS text
 	AS 'MODULE_PATHNAME'
 	LANGUAGE C IMMUTABLE;
 
+CREATE FUNCTION mobdb_stats(OUT name text, OUT count bigint, 
+		OUT time float)
+	RETURNS SETOF record
+	AS 'MODULE_PATHNAME', 'mobdb_stats_get'
+	LANGUAGE C VOLATILE STRICT PARALLEL RESTRICTED;
+
+CREATE FUNCTION mobdb_stats_reset() RETURNS void
+	AS 'MODULE_PATHNAME'
+	LANGUAGE C VOLATILE STRICT PARALLEL RESTRICTED;
+
 /******************************************************************************
  * Input/Output
  ******************************************************************************/
@@ -195,6 +205,15 @@ CREATE CAST (tint AS tint) WITH FUNCTION tint(tint, integer) AS IMPLICIT;
 CREATE CAST (tfloat AS tfloat) WITH FUNCTION tfloat(tfloat, integer) AS IMPLICIT;
 CREATE CAST (ttext AS ttext) WITH FUNCTION ttext(ttext, integer) AS IMPLICIT;
 
+CREATE FUNCTION asText(tfloat)
+	RETURNS text
+	AS 'MODULE_PATHNAME', 'temporal_as_text'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION asText(tfloat, maxdecimaldigits int4)
+	RETURNS text
+	AS 'MODULE_PATHNAME', 'temporal_as_text'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
 /******************************************************************************
  * Constructors
  ******************************************************************************/
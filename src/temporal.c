@@ -13,6 +13,7 @@
 #include "temporal.h"
 
 #include <assert.h>
+#include <float.h>
 #include <access/heapam.h>
 #include <access/htup_details.h>
 #include <access/tuptoaster.h>
@@ -27,6 +28,7 @@
 #include "temporaltypes.h"
 #include "oidcache.h"
 #include "temporal_util.h"
+#include "temporal_stats.h"
 #include "temporal_boxops.h"
 #include "temporal_parser.h"
 #include "rangetypes_ext.h"
@@ -138,6 +140,19 @@ temporal_copy(Temporal *temp)
 	return result;
 }
 
+/* Detoast a temporal argument, accounting the detoasted bytes */
+Temporal *
+temporal_detoast(Datum value)
+{
+	struct varlena *ptr = (struct varlena *) DatumGetPointer(value);
+	if (!VARATT_IS_EXTENDED(ptr))
+		return (Temporal *) ptr;
+	Temporal *result = (Temporal *) PG_DETOAST_DATUM(value);
+	MOBDB_STATS_INC(STAT_DETOASTS);
+	MOBDB_STATS_ADD(STAT_DETOAST_BYTES, VARSIZE(result));
+	return result;
+}
+
 /* 
  * intersection two temporal values
  * Returns false if the values do not overlap on time
@@ -309,14 +324,8 @@ synchronize_temporal_temporal(Temporal *temp1, Temporal *temp2,
 bool
 linear_interpolation(Oid type)
 {
-	if (type == FLOAT8OID || type == type_oid(T_DOUBLE2) || 
-		type == type_oid(T_DOUBLE3) || type == type_oid(T_DOUBLE4))
-		return true;
-#ifdef WITH_POSTGIS
-	if (type == type_oid(T_GEOGRAPHY) || type == type_oid(T_GEOMETRY)) 
-		return true;
-#endif
-	return false;
+	int basetype = base_type_find(type);
+	return basetype >= 0 && base_type_linear((BaseType) basetype);
 }
 
 /*****************************************************************************
@@ -438,16 +447,26 @@ base_oid_from_temporal(Oid temptypid)
  * Trajectory functions
  *****************************************************************************/
 
+/**
+ * @brief Value of the mobilitydb.precompute_trajectory parameter. When it is
+ *		false, the sequences of temporal geometry points are constructed
+ *		without their trajectory, which is then computed on demand
+ */
+bool precompute_trajectory = true;
+
 /**
  * @brief Returns true if the temporal type corresponding to the Oid of the 
  *		base type has its trajectory precomputed 
+ * @note The trajectory of temporal geography points is always precomputed 
+ *		since their bounding box is computed from it
  */
 bool
 type_has_precomputed_trajectory(Oid valuetypid) 
 {
 #ifdef WITH_POSTGIS
-	if (valuetypid == type_oid(T_GEOMETRY) || 
-		valuetypid == type_oid(T_GEOGRAPHY))
+	if (valuetypid == type_oid(T_GEOMETRY))
+		return precompute_trajectory;
+	if (valuetypid == type_oid(T_GEOGRAPHY))
 		return true;
 #endif
 	return false;
@@ -515,17 +534,7 @@ ensure_temporal_base_type(Oid valuetypid)
 void
 ensure_temporal_base_type_all(Oid valuetypid)
 {
-	if (valuetypid != BOOLOID && valuetypid != INT4OID && 
-		valuetypid != FLOAT8OID && valuetypid != TEXTOID &&
-		valuetypid != TIMESTAMPTZOID && valuetypid !=  type_oid(T_DOUBLE2)
-#ifdef WITH_POSTGIS
-		&& valuetypid != type_oid(T_GEOMETRY)
-		&& valuetypid != type_oid(T_GEOGRAPHY)
-		&& valuetypid != type_oid(T_DOUBLE3)
-		&& valuetypid != type_oid(T_DOUBLE4)
-#endif
-		)
-		elog(ERROR, "unknown base type: %d", valuetypid);
+	(void) base_type(valuetypid);
 }
 
 /**
@@ -646,22 +655,38 @@ temporal_in(PG_FUNCTION_ARGS)
 }
 
 /**
- * @brief Generic output function for temporal types (dispatch function)
+ * @brief Append the text representation of a temporal value to the buffer
+ * (dispatch function)
+ * @param[in] maxdd Maximum number of decimal digits of floating point values
+ * or -1 for the default output of the base type
+ * @param[in] value_out Function appending the values of the base type
  */
-char *
-temporal_to_string(Temporal *temp, char *(*value_out)(Oid, Datum))
+void
+temporal_to_stringbuf(StringInfo buf, Temporal *temp, int maxdd, 
+	value_out_func value_out)
 {
-	char *result = NULL;
 	ensure_valid_duration(temp->duration);
 	if (temp->duration == TEMPORALINST) 
-		result = temporalinst_to_string((TemporalInst *)temp, value_out);
+		temporalinst_to_stringbuf(buf, (TemporalInst *)temp, maxdd, value_out);
 	else if (temp->duration == TEMPORALI) 
-		result = temporali_to_string((TemporalI *)temp, value_out);
+		temporali_to_stringbuf(buf, (TemporalI *)temp, maxdd, value_out);
 	else if (temp->duration == TEMPORALSEQ) 
-		result = temporalseq_to_string((TemporalSeq *)temp, false, value_out);
+		temporalseq_to_stringbuf(buf, (TemporalSeq *)temp, false, maxdd, 
+			value_out);
 	else if (temp->duration == TEMPORALS) 
-		result = temporals_to_string((TemporalS *)temp, value_out);
-	return result;
+		temporals_to_stringbuf(buf, (TemporalS *)temp, maxdd, value_out);
+}
+
+/**
+ * @brief Generic output function for temporal types (dispatch function)
+ */
+char *
+temporal_to_string(Temporal *temp, int maxdd, value_out_func value_out)
+{
+	StringInfoData buf;
+	initStringInfo(&buf);
+	temporal_to_stringbuf(&buf, temp, maxdd, value_out);
+	return buf.data;
 }
 
 PG_FUNCTION_INFO_V1(temporal_out);
@@ -672,11 +697,41 @@ PGDLLEXPORT Datum
 temporal_out(PG_FUNCTION_ARGS)
 {
 	Temporal *temp = PG_GETARG_TEMPORAL(0);
-	char *result = temporal_to_string(temp, &call_output);
+	char *result = temporal_to_string(temp, -1, &stringinfo_append_value);
 	PG_FREE_IF_COPY(temp, 0);
 	PG_RETURN_CSTRING(result);
 }
 
+PG_FUNCTION_INFO_V1(temporal_as_text);
+/**
+ * @brief Output a temporal value in text format with at most the given 
+ * number of decimal digits for floating point values. Without this number
+ * the output is the one of temporal_out.
+ */
+PGDLLEXPORT Datum
+temporal_as_text(PG_FUNCTION_ARGS)
+{
+	Temporal *temp = PG_GETARG_TEMPORAL(0);
+	int maxdd = -1;
+	if (PG_NARGS() > 1)
+	{
+		maxdd = PG_GETARG_INT32(1);
+		if (maxdd > DBL_DIG)
+			maxdd = DBL_DIG;
+		else if (maxdd < 0)
+			maxdd = 0;
+	}
+	/* The text is written in place after the varlena header */
+	StringInfoData buf;
+	initStringInfo(&buf);
+	appendStringInfoSpaces(&buf, VARHDRSZ);
+	temporal_to_stringbuf(&buf, temp, maxdd, &stringinfo_append_value);
+	text *result = (text *) buf.data;
+	SET_VARSIZE(result, buf.len);
+	PG_FREE_IF_COPY(temp, 0);
+	PG_RETURN_TEXT_P(result);
+}
+
 /**
  * @brief Generic send function for temporal types (dispatch function)
  */
@@ -2433,16 +2488,12 @@ temporal_always_ge(PG_FUNCTION_ARGS)
  *****************************************************************************/
 
 
-PG_FUNCTION_INFO_V1(temporal_at_value);
 /**
- * @brief Restricts the temporal value to a value
+ * @brief Restricts the temporal value to a value (internal function)
  */
-PGDLLEXPORT Datum
-temporal_at_value(PG_FUNCTION_ARGS)
+Temporal *
+temporal_at_value_internal(Temporal *temp, Datum value)
 {
-	Temporal *temp = PG_GETARG_TEMPORAL(0);
-	Datum value = PG_GETARG_ANYDATUM(1);
-	Oid valuetypid = get_fn_expr_argtype(fcinfo->flinfo, 1);
 	Temporal *result = NULL;
 	ensure_valid_duration(temp->duration);
 	if (temp->duration == TEMPORALINST) 
@@ -2457,6 +2508,20 @@ temporal_at_value(PG_FUNCTION_ARGS)
 	else if (temp->duration == TEMPORALS) 
 		result = (Temporal *)temporals_at_value(
 			(TemporalS *)temp, value);
+	return result;
+}
+
+PG_FUNCTION_INFO_V1(temporal_at_value);
+/**
+ * @brief Restricts the temporal value to a value
+ */
+PGDLLEXPORT Datum
+temporal_at_value(PG_FUNCTION_ARGS)
+{
+	Temporal *temp = PG_GETARG_TEMPORAL(0);
+	Datum value = PG_GETARG_ANYDATUM(1);
+	Oid valuetypid = get_fn_expr_argtype(fcinfo->flinfo, 1);
+	Temporal *result = temporal_at_value_internal(temp, value);
 	PG_FREE_IF_COPY(temp, 0);
 	FREE_DATUM(value, valuetypid);
 	if (result == NULL)
@@ -25,6 +25,7 @@
 #include "temporaltypes.h"
 #include "oidcache.h"
 #include "temporal_util.h"
+#include "temporal_stats.h"
 #include "temporal_boolops.h"
 #include "doublen.h"
 
@@ -294,6 +295,8 @@ skiplist_splice(FunctionCallInfo fcinfo, SkipList *list, Temporal **values,
 	 * O(n+count*log(n)) worst case (when period spans the whole list so everything has to be deleted) 
 	 */
 	assert(list->length > 0);
+	instr_time start;
+	MOBDB_STATS_START(start);
 	int16 duration = skiplist_headval(list)->duration;
 	Period period;
 	if (duration == TEMPORALINST)
@@ -424,6 +427,7 @@ skiplist_splice(FunctionCallInfo fcinfo, SkipList *list, Temporal **values,
 			pfree(values[i]);
 		pfree(values);	
 	}
+	MOBDB_STATS_STOP(STAT_SKIPLIST_SPLICES, start);
 }
 
 PG_FUNCTION_INFO_V1(sl_test);
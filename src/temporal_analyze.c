@@ -61,6 +61,11 @@
  * 		- staop contains the "<" operator of the time dimension.
  * 		- stavalues stores the length of the histogram of periods for the time dimension.
  * 		- numvalues contains the number of buckets in the histogram.
+ * - Slot 5
+ * 		- stakind contains the type of statistics which is STATISTIC_KIND_VALUE_TIME_HISTOGRAM.
+ * 		- staop is not set.
+ * 		- stanumbers stores the joint histogram of the value and time dimensions.
+ * 		- numnumbers contains the number of elements in the stanumbers array.
  *
  * Notice that some statistics may not be collected, for example, since there
  * are no most common values. In that case, the next statistics collected is
@@ -80,6 +85,7 @@
 #include "temporal_analyze.h"
 
 #include <assert.h>
+#include <float.h>
 #include <math.h>
 #include <access/tuptoaster.h>
 #include <catalog/pg_collation_d.h>
@@ -1062,6 +1068,143 @@ range_compute_stats(VacAttrStats *stats, int non_null_cnt, int *slot_idx,
 	MemoryContextSwitchTo(old_cxt);
 }
 
+/*
+ * Compute the proportion of the extent [lower, upper] of a feature that
+ * overlaps each cell of one dimension of a TboxHistogram, starting from the
+ * cell containing lower. Returns the index of the first cell and sets the
+ * number of cells overlapped in count.
+ */
+static int
+tbox_hist_fractions(const TboxHistogram *hist, int d, double lower, 
+	double upper, double *fractions, int *count)
+{
+	int size = (int) hist->size[d];
+	double width = hist->max[d] - hist->min[d];
+	double cellwidth, cellmin, cellmax;
+	int first, last, i;
+
+	if (width <= 0 || size == 1)
+	{
+		fractions[0] = 1.0;
+		*count = 1;
+		return 0;
+	}
+	cellwidth = width / size;
+	first = (int) floor((lower - hist->min[d]) / cellwidth);
+	last = (int) floor((upper - hist->min[d]) / cellwidth);
+	first = Max(Min(first, size - 1), 0);
+	last = Max(Min(last, size - 1), 0);
+	*count = last - first + 1;
+	if (upper <= lower)
+	{
+		fractions[0] = 1.0;
+		return first;
+	}
+	for (i = first; i <= last; i++)
+	{
+		cellmin = hist->min[d] + i * cellwidth;
+		cellmax = cellmin + cellwidth;
+		/* The outer cells absorb the parts of the extent outside the histogram */
+		if (i == first)
+			cellmin = lower;
+		if (i == last)
+			cellmax = upper;
+		fractions[i - first] = (Min(cellmax, upper) - Max(cellmin, lower)) / 
+			(upper - lower);
+	}
+	return first;
+}
+
+/*
+ * Compute the joint histogram of the value and time dimensions of the sample.
+ * This must be done before computing the histograms of each dimension since
+ * these sort the arrays of bounds independently.
+ */
+static TboxHistogram *
+tbox_hist_compute(VacAttrStats *stats, int non_null_cnt, RangeBound *value_lowers,
+	RangeBound *value_uppers, PeriodBound *time_lowers, PeriodBound *time_uppers, 
+	int *nnumbers)
+{
+	MemoryContext old_context;
+	TboxHistogram *hist;
+	double *vmins, *vmaxs, *tmins, *tmaxs, *vfractions, *tfractions;
+	double vext_min = DBL_MAX, vext_max = -DBL_MAX, 
+		text_min = DBL_MAX, text_max = -DBL_MAX;
+	int size, ncells, i, j, k, vfirst, vcount, tfirst, tcount;
+
+	/*
+	 * We build a histogram having stats->attr->attstattarget cells on each
+	 * side, but ensure that we have on average at least one feature per cell.
+	 */
+	size = Min(stats->attr->attstattarget, (int) sqrt((double) non_null_cnt));
+	size = Max(size, 1);
+
+	vmins = (double *) palloc(sizeof(double) * non_null_cnt);
+	vmaxs = (double *) palloc(sizeof(double) * non_null_cnt);
+	tmins = (double *) palloc(sizeof(double) * non_null_cnt);
+	tmaxs = (double *) palloc(sizeof(double) * non_null_cnt);
+	for (i = 0; i < non_null_cnt; i++)
+	{
+		if (temporal_extra_data->value_type_id == INT4OID)
+		{
+			/* Integer ranges are canonicalized with an exclusive upper bound */
+			vmins[i] = (double) DatumGetInt32(value_lowers[i].val);
+			vmaxs[i] = (double) DatumGetInt32(value_uppers[i].val) - 
+				(value_uppers[i].inclusive ? 0 : 1);
+		}
+		else
+		{
+			vmins[i] = DatumGetFloat8(value_lowers[i].val);
+			vmaxs[i] = DatumGetFloat8(value_uppers[i].val);
+		}
+		tmins[i] = period_to_secs(time_lowers[i].val, 0);
+		tmaxs[i] = period_to_secs(time_uppers[i].val, 0);
+		vext_min = Min(vext_min, vmins[i]);
+		vext_max = Max(vext_max, vmaxs[i]);
+		text_min = Min(text_min, tmins[i]);
+		text_max = Max(text_max, tmaxs[i]);
+	}
+
+	/* Create the histogram in the stats memory context */
+	old_context = MemoryContextSwitchTo(stats->anl_context);
+	ncells = size * size;
+	*nnumbers = (int) (sizeof(TboxHistogram) / sizeof(float4)) + ncells - 1;
+	hist = palloc0(sizeof(float4) * *nnumbers);
+	MemoryContextSwitchTo(old_context);
+
+	hist->size[0] = hist->size[1] = (float4) size;
+	hist->min[0] = (float4) vext_min;
+	hist->max[0] = (float4) vext_max;
+	hist->min[1] = (float4) text_min;
+	hist->max[1] = (float4) text_max;
+	hist->features = (float4) non_null_cnt;
+	/* A dimension without extent only needs one cell */
+	for (k = 0; k < 2; k++)
+	{
+		if (hist->max[k] <= hist->min[k])
+			hist->size[k] = 1;
+	}
+
+	/* Fill the cells with the proportion of the features overlapping them */
+	vfractions = (double *) palloc(sizeof(double) * size);
+	tfractions = (double *) palloc(sizeof(double) * size);
+	for (k = 0; k < non_null_cnt; k++)
+	{
+		vfirst = tbox_hist_fractions(hist, 0, vmins[k], vmaxs[k], vfractions,
+			&vcount);
+		tfirst = tbox_hist_fractions(hist, 1, tmins[k], tmaxs[k], tfractions, 
+			&tcount);
+		for (j = 0; j < tcount; j++)
+			for (i = 0; i < vcount; i++)
+				hist->value[(tfirst + j) * (int) hist->size[0] + vfirst + i] +=
+					(float4) (vfractions[i] * tfractions[j]);
+	}
+
+	pfree(vmins); pfree(vmaxs); pfree(tmins); pfree(tmaxs);
+	pfree(vfractions); pfree(tfractions);
+	return hist;
+}
+
 /* 
  * Compute statistics for all durations distinct from TemporalInst.
  * Function derived from compute_range_stats of file rangetypes_typanalyze.c 
@@ -1083,6 +1226,8 @@ temps_compute_stats(VacAttrStats *stats, AnalyzeAttrFetchFunc fetchfunc,
 	double total_width = 0;
 	Oid 	rangetypid = 0; /* make compiler quiet */
 	TypeCacheEntry *typcache;
+	TboxHistogram *tbox_hist = NULL;
+	int tbox_hist_nnumbers = 0;
 
 	temporal_extra_data = (TemporalAnalyzeExtraData *)stats->extra_data;
 
@@ -1170,12 +1315,23 @@ temps_compute_stats(VacAttrStats *stats, AnalyzeAttrFetchFunc fetchfunc,
 
 		if (valuestats)
 		{
+			tbox_hist = tbox_hist_compute(stats, non_null_cnt, value_lowers,
+				value_uppers, time_lowers, time_uppers, &tbox_hist_nnumbers);
 			range_compute_stats(stats, non_null_cnt, &slot_idx, value_lowers, 
 				value_uppers, value_lengths, typcache, rangetypid);
 		}
 
 		period_compute_stats1(stats, non_null_cnt, &slot_idx,
 			time_lowers, time_uppers, time_lengths);
+
+		if (tbox_hist != NULL && slot_idx < STATISTIC_NUM_SLOTS)
+		{
+			stats->stakind[slot_idx] = STATISTIC_KIND_VALUE_TIME_HISTOGRAM;
+			stats->staop[slot_idx] = InvalidOid;
+			stats->stanumbers[slot_idx] = (float4 *) tbox_hist;
+			stats->numnumbers[slot_idx] = tbox_hist_nnumbers;
+			slot_idx++;
+		}
 	}
 	else if (null_cnt > 0)
 	{
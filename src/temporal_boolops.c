@@ -46,7 +46,7 @@ tand_bool_tbool(PG_FUNCTION_ARGS)
 {
 	Datum b = PG_GETARG_DATUM(0);
 	Temporal *temp = PG_GETARG_TEMPORAL(1);
-	Temporal *result = tfunc2_temporal_base(temp, b, &datum_and, BOOLOID, 
+	Temporal *result = tfunc_byval_temporal_base(temp, b, BOOLOID, LIFT_AND,
 		true);
 	PG_FREE_IF_COPY(temp, 1);
 	PG_RETURN_POINTER(result);
@@ -59,7 +59,7 @@ tand_tbool_bool(PG_FUNCTION_ARGS)
 {
 	Temporal *temp = PG_GETARG_TEMPORAL(0);
 	Datum b = PG_GETARG_DATUM(1);
-	Temporal *result = tfunc2_temporal_base(temp, b, &datum_and, BOOLOID,
+	Temporal *result = tfunc_byval_temporal_base(temp, b, BOOLOID, LIFT_AND,
 		false);
 	PG_FREE_IF_COPY(temp, 0);
 	PG_RETURN_POINTER(result);
@@ -72,8 +72,10 @@ tand_tbool_tbool(PG_FUNCTION_ARGS)
 {
 	Temporal *temp1 = PG_GETARG_TEMPORAL(0);
 	Temporal *temp2 = PG_GETARG_TEMPORAL(1);
-	Temporal *result = sync_tfunc2_temporal_temporal(temp1, temp2, 
-		&datum_and, BOOLOID, false, NULL);
+	Temporal *result = sync_tfunc_byval_supported(temp1, temp2) ?
+		sync_tfunc_byval_temporal_temporal(temp1, temp2, LIFT_AND) :
+		sync_tfunc2_temporal_temporal(temp1, temp2, &datum_and, BOOLOID, 
+			false, NULL);
 	PG_FREE_IF_COPY(temp1, 0);
 	PG_FREE_IF_COPY(temp2, 1);
 	if (result == NULL)
@@ -92,7 +94,7 @@ tor_bool_tbool(PG_FUNCTION_ARGS)
 {
 	Datum b = PG_GETARG_DATUM(0);
 	Temporal *temp = PG_GETARG_TEMPORAL(1);
-	Temporal *result = tfunc2_temporal_base(temp, b, &datum_or, BOOLOID,
+	Temporal *result = tfunc_byval_temporal_base(temp, b, BOOLOID, LIFT_OR,
 		true);
 	PG_FREE_IF_COPY(temp, 1);
 	PG_RETURN_POINTER(result);
@@ -105,7 +107,7 @@ tor_tbool_bool(PG_FUNCTION_ARGS)
 {
 	Temporal *temp = PG_GETARG_TEMPORAL(0);
 	Datum b = PG_GETARG_DATUM(1);
-	Temporal *result = tfunc2_temporal_base(temp, b, &datum_or, BOOLOID,
+	Temporal *result = tfunc_byval_temporal_base(temp, b, BOOLOID, LIFT_OR,
 		false);
 	PG_FREE_IF_COPY(temp, 0);
 	PG_RETURN_POINTER(result);
@@ -118,8 +120,10 @@ tor_tbool_tbool(PG_FUNCTION_ARGS)
 {
 	Temporal *temp1 = PG_GETARG_TEMPORAL(0);
 	Temporal *temp2 = PG_GETARG_TEMPORAL(1);
-	Temporal *result = sync_tfunc2_temporal_temporal(temp1, temp2, 
-		&datum_or, BOOLOID, false, NULL);
+	Temporal *result = sync_tfunc_byval_supported(temp1, temp2) ?
+		sync_tfunc_byval_temporal_temporal(temp1, temp2, LIFT_OR) :
+		sync_tfunc2_temporal_temporal(temp1, temp2, &datum_or, BOOLOID, 
+			false, NULL);
 	PG_FREE_IF_COPY(temp1, 0);
 	PG_FREE_IF_COPY(temp2, 1);
 	if (result == NULL)
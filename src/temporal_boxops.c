@@ -307,9 +307,9 @@ temporalseq_make_bbox(void *box, TemporalInst **instants, int count,
 	else if (valuetypid == INT4OID || valuetypid == FLOAT8OID) 
 		tnumberinstarr_to_tbox((TBOX *)box, instants, count);
 #ifdef WITH_POSTGIS
-	/* This code is currently not used since for temporal points the bounding
-	 * box is computed from the trajectory for efficiency reasons. It is left
-	 * here in case this is no longer the case */
+	/* For temporal points with a precomputed trajectory the bounding box is 
+	 * computed from the trajectory for efficiency reasons. This code is used
+	 * for temporal geometry points constructed without trajectory */
 	else if (instants[0]->valuetypid == type_oid(T_GEOGRAPHY) || 
 		instants[0]->valuetypid == type_oid(T_GEOMETRY)) 
 		tpointinstarr_to_stbox((STBOX *)box, instants, count);
@@ -24,8 +24,13 @@
 
 Temporal *
 tcomp_temporal_base(Temporal *temp, Datum value, Oid datumtypid,
-	Datum (*func)(Datum, Datum, Oid, Oid), bool invert)
+	Datum (*func)(Datum, Datum, Oid, Oid), LiftOper oper, bool invert)
 {
+	/* Temporal integers, floats, and Booleans have a specialized lifting */
+	if (lift_byval_type(temp->valuetypid) && lift_byval_type(datumtypid))
+		return tfunc_byval_temporal_base(temp, value, datumtypid, oper, 
+			invert);
+
 	Temporal *result = NULL;
 	ensure_valid_duration(temp->duration);
 	if (temp->duration == TEMPORALINST) 
@@ -51,6 +56,22 @@ tcomp_temporal_base(Temporal *temp, Datum value, Oid datumtypid,
 	return result;
 }
 
+static Temporal *
+tcomp_temporal_temporal(Temporal *temp1, Temporal *temp2,
+	Datum (*func)(Datum, Datum, Oid, Oid), LiftOper oper)
+{
+	/* Temporal integers, floats, and Booleans have a specialized lifting */
+	if (sync_tfunc_byval_supported(temp1, temp2))
+		return sync_tfunc_byval_temporal_temporal(temp1, temp2, oper);
+
+	bool linear = MOBDB_FLAGS_GET_LINEAR(temp1->flags) || 
+		MOBDB_FLAGS_GET_LINEAR(temp2->flags);
+	return linear ?
+		sync_tfunc4_temporal_temporal_cross(temp1, temp2, func, BOOLOID) :
+		sync_tfunc4_temporal_temporal(temp1, temp2, func, BOOLOID, 
+			linear, NULL);
+}
+
 /*****************************************************************************
  * Temporal eq
  *****************************************************************************/
@@ -64,7 +85,7 @@ teq_base_temporal(PG_FUNCTION_ARGS)
 	Temporal *temp = PG_GETARG_TEMPORAL(1);
 	Oid datumtypid = get_fn_expr_argtype(fcinfo->flinfo, 0);
 	Temporal *result = tcomp_temporal_base(temp, value, datumtypid,
-		&datum2_eq2, true);
+		&datum2_eq2, LIFT_EQ, true);
 	PG_FREE_IF_COPY(temp, 1);
 	PG_RETURN_POINTER(result);
 }
@@ -78,7 +99,7 @@ teq_temporal_base(PG_FUNCTION_ARGS)
 	Datum value = PG_GETARG_ANYDATUM(1);
 	Oid datumtypid = get_fn_expr_argtype(fcinfo->flinfo, 1);
 	Temporal *result = tcomp_temporal_base(temp, value, datumtypid,
-		&datum2_eq2, false);
+		&datum2_eq2, LIFT_EQ, false);
 	PG_FREE_IF_COPY(temp, 0);
 	PG_RETURN_POINTER(result);
 }
@@ -90,13 +111,8 @@ teq_temporal_temporal(PG_FUNCTION_ARGS)
 {
 	Temporal *temp1 = PG_GETARG_TEMPORAL(0);
 	Temporal *temp2 = PG_GETARG_TEMPORAL(1);
-	bool linear = MOBDB_FLAGS_GET_LINEAR(temp1->flags) || 
-		MOBDB_FLAGS_GET_LINEAR(temp2->flags);
-	Temporal *result = linear ?
-		sync_tfunc4_temporal_temporal_cross(temp1, temp2, &datum2_eq2, 
-			BOOLOID) :
-		sync_tfunc4_temporal_temporal(temp1, temp2, &datum2_eq2, BOOLOID, 
-			linear, NULL);
+	Temporal *result = tcomp_temporal_temporal(temp1, temp2, &datum2_eq2,
+		LIFT_EQ);
 	PG_FREE_IF_COPY(temp1, 0);
 	PG_FREE_IF_COPY(temp2, 1);
 	if (result == NULL)
@@ -117,7 +133,7 @@ tne_base_temporal(PG_FUNCTION_ARGS)
 	Temporal *temp = PG_GETARG_TEMPORAL(1);
 	Oid datumtypid = get_fn_expr_argtype(fcinfo->flinfo, 0);
 	Temporal *result = tcomp_temporal_base(temp, value, datumtypid,
-		&datum2_ne2, true);
+		&datum2_ne2, LIFT_NE, true);
 	PG_FREE_IF_COPY(temp, 1);
 	PG_RETURN_POINTER(result);
 }
@@ -131,7 +147,7 @@ tne_temporal_base(PG_FUNCTION_ARGS)
 	Datum value = PG_GETARG_ANYDATUM(1);
 	Oid datumtypid = get_fn_expr_argtype(fcinfo->flinfo, 1);
 	Temporal *result = tcomp_temporal_base(temp, value, datumtypid,
-		&datum2_ne2, false);
+		&datum2_ne2, LIFT_NE, false);
 	PG_FREE_IF_COPY(temp, 0);
 	PG_RETURN_POINTER(result);
 }
@@ -143,13 +159,8 @@ tne_temporal_temporal(PG_FUNCTION_ARGS)
 {
 	Temporal *temp1 = PG_GETARG_TEMPORAL(0);
 	Temporal *temp2 = PG_GETARG_TEMPORAL(1);
-	bool linear = MOBDB_FLAGS_GET_LINEAR(temp1->flags) || 
-		MOBDB_FLAGS_GET_LINEAR(temp2->flags);
-	Temporal *result = linear ?
-		sync_tfunc4_temporal_temporal_cross(temp1, temp2, &datum2_ne2,
-			BOOLOID) :
-		sync_tfunc4_temporal_temporal(temp1, temp2, &datum2_ne2, BOOLOID, 
-			linear, NULL);
+	Temporal *result = tcomp_temporal_temporal(temp1, temp2, &datum2_ne2,
+		LIFT_NE);
 	PG_FREE_IF_COPY(temp1, 0);
 	PG_FREE_IF_COPY(temp2, 1);
 	if (result == NULL)
@@ -170,7 +181,7 @@ tlt_base_temporal(PG_FUNCTION_ARGS)
 	Temporal *temp = PG_GETARG_TEMPORAL(1);
 	Oid datumtypid = get_fn_expr_argtype(fcinfo->flinfo, 0);
 	Temporal *result = tcomp_temporal_base(temp, value, datumtypid,
-		&datum2_lt2, true);
+		&datum2_lt2, LIFT_LT, true);
 	PG_FREE_IF_COPY(temp, 1);
 	PG_RETURN_POINTER(result);
 }
@@ -184,7 +195,7 @@ tlt_temporal_base(PG_FUNCTION_ARGS)
 	Datum value = PG_GETARG_ANYDATUM(1);
 	Oid datumtypid = get_fn_expr_argtype(fcinfo->flinfo, 1);
 	Temporal *result = tcomp_temporal_base(temp, value, datumtypid,
-		&datum2_lt2, false);
+		&datum2_lt2, LIFT_LT, false);
 	PG_FREE_IF_COPY(temp, 0);
 	PG_RETURN_POINTER(result);
 }
@@ -196,13 +207,8 @@ tlt_temporal_temporal(PG_FUNCTION_ARGS)
 {
 	Temporal *temp1 = PG_GETARG_TEMPORAL(0);
 	Temporal *temp2 = PG_GETARG_TEMPORAL(1);
-	bool linear = MOBDB_FLAGS_GET_LINEAR(temp1->flags) || 
-		MOBDB_FLAGS_GET_LINEAR(temp2->flags);
-	Temporal *result = linear ?
-		sync_tfunc4_temporal_temporal_cross(temp1, temp2, &datum2_lt2,
-			BOOLOID) :
-		sync_tfunc4_temporal_temporal(temp1, temp2, &datum2_lt2, BOOLOID, 
-			linear, NULL);
+	Temporal *result = tcomp_temporal_temporal(temp1, temp2, &datum2_lt2,
+		LIFT_LT);
 	PG_FREE_IF_COPY(temp1, 0);
 	PG_FREE_IF_COPY(temp2, 1);
 	if (result == NULL)
@@ -223,7 +229,7 @@ tle_base_temporal(PG_FUNCTION_ARGS)
 	Temporal *temp = PG_GETARG_TEMPORAL(1);
 	Oid datumtypid = get_fn_expr_argtype(fcinfo->flinfo, 0);
 	Temporal *result = tcomp_temporal_base(temp, value, datumtypid,
-		&datum2_le2, true);
+		&datum2_le2, LIFT_LE, true);
 	PG_FREE_IF_COPY(temp, 1);
 	PG_RETURN_POINTER(result);
 }
@@ -237,7 +243,7 @@ tle_temporal_base(PG_FUNCTION_ARGS)
 	Datum value = PG_GETARG_ANYDATUM(1);
 	Oid datumtypid = get_fn_expr_argtype(fcinfo->flinfo, 1);
 	Temporal *result = tcomp_temporal_base(temp, value, datumtypid,
-		&datum2_le2, false);
+		&datum2_le2, LIFT_LE, false);
 	PG_FREE_IF_COPY(temp, 0);
 	PG_RETURN_POINTER(result);
 }
@@ -249,13 +255,8 @@ tle_temporal_temporal(PG_FUNCTION_ARGS)
 {
 	Temporal *temp1 = PG_GETARG_TEMPORAL(0);
 	Temporal *temp2 = PG_GETARG_TEMPORAL(1);
-	bool linear = MOBDB_FLAGS_GET_LINEAR(temp1->flags) || 
-		MOBDB_FLAGS_GET_LINEAR(temp2->flags);
-	Temporal *result = linear ?
-		sync_tfunc4_temporal_temporal_cross(temp1, temp2, &datum2_le2,
-			BOOLOID) :
-		sync_tfunc4_temporal_temporal(temp1, temp2, &datum2_le2, BOOLOID, 
-			linear, NULL);
+	Temporal *result = tcomp_temporal_temporal(temp1, temp2, &datum2_le2,
+		LIFT_LE);
 	PG_FREE_IF_COPY(temp1, 0);
 	PG_FREE_IF_COPY(temp2, 1);
 	if (result == NULL)
@@ -276,7 +277,7 @@ tgt_base_temporal(PG_FUNCTION_ARGS)
 	Temporal *temp = PG_GETARG_TEMPORAL(1);
 	Oid datumtypid = get_fn_expr_argtype(fcinfo->flinfo, 0);
 	Temporal *result = tcomp_temporal_base(temp, value, datumtypid,
-		&datum2_gt2, true);
+		&datum2_gt2, LIFT_GT, true);
 	PG_FREE_IF_COPY(temp, 1);
 	PG_RETURN_POINTER(result);
 }
@@ -290,7 +291,7 @@ tgt_temporal_base(PG_FUNCTION_ARGS)
 	Datum value = PG_GETARG_ANYDATUM(1);
 	Oid datumtypid = get_fn_expr_argtype(fcinfo->flinfo, 1);
 	Temporal *result = tcomp_temporal_base(temp, value, datumtypid,
-		&datum2_gt2, false);
+		&datum2_gt2, LIFT_GT, false);
 	PG_FREE_IF_COPY(temp, 0);
 	PG_RETURN_POINTER(result);
 }
@@ -302,13 +303,8 @@ tgt_temporal_temporal(PG_FUNCTION_ARGS)
 {
 	Temporal *temp1 = PG_GETARG_TEMPORAL(0);
 	Temporal *temp2 = PG_GETARG_TEMPORAL(1);
-	bool linear = MOBDB_FLAGS_GET_LINEAR(temp1->flags) || 
-		MOBDB_FLAGS_GET_LINEAR(temp2->flags);
-	Temporal *result = linear ?
-		sync_tfunc4_temporal_temporal_cross(temp1, temp2, &datum2_gt2,
-			BOOLOID) :
-		sync_tfunc4_temporal_temporal(temp1, temp2, &datum2_gt2, BOOLOID, 
-			linear, NULL);
+	Temporal *result = tcomp_temporal_temporal(temp1, temp2, &datum2_gt2,
+		LIFT_GT);
 	PG_FREE_IF_COPY(temp1, 0);
 	PG_FREE_IF_COPY(temp2, 1);
 	if (result == NULL)
@@ -329,7 +325,7 @@ tge_base_temporal(PG_FUNCTION_ARGS)
 	Temporal *temp = PG_GETARG_TEMPORAL(1);
 	Oid datumtypid = get_fn_expr_argtype(fcinfo->flinfo, 0);
 	Temporal *result = tcomp_temporal_base(temp, value, datumtypid,
-		&datum2_ge2, true);
+		&datum2_ge2, LIFT_GE, true);
 	PG_FREE_IF_COPY(temp, 1);
 	PG_RETURN_POINTER(result);
 }
@@ -343,7 +339,7 @@ tge_temporal_base(PG_FUNCTION_ARGS)
 	Datum value = PG_GETARG_ANYDATUM(1);
 	Oid datumtypid = get_fn_expr_argtype(fcinfo->flinfo, 1);
 	Temporal *result = tcomp_temporal_base(temp, value, datumtypid,
-		&datum2_ge2, false);
+		&datum2_ge2, LIFT_GE, false);
 	PG_FREE_IF_COPY(temp, 0);
 	PG_RETURN_POINTER(result);
 }
@@ -355,13 +351,8 @@ tge_temporal_temporal(PG_FUNCTION_ARGS)
 {
 	Temporal *temp1 = PG_GETARG_TEMPORAL(0);
 	Temporal *temp2 = PG_GETARG_TEMPORAL(1);
-	bool linear = MOBDB_FLAGS_GET_LINEAR(temp1->flags) || 
-		MOBDB_FLAGS_GET_LINEAR(temp2->flags);
-	Temporal *result = linear ?
-		sync_tfunc4_temporal_temporal_cross(temp1, temp2, &datum2_ge2,
-			BOOLOID) :
-		sync_tfunc4_temporal_temporal(temp1, temp2, &datum2_ge2, BOOLOID, 
-			linear, NULL);
+	Temporal *result = tcomp_temporal_temporal(temp1, temp2, &datum2_ge2,
+		LIFT_GE);
 	PG_FREE_IF_COPY(temp1, 0);
 	PG_FREE_IF_COPY(temp2, 1);
 	if (result == NULL)
@@ -3,10 +3,12 @@
  * temporal_parser.c
  *	  Functions for parsing time types and temporal types.
  *
- * Many functions make two passes for parsing, the first one to obtain the 
- * number of elements in order to do memory allocation with palloc, the second
- * one to create the type. This is the only approach we can see at the moment
- * which is both correct and simple.
+ * The functions parse the input in a single pass, collecting the elements 
+ * in arrays that are enlarged with repalloc when needed. The values of the
+ * base types int, float and bool as well as the timestamps in ISO format, 
+ * which are the ones produced by the output functions, are parsed in place
+ * from the input string. Other values are copied and passed to the input
+ * function of their type, which also reports the errors for invalid values.
  *
  * Portions Copyright (c) 2020, Esteban Zimanyi, Arthur Lesuisse,
  *		Universite Libre de Bruxelles
@@ -17,6 +19,11 @@
 
 #include "temporal_parser.h"
 
+#include <errno.h>
+#include <pgtime.h>
+#include <utils/builtins.h>
+#include <utils/datetime.h>
+#include <utils/timestamp.h>
 #include "periodset.h"
 #include "period.h"
 #include "timestampset.h"
@@ -117,10 +124,84 @@ p_comma(char **str)
 	return false;
 }
 
-Datum 
+/* Parse a double in decimal notation. Special values such as 'NaN' or
+ * 'Infinity' and hexadecimal notation are not accepted */
+bool
+p_double(char **str, double *result)
+{
+	p_whitespace(str);
+	char *s = *str, *end;
+	if (*s == '+' || *s == '-')
+		s++;
+	if ((*s < '0' || *s > '9') && *s != '.')
+		return false;
+	if (s[0] == '0' && (s[1] == 'x' || s[1] == 'X'))
+		return false;
+	errno = 0;
+	double d = strtod(*str, &end);
+	if (end == *str || errno == ERANGE)
+		return false;
+	*result = d;
+	*str = end;
+	return true;
+}
+
+/* Parse the values of the base types int, float and bool in place, up to
+ * and including the '@' that follows them. Returns false without consuming
+ * input for other base types or when the value is not in the expected
+ * format, in which case the input function of the type is called */
+static bool
+basetype_parse_fast(char **str, Oid basetype, Datum *result)
+{
+	char *s = *str;
+	if (basetype == INT4OID)
+	{
+		char *end;
+		errno = 0;
+		long l = strtol(s, &end, 10);
+		if (end == s || errno == ERANGE || l < PG_INT32_MIN || l > PG_INT32_MAX)
+			return false;
+		*result = Int32GetDatum((int32) l);
+		s = end;
+	}
+	else if (basetype == FLOAT8OID)
+	{
+		double d;
+		if (! p_double(&s, &d))
+			return false;
+		*result = Float8GetDatum(d);
+	}
+	else if (basetype == BOOLOID)
+	{
+		size_t len = 0;
+		bool b;
+		while (s[len] != '@' && s[len] != '\0')
+			len++;
+		while (len > 0 && (s[len - 1] == ' ' || s[len - 1] == '\t' ||
+			s[len - 1] == '\n' || s[len - 1] == '\r'))
+			len--;
+		if (! parse_bool_with_len(s, len, &b))
+			return false;
+		*result = BoolGetDatum(b);
+		s += len;
+	}
+	else
+		return false;
+	p_whitespace(&s);
+	if (*s != '@')
+		return false;
+	*str = s + 1;
+	return true;
+}
+
+Datum
 basetype_parse(char **str, Oid basetype)
 {
 	p_whitespace(str);
+	Datum result;
+	if (basetype_parse_fast(str, basetype, &result))
+		return result;
+
 	int delim = 0;
 	bool isttext = false;
 	/* ttext values must be enclosed between double quotes */
@@ -142,7 +223,7 @@ basetype_parse(char **str, Oid basetype)
 		ereport(ERROR, (errcode(ERRCODE_INVALID_TEXT_REPRESENTATION), 
 			errmsg("Could not parse element value")));
 	(*str)[delim] = '\0';
-	Datum result = call_input(basetype, *str);
+	result = call_input(basetype, *str);
 	if (isttext)
 		/* Replace the double quote */
 		(*str)[delim++] = '"';
@@ -281,17 +362,132 @@ tbox_parse(char **str)
 /*****************************************************************************/
 /* Time Types */
 
-TimestampTz 
-timestamp_parse(char **str) 
+/* Parse exactly n digits */
+static bool
+p_digits(char **str, int n, int *result)
+{
+	int value = 0;
+	for (int i = 0; i < n; i++)
+	{
+		char c = (*str)[i];
+		if (c < '0' || c > '9')
+			return false;
+		value = value * 10 + (c - '0');
+	}
+	*str += n;
+	*result = value;
+	return true;
+}
+
+/* Parse a timestamp in the format YYYY-MM-DD[ HH:MI[:SS[.ffffff]][+-TZ]],
+ * which is the one of the output function with the ISO date style. Returns
+ * false without consuming input for any other format, e.g., with a time zone
+ * name or a BC suffix, or for values that need the checks of the input
+ * function, e.g., leap seconds or more than six fractional digits */
+static bool
+timestamp_parse_iso(char **str, TimestampTz *result)
+{
+	struct pg_tm tt, *tm = &tt;
+	fsec_t fsec = 0;
+	int tz, tzhour, tzmin = 0, tzsec = 0;
+	bool hastz = false;
+	char *s = *str;
+
+	memset(tm, 0, sizeof(struct pg_tm));
+	/* Date */
+	if (! p_digits(&s, 4, &tm->tm_year) || *s++ != '-' ||
+		! p_digits(&s, 2, &tm->tm_mon) || *s++ != '-' ||
+		! p_digits(&s, 2, &tm->tm_mday))
+		return false;
+	if (tm->tm_year == 0 || tm->tm_mon < 1 || tm->tm_mon > MONTHS_PER_YEAR ||
+		tm->tm_mday < 1 ||
+		tm->tm_mday > day_tab[isleap(tm->tm_year)][tm->tm_mon - 1])
+		return false;
+	/* Time */
+	if ((*s == ' ' || *s == 'T') && s[1] >= '0' && s[1] <= '9')
+	{
+		s++;
+		if (! p_digits(&s, 2, &tm->tm_hour) || *s++ != ':' ||
+			! p_digits(&s, 2, &tm->tm_min))
+			return false;
+		if (*s == ':')
+		{
+			s++;
+			if (! p_digits(&s, 2, &tm->tm_sec))
+				return false;
+			if (*s == '.')
+			{
+				int scale = 100000, ndigits = 0;
+				s++;
+				while (*s >= '0' && *s <= '9')
+				{
+					if (++ndigits > 6)
+						return false;
+					fsec += (*s++ - '0') * scale;
+					scale /= 10;
+				}
+				if (ndigits == 0)
+					return false;
+			}
+		}
+		if (tm->tm_hour >= HOURS_PER_DAY || tm->tm_min >= MINS_PER_HOUR ||
+			tm->tm_sec >= SECS_PER_MINUTE)
+			return false;
+		/* Time zone displacement */
+		if (*s == '+' || *s == '-')
+		{
+			int sign = (*s++ == '+') ? 1 : -1;
+			if (! p_digits(&s, 2, &tzhour))
+				return false;
+			if (*s == ':')
+			{
+				s++;
+				if (! p_digits(&s, 2, &tzmin))
+					return false;
+				if (*s == ':')
+				{
+					s++;
+					if (! p_digits(&s, 2, &tzsec))
+						return false;
+				}
+			}
+			if (tzhour > MAX_TZDISP_HOUR || tzmin >= MINS_PER_HOUR ||
+				tzsec >= SECS_PER_MINUTE)
+				return false;
+			/* PostgreSQL keeps the displacement in seconds west of UTC */
+			tz = -sign * (tzhour * SECS_PER_HOUR + tzmin * SECS_PER_MINUTE + tzsec);
+			hastz = true;
+		}
+	}
+	/* Ensure that the timestamp is followed by a delimiter */
+	char *end = s;
+	p_whitespace(&end);
+	if (*end != ',' && *end != ']' && *end != ')' && *end != '}' && *end != '\0')
+		return false;
+	if (! hastz)
+		tz = DetermineTimeZoneOffset(tm, session_timezone);
+	if (tm2timestamp(tm, fsec, &tz, result) != 0 || ! IS_VALID_TIMESTAMP(*result))
+		return false;
+	*str = s;
+	return true;
+}
+
+TimestampTz
+timestamp_parse(char **str)
 {
 	p_whitespace(str);
+	TimestampTz result;
+	if (timestamp_parse_iso(str, &result))
+		return result;
+
 	int delim = 0;
-	while ((*str)[delim] != ',' && (*str)[delim] != ']' && (*str)[delim] != ')' && 
+	while ((*str)[delim] != ',' && (*str)[delim] != ']' && (*str)[delim] != ')' &&
 		(*str)[delim] != '}' && (*str)[delim] != '\0')
 		delim++;
 	char bak = (*str)[delim];
 	(*str)[delim] = '\0';
-	Datum result = call_input(TIMESTAMPTZOID, *str);
+	result = DatumGetTimestampTz(DirectFunctionCall3(timestamptz_in,
+		CStringGetDatum(*str), ObjectIdGetDatum(InvalidOid), Int32GetDatum(-1)));
 	(*str)[delim] = bak;
 	*str += delim;
 	return result;
@@ -333,27 +529,20 @@ timestampset_parse(char **str)
 		ereport(ERROR, (errcode(ERRCODE_INVALID_TEXT_REPRESENTATION), 
 			errmsg("Could not parse timestamp set")));
 
-	/* First parsing */
-	char *bak = *str;
-	timestamp_parse(str);
-	int count = 1;
-	while (p_comma(str)) 
+	int count = 0, maxcount = 16;
+	TimestampTz *times = palloc(sizeof(TimestampTz) * maxcount);
+	do
 	{
-		count++;
-		timestamp_parse(str);
-	}
+		if (count == maxcount)
+		{
+			maxcount *= 2;
+			times = repalloc(times, sizeof(TimestampTz) * maxcount);
+		}
+		times[count++] = timestamp_parse(str);
+	} while (p_comma(str));
 	if (!p_cbrace(str))
 		ereport(ERROR, (errcode(ERRCODE_INVALID_TEXT_REPRESENTATION), 
 			errmsg("Could not parse timestamp set")));
-
-	*str = bak;
-	TimestampTz *times = palloc(sizeof(TimestampTz) * count);
-	for (int i = 0; i < count; i++) 
-	{
-		p_comma(str);
-		times[i] = timestamp_parse(str);
-	}
-	p_cbrace(str);
 	TimestampSet *result = timestampset_from_timestamparr_internal(times, count);
 
 	pfree(times);
@@ -368,28 +557,20 @@ periodset_parse(char **str)
 		ereport(ERROR, (errcode(ERRCODE_INVALID_TEXT_REPRESENTATION), 
 			errmsg("Could not parse period set")));
 
-	/* First parsing */
-	char *bak = *str;
-	period_parse(str, false);
-	int count = 1;
-	while (p_comma(str)) 
+	int count = 0, maxcount = 16;
+	Period **periods = palloc(sizeof(Period *) * maxcount);
+	do
 	{
-		count++;
-		period_parse(str, false);
-	}
+		if (count == maxcount)
+		{
+			maxcount *= 2;
+			periods = repalloc(periods, sizeof(Period *) * maxcount);
+		}
+		periods[count++] = period_parse(str, true);
+	} while (p_comma(str));
 	if (!p_cbrace(str))
 		ereport(ERROR, (errcode(ERRCODE_INVALID_TEXT_REPRESENTATION), 
 			errmsg("Could not parse period set")));
-
-	/* Second parsing */
-	*str = bak;
-	Period **periods = palloc(sizeof(Period *) * count);
-	for (int i = 0; i < count; i++) 
-	{
-		p_comma(str);
-		periods[i] = period_parse(str, true);
-	}
-	p_cbrace(str);
 	PeriodSet *result = periodset_from_periodarr_internal(periods, count, true);
 
 	for (int i = 0; i < count; i++)
@@ -407,7 +588,8 @@ periodset_parse(char **str)
  * basetype: Oid of the base type
  * end: set to true when reading a single instant to ensure there is no more
  * 		input after the instant
- * make: set to false for the first pass to do not create the instant */
+ * make: set to false to only validate the input without creating the 
+ * 		instant */
 TemporalInst *
 temporalinst_parse(char **str, Oid basetype, bool end, bool make) 
 {
@@ -439,15 +621,17 @@ temporali_parse(char **str, Oid basetype)
 	 * to call this function in the dispatch function temporal_parse */
 	p_obrace(str);
 
-	/* First parsing */
-	char *bak = *str;
-	temporalinst_parse(str, basetype, false, false);
-	int count = 1;
-	while (p_comma(str)) 
+	int count = 0, maxcount = 16;
+	TemporalInst **instants = palloc(sizeof(TemporalInst *) * maxcount);
+	do
 	{
-		count++;
-		temporalinst_parse(str, basetype, false, false);
-	}
+		if (count == maxcount)
+		{
+			maxcount *= 2;
+			instants = repalloc(instants, sizeof(TemporalInst *) * maxcount);
+		}
+		instants[count++] = temporalinst_parse(str, basetype, false, true);
+	} while (p_comma(str));
 	if (!p_cbrace(str))
 		ereport(ERROR, (errcode(ERRCODE_INVALID_TEXT_REPRESENTATION), 
 			errmsg("Could not parse temporal value")));
@@ -457,15 +641,6 @@ temporali_parse(char **str, Oid basetype)
 		ereport(ERROR, (errcode(ERRCODE_INVALID_TEXT_REPRESENTATION), 
 			errmsg("Could not parse temporal value")));
 
-	/* Second parsing */
-	*str = bak;
-	TemporalInst **instants = palloc(sizeof(TemporalInst *) * count);
-	for (int i = 0; i < count; i++) 
-	{
-		p_comma(str);
-		instants[i] = temporalinst_parse(str, basetype, false, true);
-	}
-	p_cbrace(str);
 	TemporalI *result = temporali_from_temporalinstarr(instants, count);
 
 	for (int i = 0; i < count; i++)
@@ -480,10 +655,9 @@ temporali_parse(char **str, Oid basetype)
  * basetype: Oid of the base type
  * linear: set to true when the sequence has linear interpolation
  * end: set to true when reading a single instant to ensure there is no more
- * 		input after the sequence
- * make: set to false for the first pass to do not create the instant */
+ * 		input after the sequence */
 static TemporalSeq *
-temporalseq_parse(char **str, Oid basetype, bool linear, bool end, bool make) 
+temporalseq_parse(char **str, Oid basetype, bool linear, bool end) 
 {
 	p_whitespace(str);
 	bool lower_inc = false, upper_inc = false;
@@ -494,15 +668,17 @@ temporalseq_parse(char **str, Oid basetype, bool linear, bool end, bool make)
 	else if (p_oparen(str))
 		lower_inc = false;
 
-	/* First parsing */
-	char *bak = *str;
-	temporalinst_parse(str, basetype, false, false);
-	int count = 1;
-	while (p_comma(str)) 
+	int count = 0, maxcount = 16;
+	TemporalInst **instants = palloc(sizeof(TemporalInst *) * maxcount);
+	do
 	{
-		count++;
-		temporalinst_parse(str, basetype, false, false);
-	}
+		if (count == maxcount)
+		{
+			maxcount *= 2;
+			instants = repalloc(instants, sizeof(TemporalInst *) * maxcount);
+		}
+		instants[count++] = temporalinst_parse(str, basetype, false, true);
+	} while (p_comma(str));
 	if (p_cbracket(str))
 		upper_inc = true;
 	else if (p_cparen(str))
@@ -518,19 +694,6 @@ temporalseq_parse(char **str, Oid basetype, bool linear, bool end, bool make)
 			ereport(ERROR, (errcode(ERRCODE_INVALID_TEXT_REPRESENTATION), 
 				errmsg("Could not parse temporal value")));
 	}
-	/* Second parsing */
-	*str = bak; 
-	TemporalInst **instants = palloc(sizeof(TemporalInst *) * count);
-	for (int i = 0; i < count; i++) 
-	{
-		p_comma(str);
-		instants[i] = temporalinst_parse(str, basetype, false, true);
-	}
-	p_cbracket(str);
-	p_cparen(str);
-
-	if (! make)
-		return NULL;
 
 	TemporalSeq *result = temporalseq_from_temporalinstarr(instants, 
 		count, lower_inc, upper_inc, linear, true);
@@ -554,15 +717,17 @@ temporals_parse(char **str, Oid basetype, bool linear)
 	 * to call this function in the dispatch function temporal_parse */
 	p_obrace(str);
 
-	/* First parsing */
-	char *bak = *str;
-	temporalseq_parse(str, basetype, linear, false, false);
-	int count = 1;
-	while (p_comma(str)) 
+	int count = 0, maxcount = 16;
+	TemporalSeq **sequences = palloc(sizeof(TemporalSeq *) * maxcount);
+	do
 	{
-		count++;
-		temporalseq_parse(str, basetype, linear, false, false);
-	}
+		if (count == maxcount)
+		{
+			maxcount *= 2;
+			sequences = repalloc(sequences, sizeof(TemporalSeq *) * maxcount);
+		}
+		sequences[count++] = temporalseq_parse(str, basetype, linear, false);
+	} while (p_comma(str));
 	if (!p_cbrace(str))
 		ereport(ERROR, (errcode(ERRCODE_INVALID_TEXT_REPRESENTATION), 
 			errmsg("Could not parse temporal value")));
@@ -572,15 +737,6 @@ temporals_parse(char **str, Oid basetype, bool linear)
 		ereport(ERROR, (errcode(ERRCODE_INVALID_TEXT_REPRESENTATION), 
 			errmsg("Could not parse temporal value")));
 
-	/* Second parsing */
-	*str = bak;
-	TemporalSeq **sequences = palloc(sizeof(TemporalSeq *) * count);
-	for (int i = 0; i < count; i++) 
-	{
-		p_comma(str);
-		sequences[i] = temporalseq_parse(str, basetype, linear, false, true);
-	}
-	p_cbrace(str);
 	TemporalS *result = temporals_from_temporalseqarr(sequences, count,
 		linear, true);
 
@@ -610,7 +766,7 @@ temporal_parse(char **str, Oid basetype)
 	if (**str != '{' && **str != '[' && **str != '(')
 		result = (Temporal *)temporalinst_parse(str, basetype, true, true);
 	else if (**str == '[' || **str == '(')
-		result = (Temporal *)temporalseq_parse(str, basetype, linear, true, true);		
+		result = (Temporal *)temporalseq_parse(str, basetype, linear, true);		
 	else if (**str == '{')
 	{
 		char *bak = *str;
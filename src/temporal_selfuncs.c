@@ -32,6 +32,7 @@
 #include <access/visibilitymap.h>
 #include <access/skey.h>
 #include <catalog/pg_collation_d.h>
+#include <catalog/pg_statistic.h>
 #include <executor/tuptable.h>
 #include <optimizer/paths.h>
 #include <storage/bufmgr.h>
@@ -1409,10 +1410,64 @@ temporal_sel(PG_FUNCTION_ARGS)
 
 PG_FUNCTION_INFO_V1(temporal_joinsel);
 
+/*
+ * Returns the fraction of not NULL values of a column, or 1.0 if there are no
+ * statistics for it.
+ */
+double
+temporal_notnullfrac(VariableStatData *vardata)
+{
+	if (!HeapTupleIsValid(vardata->statsTuple))
+		return 1.0;
+	return 1.0 - ((Form_pg_statistic) GETSTRUCT(vardata->statsTuple))->stanullfrac;
+}
+
+/*
+ * Estimate the join selectivity of an operator between two temporal columns
+ * by combining the histograms of period bounds of both sides.
+ */
+static double
+temporal_joinsel_internal(PlannerInfo *root, List *args, SpecialJoinInfo *sjinfo,
+	CachedOp cachedOp)
+{
+	VariableStatData vardata1, vardata2;
+	bool join_is_reversed;
+	double selec;
+
+	get_join_variables(root, args, sjinfo, &vardata1, &vardata2,
+		&join_is_reversed);
+	selec = calc_period_hist_joinselectivity(&vardata1, &vardata2, cachedOp);
+	if (selec >= 0.0)
+		selec *= temporal_notnullfrac(&vardata1) * temporal_notnullfrac(&vardata2);
+	ReleaseVariableStats(vardata1);
+	ReleaseVariableStats(vardata2);
+	return selec;
+}
+
 PGDLLEXPORT Datum
 temporal_joinsel(PG_FUNCTION_ARGS)
 {
-	PG_RETURN_FLOAT8(DEFAULT_TEMP_SELECTIVITY);
+	PlannerInfo *root = (PlannerInfo *) PG_GETARG_POINTER(0);
+	Oid operator = PG_GETARG_OID(1);
+	List *args = (List *) PG_GETARG_POINTER(2);
+	JoinType jointype = (JoinType) PG_GETARG_INT16(3);
+	SpecialJoinInfo *sjinfo = (SpecialJoinInfo *) PG_GETARG_POINTER(4);
+	CachedOp cachedOp;
+	double selec;
+
+	/* In the case of unknown operator */
+	if (!temporal_cachedop(operator, &cachedOp))
+		PG_RETURN_FLOAT8(DEFAULT_TEMP_SELECTIVITY);
+
+	/* Only inner joins between two arguments are estimated */
+	if (jointype != JOIN_INNER || list_length(args) != 2)
+		PG_RETURN_FLOAT8(default_temporal_selectivity(cachedOp));
+
+	selec = temporal_joinsel_internal(root, args, sjinfo, cachedOp);
+	if (selec < 0.0)
+		selec = default_temporal_selectivity(cachedOp);
+	CLAMP_PROBABILITY(selec);
+	PG_RETURN_FLOAT8(selec);
 }
 
 /*****************************************************************************/
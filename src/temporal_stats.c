@@ -0,0 +1,103 @@
+/*****************************************************************************
+ *
+ * temporal_stats.c
+ *	  Per-backend counters of the hot paths of the extension
+ *
+ * Portions Copyright (c) 2020, Esteban Zimanyi, Arthur Lesuisse,
+ *		Universite Libre de Bruxelles
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ *****************************************************************************/
+
+#include "temporal_stats.h"
+
+#include <funcapi.h>
+#include <access/htup_details.h>
+#include <utils/builtins.h>
+
+/*****************************************************************************/
+
+/* Value of the mobilitydb.stats parameter */
+bool mobdb_stats = false;
+
+MobdbStatCounter _mobdb_stats[STAT_NUM];
+
+static const char *_mobdb_stat_names[] =
+{
+	"instants",
+	"sequences",
+	"trajectories",
+	"postgis_calls",
+	"skiplist_splices",
+	"detoasts",
+	"detoast_bytes",
+	"bbox_shortcuts"
+};
+
+/* Account one execution of a timed hot path */
+
+void
+mobdb_stats_stop(MobdbStat stat, instr_time *start)
+{
+	instr_time end;
+	INSTR_TIME_SET_CURRENT(end);
+	_mobdb_stats[stat].count++;
+	INSTR_TIME_ACCUM_DIFF(_mobdb_stats[stat].time, end, *start);
+}
+
+/*****************************************************************************/
+
+PG_FUNCTION_INFO_V1(mobdb_stats_get);
+/**
+ * @brief Counters of the hot paths of the extension in the current backend
+ */
+PGDLLEXPORT Datum
+mobdb_stats_get(PG_FUNCTION_ARGS)
+{
+	FuncCallContext *funcctx;
+	MobdbStatCounter *snapshot;
+	if (SRF_IS_FIRSTCALL())
+	{
+		funcctx = SRF_FIRSTCALL_INIT();
+		MemoryContext oldcontext = 
+			MemoryContextSwitchTo(funcctx->multi_call_memory_ctx);
+		/* Take a snapshot so that the rows are consistent */
+		snapshot = palloc(sizeof(_mobdb_stats));
+		memcpy(snapshot, _mobdb_stats, sizeof(_mobdb_stats));
+		funcctx->user_fctx = snapshot;
+		TupleDesc tupdesc;
+		if (get_call_result_type(fcinfo, NULL, &tupdesc) != TYPEFUNC_COMPOSITE)
+			ereport(ERROR, (errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+				errmsg("Function returning record called in context that cannot accept type record")));
+		funcctx->tuple_desc = BlessTupleDesc(tupdesc);
+		MemoryContextSwitchTo(oldcontext);
+	}
+	funcctx = SRF_PERCALL_SETUP();
+	snapshot = funcctx->user_fctx;
+	if (funcctx->call_cntr < STAT_NUM)
+	{
+		int i = (int) funcctx->call_cntr;
+		Datum values[3];
+		bool isnull[3] = {false, false, false};
+		values[0] = PointerGetDatum(cstring_to_text(_mobdb_stat_names[i]));
+		values[1] = Int64GetDatum((int64) snapshot[i].count);
+		values[2] = Float8GetDatum(INSTR_TIME_GET_MILLISEC(snapshot[i].time));
+		HeapTuple tuple = heap_form_tuple(funcctx->tuple_desc, values, isnull);
+		SRF_RETURN_NEXT(funcctx, HeapTupleGetDatum(tuple));
+	}
+	SRF_RETURN_DONE(funcctx);
+}
+
+PG_FUNCTION_INFO_V1(mobdb_stats_reset);
+/**
+ * @brief Reset the counters of the current backend
+ */
+PGDLLEXPORT Datum
+mobdb_stats_reset(PG_FUNCTION_ARGS)
+{
+	memset(_mobdb_stats, 0, sizeof(_mobdb_stats));
+	PG_RETURN_VOID();
+}
+
+/*****************************************************************************/
@@ -13,9 +13,15 @@
 #include "temporal_util.h"
 
 #include <assert.h>
+#include <float.h>
+#include <math.h>
 #include <catalog/pg_collation.h>
+#include <miscadmin.h>
 #include <utils/builtins.h>
+#include <utils/datetime.h>
+#include <utils/guc.h>
 #include <utils/lsyscache.h>
+#include <utils/memutils.h>
 #include <utils/timestamp.h>
 #include <utils/varlena.h>
 
@@ -23,6 +29,7 @@
 #include "temporal.h"
 #include "oidcache.h"
 #include "doublen.h"
+#include "temporal_stats.h"
 
 #ifdef WITH_POSTGIS
 #include "tpoint.h"
@@ -46,6 +53,16 @@ _PG_init(void)
 #ifdef WITH_POSTGIS
 	temporalgeom_init();
 #endif
+	DefineCustomBoolVariable("mobilitydb.precompute_trajectory",
+		"Store the trajectory of temporal geometry point sequences.",
+		"When off, the trajectory is not stored with the sequences but "
+		"computed when needed, which reduces the storage size.",
+		&precompute_trajectory, true, PGC_USERSET, 0, NULL, NULL, NULL);
+	DefineCustomBoolVariable("mobilitydb.stats",
+		"Collect the counters of the hot paths reported by mobdb_stats().",
+		"The counters are kept per backend. When off, which is the default, "
+		"the instrumentation reduces to a single test in each hot path.",
+		&mobdb_stats, false, PGC_USERSET, 0, NULL, NULL, NULL);
 }
 
 /* Print messages while debugging */
@@ -67,62 +84,185 @@ double_pad(size_t size)
 		return size;
 }
 
+/* 
+ * Create a short-lived memory context in which a construction function
+ * allocates its intermediate instants, sequences, and arrays. They are 
+ * then released at once by deleting the context after the result has been
+ * built in the caller's context, instead of being freed one by one. 
+ * PostgreSQL keeps the deleted contexts with the default sizes in a 
+ * freelist, so that creating the context for each call is cheap, and the
+ * context is released together with its parent on error.
+ */
+
+MemoryContext
+temporal_arena_create(void)
+{
+	return AllocSetContextCreate(CurrentMemoryContext, "MobilityDB arena",
+		ALLOCSET_DEFAULT_SIZES);
+}
+
+/*****************************************************************************
+ * Properties of the base types
+ *****************************************************************************/
+
+/*
+ * Properties of the base types of the temporal types indexed by BaseType.
+ * Since the Oids of the types defined by the extension are not known at
+ * compile time they are filled from the Oid cache on first use.
+ */
+
+typedef struct
+{
+	Oid oid;
+	int16 typlen;
+	bool byval;
+	bool linear;
+} BaseTypeInfo;
+
+static BaseTypeInfo _base_types[BASE_NUM_TYPES] =
+{
+	{BOOLOID, 1, true, false},			/* BASE_BOOL */
+	{INT4OID, 4, true, false},			/* BASE_INT4 */
+	{FLOAT8OID, 8, true, true},			/* BASE_FLOAT8 */
+	{TEXTOID, -1, false, false},		/* BASE_TEXT */
+	{TIMESTAMPTZOID, 8, true, false},	/* BASE_TIMESTAMPTZ */
+	{InvalidOid, 16, false, true},		/* BASE_DOUBLE2 */
+	{InvalidOid, 24, false, true},		/* BASE_DOUBLE3 */
+	{InvalidOid, 32, false, true},		/* BASE_DOUBLE4 */
+	{InvalidOid, -1, false, true},		/* BASE_GEOMETRY */
+	{InvalidOid, -1, false, true}		/* BASE_GEOGRAPHY */
+};
+
+static bool _base_types_ready = false;
+
+/* 
+ * Last type looked up. Consecutive calls almost always ask for the same
+ * type, in particular when iterating over the instants of a temporal value.
+ */
+static Oid _last_base_oid = BOOLOID;
+static BaseType _last_base_type = BASE_BOOL;
+
+static void
+base_types_resolve(void)
+{
+	_base_types[BASE_DOUBLE2].oid = type_oid(T_DOUBLE2);
+	_base_types[BASE_DOUBLE3].oid = type_oid(T_DOUBLE3);
+	_base_types[BASE_DOUBLE4].oid = type_oid(T_DOUBLE4);
+#ifdef WITH_POSTGIS
+	_base_types[BASE_GEOMETRY].oid = type_oid(T_GEOMETRY);
+	_base_types[BASE_GEOGRAPHY].oid = type_oid(T_GEOGRAPHY);
+#endif
+	_base_types_ready = true;
+}
+
+/* 
+ * Get the tag of a base type or -1 if the type is not a base type of the
+ * temporal types
+ */
+
+int
+base_type_find(Oid type)
+{
+	if (type == _last_base_oid)
+		return _last_base_type;
+
+	int result = -1;
+	switch (type)
+	{
+		case BOOLOID:
+			result = BASE_BOOL;
+			break;
+		case INT4OID:
+			result = BASE_INT4;
+			break;
+		case FLOAT8OID:
+			result = BASE_FLOAT8;
+			break;
+		case TEXTOID:
+			result = BASE_TEXT;
+			break;
+		case TIMESTAMPTZOID:
+			result = BASE_TIMESTAMPTZ;
+			break;
+		default:
+			if (type == InvalidOid)
+				break;
+			if (!_base_types_ready)
+				base_types_resolve();
+			for (int i = BASE_DOUBLE2; i < BASE_NUM_TYPES; i++)
+			{
+				if (_base_types[i].oid == type)
+				{
+					result = i;
+					break;
+				}
+			}
+	}
+	if (result >= 0)
+	{
+		_last_base_oid = type;
+		_last_base_type = (BaseType) result;
+	}
+	return result;
+}
+
+/* Get the tag of a base type, raising an error if it is not a base type */
+
+BaseType
+base_type(Oid type)
+{
+	int result = base_type_find(type);
+	if (result < 0)
+		elog(ERROR, "unknown base type: %d", type);
+	return (BaseType) result;
+}
+
+bool
+base_type_byval(BaseType basetype)
+{
+	return _base_types[basetype].byval;
+}
+
+int
+base_type_typlen(BaseType basetype)
+{
+	return _base_types[basetype].typlen;
+}
+
+bool
+base_type_linear(BaseType basetype)
+{
+	return _base_types[basetype].linear;
+}
+
+/*****************************************************************************/
+
 /* 
  * Is the type passed by value?
  * This function is called only for the base types of the temporal types
  * and for TimestampTz. To avoid a call of the slow function get_typbyval 
- * (which makes a lookup call), the known base types are explicitly enumerated.
+ * (which makes a lookup call), the property is read from the table of 
+ * base types.
  */
 
 bool
 get_typbyval_fast(Oid type)
 {
-	ensure_temporal_base_type_all(type);
-	bool result = false;
-	if (type == BOOLOID || type == INT4OID || type == FLOAT8OID || 
-		type == TIMESTAMPTZOID)
-		result = true;
-	else if (type == type_oid(T_DOUBLE2) || type == TEXTOID)
-		result = false;
-#ifdef WITH_POSTGIS
-	else if (type == type_oid(T_GEOMETRY) || type == type_oid(T_GEOGRAPHY) ||
-			 type == type_oid(T_DOUBLE3) || type == type_oid(T_DOUBLE4))
-		result = false;
-#endif
-	return result;
+	return _base_types[base_type(type)].byval;
 }
 
 /* 
  * Get length of type
  * This function is called only for the base types of the temporal types
  * and for TimestampTz. To avoid a call of the slow function get_typlen 
- * (which makes a lookup call), the known base types are explicitly enumerated.
+ * (which makes a lookup call), the property is read from the table of 
+ * base types.
  */
 
 int
 get_typlen_fast(Oid type)
 {
-	ensure_temporal_base_type_all(type);
-	int result = 0;
-	if (type == BOOLOID)
-		result = 1;
-	else if (type == INT4OID)
-		result = 4;
-	else if (type == FLOAT8OID || type == TIMESTAMPTZOID)
-		result = 8;
-	else if (type == type_oid(T_DOUBLE2))
-		result = 16;
-	else if (type == TEXTOID)
-		result = -1;
-#ifdef WITH_POSTGIS
-	else if (type == type_oid(T_GEOMETRY) || type == type_oid(T_GEOGRAPHY))
-		result = -1;
-	else if (type == type_oid(T_DOUBLE3))
-		result = 24;
-	else if (type == type_oid(T_DOUBLE4))
-		result = 32;
-#endif
-	return result;
+	return _base_types[base_type(type)].typlen;
 }
 
 /* Copy a Datum if it is passed by reference */
@@ -130,12 +270,13 @@ get_typlen_fast(Oid type)
 Datum
 datum_copy(Datum value, Oid type)
 {
+	const BaseTypeInfo *info = &_base_types[base_type(type)];
 	/* For types passed by value */
-	if (get_typbyval_fast(type))
+	if (info->byval)
 		return value;
 	/* For types passed by reference */
-	int typlen = get_typlen_fast(type);
-	size_t value_size = typlen != -1 ? (unsigned int) typlen : VARSIZE(value);
+	size_t value_size = info->typlen != -1 ? 
+		(unsigned int) info->typlen : VARSIZE(value);
 	void *result = palloc0(value_size);
 	memcpy(result, DatumGetPointer(value), value_size);
 	return PointerGetDatum(result);
@@ -183,6 +324,123 @@ call_output(Oid type, Datum value)
 	return OutputFunctionCall(&outfuncinfo, value);
 }
 
+/* Output of base values and timestamps into a buffer */
+
+/*
+ * Append a double to the buffer. When maxdd is negative the output is the
+ * one of float8out in PostgreSQL 11, that is, %g with DBL_DIG digits plus
+ * extra_float_digits. Otherwise the value is rounded to at most maxdd 
+ * decimal digits, without exceeding the 15 significant digits of a double,
+ * and trailing zeros are removed.
+ */
+void
+stringinfo_append_double(StringInfo buf, double d, int maxdd)
+{
+	char str[64];
+	if (isnan(d))
+	{
+		appendStringInfoString(buf, "NaN");
+		return;
+	}
+	if (isinf(d))
+	{
+		appendStringInfoString(buf, d > 0 ? "Infinity" : "-Infinity");
+		return;
+	}
+	if (maxdd < 0)
+	{
+		int ndig = DBL_DIG + extra_float_digits;
+		if (ndig < 1)
+			ndig = 1;
+		snprintf(str, sizeof(str), "%.*g", ndig, d);
+	}
+	else
+	{
+		double ad = fabs(d);
+		if (ad >= 1e15)
+			snprintf(str, sizeof(str), "%.*g", DBL_DIG, d);
+		else
+		{
+			/* Number of digits before the decimal point */
+			int ndd = ad < 1 ? 0 : (int) floor(log10(ad)) + 1;
+			if (maxdd > DBL_DIG - ndd)
+				maxdd = DBL_DIG - ndd;
+			int len = snprintf(str, sizeof(str), "%.*f", maxdd, d);
+			if (maxdd > 0)
+			{
+				/* Remove trailing zeros and the decimal point if possible */
+				while (str[len - 1] == '0')
+					len--;
+				if (str[len - 1] == '.')
+					len--;
+				str[len] = '\0';
+			}
+			/* Values rounded to zero are written without sign */
+			if (strcmp(str, "-0") == 0)
+				strcpy(str, "0");
+		}
+	}
+	appendStringInfoString(buf, str);
+}
+
+/*
+ * Append a timestamp to the buffer in the format of timestamptz_out 
+ * without going through the function manager
+ */
+void
+stringinfo_append_timestamp(StringInfo buf, TimestampTz t)
+{
+	char str[MAXDATELEN + 1];
+	struct pg_tm tt, *tm = &tt;
+	fsec_t fsec;
+	int tz;
+	const char *tzn;
+
+	if (TIMESTAMP_IS_NOBEGIN(t))
+		appendStringInfoString(buf, EARLY);
+	else if (TIMESTAMP_IS_NOEND(t))
+		appendStringInfoString(buf, LATE);
+	else if (timestamp2tm(t, &tz, tm, &fsec, &tzn, NULL) == 0)
+	{
+		EncodeDateTime(tm, fsec, true, tz, tzn, DateStyle, str);
+		appendStringInfoString(buf, str);
+	}
+	else
+		ereport(ERROR, (errcode(ERRCODE_DATETIME_VALUE_OUT_OF_RANGE),
+			errmsg("timestamp out of range")));
+}
+
+/*
+ * Append a value of a base type to the buffer. The values of the base types
+ * of the temporal alphanumeric types are written directly, other types go 
+ * through their output function
+ */
+void
+stringinfo_append_value(StringInfo buf, Oid type, Datum value, int maxdd)
+{
+	if (type == BOOLOID)
+		appendStringInfoChar(buf, DatumGetBool(value) ? 't' : 'f');
+	else if (type == INT4OID)
+	{
+		char str[12];
+		pg_ltoa(DatumGetInt32(value), str);
+		appendStringInfoString(buf, str);
+	}
+	else if (type == FLOAT8OID)
+		stringinfo_append_double(buf, DatumGetFloat8(value), maxdd);
+	else if (type == TEXTOID)
+	{
+		text *txt = DatumGetTextPP(value);
+		appendBinaryStringInfo(buf, VARDATA_ANY(txt), VARSIZE_ANY_EXHDR(txt));
+	}
+	else
+	{
+		char *str = call_output(type, value);
+		appendStringInfoString(buf, str);
+		pfree(str);
+	}
+}
+
 /* Call send function of the base type of a temporal type */
 
 bytea *
@@ -222,7 +480,10 @@ call_function1(PGFunction func, Datum arg1)
 	InitFunctionCallInfoData(fcinfo, &flinfo, 1, DEFAULT_COLLATION_OID, NULL, NULL);
 	fcinfo.arg[0] = arg1;
 	fcinfo.argnull[0] = false;
+	instr_time start;
+	MOBDB_STATS_START(start);
 	result = (*func) (&fcinfo);
+	MOBDB_STATS_STOP(STAT_POSTGIS_CALLS, start);
 	if (fcinfo.isnull)
 		elog(ERROR, "Function %p returned NULL", (void *) func);
 	return result;
@@ -241,7 +502,10 @@ call_function2(PGFunction func, Datum arg1, Datum arg2)
 	fcinfo.argnull[0] = false;
 	fcinfo.arg[1] = arg2;
 	fcinfo.argnull[1] = false;
+	instr_time start;
+	MOBDB_STATS_START(start);
 	result = (*func) (&fcinfo);
+	MOBDB_STATS_STOP(STAT_POSTGIS_CALLS, start);
 	if (fcinfo.isnull)
 		elog(ERROR, "function %p returned NULL", (void *) func);
 	return result;
@@ -262,7 +526,10 @@ call_function3(PGFunction func, Datum arg1, Datum arg2, Datum arg3)
 	fcinfo.argnull[1] = false;
 	fcinfo.arg[2] = arg3;
 	fcinfo.argnull[2] = false;
+	instr_time start;
+	MOBDB_STATS_START(start);
 	result = (*func) (&fcinfo);
+	MOBDB_STATS_STOP(STAT_POSTGIS_CALLS, start);
 	if (fcinfo.isnull)
 		elog(ERROR, "function %p returned NULL", (void *) func);
 	return result;
@@ -285,7 +552,10 @@ call_function4(PGFunction func, Datum arg1, Datum arg2, Datum arg3, Datum arg4)
 	fcinfo.argnull[2] = false;
 	fcinfo.arg[3] = arg4;
 	fcinfo.argnull[3] = false;
+	instr_time start;
+	MOBDB_STATS_START(start);
 	result = (*func) (&fcinfo);
+	MOBDB_STATS_STOP(STAT_POSTGIS_CALLS, start);
 	if (fcinfo.isnull)
 		elog(ERROR, "function %p returned NULL", (void *) func);
 	return result;
@@ -555,26 +825,37 @@ text_cmp(text *arg1, text *arg2, Oid collid)
 bool
 datum_eq(Datum l, Datum r, Oid type)
 {
-	ensure_temporal_base_type_all(type);
 	bool result = false;
-	if (type == BOOLOID || type == INT4OID || type == FLOAT8OID)
-		result = l == r;
-	else if (type == TEXTOID)
-		result = text_cmp(DatumGetTextP(l), DatumGetTextP(r), DEFAULT_COLLATION_OID) == 0;
-	else if (type == type_oid(T_DOUBLE2))
-		result = double2_eq((double2 *)DatumGetPointer(l), (double2 *)DatumGetPointer(r));
-	else if (type == type_oid(T_DOUBLE3))
-		result = double3_eq((double3 *)DatumGetPointer(l), (double3 *)DatumGetPointer(r));
-	else if (type == type_oid(T_DOUBLE4))
-		result = double4_eq((double4 *)DatumGetPointer(l), (double4 *)DatumGetPointer(r));
+	switch (base_type(type))
+	{
+		case BASE_BOOL:
+		case BASE_INT4:
+		case BASE_FLOAT8:
+		case BASE_TIMESTAMPTZ:
+			result = l == r;
+			break;
+		case BASE_TEXT:
+			result = text_cmp(DatumGetTextP(l), DatumGetTextP(r), DEFAULT_COLLATION_OID) == 0;
+			break;
+		case BASE_DOUBLE2:
+			result = double2_eq((double2 *)DatumGetPointer(l), (double2 *)DatumGetPointer(r));
+			break;
+		case BASE_DOUBLE3:
+			result = double3_eq((double3 *)DatumGetPointer(l), (double3 *)DatumGetPointer(r));
+			break;
+		case BASE_DOUBLE4:
+			result = double4_eq((double4 *)DatumGetPointer(l), (double4 *)DatumGetPointer(r));
+			break;
 #ifdef WITH_POSTGIS
-	else if (type == type_oid(T_GEOMETRY))
-		//	result = DatumGetBool(call_function2(lwgeom_eq, l, r));
-		result = datum_point_eq(l, r);
-	else if (type == type_oid(T_GEOGRAPHY))
-		//	result = DatumGetBool(call_function2(geography_eq, l, r));
-		result = datum_point_eq(l, r);
+		case BASE_GEOMETRY:
+		case BASE_GEOGRAPHY:
+			//	result = DatumGetBool(call_function2(lwgeom_eq, l, r));
+			result = datum_point_eq(l, r);
+			break;
 #endif
+		default:
+			break;
+	}
 	return result;
 }
 
@@ -587,22 +868,32 @@ datum_ne(Datum l, Datum r, Oid type)
 bool
 datum_lt(Datum l, Datum r, Oid type)
 {
-	ensure_temporal_base_type(type);
 	bool result = false;
-	if (type == BOOLOID)
-		result = DatumGetBool(l) < DatumGetBool(r);
-	else if (type == INT4OID)
-		result = DatumGetInt32(l) < DatumGetInt32(r);
-	else if (type == FLOAT8OID)
-		result = DatumGetFloat8(l) < DatumGetFloat8(r);
-	else if (type == TEXTOID)
-		result = text_cmp(DatumGetTextP(l), DatumGetTextP(r), DEFAULT_COLLATION_OID) < 0;
+	switch (base_type(type))
+	{
+		case BASE_BOOL:
+			result = DatumGetBool(l) < DatumGetBool(r);
+			break;
+		case BASE_INT4:
+			result = DatumGetInt32(l) < DatumGetInt32(r);
+			break;
+		case BASE_FLOAT8:
+			result = DatumGetFloat8(l) < DatumGetFloat8(r);
+			break;
+		case BASE_TEXT:
+			result = text_cmp(DatumGetTextP(l), DatumGetTextP(r), DEFAULT_COLLATION_OID) < 0;
+			break;
 #ifdef WITH_POSTGIS
-	else if (type == type_oid(T_GEOMETRY))
-		result = DatumGetBool(call_function2(lwgeom_lt, l, r));
-	else if (type == type_oid(T_GEOGRAPHY))
-		result = DatumGetBool(call_function2(geography_lt, l, r));
+		case BASE_GEOMETRY:
+			result = DatumGetBool(call_function2(lwgeom_lt, l, r));
+			break;
+		case BASE_GEOGRAPHY:
+			result = DatumGetBool(call_function2(geography_lt, l, r));
+			break;
 #endif
+		default:
+			elog(ERROR, "unknown base type: %d", type);
+	}
 	return result;
 }
 
@@ -634,27 +925,23 @@ datum_ge(Datum l, Datum r, Oid type)
 bool
 datum_eq2(Datum l, Datum r, Oid typel, Oid typer)
 {
-	ensure_temporal_base_type_all(typel);
-	ensure_temporal_base_type_all(typer);
+	BaseType basel = base_type(typel), baser = base_type(typer);
 	bool result = false;
-	if ((typel == BOOLOID && typer == BOOLOID) ||
-		(typel == INT4OID && typer == INT4OID) ||
-		(typel == FLOAT8OID && typer == FLOAT8OID))
+	if (basel == baser && 
+		(basel == BASE_BOOL || basel == BASE_INT4 || basel == BASE_FLOAT8))
 		result = l == r;
-	else if (typel == INT4OID && typer == FLOAT8OID)
+	else if (basel == BASE_INT4 && baser == BASE_FLOAT8)
 		result = DatumGetInt32(l) == DatumGetFloat8(r);
-	else if (typel == FLOAT8OID && typer == INT4OID)
+	else if (basel == BASE_FLOAT8 && baser == BASE_INT4)
 		result = DatumGetFloat8(l) == DatumGetInt32(r);
-	else if (typel == TEXTOID && typer == TEXTOID)
+	else if (basel == BASE_TEXT && baser == BASE_TEXT)
 		result = text_cmp(DatumGetTextP(l), DatumGetTextP(r), DEFAULT_COLLATION_OID) == 0;
 		/* This function is never called with doubleN */
 #ifdef WITH_POSTGIS
-	else if (typel == type_oid(T_GEOMETRY) && typer == type_oid(T_GEOMETRY))
+	else if (basel == baser && 
+		(basel == BASE_GEOMETRY || basel == BASE_GEOGRAPHY))
 		//	result = DatumGetBool(call_function2(lwgeom_eq, l, r));
 		result = datum_point_eq(l, r);
-	else if (typel == type_oid(T_GEOGRAPHY) && typer == type_oid(T_GEOGRAPHY))
-		//	result = DatumGetBool(call_function2(geography_eq, l, r));
-		result = datum_point_eq(l, r);
 #endif
 	return result;
 }
@@ -25,6 +25,7 @@
 #include "temporaltypes.h"
 #include "oidcache.h"
 #include "temporal_util.h"
+#include "temporal_stats.h"
 #include "temporal_boxops.h"
 #include "rangetypes_ext.h"
 
@@ -376,36 +377,21 @@ intersection_temporali_temporali(TemporalI *ti1, TemporalI *ti2,
  * Input/output functions
  *****************************************************************************/
 
-/* Convert to string */
- 
-char*
-temporali_to_string(TemporalI *ti, char *(*value_out)(Oid, Datum))
-{
-	char** strings = palloc(sizeof(char *) * ti->count);
-	size_t outlen = 0;
+/* Append the text representation to the buffer */
 
+void
+temporali_to_stringbuf(StringInfo buf, TemporalI *ti, int maxdd, 
+	value_out_func value_out)
+{
+	appendStringInfoChar(buf, '{');
 	for (int i = 0; i < ti->count; i++)
 	{
-		TemporalInst *inst = temporali_inst_n(ti, i);
-		strings[i] = temporalinst_to_string(inst, value_out);
-		outlen += strlen(strings[i]) + 2;
-	}
-	char *result = palloc(outlen + 3);
-	result[outlen] = '\0';
-	result[0] = '{';
-	size_t pos = 1;
-	for (int i = 0; i < ti->count; i++)
-	{
-		strcpy(result + pos, strings[i]);
-		pos += strlen(strings[i]);
-		result[pos++] = ',';
-		result[pos++] = ' ';
-		pfree(strings[i]);
+		if (i > 0)
+			appendStringInfoString(buf, ", ");
+		temporalinst_to_stringbuf(buf, temporali_inst_n(ti, i), maxdd, 
+			value_out);
 	}
-	result[pos - 2] = '}';
-	result[pos - 1] = '\0';
-	pfree(strings);
-	return result;
+	appendStringInfoChar(buf, '}');
 }
 
 /* Send function */
@@ -924,7 +910,10 @@ temporali_at_value(TemporalI *ti, Datum value)
 		temporali_bbox(&box1, ti);
 		number_to_box(&box2, value, valuetypid);
 		if (!contains_tbox_tbox_internal(&box1, &box2))
+		{
+			MOBDB_STATS_INC(STAT_BBOX_SHORTCUTS);
 			return NULL;
+		}
 	}
 
 	/* Singleton instant set */
@@ -966,7 +955,10 @@ temporali_minus_value(TemporalI *ti, Datum value)
 		temporali_bbox(&box1, ti);
 		number_to_box(&box2, value, valuetypid);
 		if (!contains_tbox_tbox_internal(&box1, &box2))
+		{
+			MOBDB_STATS_INC(STAT_BBOX_SHORTCUTS);
 			return temporali_copy(ti);
+		}
 	}
 
 	/* Singleton instant set */
@@ -1088,7 +1080,10 @@ tnumberi_at_range(TemporalI *ti, RangeType *range)
 	temporali_bbox(&box1, ti);
 	range_to_tbox_internal(&box2, range);
 	if (!overlaps_tbox_tbox_internal(&box1, &box2))
+	{
+		MOBDB_STATS_INC(STAT_BBOX_SHORTCUTS);
 		return NULL;
+	}
 
 	/* Singleton instant set */
 	if (ti->count == 1)
@@ -1129,7 +1124,10 @@ tnumberi_minus_range(TemporalI *ti, RangeType *range)
 	temporali_bbox(&box1, ti);
 	range_to_tbox_internal(&box2, range);
 	if (!overlaps_tbox_tbox_internal(&box1, &box2))
+	{
+		MOBDB_STATS_INC(STAT_BBOX_SHORTCUTS);
 		return temporali_copy(ti);
+	}
 
 	/* Singleton instant set */
 	if (ti->count == 1)
@@ -1690,7 +1688,10 @@ temporali_eq(TemporalI *ti1, TemporalI *ti2)
 	void *box1 = temporali_bbox_ptr(ti1);
 	void *box2 = temporali_bbox_ptr(ti2);
 	if (! temporal_bbox_eq(ti1->valuetypid, box1, box2))
+	{
+		MOBDB_STATS_INC(STAT_BBOX_SHORTCUTS);
 		return false;
+	}
 	
 	/* Compare the composing instants */
 	for (int i = 0; i < ti1->count; i++)
@@ -25,6 +25,7 @@
 #include "temporaltypes.h"
 #include "oidcache.h"
 #include "temporal_util.h"
+#include "temporal_stats.h"
 #include "temporal_boxops.h"
 #include "rangetypes_ext.h"
 
@@ -98,38 +99,45 @@ temporalinst_bbox(void *box, TemporalInst *inst)
 	temporalinst_make_bbox(box, value, inst->t, inst->valuetypid);
 }
 
-/* Construct a temporal instant value */
- 
-TemporalInst *
-temporalinst_make(Datum value, TimestampTz t, Oid valuetypid)
+/* Size of a temporal instant value */
+
+static size_t
+temporalinst_make_size(Datum value, Oid valuetypid, bool byval)
 {
-	size_t value_offset = double_pad(sizeof(TemporalInst));
-	size_t size = value_offset;
-	/* Create the temporal value */
-	TemporalInst *result;
-	size_t value_size;
-	/* Copy value */
-	bool byval = get_typbyval_fast(valuetypid);
+	size_t size = double_pad(sizeof(TemporalInst));
 	if (byval)
-	{
 		/* For base types passed by value */
-		value_size = double_pad(sizeof(Datum));
-		size += value_size;
-		result = palloc0(size);
-		void *value_to = ((char *) result) + value_offset;
-		memcpy(value_to, &value, sizeof(Datum));
+		size += double_pad(sizeof(Datum));
+	else
+	{
+		/* For base types passed by reference */
+		int typlen = get_typlen_fast(valuetypid);
+		size += typlen != -1 ? double_pad((unsigned int) typlen) : 
+			double_pad(VARSIZE(DatumGetPointer(value)));
 	}
+	return size;
+}
+
+/* 
+ * Fill a zeroed buffer of the size computed by temporalinst_make_size 
+ * with a temporal instant value 
+ */
+
+static void
+temporalinst_fill(TemporalInst *result, size_t size, Datum value, 
+	TimestampTz t, Oid valuetypid, bool byval)
+{
+	MOBDB_STATS_INC(STAT_INSTANTS);
+	void *value_to = ((char *) result) + double_pad(sizeof(TemporalInst));
+	/* Copy value */
+	if (byval)
+		memcpy(value_to, &value, sizeof(Datum));
 	else 
 	{
-		/* For base types passed by reference */
 		void *value_from = DatumGetPointer(value);
 		int typlen = get_typlen_fast(valuetypid);
-		value_size = typlen != -1 ? double_pad((unsigned int) typlen) : 
-			double_pad(VARSIZE(value_from));
-		size += value_size;
-		result = palloc0(size);
-		void *value_to = ((char *) result) + value_offset;
-		memcpy(value_to, value_from, value_size);
+		memcpy(value_to, value_from, typlen != -1 ? (unsigned int) typlen :
+			VARSIZE(value_from));
 	}
 	/* Initialize fixed-size values */
 	result->duration = TEMPORALINST;
@@ -148,9 +156,183 @@ temporalinst_make(Datum value, TimestampTz t, Oid valuetypid)
 		POSTGIS_FREE_IF_COPY_P(gs, DatumGetPointer(value));
 	}
 #endif
+	return;
+}
+
+/* Construct a temporal instant value */
+ 
+TemporalInst *
+temporalinst_make(Datum value, TimestampTz t, Oid valuetypid)
+{
+	bool byval = get_typbyval_fast(valuetypid);
+	size_t size = temporalinst_make_size(value, valuetypid, byval);
+	TemporalInst *result = palloc0(size);
+	temporalinst_fill(result, size, value, t, valuetypid, byval);
+	return result;
+}
+
+/*
+ * Construct a temporal instant value into a buffer that is reused across 
+ * calls. The buffer, which may be NULL at the first call, is enlarged when 
+ * it is too small for the value and its allocated size is kept in bufsize. 
+ * The result overwrites the previous content of the buffer and must be 
+ * freed once with pfree when the buffer is no longer needed.
+ */
+ 
+TemporalInst *
+temporalinst_make_reuse(TemporalInst *buf, size_t *bufsize, Datum value, 
+	TimestampTz t, Oid valuetypid)
+{
+	bool byval = get_typbyval_fast(valuetypid);
+	size_t size = temporalinst_make_size(value, valuetypid, byval);
+	if (buf == NULL)
+	{
+		buf = palloc(size);
+		*bufsize = size;
+	}
+	else if (*bufsize < size)
+	{
+		buf = repalloc(buf, size);
+		*bufsize = size;
+	}
+	memset(buf, 0, size);
+	temporalinst_fill(buf, size, value, t, valuetypid, byval);
+	return buf;
+}
+
+/*
+ * Construct an array of temporal instant values of a base type passed by
+ * value. All the instants are allocated in a single buffer and thus the 
+ * result must be freed with pfree(result[0]); pfree(result).
+ */
+TemporalInst **
+temporalinstarr_make_byval(Datum *values, TimestampTz *times, int count,
+	Oid valuetypid)
+{
+	assert(count > 0);
+	TemporalInst *inst = temporalinst_make(values[0], times[0], valuetypid);
+	assert(MOBDB_FLAGS_GET_BYVAL(inst->flags));
+	size_t instsize = double_pad(VARSIZE(inst));
+	char *buffer = palloc(instsize * count);
+	TemporalInst **result = palloc(sizeof(TemporalInst *) * count);
+	for (int i = 0; i < count; i++)
+	{
+		result[i] = (TemporalInst *) (buffer + instsize * i);
+		memcpy(result[i], inst, VARSIZE(inst));
+		result[i]->t = times[i];
+		*temporalinst_value_ptr(result[i]) = values[i];
+	}
+	MOBDB_STATS_ADD(STAT_INSTANTS, count - 1);
+	pfree(inst);
+	return result;
+}
+
+/*****************************************************************************
+ * Builder of arrays of instants
+ *****************************************************************************/
+
+/* Header of a chunk, pointing to the previous chunk of the builder */
+#define INSTBUILDER_HEADER	double_pad(sizeof(char *))
+
+/* Initialize a builder for at most maxcount instants, which may grow */
+
+void
+temporalinstbuilder_init(TemporalInstBuilder *builder, int maxcount)
+{
+	builder->maxcount = maxcount > 0 ? maxcount : 1;
+	builder->instants = palloc(sizeof(TemporalInst *) * builder->maxcount);
+	builder->count = 0;
+	builder->chunk = NULL;
+	builder->chunkpos = 0;
+	builder->chunksize = 0;
+}
+
+static void
+temporalinstbuilder_append(TemporalInstBuilder *builder, TemporalInst *inst)
+{
+	if (builder->count == builder->maxcount)
+	{
+		builder->maxcount *= 2;
+		builder->instants = repalloc(builder->instants, 
+			sizeof(TemporalInst *) * builder->maxcount);
+	}
+	builder->instants[builder->count++] = inst;
+}
+
+/* Add a reference to an existing instant, which is not copied */
+
+void
+temporalinstbuilder_add_inst(TemporalInstBuilder *builder, TemporalInst *inst)
+{
+	temporalinstbuilder_append(builder, inst);
+}
+
+/* 
+ * Construct a new instant in place and add it to the builder.
+ * When the current chunk is full, a new chunk is allocated that is large
+ * enough for the remaining instants if they are of the same size, which 
+ * is always the case for base types passed by value.
+ */
+
+TemporalInst *
+temporalinstbuilder_add_value(TemporalInstBuilder *builder, Datum value, 
+	TimestampTz t, Oid valuetypid)
+{
+	bool byval = get_typbyval_fast(valuetypid);
+	size_t size = temporalinst_make_size(value, valuetypid, byval);
+	if (builder->chunk == NULL || builder->chunkpos + size > builder->chunksize)
+	{
+		int remaining = Max(builder->maxcount - builder->count, 4);
+		size_t chunksize = INSTBUILDER_HEADER + size * remaining;
+		if (chunksize < 2 * builder->chunksize)
+			chunksize = 2 * builder->chunksize;
+		char *chunk = palloc(chunksize);
+		*((char **) chunk) = builder->chunk;
+		builder->chunk = chunk;
+		builder->chunkpos = INSTBUILDER_HEADER;
+		builder->chunksize = chunksize;
+	}
+	TemporalInst *result = (TemporalInst *) (builder->chunk + builder->chunkpos);
+	memset(result, 0, size);
+	temporalinst_fill(result, size, value, t, valuetypid, byval);
+	builder->chunkpos += size;
+	temporalinstbuilder_append(builder, result);
 	return result;
 }
 
+/* Remove all the instants, keeping the current chunk for the next ones */
+
+void
+temporalinstbuilder_reset(TemporalInstBuilder *builder)
+{
+	if (builder->chunk != NULL)
+	{
+		char *prev = *((char **) builder->chunk);
+		while (prev != NULL)
+		{
+			char *chunk = prev;
+			prev = *((char **) chunk);
+			pfree(chunk);
+		}
+		*((char **) builder->chunk) = NULL;
+		builder->chunkpos = INSTBUILDER_HEADER;
+	}
+	builder->count = 0;
+}
+
+void
+temporalinstbuilder_free(TemporalInstBuilder *builder)
+{
+	char *chunk = builder->chunk;
+	while (chunk != NULL)
+	{
+		char *prev = *((char **) chunk);
+		pfree(chunk);
+		chunk = prev;
+	}
+	pfree(builder->instants);
+}
+
  /* Append an instant to another instant resulting in a TemporalI */
 
 TemporalI *
@@ -176,27 +358,19 @@ temporalinst_copy(TemporalInst *inst)
  *****************************************************************************/
 
 /* 
- * Output a temporal value as a string. 
+ * Append the text representation of a temporal value to the buffer. 
  */
-char *
-temporalinst_to_string(TemporalInst *inst, char *(*value_out)(Oid, Datum))
+void
+temporalinst_to_stringbuf(StringInfo buf, TemporalInst *inst, int maxdd, 
+	value_out_func value_out)
 {
-	char *t = call_output(TIMESTAMPTZOID, TimestampTzGetDatum(inst->t));
-	char *value = value_out(inst->valuetypid, temporalinst_value(inst));
-	char *result;
 	if (inst->valuetypid == TEXTOID)
-	{
-		result = palloc(strlen(value) + strlen(t) + 4);
-		sprintf(result, "\"%s\"@%s", value, t);
-	}
-	else
-	{
-		result = palloc(strlen(value) + strlen(t) + 2);
-		sprintf(result, "%s@%s", value, t);
-	}
-	pfree(t);
-	pfree(value);
-	return result;
+		appendStringInfoChar(buf, '"');
+	value_out(buf, inst->valuetypid, temporalinst_value(inst), maxdd);
+	if (inst->valuetypid == TEXTOID)
+		appendStringInfoChar(buf, '"');
+	appendStringInfoChar(buf, '@');
+	stringinfo_append_timestamp(buf, inst->t);
 }
 
 /* 
@@ -15,6 +15,7 @@
 #include <assert.h>
 #include <libpq/pqformat.h>
 #include <utils/builtins.h>
+#include <utils/memutils.h>
 #include <utils/timestamp.h>
 
 #include "timestampset.h"
@@ -23,6 +24,7 @@
 #include "timeops.h"
 #include "temporaltypes.h"
 #include "temporal_util.h"
+#include "temporal_stats.h"
 #include "oidcache.h"
 #include "temporal_boxops.h"
 #include "rangetypes_ext.h"
@@ -620,43 +622,24 @@ synchronize_temporals_temporals(TemporalS *ts1, TemporalS *ts2,
  * Input/output functions
  *****************************************************************************/
 
-/* Convert to string */
- 
-char *
-temporals_to_string(TemporalS *ts, char *(*value_out)(Oid, Datum))
+/* Append the text representation to the buffer */
+
+void
+temporals_to_stringbuf(StringInfo buf, TemporalS *ts, int maxdd, 
+	value_out_func value_out)
 {
-	char **strings = palloc(sizeof(char *) * ts->count);
-	size_t outlen = 0;
-	char str[20];
 	if (linear_interpolation(ts->valuetypid) && 
 		! MOBDB_FLAGS_GET_LINEAR(ts->flags))
-		sprintf(str, "Interp=Stepwise;");
-	else
-		str[0] = '\0';
+		appendStringInfoString(buf, "Interp=Stepwise;");
+	appendStringInfoChar(buf, '{');
 	for (int i = 0; i < ts->count; i++)
 	{
-		TemporalSeq *seq = temporals_seq_n(ts, i);
-		strings[i] = temporalseq_to_string(seq, true, value_out);
-		outlen += strlen(strings[i]) + 2;
-	}
-	char *result = palloc(strlen(str) + outlen + 3);
-	result[outlen] = '\0';
-	size_t pos = 0;
-	strcpy(result, str);
-	pos += strlen(str);
-	result[pos++] = '{';
-	for (int i = 0; i < ts->count; i++)
-	{
-		strcpy(result + pos, strings[i]);
-		pos += strlen(strings[i]);
-		result[pos++] = ',';
-		result[pos++] = ' ';
-		pfree(strings[i]);
+		if (i > 0)
+			appendStringInfoString(buf, ", ");
+		temporalseq_to_stringbuf(buf, temporals_seq_n(ts, i), true, maxdd, 
+			value_out);
 	}
-	result[pos - 2] = '}';
-	result[pos - 1] = '\0';
-	pfree(strings);
-	return result;
+	appendStringInfoChar(buf, '}');
 }
 
 /* Send function */
@@ -1435,7 +1418,10 @@ temporals_at_value(TemporalS *ts, Datum value)
 		temporals_bbox(&box1, ts);
 		number_to_box(&box2, value, valuetypid);
 		if (!contains_tbox_tbox_internal(&box1, &box2))
+		{
+			MOBDB_STATS_INC(STAT_BBOX_SHORTCUTS);
 			return NULL;
+		}
 	}
 
 	/* Singleton sequence set */
@@ -1443,6 +1429,8 @@ temporals_at_value(TemporalS *ts, Datum value)
 		return temporalseq_at_value(temporals_seq_n(ts, 0), value);
 
 	/* General case */
+	MemoryContext arena = temporal_arena_create();
+	MemoryContext oldcontext = MemoryContextSwitchTo(arena);
 	TemporalSeq **sequences = palloc(sizeof(TemporalSeq *) * ts->totalcount);
 	int k = 0;
 	for (int i = 0; i < ts->count; i++)
@@ -1450,17 +1438,16 @@ temporals_at_value(TemporalS *ts, Datum value)
 		TemporalSeq *seq = temporals_seq_n(ts, i);
 		k += temporalseq_at_value2(&sequences[k], seq, value);
 	}
+	MemoryContextSwitchTo(oldcontext);
 	if (k == 0)
 	{
-		pfree(sequences);
+		MemoryContextDelete(arena);
 		return NULL;
 	}
 	
 	TemporalS *result = temporals_from_temporalseqarr(sequences, k,
 		MOBDB_FLAGS_GET_LINEAR(ts->flags), true);	
-	for (int i = 0; i < k; i++)
-		pfree(sequences[i]);
-	pfree(sequences);
+	MemoryContextDelete(arena);
 	return result;
 }
 
@@ -1479,7 +1466,10 @@ temporals_minus_value(TemporalS *ts, Datum value)
 		temporals_bbox(&box1, ts);
 		number_to_box(&box2, value, valuetypid);
 		if (!contains_tbox_tbox_internal(&box1, &box2))
+		{
+			MOBDB_STATS_INC(STAT_BBOX_SHORTCUTS);
 			return temporals_copy(ts);
+		}
 	}
 
 	/* Singleton sequence set */
@@ -1492,6 +1482,8 @@ temporals_minus_value(TemporalS *ts, Datum value)
 		count = ts->totalcount;
 	else 
 		count = ts->totalcount * 2;
+	MemoryContext arena = temporal_arena_create();
+	MemoryContext oldcontext = MemoryContextSwitchTo(arena);
 	TemporalSeq **sequences = palloc(sizeof(TemporalSeq *) * count);
 	int k = 0;
 	for (int i = 0; i < ts->count; i++)
@@ -1499,17 +1491,16 @@ temporals_minus_value(TemporalS *ts, Datum value)
 		TemporalSeq *seq = temporals_seq_n(ts, i);
 		k += temporalseq_minus_value2(&sequences[k], seq, value);
 	}
+	MemoryContextSwitchTo(oldcontext);
 	if (k == 0)
 	{
-		pfree(sequences);
+		MemoryContextDelete(arena);
 		return NULL;
 	}
 
 	TemporalS *result = temporals_from_temporalseqarr(sequences, k,
 		MOBDB_FLAGS_GET_LINEAR(ts->flags), true);
-	for (int i = 0; i < k; i++)
-		pfree(sequences[i]);
-	pfree(sequences);
+	MemoryContextDelete(arena);
 	return result;
 }
 
@@ -1525,6 +1516,8 @@ temporals_at_values(TemporalS *ts, Datum *values, int count)
 		return temporalseq_at_values(temporals_seq_n(ts, 0), values, count);
 
 	/* General case */
+	MemoryContext arena = temporal_arena_create();
+	MemoryContext oldcontext = MemoryContextSwitchTo(arena);
 	TemporalSeq **sequences = palloc(sizeof(TemporalSeq *) * ts->totalcount * count);
 	int k = 0;
 	for (int i = 0; i < ts->count; i++)
@@ -1532,16 +1525,15 @@ temporals_at_values(TemporalS *ts, Datum *values, int count)
 		TemporalSeq *seq = temporals_seq_n(ts, i);
 		k += temporalseq_at_values1(&sequences[k], seq, values, count);
 	}
-	if (k == 0) 
+	MemoryContextSwitchTo(oldcontext);
+	if (k == 0)
 	{
-		pfree(sequences);
+		MemoryContextDelete(arena);
 		return NULL;
 	}
 	TemporalS *result = temporals_from_temporalseqarr(sequences, k,
 		MOBDB_FLAGS_GET_LINEAR(ts->flags), true);
-	for (int i = 0; i < k; i++)
-		pfree(sequences[i]);
-	pfree(sequences);
+	MemoryContextDelete(arena);
 	return result;
 }
 
@@ -1562,6 +1554,8 @@ temporals_minus_values(TemporalS *ts, Datum *values, int count)
 		maxcount = ts->totalcount * count;
 	else 
 		maxcount = ts->totalcount * count *2;
+	MemoryContext arena = temporal_arena_create();
+	MemoryContext oldcontext = MemoryContextSwitchTo(arena);
 	TemporalSeq **sequences = palloc(sizeof(TemporalSeq *) * maxcount);	
 	int k = 0;
 	for (int i = 0; i < ts->count; i++)
@@ -1569,17 +1563,16 @@ temporals_minus_values(TemporalS *ts, Datum *values, int count)
 		TemporalSeq *seq = temporals_seq_n(ts, i);
 		k += temporalseq_minus_values1(&sequences[k], seq, values, count);
 	}
+	MemoryContextSwitchTo(oldcontext);
 	if (k == 0)
 	{
-		pfree(sequences);
+		MemoryContextDelete(arena);
 		return NULL;
 	}
 
 	TemporalS *result = temporals_from_temporalseqarr(sequences, k,
 		MOBDB_FLAGS_GET_LINEAR(ts->flags), true);
-	for (int i = 0; i < k; i++)
-		pfree(sequences[i]);
-	pfree(sequences);
+	MemoryContextDelete(arena);
 	return result;
 }
 
@@ -1596,13 +1589,18 @@ tnumbers_at_range(TemporalS *ts, RangeType *range)
 	temporals_bbox(&box1, ts);
 	range_to_tbox_internal(&box2, range);
 	if (!overlaps_tbox_tbox_internal(&box1, &box2))
+	{
+		MOBDB_STATS_INC(STAT_BBOX_SHORTCUTS);
 		return NULL;
+	}
 
 	/* Singleton sequence set */
 	if (ts->count == 1)
 		return tnumberseq_at_range(temporals_seq_n(ts, 0), range);
 
 	/* General case */
+	MemoryContext arena = temporal_arena_create();
+	MemoryContext oldcontext = MemoryContextSwitchTo(arena);
 	TemporalSeq **sequences = palloc(sizeof(TemporalSeq *) * ts->totalcount);
 	int k = 0;
 	for (int i = 0; i < ts->count; i++)
@@ -1610,16 +1608,15 @@ tnumbers_at_range(TemporalS *ts, RangeType *range)
 		TemporalSeq *seq = temporals_seq_n(ts, i);
 		k += tnumberseq_at_range2(&sequences[k], seq, range);
 	}
+	MemoryContextSwitchTo(oldcontext);
 	if (k == 0)
 	{
-		pfree(sequences);
+		MemoryContextDelete(arena);
 		return NULL;
 	}
 	TemporalS *result = temporals_from_temporalseqarr(sequences, k,
 		MOBDB_FLAGS_GET_LINEAR(ts->flags), true);
-	for (int i = 0; i < k; i++)
-		pfree(sequences[i]);
-	pfree(sequences);
+	MemoryContextDelete(arena);
 	return result;
 }
 
@@ -1636,7 +1633,10 @@ tnumbers_minus_range(TemporalS *ts, RangeType *range)
 	temporals_bbox(&box1, ts);
 	range_to_tbox_internal(&box2, range);
 	if (!overlaps_tbox_tbox_internal(&box1, &box2))
+	{
+		MOBDB_STATS_INC(STAT_BBOX_SHORTCUTS);
 		return temporals_copy(ts);
+	}
 
 	/* Singleton sequence set */
 	if (ts->count == 1)
@@ -1648,6 +1648,8 @@ tnumbers_minus_range(TemporalS *ts, RangeType *range)
 		maxcount = ts->totalcount;
 	else 
 		maxcount = ts->totalcount * 2;
+	MemoryContext arena = temporal_arena_create();
+	MemoryContext oldcontext = MemoryContextSwitchTo(arena);
 	TemporalSeq **sequences = palloc(sizeof(TemporalSeq *) * maxcount);
 	int k = 0;
 	for (int i = 0; i < ts->count; i++)
@@ -1655,16 +1657,15 @@ tnumbers_minus_range(TemporalS *ts, RangeType *range)
 		TemporalSeq *seq = temporals_seq_n(ts, i);
 		k += tnumberseq_minus_range1(&sequences[k], seq, range);
 	}
+	MemoryContextSwitchTo(oldcontext);
 	if (k == 0)
 	{
-		pfree(sequences);
+		MemoryContextDelete(arena);
 		return NULL;
 	}
 	TemporalS *result = temporals_from_temporalseqarr(sequences, k,
 		MOBDB_FLAGS_GET_LINEAR(ts->flags), true);
-	for (int i = 0; i < k; i++)
-		pfree(sequences[i]);
-	pfree(sequences); 
+	MemoryContextDelete(arena);
 	return result;
 }
 
@@ -1680,6 +1681,8 @@ tnumbers_at_ranges(TemporalS *ts, RangeType **ranges, int count)
 		return tnumberseq_at_ranges(temporals_seq_n(ts, 0), ranges, count);
 
 	/* General case */
+	MemoryContext arena = temporal_arena_create();
+	MemoryContext oldcontext = MemoryContextSwitchTo(arena);
 	TemporalSeq **sequences = palloc(sizeof(TemporalSeq *) * ts->totalcount * count);
 	int k = 0;
 	for (int i = 0; i < ts->count; i++)
@@ -1687,16 +1690,15 @@ tnumbers_at_ranges(TemporalS *ts, RangeType **ranges, int count)
 		TemporalSeq *seq = temporals_seq_n(ts, i);
 		k += tnumberseq_at_ranges1(&sequences[k], seq, ranges, count);
 	}
+	MemoryContextSwitchTo(oldcontext);
 	if (k == 0)
 	{
-		pfree(sequences);
+		MemoryContextDelete(arena);
 		return NULL;
 	}
 	TemporalS *result = temporals_from_temporalseqarr(sequences, k,
 		MOBDB_FLAGS_GET_LINEAR(ts->flags), true);
-	for (int i = 0; i < k; i++)
-		pfree(sequences[i]);
-	pfree(sequences); 
+	MemoryContextDelete(arena);
 	return result;
 }
 
@@ -1717,6 +1719,8 @@ tnumbers_minus_ranges(TemporalS *ts, RangeType **ranges, int count)
 		maxcount = ts->totalcount;
 	else 
 		maxcount = ts->totalcount * 2;
+	MemoryContext arena = temporal_arena_create();
+	MemoryContext oldcontext = MemoryContextSwitchTo(arena);
 	TemporalSeq **sequences = palloc(sizeof(TemporalSeq *) * maxcount);
 	int k = 0;
 	for (int i = 0; i < ts->count; i++)
@@ -1724,16 +1728,15 @@ tnumbers_minus_ranges(TemporalS *ts, RangeType **ranges, int count)
 		TemporalSeq *seq = temporals_seq_n(ts, i);
 		k += tnumberseq_minus_ranges1(&sequences[k], seq, ranges, count);
 	}
+	MemoryContextSwitchTo(oldcontext);
 	if (k == 0)
 	{
-		pfree(sequences);
+		MemoryContextDelete(arena);
 		return NULL;
 	}
 	TemporalS *result = temporals_from_temporalseqarr(sequences, k,
 		MOBDB_FLAGS_GET_LINEAR(ts->flags), true);
-	for (int i = 0; i < k; i++)
-		pfree(sequences[i]);
-	pfree(sequences); 
+	MemoryContextDelete(arena);
 	return result;
 }
 
@@ -1963,6 +1966,8 @@ temporals_minus_timestampset(TemporalS *ts1, TimestampSet *ts2)
 
 	/* General case */
 	/* Each timestamp will split at most one composing sequence into two */
+	MemoryContext arena = temporal_arena_create();
+	MemoryContext oldcontext = MemoryContextSwitchTo(arena);
 	TemporalSeq **sequences = palloc(sizeof(TemporalSeq *) * (ts1->count + ts2->count + 1));
 	int k = 0;
 	for (int i = 0; i < ts1->count; i++)
@@ -1971,17 +1976,16 @@ temporals_minus_timestampset(TemporalS *ts1, TimestampSet *ts2)
 		int count = temporalseq_minus_timestampset1(&sequences[k], seq, ts2);
 		k += count;
 	}
+	MemoryContextSwitchTo(oldcontext);
 	if (k == 0)
 	{
-		pfree(sequences);
+		MemoryContextDelete(arena);
 		return NULL;
 	}
 
 	TemporalS *result = temporals_from_temporalseqarr(sequences, k,
 		MOBDB_FLAGS_GET_LINEAR(ts1->flags), true);
-	for (int i = 0; i < k; i++)
-		pfree(sequences[i]);
-	pfree(sequences); 
+	MemoryContextDelete(arena);
 	return result;
 }
 
@@ -2093,6 +2097,8 @@ temporals_at_periodset(TemporalS *ts, PeriodSet *ps)
 	int n1, n2;
 	temporals_find_timestamp(ts, t, &n1);
 	periodset_find_timestamp(ps, t, &n2);
+	MemoryContext arena = temporal_arena_create();
+	MemoryContext oldcontext = MemoryContextSwitchTo(arena);
 	TemporalSeq **sequences = palloc(sizeof(TemporalSeq *) * (ts->count + ps->count - n1 - n2));
 	int i = n1, j = n2, k = 0;
 	while (i < ts->count && j < ps->count)
@@ -2112,18 +2118,17 @@ temporals_at_periodset(TemporalS *ts, PeriodSet *ps)
 		else 
 			j++;
 	}
+	MemoryContextSwitchTo(oldcontext);
 	if (k == 0)
 	{
-		pfree(sequences);
+		MemoryContextDelete(arena);
 		return NULL;
 	}
 	/* Since both the temporals and the periodset are normalized it is not 
 	   necessary to normalize the result of the projection */
 	TemporalS *result = temporals_from_temporalseqarr(sequences, k,
 		MOBDB_FLAGS_GET_LINEAR(ts->flags), false);
-	for (i = 0; i < k; i++)
-		pfree(sequences[i]);
-	pfree(sequences); 
+	MemoryContextDelete(arena);
 	return result;
 }
 
@@ -2146,6 +2151,8 @@ temporals_minus_periodset(TemporalS *ts, PeriodSet *ps)
 		return temporalseq_minus_periodset(temporals_seq_n(ts, 0), ps);
 
 	/* General case */
+	MemoryContext arena = temporal_arena_create();
+	MemoryContext oldcontext = MemoryContextSwitchTo(arena);
 	TemporalSeq **sequences = palloc(sizeof(TemporalSeq *) * (ts->count + ps->count));
 	int i = 0, j = 0, k = 0;
 	while (i < ts->count && j < ps->count)
@@ -2181,18 +2188,17 @@ temporals_minus_periodset(TemporalS *ts, PeriodSet *ps)
 			j = l;
 		}
 	}
+	MemoryContextSwitchTo(oldcontext);
 	if (k == 0)
 	{
-		pfree(sequences);
+		MemoryContextDelete(arena);
 		return NULL;
 	}
 	/* Since both the temporals and the periodset are normalized it is not 
 	   necessary to normalize the result of the difference */
 	TemporalS *result = temporals_from_temporalseqarr(sequences, k,
 		MOBDB_FLAGS_GET_LINEAR(ts->flags), false);
-	for (i = 0; i < k; i++)
-		pfree(sequences[i]);
-	pfree(sequences);
+	MemoryContextDelete(arena);
 	return result;
 }
 
@@ -2309,7 +2315,10 @@ temporals_eq(TemporalS *ts1, TemporalS *ts2)
 	void *box1 = temporals_bbox_ptr(ts1);
 	void *box2 = temporals_bbox_ptr(ts2);
 	if (! temporal_bbox_eq(ts1->valuetypid, box1, box2))
+	{
+		MOBDB_STATS_INC(STAT_BBOX_SHORTCUTS);
 		return false;
+	}
 
 	/* Compare the composing sequences */
 	for (int i = 0; i < ts1->count; i++)
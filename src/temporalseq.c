@@ -16,6 +16,7 @@
 #include <access/hash.h>
 #include <libpq/pqformat.h>
 #include <utils/builtins.h>
+#include <utils/memutils.h>
 #include <utils/timestamp.h>
 
 #include "timestampset.h"
@@ -26,6 +27,7 @@
 #include "temporaltypes.h"
 #include "oidcache.h"
 #include "temporal_util.h"
+#include "temporal_stats.h"
 #include "temporal_boxops.h"
 #include "rangetypes_ext.h"
 
@@ -55,7 +57,12 @@
  * are offsets for the corresponding instants, offset_2 is the offset for the 
  * bounding box and offset_3 is the offset for the precomputed trajectory. 
  * Precomputed trajectories are only kept for temporal points of sequence 
- * duration.
+ * duration. When the parameter mobilitydb.precompute_trajectory is off, 
+ * temporal geometry point sequences are constructed without the trajectory,
+ * which is signaled by the NOTRAJ flag, and the trajectory is computed on
+ * demand by the function tpointseq_trajectory. Sequences stored before
+ * the flag was introduced do not have it set and thus keep being read with
+ * their trajectory.
  */
 
 /* N-th TemporalInst of a TemporalSeq */
@@ -571,6 +578,8 @@ TemporalSeq *
 temporalseq_from_temporalinstarr(TemporalInst **instants, int count, 
    bool lower_inc, bool upper_inc, bool linear, bool normalize)
 {
+	instr_time start;
+	MOBDB_STATS_START(start);
 	Oid valuetypid = instants[0]->valuetypid;
 	/* Test the validity of the instants and the bounds */
 	assert(count > 0);
@@ -660,6 +669,7 @@ temporalseq_from_temporalinstarr(TemporalInst **instants, int count,
 	{
 		MOBDB_FLAGS_SET_Z(result->flags, hasz);
 		MOBDB_FLAGS_SET_GEODETIC(result->flags, isgeodetic);
+		MOBDB_FLAGS_SET_NOTRAJ(result->flags, ! trajectory);
 	}
 #endif
 	/* Initialization of the variable-length part */
@@ -709,6 +719,7 @@ temporalseq_from_temporalinstarr(TemporalInst **instants, int count,
 	if (normalize && count > 2)
 		pfree(newinstants);
 
+	MOBDB_STATS_STOP(STAT_SEQUENCES, start);
 	return result;
 }
 
@@ -788,7 +799,8 @@ temporalseq_append_instant(TemporalSeq *seq, TemporalInst *inst)
 	Datum traj = 0; /* keep compiler quiet */
 	if (isgeo)
 	{
-		trajectory = type_has_precomputed_trajectory(valuetypid);  
+		/* The result keeps the trajectory only if the sequence has one */
+		trajectory = ! MOBDB_FLAGS_GET_NOTRAJ(seq->flags);  
 		if (trajectory)
 		{
 			bool replace = newcount != seq->count + 1;
@@ -811,7 +823,10 @@ temporalseq_append_instant(TemporalSeq *seq, TemporalInst *inst)
 	MOBDB_FLAGS_SET_LINEAR(result->flags, MOBDB_FLAGS_GET_LINEAR(seq->flags));
 #ifdef WITH_POSTGIS
 	if (isgeo)
+	{
 		MOBDB_FLAGS_SET_Z(result->flags, MOBDB_FLAGS_GET_Z(seq->flags));
+		MOBDB_FLAGS_SET_NOTRAJ(result->flags, ! trajectory);
+	}
 #endif
 	/* Initialization of the variable-length part */
 	size_t pos = 0;
@@ -832,6 +847,7 @@ temporalseq_append_instant(TemporalSeq *seq, TemporalInst *inst)
 		void *bbox = ((char *) result) + pdata + pos;
 		temporalseq_expand_bbox(bbox, seq, inst);
 		result->offsets[newcount] = pos;
+		pos += double_pad(bboxsize);
 	}
 #ifdef WITH_POSTGIS
 	if (isgeo && trajectory)
@@ -983,6 +999,133 @@ intersection_temporalseq_temporalseq(TemporalSeq *seq1, TemporalSeq *seq2,
 	return true;
 }
 
+/*****************************************************************************
+ * Cursor synchronizing two TemporalSeq values. The cursor starts at the 
+ * lower bound of the intersection of their periods and each call to 
+ * temporalseq_sync_next advances it to the next timestamp of either 
+ * sequence. The instant of the other sequence is interpolated from its
+ * current segment in constant time, so that the two sequences are traversed
+ * in a single linear pass. Interpolated instants are written into two 
+ * scratch buffers per sequence that are used alternately, which keeps valid
+ * the instants of the previous step, and are only reallocated when a value
+ * does not fit in them. The instants returned by the cursor must therefore
+ * be copied if they are kept after the next step.
+ *****************************************************************************/
+
+/* Index of the first instant of the sequence whose timestamp is >= t */
+
+static int
+temporalseq_sync_first(TemporalSeq *seq, TimestampTz t)
+{
+	int first = 0, last = seq->count - 1;
+	while (first < last)
+	{
+		int middle = (first + last) / 2;
+		if (timestamp_cmp_internal(temporalseq_inst_n(seq, middle)->t, t) < 0)
+			first = middle + 1;
+		else
+			last = middle;
+	}
+	return first;
+}
+
+/* 
+ * Instant of the sequence at the timestamp t of the current step, given 
+ * the index n of the next instant of the sequence, which is advanced when 
+ * the sequence has an instant at t 
+ */
+
+static TemporalInst *
+temporalseq_sync_inst(TemporalSeq *seq, int *n, TimestampTz t, 
+	TemporalInst **buf, size_t *bufsize, int *last, bool *interp)
+{
+	TemporalInst *next = temporalseq_inst_n(seq, *n);
+	if (timestamp_cmp_internal(next->t, t) == 0)
+	{
+		(*n)++;
+		*interp = false;
+		return next;
+	}
+	/* The timestamp is strictly inside the segment ending at next */
+	TemporalInst *start = temporalseq_inst_n(seq, *n - 1);
+	Datum value = temporalseq_value_at_timestamp1(start, next, 
+		MOBDB_FLAGS_GET_LINEAR(seq->flags), t);
+	*last = 1 - *last;
+	buf[*last] = temporalinst_make_reuse(buf[*last], &bufsize[*last], 
+		value, t, seq->valuetypid);
+	FREE_DATUM(value, seq->valuetypid);
+	*interp = true;
+	return buf[*last];
+}
+
+/* 
+ * Initialize the cursor. Returns false when the periods of the sequences
+ * do not overlap, in which case the cursor must not be used.
+ */
+
+bool
+temporalseq_sync_init(TemporalSeqSync *sync, TemporalSeq *seq1, 
+	TemporalSeq *seq2)
+{
+	Period *inter = intersection_period_period_internal(&seq1->period, 
+		&seq2->period);
+	if (inter == NULL)
+		return false;
+	memset(sync, 0, sizeof(TemporalSeqSync));
+	sync->seq1 = seq1;
+	sync->seq2 = seq2;
+	sync->inter = *inter;
+	pfree(inter);
+	sync->i = temporalseq_sync_first(seq1, sync->inter.lower);
+	sync->j = temporalseq_sync_first(seq2, sync->inter.lower);
+	return true;
+}
+
+/* 
+ * Advance the cursor to the next step. Returns false when the upper bound 
+ * of the intersection has been passed.
+ */
+
+bool
+temporalseq_sync_next(TemporalSeqSync *sync)
+{
+	if (sync->i == sync->seq1->count || sync->j == sync->seq2->count)
+		return false;
+	TimestampTz t;
+	if (sync->inst1 == NULL)
+		t = sync->inter.lower;
+	else
+	{
+		TimestampTz t1 = temporalseq_inst_n(sync->seq1, sync->i)->t;
+		TimestampTz t2 = temporalseq_inst_n(sync->seq2, sync->j)->t;
+		t = timestamp_cmp_internal(t1, t2) <= 0 ? t1 : t2;
+		if (timestamp_cmp_internal(t, sync->inter.upper) > 0)
+			return false;
+	}
+	sync->prev1 = sync->inst1;
+	sync->prev2 = sync->inst2;
+	sync->inst1 = temporalseq_sync_inst(sync->seq1, &sync->i, t, 
+		sync->buf1, sync->bufsize1, &sync->last1, &sync->interp1);
+	sync->inst2 = temporalseq_sync_inst(sync->seq2, &sync->j, t, 
+		sync->buf2, sync->bufsize2, &sync->last2, &sync->interp2);
+	return true;
+}
+
+/* Release the scratch buffers of the cursor */
+
+void
+temporalseq_sync_free(TemporalSeqSync *sync)
+{
+	for (int i = 0; i < 2; i++)
+	{
+		if (sync->buf1[i] != NULL)
+			pfree(sync->buf1[i]);
+		if (sync->buf2[i] != NULL)
+			pfree(sync->buf2[i]);
+	}
+	return;
+}
+
 /*****************************************************************************
  * Synchronize two TemporalSeq values. The values are split into (redundant)
  * segments defined over the same set of instants covering the intersection
@@ -997,28 +1140,13 @@ synchronize_temporalseq_temporalseq(TemporalSeq *seq1, TemporalSeq *seq2,
 	TemporalSeq **sync1, TemporalSeq **sync2, bool crossings)
 {
 	/* Test whether the bounding period of the two temporal values overlap */
-	Period *inter = intersection_period_period_internal(&seq1->period, 
-		&seq2->period);
-	if (inter == NULL)
+	TemporalSeqSync sync;
+	if (! temporalseq_sync_init(&sync, seq1, seq2))
 		return false;
 
 	bool linear1 = MOBDB_FLAGS_GET_LINEAR(seq1->flags);
 	bool linear2 = MOBDB_FLAGS_GET_LINEAR(seq2->flags);
-	/* If the two sequences intersect at an instant */
-	if (timestamp_cmp_internal(inter->lower, inter->upper) == 0)
-	{
-		TemporalInst *inst1 = temporalseq_at_timestamp(seq1, inter->lower);
-		TemporalInst *inst2 = temporalseq_at_timestamp(seq2, inter->lower);
-		*sync1 = temporalseq_from_temporalinstarr(&inst1, 1, true, true, 
-			linear1, false);
-		*sync2 = temporalseq_from_temporalinstarr(&inst2, 1, true, true, 
-			linear2, false);
-		pfree(inst1); pfree(inst2); pfree(inter);
-		return true;
-	}
-	
 	/* 
-	 * General case 
 	 * seq1 =  ... *     *   *   *      *>
 	 * seq2 =       <*            *     * ...
 	 * sync1 =      <X C * C * C X C X C *>
@@ -1026,72 +1154,39 @@ synchronize_temporalseq_temporalseq(TemporalSeq *seq1, TemporalSeq *seq2,
 	 * where X are values added for synchronization and C are values added
 	 * for the crossings
 	 */
-	TemporalInst *inst1 = temporalseq_inst_n(seq1, 0);
-	TemporalInst *inst2 = temporalseq_inst_n(seq2, 0);
-	TemporalInst *tofreeinst = NULL;
-	int i = 0, j = 0, k = 0, l = 0;
-	if (timestamp_cmp_internal(inst1->t, inter->lower) < 0)
-	{
-		inst1 = tofreeinst = temporalseq_at_timestamp(seq1, inter->lower);
-		i = temporalseq_find_timestamp(seq1, inter->lower);
-	}
-	else if (timestamp_cmp_internal(inst2->t, inter->lower) < 0)
-	{
-		inst2 = tofreeinst = temporalseq_at_timestamp(seq2, inter->lower);
-		j = temporalseq_find_timestamp(seq2, inter->lower);
-	}
-	int count = (seq1->count - i + seq2->count - j) * 2;
+	int count = (seq1->count + seq2->count) * 2;
 	TemporalInst **instants1 = palloc(sizeof(TemporalInst *) * count);
 	TemporalInst **instants2 = palloc(sizeof(TemporalInst *) * count);
-	TemporalInst **tofree = palloc(sizeof(TemporalInst *) * count * 2);
-	if (tofreeinst != NULL)
-		tofree[l++] = tofreeinst;
-	while (i < seq1->count && j < seq2->count &&
-		(timestamp_cmp_internal(inst1->t, inter->upper) <= 0 ||
-		timestamp_cmp_internal(inst2->t, inter->upper) <= 0))
-	{
-		int cmp = timestamp_cmp_internal(inst1->t, inst2->t);
-		if (cmp == 0)
-		{
-			i++; j++;
-		}
-		else if (cmp < 0)
-		{
-			i++;
-			inst2 = temporalseq_at_timestamp(seq2, inst1->t);
-			tofree[l++] = inst2;
-		}
-		else 
-		{
-			j++;
-			inst1 = temporalseq_at_timestamp(seq1, inst2->t);
-			tofree[l++] = inst1;
-		}
+	TemporalInst **tofree = palloc(sizeof(TemporalInst *) * (count * 2 + 2));
+	int k = 0, l = 0;
+	while (temporalseq_sync_next(&sync))
+	{
 		/* If not the first instant add potential crossing before adding
 		   the new instants */
 		if (crossings && (linear1 || linear2) && k > 0)
 		{
 			TimestampTz crosstime;
-			if (temporalseq_intersect_at_timestamp(instants1[k - 1],
-				inst1, linear1, instants2[k - 1], inst2, linear2, &crosstime))
+			if (temporalseq_intersect_at_timestamp(sync.prev1, sync.inst1, 
+				linear1, sync.prev2, sync.inst2, linear2, &crosstime))
 			{
 				instants1[k] = tofree[l++] = temporalseq_at_timestamp1(
-					instants1[k - 1], inst1, linear1, crosstime);
+					sync.prev1, sync.inst1, linear1, crosstime);
 				instants2[k] = tofree[l++] = temporalseq_at_timestamp1(
-					instants2[k - 1], inst2, linear2, crosstime);
+					sync.prev2, sync.inst2, linear2, crosstime);
 				k++;
 			}
 		}
-		instants1[k] = inst1; instants2[k++] = inst2;
-		if (i == seq1->count || j == seq2->count)
-			break;
-		inst1 = temporalseq_inst_n(seq1, i);
-		inst2 = temporalseq_inst_n(seq2, j);
+		/* Interpolated instants are overwritten by the next steps */
+		instants1[k] = sync.interp1 ? 
+			(tofree[l++] = temporalinst_copy(sync.inst1)) : sync.inst1;
+		instants2[k++] = sync.interp2 ? 
+			(tofree[l++] = temporalinst_copy(sync.inst2)) : sync.inst2;
 	}
+	temporalseq_sync_free(&sync);
 	/* We are sure that k != 0 due to the period intersection test above */
 	/* The last two values of sequences with stepwise interpolation and 
 	   exclusive upper bound must be equal */
-	if (! inter->upper_inc && k > 1 && ! linear1)
+	if (! sync.inter.upper_inc && k > 1 && ! linear1)
 	{
 		if (datum_ne(temporalinst_value(instants1[k - 2]), 
 			temporalinst_value(instants1[k - 1]), seq1->valuetypid))
@@ -1101,7 +1196,7 @@ synchronize_temporalseq_temporalseq(TemporalSeq *seq1, TemporalSeq *seq2,
 			tofree[l++] = instants1[k - 1];
 		}
 	}
-	if (! inter->upper_inc && k > 1 && ! linear2)
+	if (! sync.inter.upper_inc && k > 1 && ! linear2)
 	{
 		if (datum_ne(temporalinst_value(instants2[k - 2]), 
 			temporalinst_value(instants2[k - 1]), seq2->valuetypid))
@@ -1112,13 +1207,13 @@ synchronize_temporalseq_temporalseq(TemporalSeq *seq1, TemporalSeq *seq2,
 		}
 	}
 	*sync1 = temporalseq_from_temporalinstarr(instants1, k, 
-		inter->lower_inc, inter->upper_inc, linear1, false);
+		sync.inter.lower_inc, sync.inter.upper_inc, linear1, false);
 	*sync2 = temporalseq_from_temporalinstarr(instants2, k, 
-		inter->lower_inc, inter->upper_inc, linear2, false);
+		sync.inter.lower_inc, sync.inter.upper_inc, linear2, false);
 	
-	for (i = 0; i < l; i++)
+	for (int i = 0; i < l; i++)
 		pfree(tofree[i]);
-	pfree(instants1); pfree(instants2); pfree(tofree); pfree(inter);
+	pfree(instants1); pfree(instants2); pfree(tofree);
 
 	return true;
 }
@@ -1313,43 +1408,24 @@ temporalseq_intersect_at_timestamp(TemporalInst *start1, TemporalInst *end1, boo
  * Input/output functions
  *****************************************************************************/
 
-/* Convert to string */
- 
-char *
-temporalseq_to_string(TemporalSeq *seq, bool component, char *(*value_out)(Oid, Datum))
+/* Append the text representation to the buffer */
+
+void
+temporalseq_to_stringbuf(StringInfo buf, TemporalSeq *seq, bool component, 
+	int maxdd, value_out_func value_out)
 {
-	char **strings = palloc(sizeof(char *) * seq->count);
-	size_t outlen = 0;
-	char str[20];
 	if (! component && linear_interpolation(seq->valuetypid) && 
 		!MOBDB_FLAGS_GET_LINEAR(seq->flags))
-		sprintf(str, "Interp=Stepwise;");
-	else
-		str[0] = '\0';
+		appendStringInfoString(buf, "Interp=Stepwise;");
+	appendStringInfoChar(buf, seq->period.lower_inc ? '[' : '(');
 	for (int i = 0; i < seq->count; i++)
 	{
-		TemporalInst *inst = temporalseq_inst_n(seq, i);
-		strings[i] = temporalinst_to_string(inst, value_out);
-		outlen += strlen(strings[i]) + 2;
-	}
-	char *result = palloc(strlen(str) + outlen + 3);
-	result[outlen] = '\0';
-	size_t pos = 0;
-	strcpy(result, str);
-	pos += strlen(str);
-	result[pos++] = seq->period.lower_inc ? (char) '[' : (char) '(';
-	for (int i = 0; i < seq->count; i++)
-	{
-		strcpy(result + pos, strings[i]);
-		pos += strlen(strings[i]);
-		result[pos++] = ',';
-		result[pos++] = ' ';
-		pfree(strings[i]);
+		if (i > 0)
+			appendStringInfoString(buf, ", ");
+		temporalinst_to_stringbuf(buf, temporalseq_inst_n(seq, i), maxdd, 
+			value_out);
 	}
-	result[pos - 2] = seq->period.upper_inc ? (char) ']' : (char) ')';
-	result[pos - 1] = '\0';
-	pfree(strings);
-	return result;
+	appendStringInfoChar(buf, seq->period.upper_inc ? ']' : ')');
 }
 
 /* Send function */
@@ -2228,11 +2304,16 @@ tlinearseq_timestamp_at_value(TemporalInst *inst1, TemporalInst *inst2,
 	return true;
 }
  
-/* Restriction to a value for a segment */
+/* 
+ * Restriction to a value for a segment.
+ * The new instants are constructed in the builder, which is reset at each
+ * call so that its memory is reused across the segments of a sequence.
+ */
 
 static TemporalSeq *
-temporalseq_at_value1(TemporalInst *inst1, TemporalInst *inst2, 
-	bool linear, bool lower_inc, bool upper_inc, Datum value)
+temporalseq_at_value1(TemporalInstBuilder *builder, TemporalInst *inst1, 
+	TemporalInst *inst2, bool linear, bool lower_inc, bool upper_inc, 
+	Datum value)
 {
 	Datum value1 = temporalinst_value(inst1);
 	Datum value2 = temporalinst_value(inst2);
@@ -2259,12 +2340,11 @@ temporalseq_at_value1(TemporalInst *inst1, TemporalInst *inst2,
 		if (datum_eq(value1, value, valuetypid))
 		{
 			/* <value@t1 x@t2> */
-			TemporalInst *instants[2];
-			instants[0] = inst1;
-			instants[1] = temporalinst_make(value1, inst2->t, valuetypid);
-			result = temporalseq_from_temporalinstarr(instants, 2,
+			temporalinstbuilder_reset(builder);
+			temporalinstbuilder_add_inst(builder, inst1);
+			temporalinstbuilder_add_value(builder, value1, inst2->t, valuetypid);
+			result = temporalseq_from_temporalinstarr(builder->instants, 2,
 				lower_inc, false, linear, false);
-			pfree(instants[1]);
 		}
 		else if (upper_inc && datum_eq(value, value2, valuetypid))
 		{
@@ -2296,11 +2376,10 @@ temporalseq_at_value1(TemporalInst *inst1, TemporalInst *inst2,
 	if (!tlinearseq_timestamp_at_value(inst1, inst2, value, valuetypid, &t))
 		return NULL;
 	
-	TemporalInst *inst = temporalinst_make(value, t, valuetypid);
-	TemporalSeq *result = temporalseq_from_temporalinstarr(&inst, 1, 
+	temporalinstbuilder_reset(builder);
+	temporalinstbuilder_add_value(builder, value, t, valuetypid);
+	return temporalseq_from_temporalinstarr(builder->instants, 1, 
 		true, true, linear, false);
-	pfree(inst);
-	return result;
 }
 
 /* 
@@ -2321,7 +2400,10 @@ temporalseq_at_value2(TemporalSeq **result, TemporalSeq *seq, Datum value)
 		temporalseq_bbox(&box1, seq);
 		number_to_box(&box2, value, valuetypid);
 		if (!contains_tbox_tbox_internal(&box1, &box2))
-			return 0;			
+		{
+			MOBDB_STATS_INC(STAT_BBOX_SHORTCUTS);
+			return 0;
+		}
 	}
 
 	/* Instantaneous sequence */
@@ -2335,6 +2417,8 @@ temporalseq_at_value2(TemporalSeq **result, TemporalSeq *seq, Datum value)
 	}
 
 	/* General case */
+	TemporalInstBuilder builder;
+	temporalinstbuilder_init(&builder, 2);
 	TemporalInst *inst1 = temporalseq_inst_n(seq, 0);
 	bool lower_inc = seq->period.lower_inc;
 	int k = 0;
@@ -2342,32 +2426,34 @@ temporalseq_at_value2(TemporalSeq **result, TemporalSeq *seq, Datum value)
 	{
 		TemporalInst *inst2 = temporalseq_inst_n(seq, i);
 		bool upper_inc = (i == seq->count - 1) ? seq->period.upper_inc : false;
-		TemporalSeq *seq1 = temporalseq_at_value1(inst1, inst2, 
+		TemporalSeq *seq1 = temporalseq_at_value1(&builder, inst1, inst2, 
 			MOBDB_FLAGS_GET_LINEAR(seq->flags), lower_inc, upper_inc, value);
 		if (seq1 != NULL) 
 			result[k++] = seq1;
 		inst1 = inst2;
 		lower_inc = true;
 	}
+	temporalinstbuilder_free(&builder);
 	return k;
 }
 
 TemporalS *
 temporalseq_at_value(TemporalSeq *seq, Datum value)
 {
+	MemoryContext arena = temporal_arena_create();
+	MemoryContext oldcontext = MemoryContextSwitchTo(arena);
 	TemporalSeq **sequences = palloc(sizeof(TemporalSeq *) * seq->count);
 	int count = temporalseq_at_value2(sequences, seq, value);
+	MemoryContextSwitchTo(oldcontext);
 	if (count == 0)
 	{
-		pfree(sequences);
+		MemoryContextDelete(arena);
 		return NULL;
 	}
 
 	TemporalS *result = temporals_from_temporalseqarr(sequences, count,
 		MOBDB_FLAGS_GET_LINEAR(seq->flags), true);
-	for (int i = 0; i < count; i++)
-		pfree(sequences[i]);
-	pfree(sequences);
+	MemoryContextDelete(arena);
 	return result;
 }
 
@@ -2456,6 +2542,7 @@ temporalseq_minus_value2(TemporalSeq **result, TemporalSeq *seq, Datum value)
 		number_to_box(&box2, value, valuetypid);
 		if (!contains_tbox_tbox_internal(&box1, &box2))
 		{
+			MOBDB_STATS_INC(STAT_BBOX_SHORTCUTS);
 			result[0] = temporalseq_copy(seq);
 			return 1;
 		}
@@ -2534,16 +2621,20 @@ temporalseq_minus_value(TemporalSeq *seq, Datum value)
 		maxcount = seq->count;
 	else 
 		maxcount = seq->count * 2;
+	MemoryContext arena = temporal_arena_create();
+	MemoryContext oldcontext = MemoryContextSwitchTo(arena);
 	TemporalSeq **sequences = palloc(sizeof(TemporalSeq *) * maxcount);
 	int count = temporalseq_minus_value2(sequences, seq, value);
+	MemoryContextSwitchTo(oldcontext);
 	if (count == 0)
+	{
+		MemoryContextDelete(arena);
 		return NULL;
+	}
 	
 	TemporalS *result = temporals_from_temporalseqarr(sequences, count,
 		MOBDB_FLAGS_GET_LINEAR(seq->flags), true);
-	for (int i = 0; i < count; i++)
-		pfree(sequences[i]);
-	pfree(sequences);
+	MemoryContextDelete(arena);
 	return result;
 }
 
@@ -2569,6 +2660,8 @@ temporalseq_at_values1(TemporalSeq **result, TemporalSeq *seq, Datum *values, in
 	}
 	
 	/* General case */
+	TemporalInstBuilder builder;
+	temporalinstbuilder_init(&builder, 2);
 	TemporalInst *inst1 = temporalseq_inst_n(seq, 0);
 	bool lower_inc = seq->period.lower_inc;
 	int k = 0;	
@@ -2578,7 +2671,7 @@ temporalseq_at_values1(TemporalSeq **result, TemporalSeq *seq, Datum *values, in
 		bool upper_inc = (i == seq->count - 1) ? seq->period.upper_inc : false;
 		for (int j = 0; j < count; j++)
 		{
-			TemporalSeq *seq1 = temporalseq_at_value1(inst1, inst2, 
+			TemporalSeq *seq1 = temporalseq_at_value1(&builder, inst1, inst2, 
 				MOBDB_FLAGS_GET_LINEAR(seq->flags), lower_inc, upper_inc, values[j]);
 			if (seq1 != NULL) 
 				result[k++] = seq1;
@@ -2586,6 +2679,7 @@ temporalseq_at_values1(TemporalSeq **result, TemporalSeq *seq, Datum *values, in
 		inst1 = inst2;
 		lower_inc = true;
 	}
+	temporalinstbuilder_free(&builder);
 	temporalseqarr_sort(result, k);
 	return k;
 }
@@ -2593,18 +2687,19 @@ temporalseq_at_values1(TemporalSeq **result, TemporalSeq *seq, Datum *values, in
 TemporalS *
 temporalseq_at_values(TemporalSeq *seq, Datum *values, int count)
 {
+	MemoryContext arena = temporal_arena_create();
+	MemoryContext oldcontext = MemoryContextSwitchTo(arena);
 	TemporalSeq **sequences = palloc(sizeof(TemporalSeq *) * seq->count * count);
 	int newcount = temporalseq_at_values1(sequences, seq, values, count);
+	MemoryContextSwitchTo(oldcontext);
 	if (newcount == 0)
 	{
-		pfree(sequences);
+		MemoryContextDelete(arena);
 		return NULL;
 	}
 	TemporalS *result = temporals_from_temporalseqarr(sequences, newcount,
 		MOBDB_FLAGS_GET_LINEAR(seq->flags), true);
-	for (int i = 0; i < newcount; i++)
-		pfree(sequences[i]);
-	pfree(sequences);
+	MemoryContextDelete(arena);
 	return result;
 }
 
@@ -2653,26 +2748,58 @@ temporalseq_minus_values1(TemporalSeq **result, TemporalSeq *seq, Datum *values,
 TemporalS *
 temporalseq_minus_values(TemporalSeq *seq, Datum *values, int count)
 {
+	MemoryContext arena = temporal_arena_create();
+	MemoryContext oldcontext = MemoryContextSwitchTo(arena);
 	TemporalSeq **sequences = palloc(sizeof(TemporalSeq *) * seq->count * count * 2);
 	int newcount = temporalseq_minus_values1(sequences, seq, values, count);
+	MemoryContextSwitchTo(oldcontext);
 	if (newcount == 0)
 	{
-		pfree(sequences);
+		MemoryContextDelete(arena);
 		return NULL;
 	}
 	TemporalS *result = temporals_from_temporalseqarr(sequences, newcount,
 		MOBDB_FLAGS_GET_LINEAR(seq->flags), true);
-	for (int i = 0; i < newcount; i++)
-		pfree(sequences[i]);
-	pfree(sequences);
+	MemoryContextDelete(arena);
 	return result;
 }
 
-/* Restriction to the range for a segment */
+/* 
+ * Timestamp at which a segment with linear interpolation takes a value 
+ * that is known to be between the values at its bounds (both inclusive).
+ * The bounds are tested first since tlinearseq_timestamp_at_value does not
+ * return a timestamp at the bounds of the segment.
+ */
+static TimestampTz
+tnumberseq_timestamp_at_value(TemporalInst *inst1, TemporalInst *inst2, 
+	Datum value)
+{
+	Oid valuetypid = inst1->valuetypid;
+	Datum value1 = temporalinst_value(inst1);
+	Datum value2 = temporalinst_value(inst2);
+	if (datum_eq(value1, value, valuetypid))
+		return inst1->t;
+	if (datum_eq(value2, value, valuetypid))
+		return inst2->t;
+	TimestampTz result;
+	if (tlinearseq_timestamp_at_value(inst1, inst2, value, valuetypid, &result))
+		return result;
+	/* The value is within EPSILON of one of the bounds */
+	double dvalue = DatumGetFloat8(value);
+	return (fabs(dvalue - DatumGetFloat8(value1)) <= 
+		fabs(dvalue - DatumGetFloat8(value2))) ? inst1->t : inst2->t;
+}
+
+/* 
+ * Restriction to the range for a segment.
+ * The new instants are constructed in the builder as for 
+ * temporalseq_at_value1.
+ */
 
 static TemporalSeq *
-tnumberseq_at_range1(TemporalInst *inst1, TemporalInst *inst2, 
-	bool lower_incl, bool upper_incl, bool linear, RangeType *range)
+tnumberseq_at_range1(TemporalInstBuilder *builder, TemporalInst *inst1, 
+	TemporalInst *inst2, bool lower_incl, bool upper_incl, bool linear, 
+	RangeType *range)
 {
 	TypeCacheEntry *typcache = lookup_type_cache(range->rangetypid, TYPECACHE_RANGE_INFO);
 	Datum value1 = temporalinst_value(inst1);
@@ -2684,13 +2811,14 @@ tnumberseq_at_range1(TemporalInst *inst1, TemporalInst *inst2,
 		if (!range_contains_elem_internal(typcache, range, value1)) 
 			return NULL;
 
-		TemporalInst *instants[2];
-		instants[0] = inst1;
-		instants[1] = linear ? inst2 : 
-			temporalinst_make(value1, inst2->t, valuetypid);
-		TemporalSeq *result = temporalseq_from_temporalinstarr(instants, 2,
+		temporalinstbuilder_reset(builder);
+		temporalinstbuilder_add_inst(builder, inst1);
+		if (linear)
+			temporalinstbuilder_add_inst(builder, inst2);
+		else
+			temporalinstbuilder_add_value(builder, value1, inst2->t, valuetypid);
+		return temporalseq_from_temporalinstarr(builder->instants, 2,
 			lower_incl, upper_incl, linear, false);
-		return result;
 	}
 
 	/* Ensure data type with linear interpolation */
@@ -2713,32 +2841,24 @@ tnumberseq_at_range1(TemporalInst *inst1, TemporalInst *inst2,
 	/* Intersection range is a single value */
 	if (datum_eq(lowervalue, uppervalue, valuetypid))
 	{
-		/* Test with inclusive bounds */
-		TemporalSeq *newseq = temporalseq_at_value1(inst1, inst2, 
+		/* Test with inclusive bounds, the result is an instant sequence */
+		result = temporalseq_at_value1(builder, inst1, inst2, 
 			linear, true, true, lowervalue);
-		/* We are sure that newseq is an instant sequence */
-		TemporalInst *inst = temporalseq_inst_n(newseq, 0);
-		result = temporalseq_from_temporalinstarr(&inst, 1,
-			true, true, linear, false);
-		pfree(newseq); 
 	}
 	else
 	{
-		/* Test with inclusive bounds */
-		TemporalSeq *newseq1 = temporalseq_at_value1(inst1, inst2, 
-			linear, true, true, lowervalue);
-		TemporalSeq *newseq2 = temporalseq_at_value1(inst1, inst2, 
-			linear, true, true, uppervalue);
-		TimestampTz time1 = newseq1->period.lower;
-		TimestampTz time2 = newseq2->period.upper;
-		/* We are sure that both newseq1 and newseq2 are instant sequences */
-		TemporalInst *instants[2];
+		/* We are sure that both values are reached within the segment */
+		TimestampTz time1 = tnumberseq_timestamp_at_value(inst1, inst2, 
+			lowervalue);
+		TimestampTz time2 = tnumberseq_timestamp_at_value(inst1, inst2, 
+			uppervalue);
 		bool lower_incl1, upper_incl1;
+		temporalinstbuilder_reset(builder);
 		if (time1 < time2)
 		{
 			/* Segment increasing in value */
-			instants[0] = temporalseq_inst_n(newseq1, 0);
-			instants[1] = temporalseq_inst_n(newseq2, 0);
+			temporalinstbuilder_add_value(builder, lowervalue, time1, valuetypid);
+			temporalinstbuilder_add_value(builder, uppervalue, time2, valuetypid);
 			lower_incl1 = (timestamp_cmp_internal(time1, inst1->t) == 0) ? 
 				lower_incl && lower_inc(intersect) : lower_inc(intersect);
 			upper_incl1 = (timestamp_cmp_internal(time2, inst2->t) == 0) ? 
@@ -2747,16 +2867,15 @@ tnumberseq_at_range1(TemporalInst *inst1, TemporalInst *inst2,
 		else
 		{
 			/* Segment decreasing in value */
-			instants[0] = temporalseq_inst_n(newseq2, 0);
-			instants[1] = temporalseq_inst_n(newseq1, 0);
+			temporalinstbuilder_add_value(builder, uppervalue, time2, valuetypid);
+			temporalinstbuilder_add_value(builder, lowervalue, time1, valuetypid);
 			lower_incl1 = (timestamp_cmp_internal(time2, inst1->t) == 0) ? 
 				lower_incl && upper_inc(intersect) : upper_inc(intersect);
 			upper_incl1 = (timestamp_cmp_internal(time1, inst1->t) == 0) ? 
 				upper_incl && lower_inc(intersect) : lower_inc(intersect);
 		}
-		result = temporalseq_from_temporalinstarr(instants, 2,
+		result = temporalseq_from_temporalinstarr(builder->instants, 2,
 			lower_incl1, upper_incl1, linear, false);
-		pfree(newseq1); pfree(newseq2); 
 	}
 	pfree(valuerange); pfree(intersect); 
 
@@ -2777,7 +2896,10 @@ tnumberseq_at_range2(TemporalSeq **result, TemporalSeq *seq, RangeType *range)
 	temporalseq_bbox(&box1, seq);
 	range_to_tbox_internal(&box2, range);
 	if (!overlaps_tbox_tbox_internal(&box1, &box2))
+	{
+		MOBDB_STATS_INC(STAT_BBOX_SHORTCUTS);
 		return 0;
+	}
 
 	/* Instantaneous sequence */
 	if (seq->count == 1)
@@ -2787,6 +2909,8 @@ tnumberseq_at_range2(TemporalSeq **result, TemporalSeq *seq, RangeType *range)
 	}
 
 	/* General case */
+	TemporalInstBuilder builder;
+	temporalinstbuilder_init(&builder, 2);
 	TemporalInst *inst1 = temporalseq_inst_n(seq, 0);
 	bool lower_inc = seq->period.lower_inc;
 	int k = 0;
@@ -2794,29 +2918,34 @@ tnumberseq_at_range2(TemporalSeq **result, TemporalSeq *seq, RangeType *range)
 	{
 		TemporalInst *inst2 = temporalseq_inst_n(seq, i);
 		bool upper_inc = (i == seq->count - 1) ? seq->period.upper_inc : false;
-		TemporalSeq *seq1 = tnumberseq_at_range1(inst1, inst2, 
+		TemporalSeq *seq1 = tnumberseq_at_range1(&builder, inst1, inst2, 
 			lower_inc, upper_inc, MOBDB_FLAGS_GET_LINEAR(seq->flags), range);
 		if (seq1 != NULL) 
 			result[k++] = seq1;
 		inst1 = inst2;
 		lower_inc = true;
 	}
+	temporalinstbuilder_free(&builder);
 	return k;
 }
 
 TemporalS *
 tnumberseq_at_range(TemporalSeq *seq, RangeType *range)
 {
+	MemoryContext arena = temporal_arena_create();
+	MemoryContext oldcontext = MemoryContextSwitchTo(arena);
 	TemporalSeq **sequences = palloc(sizeof(TemporalSeq *) * seq->count);
 	int count = tnumberseq_at_range2(sequences, seq, range);
+	MemoryContextSwitchTo(oldcontext);
 	if (count == 0)
+	{
+		MemoryContextDelete(arena);
 		return NULL;
+	}
 
 	TemporalS *result = temporals_from_temporalseqarr(sequences, count,
 		MOBDB_FLAGS_GET_LINEAR(seq->flags), true);
-	for (int i = 0; i < count; i++)
-		pfree(sequences[i]);
-	pfree(sequences);
+	MemoryContextDelete(arena);
 	return result;
 }
 	
@@ -2835,6 +2964,7 @@ tnumberseq_minus_range1(TemporalSeq **result, TemporalSeq *seq, RangeType *range
 	range_to_tbox_internal(&box2, range);
 	if (!overlaps_tbox_tbox_internal(&box1, &box2))
 	{
+		MOBDB_STATS_INC(STAT_BBOX_SHORTCUTS);
 		result[0] = temporalseq_copy(seq);
 		return 1;
 	}
@@ -2875,19 +3005,20 @@ tnumberseq_minus_range(TemporalSeq *seq, RangeType *range)
 		maxcount = seq->count;
 	else 
 		maxcount = seq->count * 2;
+	MemoryContext arena = temporal_arena_create();
+	MemoryContext oldcontext = MemoryContextSwitchTo(arena);
 	TemporalSeq **sequences = palloc(sizeof(TemporalSeq *) * maxcount);
 	int count = tnumberseq_minus_range1(sequences, seq, range);
+	MemoryContextSwitchTo(oldcontext);
 	if (count == 0)
 	{
-		pfree(sequences);
+		MemoryContextDelete(arena);
 		return NULL;
 	}
 
 	TemporalS *result = temporals_from_temporalseqarr(sequences, count,
 		MOBDB_FLAGS_GET_LINEAR(seq->flags), true);
-	for (int i = 0; i < count; i++)
-		pfree(sequences[i]);
-	pfree(sequences);
+	MemoryContextDelete(arena);
 	return result;
 }
 
@@ -2912,6 +3043,8 @@ tnumberseq_at_ranges1(TemporalSeq **result, TemporalSeq *seq,
 	}
 
 	/* General case */
+	TemporalInstBuilder builder;
+	temporalinstbuilder_init(&builder, 2);
 	TemporalInst *inst1 = temporalseq_inst_n(seq, 0);
 	bool lower_inc = seq->period.lower_inc;
 	int k = 0;	
@@ -2921,7 +3054,7 @@ tnumberseq_at_ranges1(TemporalSeq **result, TemporalSeq *seq,
 		bool upper_inc = (i == seq->count - 1) ? seq->period.upper_inc : false;
 		for (int j = 0; j < count; j++)
 		{
-			TemporalSeq *seq1 = tnumberseq_at_range1(inst1, inst2, 
+			TemporalSeq *seq1 = tnumberseq_at_range1(&builder, inst1, inst2, 
 				lower_inc, upper_inc, MOBDB_FLAGS_GET_LINEAR(seq->flags), normranges[j]);
 			if (seq1 != NULL) 
 				result[k++] = seq1;
@@ -2929,6 +3062,7 @@ tnumberseq_at_ranges1(TemporalSeq **result, TemporalSeq *seq,
 		inst1 = inst2;
 		lower_inc = true;
 	}
+	temporalinstbuilder_free(&builder);
 	if (k == 0) 
 		return 0;
 	
@@ -2939,18 +3073,19 @@ tnumberseq_at_ranges1(TemporalSeq **result, TemporalSeq *seq,
 TemporalS *
 tnumberseq_at_ranges(TemporalSeq *seq, RangeType **normranges, int count)
 {
+	MemoryContext arena = temporal_arena_create();
+	MemoryContext oldcontext = MemoryContextSwitchTo(arena);
 	TemporalSeq **sequences = palloc(sizeof(TemporalSeq *) * seq->count * count);
 	int newcount = tnumberseq_at_ranges1(sequences, seq, normranges, count);
+	MemoryContextSwitchTo(oldcontext);
 	if (newcount == 0)
 	{
-		pfree(sequences);
+		MemoryContextDelete(arena);
 		return NULL;
 	}
 	TemporalS *result = temporals_from_temporalseqarr(sequences, newcount,
 		MOBDB_FLAGS_GET_LINEAR(seq->flags), true);
-	for (int i = 0; i < newcount; i++)
-		pfree(sequences[i]);
-	pfree(sequences);
+	MemoryContextDelete(arena);
 	return result;
 }
 
@@ -3004,17 +3139,21 @@ tnumberseq_minus_ranges(TemporalSeq *seq, RangeType **normranges, int count)
 		maxcount = seq->count * count;
 	else 
 		maxcount = seq->count * count * 2;
+	MemoryContext arena = temporal_arena_create();
+	MemoryContext oldcontext = MemoryContextSwitchTo(arena);
 	TemporalSeq **sequences = palloc(sizeof(TemporalSeq *) * maxcount);
 	int newcount = tnumberseq_minus_ranges1(sequences, seq, normranges, 
 		count);
-	if (newcount == 0) 
+	MemoryContextSwitchTo(oldcontext);
+	if (newcount == 0)
+	{
+		MemoryContextDelete(arena);
 		return NULL;
+	}
 	
 	TemporalS *result = temporals_from_temporalseqarr(sequences, newcount,
 		MOBDB_FLAGS_GET_LINEAR(seq->flags), true);
-	for (int i = 0; i < newcount; i++)
-		pfree(sequences[i]);
-	pfree(sequences);
+	MemoryContextDelete(arena);
 	return result;
 }
 
@@ -3239,6 +3378,22 @@ temporalseq_at_timestamp1(TemporalInst *inst1, TemporalInst *inst2, bool linear,
 	return result;
 }
 
+/* 
+ * Restriction to a timestamp constructing the instant in a builder.
+ * The function supposes that the timestamp t is between inst1->t and inst2->t
+ * (both inclusive).
+ */
+static TemporalInst *
+temporalseq_at_timestamp_builder(TemporalInstBuilder *builder, 
+	TemporalInst *inst1, TemporalInst *inst2, bool linear, TimestampTz t)
+{
+	Datum value = temporalseq_value_at_timestamp1(inst1, inst2, linear, t);
+	TemporalInst *result = temporalinstbuilder_add_value(builder, value, t, 
+		inst1->valuetypid);
+	FREE_DATUM(value, inst1->valuetypid);
+	return result;
+}
+
 /*
  * Restriction to a timestamp.
  */
@@ -3375,29 +3530,40 @@ temporalseq_at_timestampset(TemporalSeq *seq, TimestampSet *ts)
 		return temporali_from_temporalinstarr(&inst, 1);
 	}
 
-	/* General case */
+	/* General case: since both the timestamps and the instants are ordered,
+	   the segment containing each timestamp is found by advancing a cursor 
+	   on the sequence instead of a binary search for each timestamp */
 	TimestampTz t = Max(seq->period.lower, p->lower);
 	int n;
 	timestampset_find_timestamp(ts, t, &n);
-	TemporalInst **instants = palloc(sizeof(TemporalInst *) * (ts->count - n));
-	int k = 0;
+	bool linear = MOBDB_FLAGS_GET_LINEAR(seq->flags);
+	TemporalInstBuilder builder;
+	temporalinstbuilder_init(&builder, ts->count - n);
+	TemporalInst *inst1 = inst;
+	TemporalInst *inst2 = temporalseq_inst_n(seq, 1);
+	int j = 0;
 	for (int i = n; i < ts->count; i++) 
 	{
 		t = timestampset_time_n(ts, i);
-		inst = temporalseq_at_timestamp(seq, t);
-		if (inst != NULL)
-			instants[k++] = inst;
-	}
-	if (k == 0)
-	{
-		pfree(instants);
-		return NULL;
+		if (timestamp_cmp_internal(t, seq->period.upper) > 0)
+			break;
+		if (!contains_period_timestamp_internal(&seq->period, t))
+			continue;
+		while (j < seq->count - 2 && timestamp_cmp_internal(inst2->t, t) <= 0)
+		{
+			inst1 = inst2;
+			inst2 = temporalseq_inst_n(seq, ++j + 1);
+		}
+		if (timestamp_cmp_internal(inst1->t, t) == 0)
+			temporalinstbuilder_add_inst(&builder, inst1);
+		else if (timestamp_cmp_internal(inst2->t, t) == 0)
+			temporalinstbuilder_add_inst(&builder, inst2);
+		else
+			temporalseq_at_timestamp_builder(&builder, inst1, inst2, linear, t);
 	}
-
-	TemporalI *result = temporali_from_temporalinstarr(instants, k);
-	for (int i = 0; i < k; i++)
-		pfree(instants[i]);
-	pfree(instants);
+	TemporalI *result = (builder.count == 0) ? NULL :
+		temporali_from_temporalinstarr(builder.instants, builder.count);
+	temporalinstbuilder_free(&builder);
 	return result;
 }
 
@@ -3495,13 +3661,16 @@ temporalseq_at_period(TemporalSeq *seq, Period *p)
 	/* If the lower bound of the intersecting period is exclusive */
 	if (n == -1)
 		n = 0;
-	TemporalInst **instants = palloc(sizeof(TemporalInst *) * (seq->count - n));
+	bool linear = MOBDB_FLAGS_GET_LINEAR(seq->flags);
+	/* The new instants at the bounds of the intersecting period are 
+	   constructed in the builder, the other ones are those of the sequence */
+	TemporalInstBuilder builder;
+	temporalinstbuilder_init(&builder, seq->count - n);
 	/* Compute the value at the beginning of the intersecting period */
 	TemporalInst *inst1 = temporalseq_inst_n(seq, n);
 	TemporalInst *inst2 = temporalseq_inst_n(seq, n + 1);
-	instants[0] = temporalseq_at_timestamp1(inst1, inst2, 
-		MOBDB_FLAGS_GET_LINEAR(seq->flags), inter->lower);
-	int k = 1;
+	temporalseq_at_timestamp_builder(&builder, inst1, inst2, linear, 
+		inter->lower);
 	for (int i = n+2; i < seq->count; i++)
 	{
 		/* If the end of the intersecting period is between inst1 and inst2 */
@@ -3514,24 +3683,25 @@ temporalseq_at_period(TemporalSeq *seq, Period *p)
 		/* If the intersecting period contains inst1 */
 		if (timestamp_cmp_internal(inter->lower, inst1->t) <= 0 &&
 			timestamp_cmp_internal(inst1->t, inter->upper) <= 0)
-			instants[k++] = inst1;
+			temporalinstbuilder_add_inst(&builder, inst1);
 	}
 	/* The last two values of sequences with stepwise interpolation and 
 	   exclusive upper bound must be equal */
-	if (MOBDB_FLAGS_GET_LINEAR(seq->flags) || inter->upper_inc)
-		instants[k++] = temporalseq_at_timestamp1(inst1, inst2, 
-			MOBDB_FLAGS_GET_LINEAR(seq->flags), inter->upper);
+	if (linear || inter->upper_inc)
+		temporalseq_at_timestamp_builder(&builder, inst1, inst2, linear, 
+			inter->upper);
 	else
 	{	
-		Datum value = temporalinst_value(instants[k - 1]);
-		instants[k++] = temporalinst_make(value, inter->upper, seq->valuetypid);
+		Datum value = temporalinst_value(builder.instants[builder.count - 1]);
+		temporalinstbuilder_add_value(&builder, value, inter->upper, 
+			seq->valuetypid);
 	}
 	/* Since by definition the sequence is normalized it is not necessary to
 	   normalize the projection of the sequence to the period */
-	TemporalSeq *result = temporalseq_from_temporalinstarr(instants, k,
-		inter->lower_inc, inter->upper_inc, MOBDB_FLAGS_GET_LINEAR(seq->flags), false);
+	TemporalSeq *result = temporalseq_from_temporalinstarr(builder.instants, 
+		builder.count, inter->lower_inc, inter->upper_inc, linear, false);
 
-	pfree(instants[0]); pfree(instants[k - 1]); pfree(instants); pfree(inter);
+	temporalinstbuilder_free(&builder); pfree(inter);
 	
 	return result;
 }
@@ -3712,20 +3882,21 @@ temporalseq_minus_periodset(TemporalSeq *seq, PeriodSet *ps)
 	}
 
 	/* General case */
+	MemoryContext arena = temporal_arena_create();
+	MemoryContext oldcontext = MemoryContextSwitchTo(arena);
 	TemporalSeq **sequences = palloc(sizeof(TemporalSeq *) * (ps->count + 1));
 	int count = temporalseq_minus_periodset1(sequences, seq, ps,
 		0, ps->count);
+	MemoryContextSwitchTo(oldcontext);
 	if (count == 0)
 	{
-		pfree(sequences);
+		MemoryContextDelete(arena);
 		return NULL;
 	}
 
 	TemporalS *result =temporals_from_temporalseqarr(sequences, count,
 		MOBDB_FLAGS_GET_LINEAR(seq->flags), false);
-	for (int i = 0; i < count; i++)
-		pfree(sequences[i]);
-	pfree(sequences);
+	MemoryContextDelete(arena);
 	return result;
 }
 
@@ -3857,7 +4028,10 @@ temporalseq_eq(TemporalSeq *seq1, TemporalSeq *seq2)
 	void *box1 = temporalseq_bbox_ptr(seq1);
 	void *box2 = temporalseq_bbox_ptr(seq2);
 	if (! temporal_bbox_eq(seq1->valuetypid, box1, box2))
+	{
+		MOBDB_STATS_INC(STAT_BBOX_SHORTCUTS);
 		return false;
+	}
 	
 	/* Compare the composing instants */
 	for (int i = 0; i < seq1->count; i++)
@@ -826,6 +826,134 @@ double calc_period_hist_selectivity_adjacent(PeriodBound *lower, PeriodBound *up
 	return selec1 + selec2;
 }
 
+/*
+ * Load the histogram of period bounds of a column into two arrays of lower
+ * and upper bounds. Returns false if the statistics are not available.
+ */
+static bool
+period_hist_bounds(VariableStatData *vardata, PeriodBound **hist_lower,
+	PeriodBound **hist_upper, int *nhist)
+{
+	AttStatsSlot hslot;
+	int i;
+
+	if (!(HeapTupleIsValid(vardata->statsTuple) &&
+		  get_attstatsslot(&hslot, vardata->statsTuple,
+						   STATISTIC_KIND_PERIOD_BOUNDS_HISTOGRAM,
+						   InvalidOid, ATTSTATSSLOT_VALUES)))
+		return false;
+	/* A histogram needs at least two entries to define a bin */
+	if (hslot.nvalues < 2)
+	{
+		free_attstatsslot(&hslot);
+		return false;
+	}
+	*nhist = hslot.nvalues;
+	*hist_lower = (PeriodBound *) palloc(sizeof(PeriodBound) * hslot.nvalues);
+	*hist_upper = (PeriodBound *) palloc(sizeof(PeriodBound) * hslot.nvalues);
+	for (i = 0; i < hslot.nvalues; i++)
+		period_deserialize(DatumGetPeriod(hslot.values[i]),
+						   &(*hist_lower)[i], &(*hist_upper)[i]);
+	free_attstatsslot(&hslot);
+	return true;
+}
+
+/*
+ * Estimate the fraction of pairs (b1, b2) with b1 < b2 (or b1 <= b2 when
+ * equal is true), where b1 and b2 are drawn from the two histograms of
+ * bounds. Every entry of hist2 represents 1/(nhist2 - 1) of the values,
+ * except the first and the last ones that represent half of it.
+ */
+static double
+period_joinsel_scalar(PeriodBound *hist1, int nhist1, PeriodBound *hist2,
+	int nhist2, bool equal)
+{
+	double selec = 0.0, frac;
+	int i;
+
+	for (i = 0; i < nhist2; i++)
+	{
+		/* Fraction of values of hist1 less than (or equal to) hist2[i] */
+		frac = calc_period_hist_selectivity_scalar(&hist2[i], hist1, nhist1,
+			equal);
+		if (i == 0 || i == nhist2 - 1)
+			frac /= 2.0;
+		selec += frac;
+	}
+	return selec / (double) (nhist2 - 1);
+}
+
+/*
+ * Calculate the join selectivity of period operators using the histograms
+ * of period bounds of both columns.
+ *
+ * The estimate is the fraction of pairs of not NULL values satisfying the
+ * operator, where vardata1 is the left argument. Returns -1 if the
+ * statistics are not available or the operator is not supported.
+ */
+double
+calc_period_hist_joinselectivity(VariableStatData *vardata1,
+	VariableStatData *vardata2, CachedOp cachedOp)
+{
+	PeriodBound *lower1, *upper1, *lower2, *upper2;
+	int nhist1, nhist2;
+	double selec;
+
+	if (cachedOp != OVERLAPS_OP && cachedOp != CONTAINS_OP &&
+		cachedOp != CONTAINED_OP && cachedOp != BEFORE_OP &&
+		cachedOp != OVERBEFORE_OP && cachedOp != AFTER_OP &&
+		cachedOp != OVERAFTER_OP && cachedOp != LT_OP &&
+		cachedOp != LE_OP && cachedOp != GT_OP && cachedOp != GE_OP)
+		return -1.0;
+
+	if (! period_hist_bounds(vardata1, &lower1, &upper1, &nhist1))
+		return -1.0;
+	if (! period_hist_bounds(vardata2, &lower2, &upper2, &nhist2))
+	{
+		pfree(lower1); pfree(upper1);
+		return -1.0;
+	}
+
+	if (cachedOp == LT_OP || cachedOp == LE_OP)
+		/* As in the restriction case, compare only the lower bounds */
+		selec = period_joinsel_scalar(lower1, nhist1, lower2, nhist2,
+			cachedOp == LE_OP);
+	else if (cachedOp == GT_OP || cachedOp == GE_OP)
+		selec = 1.0 - period_joinsel_scalar(lower1, nhist1, lower2, nhist2,
+			cachedOp == GT_OP);
+	else if (cachedOp == BEFORE_OP)
+		/* upper1 < lower2 */
+		selec = period_joinsel_scalar(upper1, nhist1, lower2, nhist2, false);
+	else if (cachedOp == OVERBEFORE_OP)
+		/* upper1 <= upper2 */
+		selec = period_joinsel_scalar(upper1, nhist1, upper2, nhist2, true);
+	else if (cachedOp == AFTER_OP)
+		/* lower1 > upper2 */
+		selec = 1.0 - period_joinsel_scalar(lower1, nhist1, upper2, nhist2,
+			true);
+	else if (cachedOp == OVERAFTER_OP)
+		/* lower1 >= lower2 */
+		selec = 1.0 - period_joinsel_scalar(lower1, nhist1, lower2, nhist2,
+			false);
+	else
+	{
+		/*
+		 * Two periods overlap unless one is before the other. The
+		 * containment operators are estimated by the overlaps selectivity,
+		 * which is an upper bound of them.
+		 */
+		selec = 1.0;
+		selec -= period_joinsel_scalar(upper1, nhist1, lower2, nhist2, false);
+		selec -= 1.0 - period_joinsel_scalar(lower1, nhist1, upper2, nhist2,
+			true);
+	}
+
+	pfree(lower1); pfree(upper1); pfree(lower2); pfree(upper2);
+
+	CLAMP_PROBABILITY(selec);
+	return selec;
+}
+
 /*
  * periodsel -- restriction selectivity for period operators
  */
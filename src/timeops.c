@@ -33,6 +33,217 @@ time_type_oid(Oid timetypid)
 		timetypid == type_oid(T_PERIOD) || timetypid == type_oid(T_PERIODSET));
 }
 
+/*****************************************************************************
+ * Galloping search
+ * The operations between two sets advance in both of them as in a merge, 
+ * but the position in the larger set is obtained with a galloping search: 
+ * the step is doubled until the value is passed, followed by a binary search
+ * in the last step. The cost of a search is logarithmic in the number of 
+ * elements skipped, so that an operation between sets of m and n elements, 
+ * m <= n, takes O(m log(n/m)) instead of O(m + n).
+ *****************************************************************************/
+
+/* 
+ * Position of the first timestamp of times[from..count) that is greater 
+ * than or equal to t, or count if there is none
+ */
+
+static int
+timestamparr_gallop(TimestampTz *times, int from, int count, TimestampTz t)
+{
+	if (from >= count || timestamp_cmp_internal(times[from], t) >= 0)
+		return from;
+	/* Invariant: times[lo] < t and (hi == count or times[hi] >= t) */
+	int lo = from, hi = from + 1, step = 1;
+	while (hi < count && timestamp_cmp_internal(times[hi], t) < 0)
+	{
+		lo = hi;
+		step *= 2;
+		hi = (step < count - lo) ? lo + step : count;
+	}
+	while (hi - lo > 1)
+	{
+		int middle = lo + (hi - lo) / 2;
+		if (timestamp_cmp_internal(times[middle], t) < 0)
+			lo = middle;
+		else
+			hi = middle;
+	}
+	return hi;
+}
+
+/* 
+ * Position of the first period of periods[from..count) that is not before
+ * t, or count if there is none
+ */
+
+static int
+periodarr_gallop(Period *periods, int from, int count, TimestampTz t)
+{
+	if (from >= count || !before_period_timestamp_internal(&periods[from], t))
+		return from;
+	/* Invariant: periods[lo] is before t and (hi == count or periods[hi] 
+	   is not before t) */
+	int lo = from, hi = from + 1, step = 1;
+	while (hi < count && before_period_timestamp_internal(&periods[hi], t))
+	{
+		lo = hi;
+		step *= 2;
+		hi = (step < count - lo) ? lo + step : count;
+	}
+	while (hi - lo > 1)
+	{
+		int middle = lo + (hi - lo) / 2;
+		if (before_period_timestamp_internal(&periods[middle], t))
+			lo = middle;
+		else
+			hi = middle;
+	}
+	return hi;
+}
+
+/* 
+ * Position of the first timestamp of times[from..count) that is not before
+ * the period p, or count if there is none
+ */
+
+static int
+timestamparr_gallop_period(TimestampTz *times, int from, int count, Period *p)
+{
+	int i = timestamparr_gallop(times, from, count, p->lower);
+	if (i < count && ! p->lower_inc && 
+		timestamp_cmp_internal(times[i], p->lower) == 0)
+		i++;
+	return i;
+}
+
+/*****************************************************************************
+ * Cached probes
+ * When a timestamp is tested against a timestamp set or a period set that is
+ * a constant or an external parameter of the query, e.g., 
+ *	  SELECT ... FROM events WHERE t <@ periodset '{...}'
+ * the search structure for the set is built once and kept in fn_extra for 
+ * the subsequent calls. The bounds of the set are stored in the Eytzinger
+ * (breadth-first) order of a complete binary search tree, so that the first
+ * levels of the search stay in cache and the children of a node are adjacent
+ * in memory. Arguments that may change between calls are not cached since 
+ * verifying that the value is the same would cost more than the search.
+ *****************************************************************************/
+
+typedef struct
+{
+	int count;				/* Number of elements of the set */
+	TimestampTz *bounds;	/* Timestamps or lower bounds of the periods in 
+							   Eytzinger order, starting at position 1 */
+	int *pos;				/* Position in the set of each bound, only for 
+							   period sets */
+	PeriodSet *ps;			/* Copy of the period set, NULL for timestamp sets */
+} TimeSetProbe;
+
+/* Fill the tree rooted at node k from the sorted values starting at i */
+
+static int
+eytzinger_fill(TimeSetProbe *probe, TimestampTz *values, int i, int k)
+{
+	if (k <= probe->count)
+	{
+		i = eytzinger_fill(probe, values, i, 2 * k);
+		probe->bounds[k] = values[i];
+		if (probe->pos != NULL)
+			probe->pos[k] = i;
+		i++;
+		i = eytzinger_fill(probe, values, i, 2 * k + 1);
+	}
+	return i;
+}
+
+/* 
+ * Node of the first bound strictly greater than t (strict is true) or 
+ * greater than or equal to t (strict is false), 0 if there is none
+ */
+
+static int
+eytzinger_search(TimeSetProbe *probe, TimestampTz t, bool strict)
+{
+	int k = 1, result = 0;
+	while (k <= probe->count)
+	{
+		int cmp = timestamp_cmp_internal(probe->bounds[k], t);
+		bool left = strict ? cmp > 0 : cmp >= 0;
+		result = left ? k : result;
+		k = 2 * k + (left ? 0 : 1);
+	}
+	return result;
+}
+
+/* 
+ * Returns the probe for argument argno of the function, building it in the 
+ * first call, or NULL if the argument is not stable across calls
+ */
+
+static TimeSetProbe *
+timeset_probe(FunctionCallInfo fcinfo, int argno, bool isperiodset)
+{
+	FmgrInfo *flinfo = fcinfo->flinfo;
+	if (flinfo == NULL)
+		return NULL;
+	if (flinfo->fn_extra != NULL)
+		return (TimeSetProbe *) flinfo->fn_extra;
+	if (!get_fn_expr_arg_stable(flinfo, argno))
+		return NULL;
+
+	MemoryContext oldcontext = MemoryContextSwitchTo(flinfo->fn_mcxt);
+	TimeSetProbe *probe = palloc0(sizeof(TimeSetProbe));
+	if (isperiodset)
+	{
+		probe->ps = (PeriodSet *) PG_DETOAST_DATUM_COPY(PG_GETARG_DATUM(argno));
+		probe->count = probe->ps->count;
+		probe->pos = palloc(sizeof(int) * (probe->count + 1));
+		probe->bounds = palloc(sizeof(TimestampTz) * (probe->count + 1));
+		Period *periods = periodset_per_array(probe->ps);
+		TimestampTz *lowers = palloc(sizeof(TimestampTz) * probe->count);
+		for (int i = 0; i < probe->count; i++)
+			lowers[i] = periods[i].lower;
+		eytzinger_fill(probe, lowers, 0, 1);
+		pfree(lowers);
+	}
+	else
+	{
+		TimestampSet *ts = PG_GETARG_TIMESTAMPSET(argno);
+		probe->count = ts->count;
+		probe->bounds = palloc(sizeof(TimestampTz) * (probe->count + 1));
+		eytzinger_fill(probe, timestampset_time_array(ts), 0, 1);
+		PG_FREE_IF_COPY(ts, argno);
+	}
+	MemoryContextSwitchTo(oldcontext);
+	flinfo->fn_extra = probe;
+	return probe;
+}
+
+/* Does the timestamp set of the probe contain the timestamp? */
+
+static bool
+timestampset_probe_contains(TimeSetProbe *probe, TimestampTz t)
+{
+	int k = eytzinger_search(probe, t, false);
+	return (k != 0 && timestamp_cmp_internal(probe->bounds[k], t) == 0);
+}
+
+/* Does the period set of the probe contain the timestamp? */
+
+static bool
+periodset_probe_contains(TimeSetProbe *probe, TimestampTz t)
+{
+	/* The only period that may contain t is the last one starting at or 
+	   before t */
+	int k = eytzinger_search(probe, t, true);
+	int n = (k == 0) ? probe->count - 1 : probe->pos[k] - 1;
+	if (n < 0)
+		return false;
+	Period *p = periodset_per_n(probe->ps, n);
+	return contains_period_timestamp_internal(p, t);
+}
+
 /*****************************************************************************/
 /* contains? */
 
@@ -53,8 +264,11 @@ PG_FUNCTION_INFO_V1(contains_timestampset_timestamp);
 PGDLLEXPORT Datum
 contains_timestampset_timestamp(PG_FUNCTION_ARGS)
 {
-	TimestampSet *ts = PG_GETARG_TIMESTAMPSET(0);
 	TimestampTz t = PG_GETARG_TIMESTAMPTZ(1);
+	TimeSetProbe *probe = timeset_probe(fcinfo, 0, false);
+	if (probe != NULL)
+		PG_RETURN_BOOL(timestampset_probe_contains(probe, t));
+	TimestampSet *ts = PG_GETARG_TIMESTAMPSET(0);
 	bool result = contains_timestampset_timestamp_internal(ts, t);
 	PG_FREE_IF_COPY(ts, 0);
 	PG_RETURN_BOOL(result);
@@ -69,20 +283,16 @@ contains_timestampset_timestampset_internal(TimestampSet *ts1, TimestampSet *ts2
 	if (!contains_period_period_internal(p1, p2))
 		return false;
 
-	int i = 0, j = 0;
-	while (j < ts2->count)
+	TimestampTz *times1 = timestampset_time_array(ts1);
+	TimestampTz *times2 = timestampset_time_array(ts2);
+	int i = 0;
+	for (int j = 0; j < ts2->count; j++)
 	{
-		TimestampTz t1 = timestampset_time_n(ts1, i);
-		TimestampTz t2 = timestampset_time_n(ts2, j);
-		int cmp = timestamp_cmp_internal(t1, t2);
-		if (cmp == 0)
-		{
-			i++; j++;
-		}
-		else if (cmp < 0)
-			i++;
-		else
+		i = timestamparr_gallop(times1, i, ts1->count, times2[j]);
+		if (i == ts1->count || 
+			timestamp_cmp_internal(times1[i], times2[j]) != 0)
 			return false;
+		i++;
 	}
 	return true;
 }
@@ -189,8 +399,11 @@ PG_FUNCTION_INFO_V1(contains_periodset_timestamp);
 PGDLLEXPORT Datum
 contains_periodset_timestamp(PG_FUNCTION_ARGS)
 {
-	PeriodSet *ps = PG_GETARG_PERIODSET(0);
 	TimestampTz t = PG_GETARG_TIMESTAMPTZ(1);
+	TimeSetProbe *probe = timeset_probe(fcinfo, 0, true);
+	if (probe != NULL)
+		PG_RETURN_BOOL(periodset_probe_contains(probe, t));
+	PeriodSet *ps = PG_GETARG_PERIODSET(0);
 	bool result = contains_periodset_timestamp_internal(ps, t);
 	PG_FREE_IF_COPY(ps, 0);
 	PG_RETURN_BOOL(result);
@@ -205,20 +418,16 @@ contains_periodset_timestampset_internal(PeriodSet *ps, TimestampSet *ts)
 	if (!contains_period_period_internal(p1, p2))
 		return false;
 
-	int i = 0, j = 0;
-	while (j < ts->count)
+	Period *periods = periodset_per_array(ps);
+	TimestampTz *times = timestampset_time_array(ts);
+	int i = 0;
+	for (int j = 0; j < ts->count; j++)
 	{
-		Period *p = periodset_per_n(ps, i);
-		TimestampTz t = timestampset_time_n(ts, j);
-		if (contains_period_timestamp_internal(p, t))
-			j++;
-		else
-		{
-			if (timestamp_cmp_internal(t, p->upper) > 0)
-				i++;
-			else
-				return false;
-		}
+		/* The only period that may contain the timestamp */
+		i = periodarr_gallop(periods, i, ps->count, times[j]);
+		if (i == ps->count || 
+			!contains_period_timestamp_internal(&periods[i], times[j]))
+			return false;
 	}
 	return true;
 }
@@ -290,34 +499,22 @@ contains_periodset_periodset_internal(PeriodSet *ps1, PeriodSet *ps2)
 	if (!contains_period_period_internal(p1, p2))
 		return false;
 
-	int i = 0, j = 0;
-	while (i < ps1->count && j < ps2->count)
+	Period *periods1 = periodset_per_array(ps1);
+	Period *periods2 = periodset_per_array(ps2);
+	int i = 0;
+	for (int j = 0; j < ps2->count; j++)
 	{
-		p1 = periodset_per_n(ps1, i);
-		p2 = periodset_per_n(ps2, j);
-		if (before_period_period_internal(p1, p2))
+		/* The only period that may contain periods2[j], the one found may
+		   end at an exclusive lower bound of periods2[j] */
+		i = periodarr_gallop(periods1, i, ps1->count, periods2[j].lower);
+		if (i < ps1->count && 
+			before_period_period_internal(&periods1[i], &periods2[j]))
 			i++;
-		else if (before_period_period_internal(p2, p1))
+		if (i == ps1->count || 
+			!contains_period_period_internal(&periods1[i], &periods2[j]))
 			return false;
-		else
-		{
-			/* p1 and p2 overlap */
-			if (contains_period_period_internal(p1, p2))
-			{
-				if (timestamp_cmp_internal(p1->upper, p2->upper) == 0)
-				{
-					i++; j++;
-				}
-				else
-					j++;
-			}
-			else
-				return false;
-		}
 	}
-	/* if j == ps2->count every period in p2 is contained in a period of p1 
-	   but p1 may have additional periods */
-	return (j == ps2->count);
+	return true;
 }
 
 PG_FUNCTION_INFO_V1(contains_periodset_periodset);
@@ -342,6 +539,9 @@ PGDLLEXPORT Datum
 contained_timestamp_timestampset(PG_FUNCTION_ARGS)
 {
 	TimestampTz t = PG_GETARG_TIMESTAMPTZ(0);
+	TimeSetProbe *probe = timeset_probe(fcinfo, 1, false);
+	if (probe != NULL)
+		PG_RETURN_BOOL(timestampset_probe_contains(probe, t));
 	TimestampSet *ts = PG_GETARG_TIMESTAMPSET(1);
 	bool result = contains_timestampset_timestamp_internal(ts, t);
 	PG_FREE_IF_COPY(ts, 1);
@@ -364,6 +564,9 @@ PGDLLEXPORT Datum
 contained_timestamp_periodset(PG_FUNCTION_ARGS)
 {
 	TimestampTz t = PG_GETARG_TIMESTAMPTZ(0);
+	TimeSetProbe *probe = timeset_probe(fcinfo, 1, true);
+	if (probe != NULL)
+		PG_RETURN_BOOL(periodset_probe_contains(probe, t));
 	PeriodSet *ps = PG_GETARG_PERIODSET(1);
 	bool result = contains_periodset_timestamp_internal(ps, t);
 	PG_FREE_IF_COPY(ps, 1);
@@ -467,17 +670,21 @@ overlaps_timestampset_timestampset_internal(TimestampSet *ts1, TimestampSet *ts2
 	if (!overlaps_period_period_internal(p1, p2))
 		return false;
 
-	int i = 0, j = 0;
-	while (i < ts1->count && j < ts2->count)
+	/* Gallop in the larger set */
+	if (ts1->count > ts2->count)
+	{
+		TimestampSet *tmp = ts1; ts1 = ts2; ts2 = tmp;
+	}
+	TimestampTz *times1 = timestampset_time_array(ts1);
+	TimestampTz *times2 = timestampset_time_array(ts2);
+	int j = 0;
+	for (int i = 0; i < ts1->count; i++)
 	{
-		TimestampTz t1 = timestampset_time_n(ts1, i);
-		TimestampTz t2 = timestampset_time_n(ts2, j);
-		if (timestamp_cmp_internal(t1, t2) == 0)
+		j = timestamparr_gallop(times2, j, ts2->count, times1[i]);
+		if (j == ts2->count)
+			return false;
+		if (timestamp_cmp_internal(times1[i], times2[j]) == 0)
 			return true;
-		if (timestamp_cmp_internal(t1, t2) < 0)
-			i++;
-		else
-			j++;
 	}
 	return false;
 }
@@ -503,13 +710,9 @@ overlaps_timestampset_period_internal(TimestampSet *ts, Period *p)
 	if (!overlaps_period_period_internal(p, p1))
 		return false;
 
-	for (int i = 0; i < ts->count; i++)
-	{
-		TimestampTz t = timestampset_time_n(ts, i);
-		if (contains_period_timestamp_internal(p, t))
-			return true;
-	}
-	return false;
+	TimestampTz *times = timestampset_time_array(ts);
+	int i = timestamparr_gallop_period(times, 0, ts->count, p);
+	return (i < ts->count && contains_period_timestamp_internal(p, times[i]));
 }
 
 PG_FUNCTION_INFO_V1(overlaps_timestampset_period);
@@ -533,17 +736,31 @@ overlaps_timestampset_periodset_internal(TimestampSet *ts, PeriodSet *ps)
 	if (!overlaps_period_period_internal(p1, p2))
 		return false;
 
+	/* Gallop in the larger set */
+	TimestampTz *times = timestampset_time_array(ts);
+	Period *periods = periodset_per_array(ps);
 	int i = 0, j = 0;
-	while (i < ts->count && j < ps->count)
+	if (ts->count <= ps->count)
 	{
-		TimestampTz t = timestampset_time_n(ts, i);
-		Period *p = periodset_per_n(ps, j);
-		if (contains_period_timestamp_internal(p, t))
-			return true;
-		else if (timestamp_cmp_internal(t, p->upper) > 0)
-			j++;
-		else
-			i++;
+		for (i = 0; i < ts->count; i++)
+		{
+			j = periodarr_gallop(periods, j, ps->count, times[i]);
+			if (j == ps->count)
+				return false;
+			if (contains_period_timestamp_internal(&periods[j], times[i]))
+				return true;
+		}
+	}
+	else
+	{
+		for (j = 0; j < ps->count; j++)
+		{
+			i = timestamparr_gallop_period(times, i, ts->count, &periods[j]);
+			if (i == ts->count)
+				return false;
+			if (contains_period_timestamp_internal(&periods[j], times[i]))
+				return true;
+		}
 	}
 	return false;
 }
@@ -614,9 +831,10 @@ overlaps_period_periodset_internal(Period *p, PeriodSet *ps)
 	/* Binary search of lower bound of period */
 	int n;
 	periodset_find_timestamp(ps, p->lower, &n);
+	Period *periods = periodset_per_array(ps);
 	for (int i = n; i < ps->count; i++)
 	{
-		p1 = periodset_per_n(ps, i);
+		p1 = &periods[i];
 		if (overlaps_period_period_internal(p1, p))
 			return true;
 		if (timestamp_cmp_internal(p->upper, p1->upper) < 0)
@@ -670,21 +888,25 @@ overlaps_periodset_periodset_internal(PeriodSet *ps1, PeriodSet *ps2)
 	if (!overlaps_period_period_internal(p1, p2))
 		return false;
 
-	int i = 0, j = 0;
-	while (i < ps1->count && j < ps2->count)
+	/* Gallop in the larger set */
+	if (ps1->count > ps2->count)
 	{
-		p1 = periodset_per_n(ps1, i);
-		p2 = periodset_per_n(ps2, j);
-		if (overlaps_period_period_internal(p1, p2))
-			return true;
-		if (timestamp_cmp_internal(p1->upper, p2->upper) == 0)
-		{
-			i++; j++;
-		}
-		else if (timestamp_cmp_internal(p1->upper, p2->upper) < 0)
-			i++;
-		else
+		PeriodSet *tmp = ps1; ps1 = ps2; ps2 = tmp;
+	}
+	Period *periods1 = periodset_per_array(ps1);
+	Period *periods2 = periodset_per_array(ps2);
+	int j = 0;
+	for (int i = 0; i < ps1->count; i++)
+	{
+		p1 = &periods1[i];
+		j = periodarr_gallop(periods2, j, ps2->count, p1->lower);
+		/* The period may end at an exclusive lower bound of p1 */
+		if (j < ps2->count && before_period_period_internal(&periods2[j], p1))
 			j++;
+		if (j == ps2->count)
+			return false;
+		if (overlaps_period_period_internal(&periods2[j], p1))
+			return true;
 	}
 	return false;
 }
@@ -2215,8 +2437,20 @@ adjacent_periodset_periodset(PG_FUNCTION_ARGS)
 
 /*****************************************************************************
  * Set union
+ * The set operations below are merge kernels that write their result 
+ * directly into a TimestampSet or a PeriodSet allocated with the maximum
+ * number of elements of the result, see periodset_alloc, periodset_append
+ * and periodset_finish. The periods are normalized while they are appended.
  *****************************************************************************/
 
+/* Append a period to a PeriodSet under construction */
+
+static void
+periodset_append_period(PeriodSet *ps, Period *p)
+{
+	periodset_append(ps, p->lower, p->upper, p->lower_inc, p->upper_inc);
+}
+
 PG_FUNCTION_INFO_V1(union_timestamp_timestamp);
 
 PGDLLEXPORT Datum
@@ -2230,7 +2464,7 @@ union_timestamp_timestamp(PG_FUNCTION_ARGS)
 		result = timestampset_from_timestamparr_internal(&t1, 1);
 	else
 	{
-		TimestampTz *times = palloc(sizeof(TimestampTz) * 2);
+		TimestampTz times[2];
 		if (cmp < 0)
 		{
 			times[0] = t1;
@@ -2242,7 +2476,6 @@ union_timestamp_timestamp(PG_FUNCTION_ARGS)
 			times[1] = t1;
 		}
 		result = timestampset_from_timestamparr_internal(times, 2);
-		pfree(times);
 	}
 	PG_RETURN_POINTER(result);
 }
@@ -2250,29 +2483,21 @@ union_timestamp_timestamp(PG_FUNCTION_ARGS)
 TimestampSet *
 union_timestamp_timestampset_internal(TimestampTz t, TimestampSet *ts)
 {
-	TimestampTz *times = palloc(sizeof(TimestampTz) * (ts->count + 1));
-	int k = 0;
+	TimestampTz *times = timestampset_time_array(ts);
+	TimestampSet *result = timestampset_alloc(ts->count + 1);
 	bool found = false;
 	for (int i = 0; i < ts->count; i++)
 	{
-		TimestampTz t1 = timestampset_time_n(ts, i);
-		if (!found)
+		if (!found && timestamp_cmp_internal(t, times[i]) <= 0)
 		{
-			if (timestamp_cmp_internal(t, t1) < 0)
-			{
-				times[k++] = t;
-				found = true;
-			}
-			if (timestamp_cmp_internal(t, t1) == 0)
-				found = true;
+			timestampset_append(result, t);
+			found = true;
 		}
-		times[k++] = t1;
+		timestampset_append(result, times[i]);
 	}
 	if (!found)
-		times[k++] = t;
-	TimestampSet *result = timestampset_from_timestamparr_internal(times, k);
-	pfree(times);
-	return result;
+		timestampset_append(result, t);
+	return timestampset_finish(result);
 }
 
 PG_FUNCTION_INFO_V1(union_timestamp_timestampset);
@@ -2294,9 +2519,9 @@ union_timestamp_period(PG_FUNCTION_ARGS)
 {
 	TimestampTz t = PG_GETARG_TIMESTAMPTZ(0);
 	Period *p = PG_GETARG_PERIOD(1);
-	Period *p1 = period_make(t, t, true, true);
-	PeriodSet *result = union_period_period_internal(p, p1);
-	pfree(p1);
+	Period p1;
+	period_set(&p1, t, t, true, true);
+	PeriodSet *result = union_period_period_internal(p, &p1);
 	PG_RETURN_POINTER(result);
 }
 
@@ -2307,9 +2532,9 @@ union_timestamp_periodset(PG_FUNCTION_ARGS)
 {
 	TimestampTz t = PG_GETARG_TIMESTAMPTZ(0);
 	PeriodSet *ps = PG_GETARG_PERIODSET(1);
-	Period *p = period_make(t, t, true, true);
-	PeriodSet *result = union_period_periodset_internal(p, ps);
-	pfree(p);
+	Period p;
+	period_set(&p, t, t, true, true);
+	PeriodSet *result = union_period_periodset_internal(&p, ps);
 	PG_FREE_IF_COPY(ps, 1);
 	PG_RETURN_POINTER(result);
 }
@@ -2332,37 +2557,27 @@ union_timestampset_timestamp(PG_FUNCTION_ARGS)
 TimestampSet *
 union_timestampset_timestampset_internal(TimestampSet *ts1, TimestampSet *ts2)
 {
-	TimestampTz *times = palloc(sizeof(TimestampTz) * (ts1->count + ts2->count));
-	TimestampTz t1 = timestampset_time_n(ts1, 0);
-	TimestampTz t2 = timestampset_time_n(ts2, 0);
-	int i = 0, j = 0, k = 0;
+	TimestampTz *times1 = timestampset_time_array(ts1);
+	TimestampTz *times2 = timestampset_time_array(ts2);
+	TimestampSet *result = timestampset_alloc(ts1->count + ts2->count);
+	int i = 0, j = 0;
 	while (i < ts1->count && j < ts2->count)
 	{
-		if (timestamp_cmp_internal(t1, t2) == 0)
+		int cmp = timestamp_cmp_internal(times1[i], times2[j]);
+		if (cmp <= 0)
 		{
-			times[k++] = t1;
-			t1 = timestampset_time_n(ts1, ++i);
-			t2 = timestampset_time_n(ts2, ++j);
-		}
-		else if (timestamp_cmp_internal(t1, t2) < 0)
-		{
-			times[k++] = t1;
-			t1 = timestampset_time_n(ts1, ++i);
+			timestampset_append(result, times1[i++]);
+			if (cmp == 0)
+				j++;
 		}
 		else
-		{
-			times[k++] = t2;
-			t2 = timestampset_time_n(ts2, ++j);
-		}
+			timestampset_append(result, times2[j++]);
 	}
 	while (i < ts1->count)
-		times[k++] = timestampset_time_n(ts1, i++);
+		timestampset_append(result, times1[i++]);
 	while (j < ts2->count)
-		times[k++] = timestampset_time_n(ts2, j++);
-
-	TimestampSet *result = timestampset_from_timestamparr_internal(times, k);
-	pfree(times);
-	return result;
+		timestampset_append(result, times2[j++]);
+	return timestampset_finish(result);
 }
 
 PG_FUNCTION_INFO_V1(union_timestampset_timestampset);
@@ -2412,57 +2627,20 @@ union_timestampset_periodset(PG_FUNCTION_ARGS)
 PeriodSet *
 union_period_period_internal(Period *p1, Period *p2)
 {
-	TimestampTz lower;
-	TimestampTz upper;
-	bool lower_inc;
-	bool upper_inc;
-
-	if (!overlaps_period_period_internal(p1, p2) &&
-		!adjacent_period_period_internal(p1, p2))
-	{
-		Period *periods[2];
-		if (timestamp_cmp_internal(p1->lower, p2->lower) < 0)
-		{
-			periods[0] = p1;
-			periods[1] = p2;
-		}
-		else
-		{
-			periods[0] = p2;
-			periods[1] = p1;	
-		}
-		PeriodSet *result = periodset_from_periodarr_internal(periods, 2, false);
-		return result;
-	}
-
+	/* The periods are merged if they overlap or are adjacent */
+	PeriodSet *result = periodset_alloc(2);
 	if (period_cmp_bounds(p1->lower, p2->lower, true, true,
-		p1->lower_inc, p2->lower_inc) < 0)
+		p1->lower_inc, p2->lower_inc) <= 0)
 	{
-		lower = p1->lower;
-		lower_inc = p1->lower_inc;
+		periodset_append_period(result, p1);
+		periodset_append_period(result, p2);
 	}
 	else
 	{
-		lower = p2->lower;
-		lower_inc = p2->lower_inc;
+		periodset_append_period(result, p2);
+		periodset_append_period(result, p1);
 	}
-
-	if (period_cmp_bounds(p1->upper, p2->upper, false, false,
-		p1->upper_inc, p2->upper_inc) > 0)
-	{
-		upper = p1->upper;
-		upper_inc = p1->upper_inc;
-	}
-	else
-	{
-		upper = p2->upper;
-		upper_inc = p2->upper_inc;
-	}
-
-	Period *p = period_make(lower, upper, lower_inc, upper_inc);
-	PeriodSet *result = periodset_from_periodarr_internal(&p, 1, false);
-	pfree(p);
-	return result;
+	return periodset_finish(result);
 }
 
 PG_FUNCTION_INFO_V1(union_period_timestamp);
@@ -2472,9 +2650,9 @@ union_period_timestamp(PG_FUNCTION_ARGS)
 {
 	Period *p = PG_GETARG_PERIOD(0);
 	TimestampTz t = PG_GETARG_TIMESTAMPTZ(1);
-	Period *p1 = period_make(t, t, true, true);
-	PeriodSet *result = union_period_period_internal(p, p1);
-	pfree(p1);
+	Period p1;
+	period_set(&p1, t, t, true, true);
+	PeriodSet *result = union_period_period_internal(p, &p1);
 	PG_RETURN_POINTER(result);
 }
 
@@ -2505,74 +2683,22 @@ union_period_period(PG_FUNCTION_ARGS)
 PeriodSet *
 union_period_periodset_internal(Period *p, PeriodSet *ps)
 {
-	Period **periods = palloc(sizeof(Period *) * (ps->count + 1));
-	int i = 0, j, k = 0;
-
-	/* Copy the periods of ps that are before p, if any */
-	Period *p1, *p2;
-   	for (i = 0; i < ps->count; i++)
-	{
-		p1 = periodset_per_n(ps, i);
-		if (before_period_period_internal(p1, p))
-			periods[k++] = p1;
-		else
-			break;
-	}
-
-	j = i;
-	/* Copy p when disjoint of ps */
-	if (i == ps->count)
-		periods[k++] = p;
-	else if (before_period_period_internal(p, p1))
-		periods[k++] = p;
-	else
+	Period *periods = periodset_per_array(ps);
+	PeriodSet *result = periodset_alloc(ps->count + 1);
+	bool found = false;
+	for (int i = 0; i < ps->count; i++)
 	{
-		/* Find the periods of ps that overlap with p */
-		p2 = p1;
-		for (j = i + 1; j < ps->count; j++)
-		{
-			Period *p3 = periodset_per_n(ps, j);
-			if (!overlaps_period_period_internal(p3, p))
-				break;
-			p2 = p3;
-		}
-		/* Compute the union of p with the overlapping periods */
-		TimestampTz lower, upper;
-		bool lower_inc, upper_inc;
-		if (period_cmp_bounds(p->lower, p1->lower, true, true,
-			p->lower_inc, p1->lower_inc) < 0)
-		{
-			lower = p->lower;
-			lower_inc = p->lower_inc;
-		}
-		else
-		{
-			lower = p1->lower;
-			lower_inc = p1->lower_inc;
-		}
-		if (period_cmp_bounds(p->upper, p2->upper, false, false,
-			p->upper_inc, p2->upper_inc) > 0)
+		if (!found && period_cmp_bounds(p->lower, periods[i].lower, true, true,
+			p->lower_inc, periods[i].lower_inc) <= 0)
 		{
-			upper = p->upper;
-			upper_inc = p->upper_inc;
+			periodset_append_period(result, p);
+			found = true;
 		}
-		else
-		{
-			upper = p2->upper;
-			upper_inc = p2->upper_inc;
-		}
-		Period p4;
-		period_set(&p4, lower, upper, lower_inc, upper_inc);
-		periods[k++] = &p4;
-   }
-
-	/* Copy the periods of ps that are after p, if any */
-   	for (i = j; i < ps->count; i++)
-		periods[k++] = periodset_per_n(ps, i);
-
-	PeriodSet *result = periodset_from_periodarr_internal(periods, k, true);
-	pfree(periods);
-	return result;
+		periodset_append_period(result, &periods[i]);
+	}
+	if (!found)
+		periodset_append_period(result, p);
+	return periodset_finish(result);
 }
 
 PG_FUNCTION_INFO_V1(union_period_periodset);
@@ -2596,9 +2722,9 @@ union_periodset_timestamp(PG_FUNCTION_ARGS)
 {
 	PeriodSet *ps = PG_GETARG_PERIODSET(0);
 	TimestampTz t = PG_GETARG_TIMESTAMPTZ(1);
-	Period *p = period_make(t, t, true, true);
-	PeriodSet *result = union_period_periodset_internal(p, ps);
-	pfree(p);
+	Period p;
+	period_set(&p, t, t, true, true);
+	PeriodSet *result = union_period_periodset_internal(&p, ps);
 	PG_FREE_IF_COPY(ps, 0);
 	PG_RETURN_POINTER(result);
 }
@@ -2633,138 +2759,23 @@ union_periodset_period(PG_FUNCTION_ARGS)
 PeriodSet *
 union_periodset_periodset_internal(PeriodSet *ps1, PeriodSet *ps2)
 {
-	Period **periods = palloc(sizeof(Period *) * (ps1->count + ps2->count));
-	
-	/* If the period sets do not overlap */
-	if (!overlaps_periodset_periodset_internal(ps1, ps2))
-	{
-		int i = 0, j = 0, k = 0;
-		while (i < ps1->count && j < ps2->count)
-		{
-			Period *p1 = periodset_per_n(ps1, i);
-			Period *p2 = periodset_per_n(ps2, j);
-			if (before_period_period_internal(p1, p2))
-			{
-				periods[k++] = p1;
-				i++;
-			}
-			else
-			{
-				periods[k++] = p2;
-				j++;
-			}
-		}
-		PeriodSet *result = periodset_from_periodarr_internal(periods, k, false);
-		pfree(periods);
-		return result;
-	}
-
-	Period **mustfree = palloc(sizeof(Period *) * Max(ps1->count, ps2->count));
-	int i = 0, j = 0, k = 0, l = 0;
+	Period *periods1 = periodset_per_array(ps1);
+	Period *periods2 = periodset_per_array(ps2);
+	PeriodSet *result = periodset_alloc(ps1->count + ps2->count);
+	int i = 0, j = 0;
 	while (i < ps1->count && j < ps2->count)
 	{
-		Period *p1 = periodset_per_n(ps1, i);
-		Period *p2 = periodset_per_n(ps2, j);
-		/* The periods do not overlap, copy the earliest period */
-		if (!overlaps_period_period_internal(p1, p2))
-		{
-			if (before_period_period_internal(p1, p2))
-			{
-				periods[k++] = p1;
-				i++;
-			}
-			else
-			{
-				periods[k++] = p2;
-				j++;
-			}
-		}
+		if (period_cmp_bounds(periods1[i].lower, periods2[j].lower, true, true,
+			periods1[i].lower_inc, periods2[j].lower_inc) <= 0)
+			periodset_append_period(result, &periods1[i++]);
 		else
-		{
-			/* Find all periods in ps1 that overlap with periods in ps2
-				   i				 i
-				|-----|  |-----|  |-----|  |-----|	 
-					 |-----|  |-----| 
-						j		j
-			*/
-			Period *q1 = NULL, *q2 = NULL; /* keep compiler quiet */
-			/* remember whether i or j was the last value incremented */
-			bool ilastinc = false, jlastinc = false;
-			while (i < ps1->count && j < ps2->count)
-			{
-				q1 = periodset_per_n(ps1, i);
-				q2 = periodset_per_n(ps2, j);
-				if (overlaps_period_period_internal(q1, q2))
-				{
-					if (timestamp_cmp_internal(q1->upper, q2->upper) == 0)
-					{
-						i++; j++;
-						ilastinc = true; jlastinc = true;
-
-					}
-					else if (timestamp_cmp_internal(q1->upper, q2->upper) < 0)
-					{
-						i++;
-						ilastinc = true; jlastinc = false;
-					}
-					else
-					{
-						j++;
-						ilastinc = false; jlastinc = true;
-					}
-				}
-				else
-					break;
-			}
-			/* Put after the value of last counter to be incremented */
-			if (ilastinc)
-				q1 = periodset_per_n(ps1, --i);
-			if (jlastinc)
-				q2 = periodset_per_n(ps2, --j);
-			/* Compute the union of the overlapping periods */
-			TimestampTz lower, upper;
-			bool lower_inc, upper_inc;
-			if (period_cmp_bounds(p1->lower, p2->lower, true, true,
-				p1->lower_inc, p2->lower_inc) < 0)
-			{
-				lower = p1->lower;
-				lower_inc = p1->lower_inc;
-			}
-			else
-			{
-				lower = p2->lower;
-				lower_inc = p2->lower_inc;
-			}
-			if (period_cmp_bounds(q1->upper, q2->upper, false, false,
-				q1->upper_inc, q2->upper_inc) > 0)
-			{
-				upper = q1->upper;
-				upper_inc = q1->upper_inc;
-			}
-			else
-			{
-				upper = q2->upper;
-				upper_inc = q2->upper_inc;
-			}
-			Period *p3 = period_make(lower, upper, lower_inc, upper_inc);
-			periods[k++] = p3;
-			mustfree[l++] = p3;
-			i++; j++;
-		}
+			periodset_append_period(result, &periods2[j++]);
 	}
 	while (i < ps1->count)
-		periods[k++] = periodset_per_n(ps1, i++);
+		periodset_append_period(result, &periods1[i++]);
 	while (j < ps2->count)
-		periods[k++] = periodset_per_n(ps2, j++);
-	/* k is never equal to 0 since the periodsets are not empty*/
-	PeriodSet *result = periodset_from_periodarr_internal(periods, k, true);
-
-	pfree(periods);
-	for (i = 0; i < l; i++)
-		pfree(mustfree[i]);
-	pfree(mustfree);
-
-	return result;
+		periodset_append_period(result, &periods2[j++]);
+	return periodset_finish(result);
 }
 
 PG_FUNCTION_INFO_V1(union_periodset_periodset);
@@ -2861,31 +2872,24 @@ intersection_timestampset_timestampset_internal(TimestampSet *ts1, TimestampSet
 	if (!overlaps_period_period_internal(p1, p2))
 		return NULL;
 
-	TimestampTz *times = palloc(sizeof(TimestampTz) * (ts1->count + ts2->count));
-	int i = 0, j = 0, k = 0;
-	while (i < ts1->count && j < ts2->count)
+	/* Gallop in the larger set */
+	if (ts1->count > ts2->count)
 	{
-		TimestampTz t1 = timestampset_time_n(ts1, i);
-		TimestampTz t2 = timestampset_time_n(ts2, j);
-		if (timestamp_cmp_internal(t1, t2) == 0)
-		{
-			times[k++] = t1;
-			i++; j++;
-		}
-		else if (timestamp_cmp_internal(t1, t2) < 0)
-			i++;
-		else
-			j++;
+		TimestampSet *tmp = ts1; ts1 = ts2; ts2 = tmp;
 	}
-	if (k == 0)
+	TimestampTz *times1 = timestampset_time_array(ts1);
+	TimestampTz *times2 = timestampset_time_array(ts2);
+	TimestampSet *result = timestampset_alloc(ts1->count);
+	int j = 0;
+	for (int i = 0; i < ts1->count; i++)
 	{
-		pfree(times);
-		return NULL;
+		j = timestamparr_gallop(times2, j, ts2->count, times1[i]);
+		if (j == ts2->count)
+			break;
+		if (timestamp_cmp_internal(times1[i], times2[j]) == 0)
+			timestampset_append(result, times1[i]);
 	}
-
-	TimestampSet *result = timestampset_from_timestamparr_internal(times, k);
-	pfree(times);
-	return result;
+	return timestampset_finish(result);
 }
 
 PG_FUNCTION_INFO_V1(intersection_timestampset_timestampset);
@@ -2911,22 +2915,13 @@ intersection_timestampset_period_internal(TimestampSet *ts, Period *p)
 	if (!overlaps_period_period_internal(p1, p))
 		return NULL;
 
-	TimestampTz *times = palloc(sizeof(TimestampTz) * ts->count);
-	int k = 0;
-	for (int i = 0; i < ts->count; i++)
-	{
-		TimestampTz t = timestampset_time_n(ts, i);
-		if (contains_period_timestamp_internal(p, t))
-			times[k++] = t;
-	}
-	if (k == 0)
-	{
-		pfree(times);
-		return NULL;
-	}
-	TimestampSet *result = timestampset_from_timestamparr_internal(times, k);
-	pfree(times);
-	return result;
+	TimestampTz *times = timestampset_time_array(ts);
+	int from = timestamparr_gallop_period(times, 0, ts->count, p);
+	TimestampSet *result = timestampset_alloc(ts->count - from);
+	for (int i = from; i < ts->count && 
+		contains_period_timestamp_internal(p, times[i]); i++)
+		timestampset_append(result, times[i]);
+	return timestampset_finish(result);
 }
 
 PG_FUNCTION_INFO_V1(intersection_timestampset_period);
@@ -2953,51 +2948,33 @@ intersection_timestampset_periodset_internal(TimestampSet *ts, PeriodSet *ps)
 	if (!overlaps_period_period_internal(p1, p2))
 		return NULL;
 
-	TimestampTz *times = palloc(sizeof(TimestampTz) * ts->count);
-	TimestampTz t = timestampset_time_n(ts, 0);
-	Period *p = periodset_per_n(ps, 0);
-	int i = 0, j = 0, k = 0;
-	while (i < ts->count && j < ps->count)
+	/* Gallop in the larger set */
+	TimestampTz *times = timestampset_time_array(ts);
+	Period *periods = periodset_per_array(ps);
+	TimestampSet *result = timestampset_alloc(ts->count);
+	int i = 0, j = 0;
+	if (ts->count <= ps->count)
 	{
-		if (timestamp_cmp_internal(t, p->lower) < 0)
-		{
-			times[k++] = t;
-			i++;
-			if (i == ts->count)
-				break;
-			else
-				t = timestampset_time_n(ts, i);
-		}
-		else if (timestamp_cmp_internal(t, p->upper) > 0)
+		for (i = 0; i < ts->count; i++)
 		{
-			j++;
+			j = periodarr_gallop(periods, j, ps->count, times[i]);
 			if (j == ps->count)
 				break;
-			else
-				p = periodset_per_n(ps, j);
-		}
-		else
-		{
-			if (contains_period_timestamp_internal(p, t))
-				times[k++] = t;
-			i++;
-			if (i == ts->count)
-				break;
-			else
-				t = timestampset_time_n(ts, i);
+			if (contains_period_timestamp_internal(&periods[j], times[i]))
+				timestampset_append(result, times[i]);
 		}
 	}
-	if (k == 0)
+	else
 	{
-		pfree(times);
-		return NULL;
+		for (j = 0; j < ps->count; j++)
+		{
+			Period *p = &periods[j];
+			i = timestamparr_gallop_period(times, i, ts->count, p);
+			while (i < ts->count && contains_period_timestamp_internal(p, times[i]))
+				timestampset_append(result, times[i++]);
+		}
 	}
-
-	TimestampSet *result = timestampset_from_timestamparr_internal(times, k);
-
-	pfree(times);
-
-	return result;
+	return timestampset_finish(result);
 }
 
 PG_FUNCTION_INFO_V1(intersection_timestampset_periodset);
@@ -3046,8 +3023,13 @@ intersection_period_timestampset(PG_FUNCTION_ARGS)
 	PG_RETURN_POINTER(result);
 }
 
-Period *
-intersection_period_period_internal(Period *p1, Period *p2)
+/* 
+ * Set in result the intersection of the periods, returns false if they do not
+ * overlap
+ */
+
+static bool
+intersection_period_period_internal1(Period *result, Period *p1, Period *p2)
 {
 	TimestampTz lower;
 	TimestampTz upper;
@@ -3056,7 +3038,7 @@ intersection_period_period_internal(Period *p1, Period *p2)
 
 	/* Bounding box test */
 	if (!overlaps_period_period_internal(p1, p2))
-		return NULL;
+		return false;
 
 	if (period_cmp_bounds(p1->lower, p2->lower, true, true,
 		p1->lower_inc, p2->lower_inc) >= 0)
@@ -3082,7 +3064,17 @@ intersection_period_period_internal(Period *p1, Period *p2)
 		upper_inc = p2->upper_inc;
 	}
 
-	return period_make(lower, upper, lower_inc, upper_inc);
+	period_set(result, lower, upper, lower_inc, upper_inc);
+	return true;
+}
+
+Period *
+intersection_period_period_internal(Period *p1, Period *p2)
+{
+	Period inter;
+	if (!intersection_period_period_internal1(&inter, p1, p2))
+		return NULL;
+	return period_copy(&inter);
 }
 
 PG_FUNCTION_INFO_V1(intersection_period_period);
@@ -3113,28 +3105,18 @@ intersection_period_periodset_internal(Period *p, PeriodSet *ps)
 	/* General case */
 	int n;
 	periodset_find_timestamp(ps, p->lower, &n);
-	Period **periods = palloc(sizeof(Period *) * (ps->count - n));
-	int k = 0;
+	Period *periods = periodset_per_array(ps);
+	PeriodSet *result = periodset_alloc(ps->count - n);
 	for (int i = n; i < ps->count; i++)
 	{
-		p1 = periodset_per_n(ps, i);
-		Period *p2 = intersection_period_period_internal(p1, p);
-		if (p2 != NULL)
-			periods[k++] = p2;
+		Period inter;
+		p1 = &periods[i];
+		if (intersection_period_period_internal1(&inter, p1, p))
+			periodset_append_period(result, &inter);
 		if (timestamp_cmp_internal(p->upper, p1->upper) < 0)
 			break;
 	}
-	if (k == 0)
-	{
-		pfree(periods);
-		return NULL;
-	}
-
-	PeriodSet *result = periodset_from_periodarr_internal(periods, k, false);
-	for (int i = 0; i < k; i++)
-		pfree(periods[i]);
-	pfree(periods);
-	return result;
+	return periodset_finish(result);
 }
 
 PG_FUNCTION_INFO_V1(intersection_period_periodset);
@@ -3202,23 +3184,23 @@ intersection_periodset_periodset_internal(PeriodSet *ps1, PeriodSet *ps2)
 	/* Bounding box test */
 	Period *p1 = periodset_bbox(ps1);
 	Period *p2 = periodset_bbox(ps2);
-	if (!overlaps_period_period_internal(p1, p2))
+	Period inter;
+	if (!intersection_period_period_internal1(&inter, p1, p2))
 		return NULL;
 
-	Period *inter = intersection_period_period_internal(p1, p2);
 	int n1, n2;
-	periodset_find_timestamp(ps1, inter->lower, &n1);
-	periodset_find_timestamp(ps2, inter->lower, &n2);
-	pfree(inter);
-	Period **periods = palloc(sizeof(Period *) * (ps1->count + ps2->count - n1 - n2));
-	int i = n1, j = n2, k = 0;
+	periodset_find_timestamp(ps1, inter.lower, &n1);
+	periodset_find_timestamp(ps2, inter.lower, &n2);
+	Period *periods1 = periodset_per_array(ps1);
+	Period *periods2 = periodset_per_array(ps2);
+	PeriodSet *result = periodset_alloc(ps1->count + ps2->count - n1 - n2);
+	int i = n1, j = n2;
 	while (i < ps1->count && j < ps2->count)
 	{
-		p1 = periodset_per_n(ps1, i);
-		p2 = periodset_per_n(ps2, j);
-		inter = intersection_period_period_internal(p1, p2);
-		if (inter != NULL)
-			periods[k++] = inter;
+		p1 = &periods1[i];
+		p2 = &periods2[j];
+		if (intersection_period_period_internal1(&inter, p1, p2))
+			periodset_append_period(result, &inter);
 		int cmp = timestamp_cmp_internal(p1->upper, p2->upper);
 		if (cmp == 0 && p1->upper_inc == p2->upper_inc)
 		{
@@ -3229,17 +3211,7 @@ intersection_periodset_periodset_internal(PeriodSet *ps1, PeriodSet *ps2)
 		else
 			j++;
 	}
-	if (k == 0)
-	{
-		pfree(periods);
-		return NULL;
-	}
-
-	PeriodSet *result = periodset_from_periodarr_internal(periods, k, true);
-	for (i = 0; i < k; i++)
-		pfree(periods[i]);
-	pfree(periods);
-	return result;
+	return periodset_finish(result);
 }
 
 PG_FUNCTION_INFO_V1(intersection_periodset_periodset);
@@ -3326,23 +3298,14 @@ minus_timestampset_timestamp_internal(TimestampSet *ts, TimestampTz t)
 	if (!contains_period_timestamp_internal(p, t))
 		return timestampset_copy(ts);
 
-	TimestampTz *times = palloc(sizeof(TimestampTz) * ts->count);
-	int k = 0;
+	TimestampTz *times = timestampset_time_array(ts);
+	TimestampSet *result = timestampset_alloc(ts->count);
 	for (int i = 0; i < ts->count; i++)
 	{
-		TimestampTz t1 = timestampset_time_n(ts, i);
-		if (timestamp_cmp_internal(t, t1) != 0)
-			times[k++] = t1;
+		if (timestamp_cmp_internal(t, times[i]) != 0)
+			timestampset_append(result, times[i]);
 	}
-	if (k == 0)
-	{
-		pfree(times);
-		return NULL;
-	}
-
-	TimestampSet *result = timestampset_from_timestamparr_internal(times, k);
-	pfree(times);
-	return result;
+	return timestampset_finish(result);
 }
 
 PG_FUNCTION_INFO_V1(minus_timestampset_timestamp);
@@ -3368,33 +3331,25 @@ minus_timestampset_timestampset_internal(TimestampSet *ts1, TimestampSet *ts2)
 	if (!overlaps_period_period_internal(p1, p2))
 		return timestampset_copy(ts1);
 
-	TimestampTz *times = palloc(sizeof(TimestampTz) * ts1->count);
-	int i = 0, j = 0, k = 0;
+	TimestampTz *times1 = timestampset_time_array(ts1);
+	TimestampTz *times2 = timestampset_time_array(ts2);
+	TimestampSet *result = timestampset_alloc(ts1->count);
+	int i = 0, j = 0;
 	while (i < ts1->count && j < ts2->count)
 	{
-		TimestampTz t1 = timestampset_time_n(ts1, i);
-		TimestampTz t2 = timestampset_time_n(ts2, j);
-		if (timestamp_cmp_internal(t1, t2) == 0)
-		{
-			i++; j++;
-		}
-		if (timestamp_cmp_internal(t1, t2) < 0)
-		{
-			times[k++] = t1;
+		/* Copy the timestamps of ts1 before times2[j] */
+		int k = timestamparr_gallop(times1, i, ts1->count, times2[j]);
+		while (i < k)
+			timestampset_append(result, times1[i++]);
+		if (i < ts1->count && timestamp_cmp_internal(times1[i], times2[j]) == 0)
 			i++;
-		}
-		else
-			j++;
-	}
-	if (k == 0)
-	{
-		pfree(times);
-		return NULL;
+		/* Skip the timestamps of ts2 before times1[i] */
+		if (i < ts1->count)
+			j = timestamparr_gallop(times2, j + 1, ts2->count, times1[i]);
 	}
-	
-	TimestampSet *result = timestampset_from_timestamparr_internal(times, k);
-	pfree(times);
-	return result;
+	while (i < ts1->count)
+		timestampset_append(result, times1[i++]);
+	return timestampset_finish(result);
 }
 
 PG_FUNCTION_INFO_V1(minus_timestampset_timestampset);
@@ -3420,23 +3375,17 @@ minus_timestampset_period_internal(TimestampSet *ts, Period *p)
 	if (!overlaps_period_period_internal(p1, p))
 		return timestampset_copy(ts);
 
-	TimestampTz *times = palloc(sizeof(TimestampTz) * ts->count);
-	int k = 0;
-	for (int i = 0; i < ts->count; i++)
-	{
-		TimestampTz t = timestampset_time_n(ts, i);
-		if (!contains_period_timestamp_internal(p, t))
-			times[k++] = t;
-	}
-	if (k == 0)
-	{
-		pfree(times);
-		return NULL;
-	}
-
-	TimestampSet *result = timestampset_from_timestamparr_internal(times, k);
-	pfree(times);
-	return result;
+	TimestampTz *times = timestampset_time_array(ts);
+	int from = timestamparr_gallop_period(times, 0, ts->count, p);
+	TimestampSet *result = timestampset_alloc(ts->count);
+	int i;
+	for (i = 0; i < from; i++)
+		timestampset_append(result, times[i]);
+	while (i < ts->count && contains_period_timestamp_internal(p, times[i]))
+		i++;
+	for (; i < ts->count; i++)
+		timestampset_append(result, times[i]);
+	return timestampset_finish(result);
 }
 
 PG_FUNCTION_INFO_V1(minus_timestampset_period);
@@ -3463,51 +3412,36 @@ minus_timestampset_periodset_internal(TimestampSet *ts, PeriodSet *ps)
 	if (!overlaps_period_period_internal(p1, p2))
 		return timestampset_copy(ts);
 
-	TimestampTz *times = palloc(sizeof(TimestampTz) * ts->count);
-	TimestampTz t = timestampset_time_n(ts, 0);
-	Period *p = periodset_per_n(ps, 0);
-	int i = 0, j = 0, k = 0;
-	while (i < ts->count && j < ps->count)
+	/* Gallop in the larger set */
+	TimestampTz *times = timestampset_time_array(ts);
+	Period *periods = periodset_per_array(ps);
+	TimestampSet *result = timestampset_alloc(ts->count);
+	int i = 0, j = 0;
+	if (ts->count <= ps->count)
 	{
-		if (timestamp_cmp_internal(t, p->lower) < 0)
-		{
-			times[k++] = t;
-			i++;
-			if (i == ts->count)
-				break;
-			else
-				t = timestampset_time_n(ts, i);
-		}
-		else if (timestamp_cmp_internal(t, p->upper) > 0)
-		{
-			j++;
-			if (j == ps->count)
-				break;
-			else
-				p = periodset_per_n(ps, j);
-		}
-		else
+		for (i = 0; i < ts->count; i++)
 		{
-			if (!contains_period_timestamp_internal(p, t))
-				times[k++] = t;
-			i++;
-			if (i == ts->count)
-				break;
-			else
-				t = timestampset_time_n(ts, i);
+			j = periodarr_gallop(periods, j, ps->count, times[i]);
+			if (j == ps->count || 
+				!contains_period_timestamp_internal(&periods[j], times[i]))
+				timestampset_append(result, times[i]);
 		}
 	}
-	for (int l = i; l < ts->count; l++)
-		times[k++] = timestampset_time_n(ts, l);
-	if (k == 0)
+	else
 	{
-		pfree(times);
-		return NULL;
+		for (j = 0; j < ps->count && i < ts->count; j++)
+		{
+			Period *p = &periods[j];
+			int k = timestamparr_gallop_period(times, i, ts->count, p);
+			while (i < k)
+				timestampset_append(result, times[i++]);
+			while (i < ts->count && contains_period_timestamp_internal(p, times[i]))
+				i++;
+		}
+		while (i < ts->count)
+			timestampset_append(result, times[i++]);
 	}
-
-	TimestampSet *result = timestampset_from_timestamparr_internal(times, k);
-	pfree(times);
-	return result;
+	return timestampset_finish(result);
 }
 
 PG_FUNCTION_INFO_V1(minus_timestampset_periodset);
@@ -3527,47 +3461,41 @@ minus_timestampset_periodset(PG_FUNCTION_ARGS)
 
 /*****************************************************************************/
 
-static int
-minus_period_timestamp_internal1(Period **result, Period *p, TimestampTz t)
+static void
+minus_period_timestamp_internal1(PeriodSet *result, Period *p, TimestampTz t)
 {
 	if (!contains_period_timestamp_internal(p, t))
 	{
-		result[0] = period_copy(p);
-		return 1;
+		periodset_append_period(result, p);
+		return;
 	}
 
 	if (timestamp_cmp_internal(p->lower, t) == 0 &&
 		timestamp_cmp_internal(p->upper, t) == 0)
-		return 0;
+		return;
 
 	if (timestamp_cmp_internal(p->lower, t) == 0)
 	{
-		result[0] = period_make(p->lower, p->upper, false, p->upper_inc);
-		return 1;
+		periodset_append(result, p->lower, p->upper, false, p->upper_inc);
+		return;
 	}
 
 	if (timestamp_cmp_internal(p->upper, t) == 0)
 	{
-		result[0] = period_make(p->lower, p->upper, p->lower_inc, false);
-		return 1;
+		periodset_append(result, p->lower, p->upper, p->lower_inc, false);
+		return;
 	}
 
-	result[0] = period_make(p->lower, t, p->lower_inc, false);
-	result[1] = period_make(t, p->upper, false, p->upper_inc);
-	return 2;
+	periodset_append(result, p->lower, t, p->lower_inc, false);
+	periodset_append(result, t, p->upper, false, p->upper_inc);
 }
 
 PeriodSet *
 minus_period_timestamp_internal(Period *p, TimestampTz t)
 {
-	Period *periods[2];
-	int n = minus_period_timestamp_internal1(periods, p, t);
-	if (n == 0)
-		return NULL;
-	PeriodSet *result = periodset_from_periodarr_internal(periods, n, false);
-	for (int i = 0; i < n; i++)
-		pfree(periods[i]);
-	return result;
+	PeriodSet *result = periodset_alloc(2);
+	minus_period_timestamp_internal1(result, p, t);
+	return periodset_finish(result);
 }
 
 PG_FUNCTION_INFO_V1(minus_period_timestamp);
@@ -3592,54 +3520,33 @@ minus_period_timestampset_internal(Period *p, TimestampSet *ts)
 	if (!overlaps_period_period_internal(p, p1))
 		return periodset_from_periodarr_internal(&p, 1, false);
 
-	Period **periods = palloc(sizeof(Period *) * (ts->count + 1));
-	Period *curr = period_copy(p);
-	int k = 0;
+	TimestampTz *times = timestampset_time_array(ts);
+	PeriodSet *result = periodset_alloc(ts->count + 1);
+	Period curr = *p;
 	for (int i = 0; i < ts->count; i++)
 	{
-		TimestampTz t = timestampset_time_n(ts, i);
-		if (contains_period_timestamp_internal(curr, t))
+		TimestampTz t = times[i];
+		if (contains_period_timestamp_internal(&curr, t))
 		{
-			if (timestamp_cmp_internal(curr->lower, curr->upper) == 0)
+			if (timestamp_cmp_internal(curr.lower, curr.upper) == 0)
+				return periodset_finish(result);
+			else if (timestamp_cmp_internal(curr.lower, t) == 0)
+				curr.lower_inc = false;
+			else if (timestamp_cmp_internal(curr.upper, t) == 0)
 			{
-				pfree(curr);
-				curr = NULL;
-				break;
-			}
-			else if (timestamp_cmp_internal(curr->lower, t) == 0)
-			{
-				Period *curr1 = period_make(curr->lower, curr->upper, false, curr->upper_inc);
-				pfree(curr);
-				curr = curr1;
-			}
-			else if (timestamp_cmp_internal(curr->upper, t) == 0)
-			{
-				Period *curr1 = period_make(curr->lower, curr->upper, curr->lower_inc, false);
-				pfree(curr);
-				curr = curr1;
+				curr.upper_inc = false;
 				break;
 			}
 			else
 			{
-				periods[k++] = period_make(curr->lower, t, curr->lower_inc, false);
-				Period *curr1 = period_make(t, curr->upper, false, curr->upper_inc);
-				pfree(curr);
-				curr = curr1;
+				periodset_append(result, curr.lower, t, curr.lower_inc, false);
+				curr.lower = t;
+				curr.lower_inc = false;
 			}
 		}
 	}
-	if (curr != NULL)
-		periods[k++] = curr;
-	if (k == 0)
-	{
-		pfree(periods);
-		return NULL;
-	}
-	PeriodSet *result = periodset_from_periodarr_internal(periods, k, false);
-	for (int i = 0; i < k; i++)
-		pfree(periods[i]);
-	pfree(periods);
-	return result;
+	periodset_append_period(result, &curr);
+	return periodset_finish(result);
 }
 
 PG_FUNCTION_INFO_V1(minus_period_timestampset);
@@ -3657,8 +3564,8 @@ minus_period_timestampset(PG_FUNCTION_ARGS)
 	PG_RETURN_POINTER(result);
 }
 
-static int
-minus_period_period_internal1(Period **result, Period *p1, Period *p2)
+static void
+minus_period_period_internal1(PeriodSet *result, Period *p1, Period *p2)
 {
 	int cmp_l1l2 = period_cmp_bounds(p1->lower, p2->lower, true, true,
 		p1->lower_inc, p2->lower_inc);
@@ -3670,38 +3577,31 @@ minus_period_period_internal1(Period **result, Period *p1, Period *p2)
 		p1->upper_inc, p2->upper_inc);
 
 	if (cmp_l1l2 >= 0 && cmp_u1u2 <= 0)
-		return 0;
+		return;
 
 	if (cmp_l1l2 < 0 && cmp_u1u2 > 0)
 	{
-		result[0] = period_make(p1->lower, p2->lower,
+		periodset_append(result, p1->lower, p2->lower,
 			p1->lower_inc, !(p2->lower_inc));
-		result[1] = period_make(p2->upper, p1->upper,
+		periodset_append(result, p2->upper, p1->upper,
 			!(p2->upper_inc), p1->upper_inc);
-		return 2;
+		return;
 	}
 
 	if (cmp_l1u2 > 0 || cmp_u1l2 < 0)
-		result[0] = period_copy(p1);
+		periodset_append_period(result, p1);
 	else if (cmp_l1l2 <= 0 && cmp_u1l2 >= 0 && cmp_u1u2 <= 0)
-		result[0] = period_make(p1->lower, p2->lower, p1->lower_inc, !(p2->lower_inc));
+		periodset_append(result, p1->lower, p2->lower, p1->lower_inc, !(p2->lower_inc));
 	else if (cmp_l1l2 >= 0 && cmp_u1u2 >= 0 && cmp_l1u2 <= 0)
-		result[0] = period_make(p2->upper, p1->upper, !(p2->upper_inc), p1->upper_inc);
-	return 1;
+		periodset_append(result, p2->upper, p1->upper, !(p2->upper_inc), p1->upper_inc);
 }
 
 PeriodSet *
 minus_period_period_internal(Period *p1, Period *p2)
 {
-	Period *periods[2];
-	int count = minus_period_period_internal1(periods, p1, p2);
-	if (count == 0)
-		return NULL;
-
-	PeriodSet *result = periodset_from_periodarr_internal(periods, count, false);
-	for (int i = 0; i < count; i++)
-		pfree(periods[i]);
-	return result;
+	PeriodSet *result = periodset_alloc(2);
+	minus_period_period_internal1(result, p1, p2);
+	return periodset_finish(result);
 }
 
 PG_FUNCTION_INFO_V1(minus_period_period);
@@ -3717,44 +3617,40 @@ minus_period_period(PG_FUNCTION_ARGS)
 	PG_RETURN_POINTER(result);
 }
 
-static int
-minus_period_periodset_internal1(Period **result, Period *p, PeriodSet *ps, 
-	int from, int count)
+static void
+minus_period_periodset_internal1(PeriodSet *result, Period *p, PeriodSet *ps, 
+	int from, int to)
 {
-	/* The period can be split at most into (count + 1) periods
+	/* The period can be split at most into (to - from + 1) periods
 		|----------------------|
 			|---| |---| |---|
 	*/
-	Period *curr = period_copy(p);
-	int k = 0;
-	for (int i = from; i < count; i++)
+	Period *periods = periodset_per_array(ps);
+	Period curr = *p;
+	for (int i = from; i < to; i++)
 	{
-		Period *p1 = periodset_per_n(ps, i);
-		/* If the remaining periods are to the left of the current period */
-		if (period_cmp_bounds(curr->upper, p1->lower, false, true,
-				curr->upper_inc, p1->lower_inc) < 0)
-		{
-			result[k++] = curr;
-			break;
-		}
-		Period *minus[2];
-		int countminus = minus_period_period_internal1(minus, curr, p1);
-		pfree(curr);
-		/* minus can have from 0 to 2 periods */
-		if (countminus == 0)
+		Period *p1 = &periods[i];
+		/* Skip the periods to the left of the current period */
+		if (period_cmp_bounds(p1->upper, curr.lower, false, true,
+				p1->upper_inc, curr.lower_inc) < 0)
+			continue;
+		/* If the remaining periods are to the right of the current period */
+		if (period_cmp_bounds(curr.upper, p1->lower, false, true,
+				curr.upper_inc, p1->lower_inc) < 0)
 			break;
-		else if (countminus == 1)
-			curr = minus[0];
-		else /* countminus == 2 */
-		{
-			result[k++] = minus[0];
-			curr = minus[1];
-		}
-		/* There are no more periods left */
-		if (i == count - 1)
-			result[k++] = curr;
+		/* The part of the current period before p1, if any, is final */
+		if (period_cmp_bounds(curr.lower, p1->lower, true, true,
+				curr.lower_inc, p1->lower_inc) < 0)
+			periodset_append(result, curr.lower, p1->lower, curr.lower_inc,
+				!(p1->lower_inc));
+		/* Continue with the part of the current period after p1, if any */
+		if (period_cmp_bounds(curr.upper, p1->upper, false, false,
+				curr.upper_inc, p1->upper_inc) <= 0)
+			return;
+		curr.lower = p1->upper;
+		curr.lower_inc = !(p1->upper_inc);
 	}
-	return k;
+	periodset_append_period(result, &curr);
 }
 
 PeriodSet *
@@ -3765,20 +3661,12 @@ minus_period_periodset_internal(Period *p, PeriodSet *ps)
 	if (!overlaps_period_period_internal(p, p1))
 		return periodset_from_periodarr_internal(&p, 1, false);
 
-	Period **periods = palloc(sizeof(Period *) * (ps->count + 1));
-	int count = minus_period_periodset_internal1(periods, p, ps,
-		0, ps->count);
-	if (count == 0)
-	{
-		pfree(periods);
-		return NULL;
-	}
-
-	PeriodSet *result = periodset_from_periodarr_internal(periods, count, false);
-	for (int i = 0; i < count; i++)
-		pfree(periods[i]);
-	pfree(periods);
-	return result;
+	/* Binary search of lower bound of period */
+	int n;
+	periodset_find_timestamp(ps, p->lower, &n);
+	PeriodSet *result = periodset_alloc(ps->count - n + 1);
+	minus_period_periodset_internal1(result, p, ps, n, ps->count);
+	return periodset_finish(result);
 }
 
 PG_FUNCTION_INFO_V1(minus_period_periodset);
@@ -3806,24 +3694,11 @@ minus_periodset_timestamp_internal(PeriodSet *ps, TimestampTz t)
 		return periodset_copy(ps);
 
 	/* At most one composing period can be split into two */
-	Period **periods = palloc(sizeof(Period *) * (ps->count + 1));
-	int k = 0;
+	Period *periods = periodset_per_array(ps);
+	PeriodSet *result = periodset_alloc(ps->count + 1);
 	for (int i = 0; i < ps->count; i++)
-	{
-		p = periodset_per_n(ps, i);
-		k += minus_period_timestamp_internal1(&periods[k], p, t);
-	}
-	if (k == 0)
-	{
-		pfree(periods);
-		return NULL;
-	}
-
-	PeriodSet *result = periodset_from_periodarr_internal(periods, k, false);
-	for (int i = 0; i < k; i++)
-		pfree(periods[i]);
-	pfree(periods);
-	return result;
+		minus_period_timestamp_internal1(result, &periods[i], t);
+	return periodset_finish(result);
 }
 
 PG_FUNCTION_INFO_V1(minus_periodset_timestamp);
@@ -3850,102 +3725,41 @@ minus_periodset_timestampset_internal(PeriodSet *ps, TimestampSet *ts)
 		return periodset_copy(ps);
 
 	/* Each timestamp will split at most one composing period into two */
-	Period **periods = palloc(sizeof(Period *) * (ps->count + ts->count + 1));
-	int i = 0, j = 0, k = 0;
-	Period *curr = period_copy(periodset_per_n(ps, 0));
-	TimestampTz t = timestampset_time_n(ts, 0);
-	while (i < ps->count && j < ts->count)
+	Period *periods = periodset_per_array(ps);
+	TimestampTz *times = timestampset_time_array(ts);
+	PeriodSet *result = periodset_alloc(ps->count + ts->count);
+	int j = 0;
+	for (int i = 0; i < ps->count; i++)
 	{
-		if (timestamp_cmp_internal(t, curr->upper) > 0)
-		{
-			periods[k++] = curr;
-			i++;
-			if (i == ps->count)
-				break;
-			else
-				curr = period_copy(periodset_per_n(ps, i));
-		}
-		else if (timestamp_cmp_internal(t, curr->lower) < 0)
-		{
+		Period curr = periods[i];
+		/* Skip the timestamps before the period */
+		while (j < ts->count && timestamp_cmp_internal(times[j], curr.lower) < 0)
 			j++;
-			if (j == ts->count)
-				break;
-			else
-				t = timestampset_time_n(ts, j);
-		}
-		else
+		/* Split the period at the timestamps before its upper bound */
+		while (j < ts->count && timestamp_cmp_internal(times[j], curr.upper) < 0)
 		{
-			if (contains_period_timestamp_internal(curr, t))
-			{
-				if (timestamp_cmp_internal(curr->lower, curr->upper) == 0)
-				{
-					pfree(curr);
-					i++;
-					if (i == ps->count)
-						break;
-					else
-						curr = period_copy(periodset_per_n(ps, i));
-				}
-				else if (timestamp_cmp_internal(curr->lower, t) == 0)
-				{
-					Period *curr1 = period_make(curr->lower, curr->upper, false, curr->upper_inc);
-					pfree(curr);
-					curr = curr1;
-				}
-				else if (timestamp_cmp_internal(curr->upper, t) == 0)
-				{
-					periods[k++] = period_make(curr->lower, curr->upper, curr->lower_inc, false);
-					pfree(curr);
-					i++;
-					if (i == ps->count)
-						break;
-					else
-						curr = period_copy(periodset_per_n(ps, i));
-				}
-				else
-				{
-					periods[k++] = period_make(curr->lower, t, curr->lower_inc, false);
-					Period *curr1 = period_make(t, curr->upper, false, curr->upper_inc);
-					pfree(curr);
-					curr = curr1;
-				}
-			}
+			TimestampTz t = times[j++];
+			if (timestamp_cmp_internal(t, curr.lower) == 0)
+				curr.lower_inc = false;
 			else
 			{
-				if (timestamp_cmp_internal(curr->upper, t) == 0)
-				{
-					periods[k++] = curr;
-					i++;
-					if (i == ps->count)
-						break;
-					else
-						curr = period_copy(periodset_per_n(ps, i));
-				}
+				periodset_append(result, curr.lower, t, curr.lower_inc, false);
+				curr.lower = t;
+				curr.lower_inc = false;
 			}
-			j++;
-			if (j == ts->count)
-				break;
-			else
-				t = timestampset_time_n(ts, j);
 		}
+		/* Remove the upper bound if it is a timestamp of the set, the 
+		   timestamp is kept since the next period may start at it */
+		if (j < ts->count && curr.upper_inc &&
+			timestamp_cmp_internal(times[j], curr.upper) == 0)
+		{
+			if (timestamp_cmp_internal(curr.lower, curr.upper) == 0)
+				continue;
+			curr.upper_inc = false;
+		}
+		periodset_append_period(result, &curr);
 	}
-	/* If we ran through all the instants */
-	if (j == ts->count)
-		periods[k++] = curr;
-	for (int l = i + 1; l < ps->count; l++)
-		periods[k++] = periodset_per_n(ps, l);
-
-	if (k == 0)
-	{
-		pfree(periods);
-		return NULL;
-	}
-
-	PeriodSet *result = periodset_from_periodarr_internal(periods, k, false);
-	for (int l = 0; l < i; l++)
-		pfree(periods[l]);
-	pfree(periods);
-	return result;
+	return periodset_finish(result);
 }
 
 PG_FUNCTION_INFO_V1(minus_periodset_timestampset);
@@ -3972,24 +3786,11 @@ minus_periodset_period_internal(PeriodSet *ps, Period *p)
 		return periodset_copy(ps);
 
 	/* At most one composing period can be split into two */
-	Period **periods = palloc(sizeof(Period *) * (ps->count + 1));
-	int k = 0;
+	Period *periods = periodset_per_array(ps);
+	PeriodSet *result = periodset_alloc(ps->count + 1);
 	for (int i = 0; i < ps->count; i++)
-	{
-		p1 = periodset_per_n(ps, i);
-		k += minus_period_period_internal1(&periods[k], p1, p);
-	}
-	if (k == 0)
-	{
-		pfree(periods);
-		return NULL;
-	}
-
-	PeriodSet *result = periodset_from_periodarr_internal(periods, k, false);
-	for (int i = 0; i < k; i++)
-		pfree(periods[i]);
-	pfree(periods);
-	return result;
+		minus_period_period_internal1(result, &periods[i], p);
+	return periodset_finish(result);
 }
 
 PG_FUNCTION_INFO_V1(minus_periodset_period);
@@ -4015,52 +3816,20 @@ minus_periodset_periodset_internal(PeriodSet *ps1, PeriodSet *ps2)
 	if (!overlaps_period_period_internal(p1, p2))
 		return periodset_copy(ps1);
 
-	Period **periods = palloc(sizeof(Period *) * (ps1->count + ps2->count));
-	int i = 0, j = 0, k = 0;
-	while (i < ps1->count && j < ps2->count)
+	/* Each period of ps2 will split at most one period of ps1 into two */
+	Period *periods1 = periodset_per_array(ps1);
+	Period *periods2 = periodset_per_array(ps2);
+	PeriodSet *result = periodset_alloc(ps1->count + ps2->count);
+	int j = 0;
+	for (int i = 0; i < ps1->count; i++)
 	{
-		p1 = periodset_per_n(ps1, i);
-		p2 = periodset_per_n(ps2, j);
-		/* The periods do not overlap, copy the first period */
-		if (!overlaps_period_period_internal(p1, p2))
-		{
-			periods[k++] = period_copy(p1);
-			i++;
-		}
-		else
-		{
-			/* Find all periods in ps2 that overlap with p1
-							  i
-				|------------------------|  
-					 |-----|  |-----|	  |---|
-						j					l
-			*/
-			int l;
-			for (l = j; l < ps2->count; l++)
-			{
-				Period *p3 = periodset_per_n(ps2, l);
-				if (!overlaps_period_period_internal(p1, p3))
-					break;
-			}
-			int count = l - j;
-			/* Compute the difference of the overlapping periods */
-			k += minus_period_periodset_internal1(&periods[k], p1,
-				ps2, j, count);
-			i++;
-			j = l;
-		}
-	}
-	if (k == 0)
-	{
-		pfree(periods);
-		return NULL;
+		p1 = &periods1[i];
+		/* Skip the periods of ps2 that are before p1 */
+		while (j < ps2->count && before_period_period_internal(&periods2[j], p1))
+			j++;
+		minus_period_periodset_internal1(result, p1, ps2, j, ps2->count);
 	}
-
-	PeriodSet *result = periodset_from_periodarr_internal(periods, k, false);
-	for (i = 0; i < k; i++)
-		pfree(periods[i]);
-	pfree(periods);
-	return result;
+	return periodset_finish(result);
 }
 
 PG_FUNCTION_INFO_V1(minus_periodset_periodset);
@@ -28,24 +28,27 @@
 /* 
  * The memory structure of a TimestampSet with, e.g., 3 timestamps is as follows
  *
- *  --------------------------------------------------------------------
- *	( TimestampSet | offset_0 | offset_1 | offset_2 | offset_3 | )_X | ...
  *	--------------------------------------------------------------------
- *	------------------------------------------------------------
- *	( Timestamp_0 | Timestamp_1 | Timestamp_2 | ( bbox )_Y )_X |
- *	------------------------------------------------------------
+ *	( TimestampSet )_X | Timestamp_0 | Timestamp_1 | Timestamp_2 | bbox |
+ *	--------------------------------------------------------------------
+ *
+ * where the X are unused bytes added for double padding and the bounding box
+ * is a Period. Since all the timestamps have the same size, they are 
+ * accessed with a fixed stride from the first one.
  *
- * where the X are unused bytes added for double padding, the Y are unused bytes 
- * added for int4 padding, offset_0 to offset_2 are offsets for the corresponding 
- * timestamps, and offset_3 is the offset for the bounding box.
+ * Previous versions stored in addition an array of count + 1 offsets of type
+ * size_t between the header and the timestamps. Such values are recognized 
+ * by their size, which is always greater than the one of the current layout
+ * for the same number of timestamps, and remain readable.
  */
- 
-/* Pointer to array of offsets of the TimestampSet */
 
-static size_t *
-timestampset_offsets_ptr(TimestampSet *ts)
+/* Returns true if the TimestampSet has the array of offsets of previous versions */
+
+static bool
+timestampset_has_offsets(TimestampSet *ts)
 {
-	return (size_t *) (((char *)ts) + sizeof(TimestampSet));
+	return VARSIZE(ts) != double_pad(sizeof(TimestampSet)) + 
+		sizeof(TimestampTz) * ts->count + double_pad(sizeof(Period));
 }
 
 /* Pointer to the first timestamp */
@@ -53,8 +56,18 @@ timestampset_offsets_ptr(TimestampSet *ts)
 static char * 
 timestampset_data_ptr(TimestampSet *ts)
 {
-	return (char *)ts + double_pad(sizeof(TimestampSet) + 
-		sizeof(size_t) * (ts->count + 1));
+	if (timestampset_has_offsets(ts))
+		return (char *)ts + double_pad(sizeof(TimestampSet) + 
+			sizeof(size_t) * (ts->count + 1));
+	return (char *)ts + double_pad(sizeof(TimestampSet));
+}
+
+/* Array of the timestamps of a TimestampSet */
+
+TimestampTz *
+timestampset_time_array(TimestampSet *ts)
+{
+	return (TimestampTz *) timestampset_data_ptr(ts);
 }
 
 /* N-th TimestampTz of a TimestampSet */
@@ -62,9 +75,7 @@ timestampset_data_ptr(TimestampSet *ts)
 TimestampTz
 timestampset_time_n(TimestampSet *ts, int index)
 {
-	size_t *offsets = timestampset_offsets_ptr(ts);
-	TimestampTz *result = (TimestampTz *) (timestampset_data_ptr(ts) + offsets[index]);
-	return *result;
+	return timestampset_time_array(ts)[index];
 }
 
 /* Bounding box of a TimestampSet */
@@ -72,8 +83,69 @@ timestampset_time_n(TimestampSet *ts, int index)
 Period *
 timestampset_bbox(TimestampSet *ts) 
 {
-	size_t *offsets = timestampset_offsets_ptr(ts);
-	return (Period *)(timestampset_data_ptr(ts) + offsets[ts->count]);
+	return (Period *) (timestampset_time_array(ts) + ts->count);
+}
+
+/*
+ * Construction of a TimestampSet in a single pass. The result is allocated 
+ * with room for at most maxcount timestamps, the timestamps are appended in
+ * increasing order with timestampset_append, and the value is completed with
+ * timestampset_finish.
+ */
+
+static TimestampTz *
+timestampset_alloc_data(TimestampSet *ts)
+{
+	/* The size of the value is not yet final, do not test the layout */
+	return (TimestampTz *) ((char *)ts + double_pad(sizeof(TimestampSet)));
+}
+
+TimestampSet *
+timestampset_alloc(int maxcount)
+{
+	size_t pdata = double_pad(sizeof(TimestampSet));
+	size_t memsize = sizeof(TimestampTz) * maxcount + double_pad(sizeof(Period));
+	TimestampSet *result = palloc0(pdata + memsize);
+	SET_VARSIZE(result, pdata + memsize);
+	result->count = 0;
+	return result;
+}
+
+/* 
+ * Append a timestamp to a TimestampSet under construction. The timestamp 
+ * must not be before the last one appended, it is ignored if it is equal.
+ */
+
+void
+timestampset_append(TimestampSet *ts, TimestampTz t)
+{
+	TimestampTz *timearr = timestampset_alloc_data(ts);
+	if (ts->count > 0 && timestamp_cmp_internal(timearr[ts->count - 1], t) == 0)
+		return;
+	timearr[ts->count++] = t;
+}
+
+/* 
+ * Complete a TimestampSet under construction by setting its bounding box and
+ * its final size. Returns NULL and frees the value if it has no timestamp.
+ */
+
+TimestampSet *
+timestampset_finish(TimestampSet *ts)
+{
+	if (ts->count == 0)
+	{
+		pfree(ts);
+		return NULL;
+	}
+	TimestampTz *timearr = timestampset_alloc_data(ts);
+	int count = ts->count;
+	period_set((Period *) (timearr + count), timearr[0], timearr[count - 1], 
+		true, true);
+	/* The memory in excess, if any, is left unused */
+	SET_VARSIZE(ts, double_pad(sizeof(TimestampSet)) + 
+		sizeof(TimestampTz) * count + double_pad(sizeof(Period)));
+	return ts;
 }
 
 /* Construct a TimestampSet from an array of TimestampTz */
@@ -81,7 +153,6 @@ timestampset_bbox(TimestampSet *ts)
 TimestampSet *
 timestampset_from_timestamparr_internal(TimestampTz *times, int count)
 {
-	Period bbox;
 	/* Test the validity of the timestamps */
 	for (int i = 0; i < count - 1; i++)
 	{
@@ -90,28 +161,10 @@ timestampset_from_timestamparr_internal(TimestampTz *times, int count)
 				errmsg("Invalid value for timestamp set")));
 	}
 
-	size_t memsize = double_pad(sizeof(TimestampTz) * count + double_pad(sizeof(Period)));
-	/* Array of pointers containing the pointers to the component timestamps,
-	   and a pointer to the bbox */
-	size_t pdata = double_pad(sizeof(TimestampSet) + (count + 1) * sizeof(size_t));
-	/* Create the TimestampSet */
-	TimestampSet *result = palloc0(pdata + memsize);
-	SET_VARSIZE(result, pdata + memsize);
+	TimestampSet *result = timestampset_alloc(count);
+	memcpy(timestampset_alloc_data(result), times, sizeof(TimestampTz) * count);
 	result->count = count;
-
-	size_t *offsets = timestampset_offsets_ptr(result);
-	size_t pos = 0;	
-	for (int i = 0; i < count; i++)
-	{
-		memcpy(((char *) result) + pdata + pos, &times[i], sizeof(TimestampTz));
-		offsets[i] = pos;
-		pos += sizeof(TimestampTz);
-	}
-	/* Precompute the bounding box */
-	period_set(&bbox, times[0], times[count - 1], true, true);
-	offsets[count] = pos;
-	memcpy(((char *) result) + pdata + pos, &bbox, sizeof(Period));
-	return result;
+	return timestampset_finish(result);
 }
 
 TimestampSet *
@@ -139,14 +192,13 @@ timestampset_copy(TimestampSet *ts)
 bool 
 timestampset_find_timestamp(TimestampSet *ts, TimestampTz t, int *pos) 
 {
+	TimestampTz *timearr = timestampset_time_array(ts);
 	int first = 0;
 	int last = ts->count - 1;
-	int middle = 0; /* make compiler quiet */
 	while (first <= last) 
 	{
-		middle = (first + last)/2;
-		TimestampTz t1 = timestampset_time_n(ts, middle);
-		int cmp = timestamp_cmp_internal(t, t1);
+		int middle = (first + last)/2;
+		int cmp = timestamp_cmp_internal(t, timearr[middle]);
 		if (cmp == 0)
 		{
 			*pos = middle;
@@ -157,9 +209,8 @@ timestampset_find_timestamp(TimestampSet *ts, TimestampTz t, int *pos)
 		else
 			first = middle + 1;
 	}
-	if (middle == ts->count)
-		middle++;
-	*pos = middle;
+	/* The timestamp would be inserted before timearr[first] */
+	*pos = first;
 	return false;
 }
 
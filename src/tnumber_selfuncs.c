@@ -618,9 +618,113 @@ calc_hist_selectivity(TypeCacheEntry *typcache, VariableStatData *vardata,
  * Internal functions computing selectivity
  * The functions assume that the value and time dimensions of temporal values 
  * are independent and thus the selectivity values obtained by analyzing the 
- * histograms for each dimension can be multiplied.
+ * histograms for each dimension can be multiplied. When the joint histogram
+ * of both dimensions is available, the product is corrected for the 
+ * correlation between them.
  *****************************************************************************/
 
+/*
+ * Returns the proportion of each cell of one dimension of a TboxHistogram
+ * that is covered by the interval [lower, upper].
+ */
+static void
+tbox_hist_coverage(const TboxHistogram *hist, int d, double lower,
+	double upper, double *coverage)
+{
+	int size = (int) hist->size[d];
+	double width = hist->max[d] - hist->min[d];
+	double cellwidth, cellmin, cellmax;
+	int i;
+
+	if (width <= 0)
+	{
+		/* The only cell has no extent and is either covered or not */
+		coverage[0] = (lower <= hist->min[d] && hist->max[d] <= upper) ? 
+			1.0 : 0.0;
+		return;
+	}
+	cellwidth = width / size;
+	for (i = 0; i < size; i++)
+	{
+		cellmin = hist->min[d] + i * cellwidth;
+		cellmax = cellmin + cellwidth;
+		if (upper <= cellmin || lower >= cellmax)
+			coverage[i] = 0.0;
+		else
+			coverage[i] = (Min(upper, cellmax) - Max(lower, cellmin)) / cellwidth;
+	}
+}
+
+/*
+ * Returns the proportion of the features of a TboxHistogram falling in a 
+ * rectangle of the value and time dimensions, assuming that the features 
+ * are uniformly distributed inside each cell.
+ */
+static double
+tbox_hist_fraction(const TboxHistogram *hist, const double *vcoverage,
+	const double *tcoverage)
+{
+	int vsize = (int) hist->size[0], tsize = (int) hist->size[1];
+	double total = 0.0;
+	int i, j;
+
+	for (j = 0; j < tsize; j++)
+	{
+		if (tcoverage[j] == 0.0)
+			continue;
+		for (i = 0; i < vsize; i++)
+			total += hist->value[j * vsize + i] * vcoverage[i] * tcoverage[j];
+	}
+	return total / hist->features;
+}
+
+/*
+ * Returns the ratio between the proportion of the features falling in the 
+ * value and time extent of the box and the product of the proportions of 
+ * the features falling in each extent separately, as estimated by the joint
+ * histogram of the value and time dimensions. This ratio is 1 when both 
+ * dimensions are independent. Returns -1 when the histogram is not available
+ * or the ratio cannot be computed.
+ */
+static double
+calc_tbox_hist_correlation(VariableStatData *vardata, const TBOX *box)
+{
+	AttStatsSlot sslot;
+	const TboxHistogram *hist;
+	double *vcoverage, *tcoverage, *vall, *tall;
+	double joint, vmarginal, tmarginal, result = -1.0;
+	int i;
+
+	if (!(HeapTupleIsValid(vardata->statsTuple) &&
+		  get_attstatsslot(&sslot, vardata->statsTuple, 
+			STATISTIC_KIND_VALUE_TIME_HISTOGRAM, InvalidOid, ATTSTATSSLOT_NUMBERS)))
+		return -1.0;
+	hist = (const TboxHistogram *) sslot.numbers;
+
+	vcoverage = palloc(sizeof(double) * (int) hist->size[0]);
+	vall = palloc(sizeof(double) * (int) hist->size[0]);
+	tcoverage = palloc(sizeof(double) * (int) hist->size[1]);
+	tall = palloc(sizeof(double) * (int) hist->size[1]);
+	tbox_hist_coverage(hist, 0, box->xmin, box->xmax, vcoverage);
+	tbox_hist_coverage(hist, 1, period_to_secs(box->tmin, 0), 
+		period_to_secs(box->tmax, 0), tcoverage);
+	for (i = 0; i < (int) hist->size[0]; i++)
+		vall[i] = 1.0;
+	for (i = 0; i < (int) hist->size[1]; i++)
+		tall[i] = 1.0;
+
+	joint = tbox_hist_fraction(hist, vcoverage, tcoverage);
+	vmarginal = tbox_hist_fraction(hist, vcoverage, tall);
+	tmarginal = tbox_hist_fraction(hist, vall, tcoverage);
+	/* Degenerate extents, e.g., a single value or timestamp, are not covered */
+	if (vmarginal > 0.0 && tmarginal > 0.0)
+		result = joint / (vmarginal * tmarginal);
+
+	pfree(vcoverage); pfree(vall); pfree(tcoverage); pfree(tall);
+	free_attstatsslot(&sslot);
+	return result;
+}
+
 /* Transform the constant into a TBOX */
 static bool
 tnumber_const_to_tbox(const Node *other, TBOX *box)
@@ -1001,13 +1105,31 @@ tnumbers_sel(PlannerInfo *root, VariableStatData *vardata, TBOX *box,
 		cachedOp == AFTER_OP || cachedOp == OVERBEFORE_OP || 
 		cachedOp == OVERAFTER_OP) 
 	{
+		double selec_value = 1.0, selec_time = 1.0, correlation;
+
 		/* Selectivity for the value dimension */
 		if (MOBDB_FLAGS_GET_X(box->flags))
-			selec *= calc_hist_selectivity(typcache, vardata, range, 
+			selec_value = calc_hist_selectivity(typcache, vardata, range, 
 				value_oprid);
 		/* Selectivity for the time dimension */
 		if (MOBDB_FLAGS_GET_T(box->flags))
-			selec *= calc_period_hist_selectivity(vardata, &period, cachedOp);
+			selec_time = calc_period_hist_selectivity(vardata, &period, cachedOp);
+		selec = selec_value * selec_time;
+
+		/* 
+		 * Correct the selectivity of the bounding box operators for the
+		 * correlation between the value and time dimensions. The selectivity
+		 * of both dimensions cannot be greater than the one of each dimension.
+		 */
+		if (MOBDB_FLAGS_GET_X(box->flags) && MOBDB_FLAGS_GET_T(box->flags) &&
+			cachedOp != BEFORE_OP && cachedOp != AFTER_OP && 
+			cachedOp != OVERBEFORE_OP && cachedOp != OVERAFTER_OP &&
+			selec_value >= 0.0 && selec_time >= 0.0)
+		{
+			correlation = calc_tbox_hist_correlation(vardata, box);
+			if (correlation >= 0.0)
+				selec = Min(selec * correlation, Min(selec_value, selec_time));
+		}
 	}
 	else if (cachedOp == LT_OP || cachedOp == LE_OP || 
 		cachedOp == GT_OP || cachedOp == GE_OP) 
@@ -0,0 +1,111 @@
+/*****************************************************************************
+ *
+ * bench_setup.sql
+ *	  Functions for running the benchmarks and recording their results, and
+ *	  generation of the datasets of temporal numbers.
+ *
+ * The datasets are generated with the functions of random_temporal.sql from
+ * a fixed seed so that two runs measure the same data. Their size is given 
+ * by the psql variables rows (number of rows of each table), instants 
+ * (maximum number of instants per sequence) and sequences (maximum number 
+ * of sequences per sequence set), which the run_bench command of test.sh 
+ * sets from the environment variables BENCH_ROWS, BENCH_INSTANTS and 
+ * BENCH_SEQUENCES.
+ *
+ * Portions Copyright (c) 2020, Esteban Zimanyi, Arthur Lesuisse, 
+ * 		Universite Libre de Bruxelles
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ *****************************************************************************/
+
+DROP TABLE IF EXISTS bench_params;
+CREATE TABLE bench_params AS
+SELECT :rows AS rows, :instants AS instants, :sequences AS sequences,
+	mobdb_lib_version() AS version;
+
+DROP TABLE IF EXISTS bench_results;
+CREATE TABLE bench_results (
+	name text,
+	version text,
+	rows int,
+	instants int,
+	sequences int,
+	repeat int,
+	min_ms float,
+	avg_ms float,
+	max_ms float,
+	bytes bigint
+);
+
+/*
+ * Run a query repeat times and record the minimum, average and maximum 
+ * duration. The cleanup statement, if any, is run after each execution 
+ * and is not timed.
+ */
+CREATE OR REPLACE FUNCTION bench_run(name text, query text, 
+	repeat int DEFAULT 3, cleanup text DEFAULT NULL) 
+RETURNS void AS $$
+DECLARE
+	start timestamptz;
+	times float[];
+BEGIN
+	FOR i IN 1..repeat 
+	LOOP
+		start = clock_timestamp();
+		EXECUTE query;
+		times = times || extract(epoch FROM clock_timestamp() - start) * 1000;
+		IF cleanup IS NOT NULL THEN
+			EXECUTE cleanup;
+		END IF;
+	END LOOP;
+	INSERT INTO bench_results
+	SELECT name, p.version, p.rows, p.instants, p.sequences, repeat,
+		min(t), avg(t), max(t), NULL
+	FROM bench_params p, unnest(times) t
+	GROUP BY p.version, p.rows, p.instants, p.sequences;
+END;
+$$ LANGUAGE plpgsql;
+
+/* Record the storage size of a table, including its TOAST table */
+CREATE OR REPLACE FUNCTION bench_size(name text, tbl regclass) 
+RETURNS void AS $$
+BEGIN
+	INSERT INTO bench_results
+	SELECT name, p.version, p.rows, p.instants, p.sequences, NULL,
+		NULL, NULL, NULL, pg_total_relation_size(tbl)
+	FROM bench_params p;
+END;
+$$ LANGUAGE plpgsql;
+
+-------------------------------------------------------------------------------
+-- Datasets
+-------------------------------------------------------------------------------
+
+SELECT setseed(0.5);
+
+DROP TABLE IF EXISTS bench_tintseq;
+CREATE TABLE bench_tintseq AS
+SELECT k, random_tintseq(0, 100, '2001-01-01', '2001-12-31', 10, :instants) AS seq
+FROM generate_series(1, :rows) k;
+
+DROP TABLE IF EXISTS bench_tfloatseq;
+CREATE TABLE bench_tfloatseq AS
+SELECT k, random_tfloatseq(0, 100, '2001-01-01', '2001-12-31', 10, :instants) AS seq
+FROM generate_series(1, :rows) k;
+
+DROP TABLE IF EXISTS bench_tfloats;
+CREATE TABLE bench_tfloats AS
+SELECT k, random_tfloats(0, 100, '2001-01-01', '2001-12-31', 10, :instants, 
+	:sequences) AS ts
+FROM generate_series(1, :rows) k;
+
+ANALYZE bench_tintseq;
+ANALYZE bench_tfloatseq;
+ANALYZE bench_tfloats;
+
+SELECT bench_size('size_tintseq', 'bench_tintseq');
+SELECT bench_size('size_tfloatseq', 'bench_tfloatseq');
+SELECT bench_size('size_tfloats', 'bench_tfloats');
+
+/*****************************************************************************/
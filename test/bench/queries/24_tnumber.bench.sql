@@ -0,0 +1,53 @@
+-------------------------------------------------------------------------------
+-- Restriction
+-------------------------------------------------------------------------------
+
+SELECT bench_run('atPeriod_tfloatseq',
+	'SELECT count(atPeriod(seq, period ''[2001-06-01, 2001-07-01]'')) FROM bench_tfloatseq');
+SELECT bench_run('atPeriod_tfloats',
+	'SELECT count(atPeriod(ts, period ''[2001-06-01, 2001-07-01]'')) FROM bench_tfloats');
+SELECT bench_run('atValue_tfloats',
+	'SELECT count(atValue(ts, 50.0)) FROM bench_tfloats');
+
+-------------------------------------------------------------------------------
+-- Aggregates
+-------------------------------------------------------------------------------
+
+SELECT bench_run('tcount_tfloatseq',
+	'SELECT numInstants(tcount(seq)) FROM bench_tfloatseq');
+SELECT bench_run('tavg_tfloats',
+	'SELECT numInstants(tavg(ts)) FROM bench_tfloats');
+SELECT bench_run('wavg_tintseq',
+	'SELECT numInstants(wavg(seq, interval ''1 hour'')) FROM bench_tintseq');
+
+-------------------------------------------------------------------------------
+-- Indexes
+-------------------------------------------------------------------------------
+
+SELECT bench_run('gist_build_tfloats',
+	'CREATE INDEX bench_tfloats_gist_idx ON bench_tfloats USING gist(ts)',
+	3, 'DROP INDEX bench_tfloats_gist_idx');
+SELECT bench_run('spgist_build_tfloats',
+	'CREATE INDEX bench_tfloats_spgist_idx ON bench_tfloats USING spgist(ts)',
+	3, 'DROP INDEX bench_tfloats_spgist_idx');
+
+CREATE INDEX bench_tfloats_gist_idx ON bench_tfloats USING gist(ts);
+SET enable_seqscan = off;
+SELECT bench_run('gist_probe_tfloats',
+	'SELECT count(*) FROM bench_tfloats WHERE ts && period ''[2001-06-01, 2001-06-02]''');
+SET enable_seqscan = on;
+DROP INDEX bench_tfloats_gist_idx;
+
+-------------------------------------------------------------------------------
+-- Input/output
+-------------------------------------------------------------------------------
+
+SELECT bench_run('copy_out_tfloats',
+	'COPY bench_tfloats TO ' || quote_literal(:'copyfile'));
+CREATE TABLE bench_tfloats_copy (LIKE bench_tfloats);
+SELECT bench_run('copy_in_tfloats',
+	'COPY bench_tfloats_copy FROM ' || quote_literal(:'copyfile'),
+	3, 'TRUNCATE bench_tfloats_copy');
+DROP TABLE bench_tfloats_copy;
+
+-------------------------------------------------------------------------------
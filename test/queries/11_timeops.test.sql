@@ -89,6 +89,7 @@ select periodset '{[2000-01-01,2000-01-02],[2000-01-05,2000-01-06]}' + periodset
 select periodset '{[2000-01-01,2000-01-02],[2000-01-05,2000-01-06]}' + periodset '{[2000-01-01,2000-01-02],[2000-01-03,2000-01-04],[2000-01-07,2000-01-08]}';
 SELECT periodset '{[2000-01-01, 2000-01-02],[2000-01-03, 2000-01-04], [2000-01-06, 2000-01-07]}' + periodset '{[2000-01-02, 2000-01-03],[2000-01-04, 2000-01-05]}';
 SELECT periodset '{[2000-01-02, 2000-01-03],[2000-01-04, 2000-01-05]}' + periodset '{[2000-01-01, 2000-01-02],[2000-01-03, 2000-01-04], [2000-01-06, 2000-01-07]}';
+SELECT periodset '{[2000-01-01, 2000-01-02)}' + periodset '{[2000-01-02, 2000-01-03]}';
 
 -------------------------------------------------------------------------------
 
@@ -120,6 +121,7 @@ SELECT timestampset '{2000-01-01, 2000-01-03, 2000-01-05}' - timestamptz '2000-0
 SELECT timestampset '{2000-01-01, 2000-01-03, 2000-01-05}' - timestamptz '2000-01-02';
 SELECT timestampset '{2000-01-01, 2000-01-03, 2000-01-05}' - timestampset '{2000-01-01, 2000-01-03, 2000-01-05}';
 SELECT timestampset '{2000-01-01, 2000-01-03, 2000-01-05}' - timestampset '{2000-01-03, 2000-01-05, 2000-01-07}';
+SELECT timestampset '{2000-01-01, 2000-01-03, 2000-01-05}' - timestampset '{2000-01-02}';
 SELECT timestampset '{2000-01-01, 2000-01-03, 2000-01-05}' - period '[2000-01-01, 2000-01-03]';
 SELECT timestampset '{2000-01-01, 2000-01-03, 2000-01-05}' - period '[2000-01-01, 2000-01-05]';
 SELECT timestampset '{2000-01-01, 2000-01-04}' - periodset '{[2000-01-02, 2000-01-03],[2000-01-05, 2000-01-06]}';
@@ -165,6 +167,7 @@ SELECT periodset '{[2000-01-01, 2000-01-03]}' - period '[2000-01-01, 2000-01-03]
 SELECT periodset '{[2000-01-01, 2000-01-03],[2000-01-04, 2000-01-05]}' - periodset '{[2000-01-01, 2000-01-03],[2000-01-04, 2000-01-05]}';
 SELECT periodset '{[2000-01-01, 2000-01-03],[2000-01-04, 2000-01-05]}' - periodset '{[2000-01-04, 2000-01-05]}';
 SELECT periodset '{[2000-01-01, 2000-01-03],[2000-01-04, 2000-01-05]}' - periodset '{[2000-01-01, 2000-01-03]}';
+SELECT periodset '{[2000-01-01, 2000-01-02],[2000-01-03, 2000-01-04],[2000-01-05, 2000-01-06]}' - periodset '{[2000-01-01, 2000-01-02]}';
 
 -------------------------------------------------------------------------------
 
@@ -200,6 +203,7 @@ SELECT timestampset '{2000-01-01,2000-01-03}' * periodset '{[2000-01-01,2000-01-
 SELECT timestampset '{2000-01-01, 2000-01-04, 2000-01-07}' * periodset '{[2000-01-02, 2000-01-03],[2000-01-05, 2000-01-06]}';
 SELECT timestampset '{2000-01-03, 2000-01-06}' * periodset '{[2000-01-01, 2000-01-02],[2000-01-04, 2000-01-05]}';
 SELECT timestampset '{2000-01-01, 2000-01-04}' * periodset '{(2000-01-01, 2000-01-03]}';
+SELECT timestampset '{2000-01-01, 2000-01-03}' * periodset '{[2000-01-02, 2000-01-04]}';
 
 SELECT period '[2000-01-01, 2000-01-03]' * timestamptz '2000-01-01';
 SELECT period '[2000-01-01, 2000-01-03]' * timestampset '{2000-01-01, 2000-01-03, 2000-01-05}';
@@ -21,6 +21,20 @@ SELECT count(*) FROM tbl_periodset, tbl_timestampset WHERE ps -|- ts;
 SELECT count(*) FROM tbl_periodset, tbl_period WHERE ps -|- p;
 SELECT count(*) FROM tbl_periodset t1, tbl_periodset t2 WHERE t1.ps -|- t2.ps;
 
+SELECT (SELECT count(*) FROM tbl_timestamptz WHERE t <@ periodset '{[2001-01-01, 2001-03-01], [2001-05-01, 2001-08-01), (2001-10-01, 2001-12-01]}') = (SELECT count(*) FROM tbl_timestamptz, (SELECT periodset '{[2001-01-01, 2001-03-01], [2001-05-01, 2001-08-01), (2001-10-01, 2001-12-01]}' AS ps OFFSET 0) AS c WHERE t <@ ps);
+DROP FUNCTION IF EXISTS count_in_timestampset;
+CREATE FUNCTION count_in_timestampset(ts timestampset)
+RETURNS bigint AS $$
+DECLARE
+	C bigint;
+BEGIN
+	EXECUTE 'SELECT count(*) FROM tbl_timestamptz WHERE $1 @> t' INTO C USING ts;
+	RETURN C;
+END;
+$$ LANGUAGE 'plpgsql';
+SELECT count_in_timestampset(ts) > 0 AND count_in_timestampset(ts) = (SELECT count(*) FROM tbl_timestamptz WHERE ts @> t) FROM (SELECT timestampset(array_agg(DISTINCT t ORDER BY t)) AS ts FROM (SELECT t FROM tbl_timestamptz WHERE t IS NOT NULL LIMIT 10) AS s) AS c;
+DROP FUNCTION count_in_timestampset;
+
 -------------------------------------------------------------------------------
 
 SELECT count(*) FROM tbl_timestamptz t1, tbl_timestamptz t2 WHERE t1.t + t2.t IS NOT NULL;
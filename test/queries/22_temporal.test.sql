@@ -11,6 +11,10 @@ SELECT tfloat '1@2012-01-01 08:00:00';
 SELECT tfloat '2@2012-01-01 08:00:00';
 SELECT ttext 'AAA@2012-01-01 08:00:00';
 SELECT ttext 'BBB@2012-01-01 08:00:00';
+SELECT tfloat '1.5e2@2012-01-01 08:00:00.5+02';
+SELECT tint '-3@2012-01-01T08:00:00+02:30';
+SELECT asText(tfloat '{1.123456789@2000-01-01, 2.5@2000-01-02}', 2);
+SELECT asText(tfloat '{1e-20@2000-01-01, 0.000123456789012345678@2000-01-02, 1.5e300@2000-01-03}');
 /* Errors */
 SELECT tbool '2@2012-01-01 08:00:00';
 SELECT tint 'TRUE@2012-01-01 08:00:00';
@@ -2310,4 +2314,12 @@ SELECT ttext_hash(ttext '{AAA@2000-01-01, BBB@2000-01-02, AAA@2000-01-03}');
 SELECT ttext_hash(ttext '[AAA@2000-01-01, BBB@2000-01-02, AAA@2000-01-03]');
 SELECT ttext_hash(ttext '{[AAA@2000-01-01, BBB@2000-01-02, AAA@2000-01-03],[CCC@2000-01-04, CCC@2000-01-05]}');
 
+SELECT mobdb_stats_reset();
+SELECT name, count FROM mobdb_stats();
+SET mobilitydb.stats = on;
+SELECT atValue(tint '[1@2000-01-01, 2@2000-01-02, 1@2000-01-03]', 3);
+SELECT name, count > 0 AS counted FROM mobdb_stats() WHERE name IN ('instants', 'sequences', 'bbox_shortcuts');
+SELECT mobdb_stats_reset();
+RESET mobilitydb.stats;
+
 ------------------------------------------------------------------------------
@@ -100,6 +100,7 @@ SELECT tfloat '{[1.5@2000-01-01, 2.5@2000-01-02, 1.5@2000-01-03],[3.5@2000-01-04
 SELECT tfloat '1.5@2000-01-01' + tfloat '[1.5@2000-01-01, 2.5@2000-01-02, 1.5@2000-01-03]';
 SELECT tfloat '{1.5@2000-01-01, 2.5@2000-01-02, 1.5@2000-01-03}' + tfloat '[1.5@2000-01-01, 2.5@2000-01-02, 1.5@2000-01-03]';
 SELECT tfloat '[1.5@2000-01-01, 2.5@2000-01-02, 1.5@2000-01-03]' + tfloat '[1.5@2000-01-01, 2.5@2000-01-02, 1.5@2000-01-03]';
+SELECT tfloat '[1@2000-01-01, 3@2000-01-03, 1@2000-01-05)' + tfloat '[2@2000-01-02, 4@2000-01-04]';
 SELECT tfloat '{[1.5@2000-01-01, 2.5@2000-01-02, 1.5@2000-01-03],[3.5@2000-01-04, 3.5@2000-01-05]}' + tfloat '[1.5@2000-01-01, 2.5@2000-01-02, 1.5@2000-01-03]';
 SELECT tfloat '1.5@2000-01-01' + tfloat '{[1.5@2000-01-01, 2.5@2000-01-02, 1.5@2000-01-03],[3.5@2000-01-04, 3.5@2000-01-05]}';
 SELECT tfloat '{1.5@2000-01-01, 2.5@2000-01-02, 1.5@2000-01-03}' + tfloat '{[1.5@2000-01-01, 2.5@2000-01-02, 1.5@2000-01-03],[3.5@2000-01-04, 3.5@2000-01-05]}';
@@ -423,6 +423,8 @@ SELECT tint '1@2000-01-01' #< tint '{[1@2000-01-01, 2@2000-01-02, 1@2000-01-03],
 SELECT tint '{1@2000-01-01, 2@2000-01-02, 1@2000-01-03}' #< tint '{[1@2000-01-01, 2@2000-01-02, 1@2000-01-03],[3@2000-01-04, 3@2000-01-05]}';
 SELECT tint '[1@2000-01-01, 2@2000-01-02, 1@2000-01-03]' #< tint '{[1@2000-01-01, 2@2000-01-02, 1@2000-01-03],[3@2000-01-04, 3@2000-01-05]}';
 SELECT tint '{[1@2000-01-01, 2@2000-01-02, 1@2000-01-03],[3@2000-01-04, 3@2000-01-05]}' #< tint '{[1@2000-01-01, 2@2000-01-02, 1@2000-01-03],[3@2000-01-04, 3@2000-01-05]}';
+SELECT tint '{[1@2000-01-01, 2@2000-01-03), [3@2000-01-04, 3@2000-01-05]}' #< tint '[2@2000-01-02, 1@2000-01-06]';
+SELECT tfloat '{[1@2000-01-01, 1@2000-01-05], [1@2000-01-06, 1@2000-01-07]}' #= tfloat '{[2@2000-01-02, 2@2000-01-03], [1@2000-01-04, 1@2000-01-10]}';
 
 SELECT tint '1@2000-01-01' #< tfloat '1.5@2000-01-01';
 SELECT tint '{1@2000-01-01, 2@2000-01-02, 1@2000-01-03}' #< tfloat '1.5@2000-01-01';
@@ -5,6 +5,9 @@ VACUUM ANALYZE tbl_tint_big;
 VACUUM ANALYZE tbl_tfloat_big;
 VACUUM ANALYZE tbl_ttext_big;
 
+-- Joint histogram of the value and time dimensions
+SELECT count(*) FROM pg_statistic WHERE starelid = 'tbl_tfloat_big'::regclass AND 11 IN (stakind1, stakind2, stakind3, stakind4, stakind5);
+
 DROP INDEX IF EXISTS tbl_tbool_big_gist_idx;
 DROP INDEX IF EXISTS tbl_tint_big_gist_idx;
 DROP INDEX IF EXISTS tbl_tfloat_big_gist_idx;
@@ -47,3 +47,17 @@ foreach(file ${testfiles})
 	set_tests_properties(${TESTNAME} PROPERTIES RESOURCE_LOCK DBLOCK)
 endforeach()
 
+
+# Benchmarks, run with "make bench" in a cluster of their own. The size of
+# the datasets is set with the BENCH_ROWS, BENCH_INSTANTS and BENCH_SEQUENCES 
+# environment variables. The results are written in tmpbench/out/bench.csv.
+set(BENCHENV ${CMAKE_COMMAND} -E env TEST_WORKDIR=${CMAKE_BINARY_DIR}/tmpbench)
+add_custom_target(bench
+	COMMAND ${BENCHENV} ${PROJECT_SOURCE_DIR}/test/scripts/test.sh setup ${CMAKE_BINARY_DIR}
+	COMMAND ${BENCHENV} ${PROJECT_SOURCE_DIR}/test/scripts/test.sh create_ext ${CMAKE_BINARY_DIR}
+	COMMAND ${BENCHENV} ${PROJECT_SOURCE_DIR}/test/scripts/test.sh run_bench ${CMAKE_BINARY_DIR}
+	COMMAND ${BENCHENV} ${PROJECT_SOURCE_DIR}/test/scripts/test.sh teardown ${CMAKE_BINARY_DIR}
+	WORKING_DIRECTORY ${PROJECT_SOURCE_DIR}/test
+	DEPENDS ${CMAKE_PROJECT_NAME} sqlscript control
+	USES_TERMINAL
+)
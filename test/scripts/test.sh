@@ -5,7 +5,7 @@ set -o pipefail
 
 CMD=$1
 BUILDDIR=$2
-WORKDIR=$BUILDDIR/tmptest
+WORKDIR=${TEST_WORKDIR:-$BUILDDIR/tmptest}
 EXTFILE=$BUILDDIR/*--*.sql
 SOFILE=`echo $BUILDDIR/lib*.so`
 PSQL="psql -h $WORKDIR/lock -e --set ON_ERROR_STOP=0 postgres"
@@ -113,6 +113,41 @@ run_passfail)
 	fi
 	exit $?
 	;;
+
+run_bench)
+	# Dataset sizes: rows per table, maximum number of instants per 
+	# sequence, and maximum number of sequences per sequence set
+	BENCH_ROWS=${BENCH_ROWS:-1000}
+	BENCH_INSTANTS=${BENCH_INSTANTS:-10}
+	BENCH_SEQUENCES=${BENCH_SEQUENCES:-5}
+	BENCHPSQL="$FAILPSQL -v rows=$BENCH_ROWS -v instants=$BENCH_INSTANTS -v sequences=$BENCH_SEQUENCES -v copyfile=$WORKDIR/out/bench_copy.csv"
+
+	$PGCTL status || $PGCTL start
+
+	while ! $PSQL -l; do
+		sleep 1
+	done
+
+	SETUPFILES="../src/debug/random_temporal.sql bench/bench_setup.sql"
+	BENCHFILES=`ls bench/queries/*.sql`
+	if [ ! -z "$POSTGIS" ]; then
+		SETUPFILES="$SETUPFILES ../point/src/debug/random_tpoint.sql ../point/test/bench/bench_setup_tpoint.sql"
+		BENCHFILES="$BENCHFILES `ls ../point/test/bench/queries/*.sql`"
+	fi
+
+	rm -f $WORKDIR/log/bench.log
+	for file in $SETUPFILES $BENCHFILES; do
+		$BENCHPSQL < $file >> $WORKDIR/log/bench.log 2>&1
+		if [ "$?" != "0" ]; then
+			echo "Benchmark $file failed, see $WORKDIR/log/bench.log" >&2
+			exit 1
+		fi
+	done
+
+	echo "\\copy (SELECT * FROM bench_results ORDER BY name) TO '$WORKDIR/out/bench.csv' CSV HEADER" | $FAILPSQL > /dev/null
+	cat $WORKDIR/out/bench.csv
+	exit $?
+	;;
 	
 esac
 